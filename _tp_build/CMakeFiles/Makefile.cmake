@@ -0,0 +1,172 @@
+# CMAKE generated file: DO NOT EDIT!
+# Generated by "Unix Makefiles" Generator, CMake Version 3.25
+
+# The generator used is:
+set(CMAKE_DEPENDS_GENERATOR "Unix Makefiles")
+
+# The top level Makefile was generated from the following files:
+set(CMAKE_MAKEFILE_DEPENDS
+  "CMakeCache.txt"
+  "/root/repo/CMakeLists.txt"
+  "CMakeFiles/3.25.1/CMakeCCompiler.cmake"
+  "CMakeFiles/3.25.1/CMakeCXXCompiler.cmake"
+  "CMakeFiles/3.25.1/CMakeSystem.cmake"
+  "/root/repo/benchmark/CMakeLists.txt"
+  "/root/repo/cmake/ncnnConfig.cmake.in"
+  "/root/repo/cmake/ncnn_generate_shader_spv_header.cmake"
+  "/root/repo/examples/CMakeLists.txt"
+  "/root/repo/src/CMakeLists.txt"
+  "/root/repo/src/layer_declaration.h.in"
+  "/root/repo/src/layer_registry.h.in"
+  "/root/repo/src/layer_registry_avx2.h.in"
+  "/root/repo/src/layer_registry_avx512.h.in"
+  "/root/repo/src/layer_shader_registry.h.in"
+  "/root/repo/src/layer_shader_spv_data.h.in"
+  "/root/repo/src/layer_shader_type_enum.h.in"
+  "/root/repo/src/layer_type_enum.h.in"
+  "/root/repo/src/platform.h.in"
+  "/root/repo/tests/CMakeLists.txt"
+  "/root/repo/tools/CMakeLists.txt"
+  "/root/repo/tools/caffe/CMakeLists.txt"
+  "/root/repo/tools/darknet/CMakeLists.txt"
+  "/root/repo/tools/mxnet/CMakeLists.txt"
+  "/root/repo/tools/onnx/CMakeLists.txt"
+  "/root/repo/tools/quantize/CMakeLists.txt"
+  "/usr/share/cmake-3.25/Modules/CMakeCInformation.cmake"
+  "/usr/share/cmake-3.25/Modules/CMakeCXXInformation.cmake"
+  "/usr/share/cmake-3.25/Modules/CMakeCheckCompilerFlagCommonPatterns.cmake"
+  "/usr/share/cmake-3.25/Modules/CMakeCommonLanguageInclude.cmake"
+  "/usr/share/cmake-3.25/Modules/CMakeGenericSystem.cmake"
+  "/usr/share/cmake-3.25/Modules/CMakeInitializeConfigs.cmake"
+  "/usr/share/cmake-3.25/Modules/CMakeLanguageInformation.cmake"
+  "/usr/share/cmake-3.25/Modules/CMakeParseImplicitLinkInfo.cmake"
+  "/usr/share/cmake-3.25/Modules/CMakeSystemSpecificInformation.cmake"
+  "/usr/share/cmake-3.25/Modules/CMakeSystemSpecificInitialize.cmake"
+  "/usr/share/cmake-3.25/Modules/CheckCSourceCompiles.cmake"
+  "/usr/share/cmake-3.25/Modules/CheckCXXCompilerFlag.cmake"
+  "/usr/share/cmake-3.25/Modules/CheckCXXSourceCompiles.cmake"
+  "/usr/share/cmake-3.25/Modules/CheckIncludeFile.cmake"
+  "/usr/share/cmake-3.25/Modules/CheckLibraryExists.cmake"
+  "/usr/share/cmake-3.25/Modules/Compiler/CMakeCommonCompilerMacros.cmake"
+  "/usr/share/cmake-3.25/Modules/Compiler/GNU-C.cmake"
+  "/usr/share/cmake-3.25/Modules/Compiler/GNU-CXX.cmake"
+  "/usr/share/cmake-3.25/Modules/Compiler/GNU.cmake"
+  "/usr/share/cmake-3.25/Modules/FindOpenMP.cmake"
+  "/usr/share/cmake-3.25/Modules/FindPackageHandleStandardArgs.cmake"
+  "/usr/share/cmake-3.25/Modules/FindPackageMessage.cmake"
+  "/usr/share/cmake-3.25/Modules/FindProtobuf.cmake"
+  "/usr/share/cmake-3.25/Modules/FindThreads.cmake"
+  "/usr/share/cmake-3.25/Modules/Internal/CheckCompilerFlag.cmake"
+  "/usr/share/cmake-3.25/Modules/Internal/CheckFlagCommonConfig.cmake"
+  "/usr/share/cmake-3.25/Modules/Internal/CheckSourceCompiles.cmake"
+  "/usr/share/cmake-3.25/Modules/Platform/Linux-GNU-C.cmake"
+  "/usr/share/cmake-3.25/Modules/Platform/Linux-GNU-CXX.cmake"
+  "/usr/share/cmake-3.25/Modules/Platform/Linux-GNU.cmake"
+  "/usr/share/cmake-3.25/Modules/Platform/Linux.cmake"
+  "/usr/share/cmake-3.25/Modules/Platform/UnixPaths.cmake"
+  "/usr/share/cmake-3.25/Modules/SelectLibraryConfigurations.cmake"
+  )
+
+# The corresponding makefile is:
+set(CMAKE_MAKEFILE_OUTPUTS
+  "Makefile"
+  "CMakeFiles/cmake.check_cache"
+  )
+
+# Byproducts of CMake generate step:
+set(CMAKE_MAKEFILE_PRODUCTS
+  "CMakeFiles/CMakeDirectoryInformation.cmake"
+  "src/platform.h"
+  "src/layer_declaration.h"
+  "src/layer_registry.h"
+  "src/layer_registry_avx2.h"
+  "src/layer_registry_avx512.h"
+  "src/layer_type_enum.h"
+  "src/layer_shader_registry.h"
+  "src/layer_shader_spv_data.h"
+  "src/layer_shader_type_enum.h"
+  "src/ncnnConfig.cmake"
+  "src/CMakeFiles/CMakeDirectoryInformation.cmake"
+  "benchmark/CMakeFiles/CMakeDirectoryInformation.cmake"
+  "examples/CMakeFiles/CMakeDirectoryInformation.cmake"
+  "tools/CMakeFiles/CMakeDirectoryInformation.cmake"
+  "tools/caffe/CMakeFiles/CMakeDirectoryInformation.cmake"
+  "tools/mxnet/CMakeFiles/CMakeDirectoryInformation.cmake"
+  "tools/onnx/CMakeFiles/CMakeDirectoryInformation.cmake"
+  "tools/darknet/CMakeFiles/CMakeDirectoryInformation.cmake"
+  "tools/quantize/CMakeFiles/CMakeDirectoryInformation.cmake"
+  "tests/CMakeFiles/CMakeDirectoryInformation.cmake"
+  )
+
+# Dependency information for all targets:
+set(CMAKE_DEPEND_INFO_FILES
+  "src/CMakeFiles/ncnn-generate-spirv.dir/DependInfo.cmake"
+  "src/CMakeFiles/ncnn.dir/DependInfo.cmake"
+  "benchmark/CMakeFiles/benchncnn.dir/DependInfo.cmake"
+  "benchmark/CMakeFiles/benchconvert.dir/DependInfo.cmake"
+  "benchmark/CMakeFiles/benchstream.dir/DependInfo.cmake"
+  "benchmark/CMakeFiles/benchnuma.dir/DependInfo.cmake"
+  "tools/CMakeFiles/ncnn2mem.dir/DependInfo.cmake"
+  "tools/CMakeFiles/ncnn2container.dir/DependInfo.cmake"
+  "tools/CMakeFiles/ncnnoptimize.dir/DependInfo.cmake"
+  "tools/caffe/CMakeFiles/caffe2ncnn.dir/DependInfo.cmake"
+  "tools/mxnet/CMakeFiles/mxnet2ncnn.dir/DependInfo.cmake"
+  "tools/onnx/CMakeFiles/onnx2ncnn.dir/DependInfo.cmake"
+  "tools/darknet/CMakeFiles/darknet2ncnn.dir/DependInfo.cmake"
+  "tests/CMakeFiles/test_extractor.dir/DependInfo.cmake"
+  "tests/CMakeFiles/test_mat_pixel_rotate.dir/DependInfo.cmake"
+  "tests/CMakeFiles/test_memoryplan.dir/DependInfo.cmake"
+  "tests/CMakeFiles/test_sizeclasspoolallocator.dir/DependInfo.cmake"
+  "tests/CMakeFiles/test_streamextractor.dir/DependInfo.cmake"
+  "tests/CMakeFiles/test_absval.dir/DependInfo.cmake"
+  "tests/CMakeFiles/test_batchnorm.dir/DependInfo.cmake"
+  "tests/CMakeFiles/test_binaryop.dir/DependInfo.cmake"
+  "tests/CMakeFiles/test_cast.dir/DependInfo.cmake"
+  "tests/CMakeFiles/test_clip.dir/DependInfo.cmake"
+  "tests/CMakeFiles/test_concat.dir/DependInfo.cmake"
+  "tests/CMakeFiles/test_convolution.dir/DependInfo.cmake"
+  "tests/CMakeFiles/test_convolutiondepthwise.dir/DependInfo.cmake"
+  "tests/CMakeFiles/test_crop.dir/DependInfo.cmake"
+  "tests/CMakeFiles/test_deconvolution.dir/DependInfo.cmake"
+  "tests/CMakeFiles/test_deconvolutiondepthwise.dir/DependInfo.cmake"
+  "tests/CMakeFiles/test_deepcopy.dir/DependInfo.cmake"
+  "tests/CMakeFiles/test_dequantize.dir/DependInfo.cmake"
+  "tests/CMakeFiles/test_dropout.dir/DependInfo.cmake"
+  "tests/CMakeFiles/test_eltwise.dir/DependInfo.cmake"
+  "tests/CMakeFiles/test_elu.dir/DependInfo.cmake"
+  "tests/CMakeFiles/test_flatten.dir/DependInfo.cmake"
+  "tests/CMakeFiles/test_hardsigmoid.dir/DependInfo.cmake"
+  "tests/CMakeFiles/test_hardswish.dir/DependInfo.cmake"
+  "tests/CMakeFiles/test_innerproduct.dir/DependInfo.cmake"
+  "tests/CMakeFiles/test_instancenorm.dir/DependInfo.cmake"
+  "tests/CMakeFiles/test_interp.dir/DependInfo.cmake"
+  "tests/CMakeFiles/test_lrn.dir/DependInfo.cmake"
+  "tests/CMakeFiles/test_memorydata.dir/DependInfo.cmake"
+  "tests/CMakeFiles/test_noop.dir/DependInfo.cmake"
+  "tests/CMakeFiles/test_normalize.dir/DependInfo.cmake"
+  "tests/CMakeFiles/test_packing.dir/DependInfo.cmake"
+  "tests/CMakeFiles/test_padding.dir/DependInfo.cmake"
+  "tests/CMakeFiles/test_permute.dir/DependInfo.cmake"
+  "tests/CMakeFiles/test_pixelshuffle.dir/DependInfo.cmake"
+  "tests/CMakeFiles/test_pooling.dir/DependInfo.cmake"
+  "tests/CMakeFiles/test_prelu.dir/DependInfo.cmake"
+  "tests/CMakeFiles/test_priorbox.dir/DependInfo.cmake"
+  "tests/CMakeFiles/test_quantize.dir/DependInfo.cmake"
+  "tests/CMakeFiles/test_roipooling.dir/DependInfo.cmake"
+  "tests/CMakeFiles/test_roialign.dir/DependInfo.cmake"
+  "tests/CMakeFiles/test_relu.dir/DependInfo.cmake"
+  "tests/CMakeFiles/test_reorg.dir/DependInfo.cmake"
+  "tests/CMakeFiles/test_requantize.dir/DependInfo.cmake"
+  "tests/CMakeFiles/test_reshape.dir/DependInfo.cmake"
+  "tests/CMakeFiles/test_scale.dir/DependInfo.cmake"
+  "tests/CMakeFiles/test_shufflechannel.dir/DependInfo.cmake"
+  "tests/CMakeFiles/test_sigmoid.dir/DependInfo.cmake"
+  "tests/CMakeFiles/test_slice.dir/DependInfo.cmake"
+  "tests/CMakeFiles/test_softmax.dir/DependInfo.cmake"
+  "tests/CMakeFiles/test_tanh.dir/DependInfo.cmake"
+  "tests/CMakeFiles/test_unaryop.dir/DependInfo.cmake"
+  "tests/CMakeFiles/test_mish.dir/DependInfo.cmake"
+  "tests/CMakeFiles/test_swish.dir/DependInfo.cmake"
+  "tests/CMakeFiles/test_lstm.dir/DependInfo.cmake"
+  "tests/CMakeFiles/test_gru.dir/DependInfo.cmake"
+  )
@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/benchconvert.dir/benchconvert.cpp.o"
+  "CMakeFiles/benchconvert.dir/benchconvert.cpp.o.d"
+  "benchconvert"
+  "benchconvert.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/benchconvert.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/benchnuma.dir/benchnuma.cpp.o"
+  "CMakeFiles/benchnuma.dir/benchnuma.cpp.o.d"
+  "benchnuma"
+  "benchnuma.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/benchnuma.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
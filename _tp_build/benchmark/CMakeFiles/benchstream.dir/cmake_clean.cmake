@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/benchstream.dir/benchstream.cpp.o"
+  "CMakeFiles/benchstream.dir/benchstream.cpp.o.d"
+  "benchstream"
+  "benchstream.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/benchstream.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
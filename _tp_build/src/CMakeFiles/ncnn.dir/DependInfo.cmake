@@ -0,0 +1,198 @@
+
+# Consider dependencies only in project.
+set(CMAKE_DEPENDS_IN_PROJECT_ONLY OFF)
+
+# The set of languages for which implicit dependencies are needed:
+set(CMAKE_DEPENDS_LANGUAGES
+  )
+
+# The set of dependency files which are needed:
+set(CMAKE_DEPENDS_DEPENDENCY_FILES
+  "/root/repo/src/allocator.cpp" "src/CMakeFiles/ncnn.dir/allocator.cpp.o" "gcc" "src/CMakeFiles/ncnn.dir/allocator.cpp.o.d"
+  "/root/repo/src/benchmark.cpp" "src/CMakeFiles/ncnn.dir/benchmark.cpp.o" "gcc" "src/CMakeFiles/ncnn.dir/benchmark.cpp.o.d"
+  "/root/repo/src/blob.cpp" "src/CMakeFiles/ncnn.dir/blob.cpp.o" "gcc" "src/CMakeFiles/ncnn.dir/blob.cpp.o.d"
+  "/root/repo/src/c_api.cpp" "src/CMakeFiles/ncnn.dir/c_api.cpp.o" "gcc" "src/CMakeFiles/ncnn.dir/c_api.cpp.o.d"
+  "/root/repo/src/command.cpp" "src/CMakeFiles/ncnn.dir/command.cpp.o" "gcc" "src/CMakeFiles/ncnn.dir/command.cpp.o.d"
+  "/root/repo/src/cpu.cpp" "src/CMakeFiles/ncnn.dir/cpu.cpp.o" "gcc" "src/CMakeFiles/ncnn.dir/cpu.cpp.o.d"
+  "/root/repo/src/datareader.cpp" "src/CMakeFiles/ncnn.dir/datareader.cpp.o" "gcc" "src/CMakeFiles/ncnn.dir/datareader.cpp.o.d"
+  "/root/repo/src/gpu.cpp" "src/CMakeFiles/ncnn.dir/gpu.cpp.o" "gcc" "src/CMakeFiles/ncnn.dir/gpu.cpp.o.d"
+  "/root/repo/src/layer.cpp" "src/CMakeFiles/ncnn.dir/layer.cpp.o" "gcc" "src/CMakeFiles/ncnn.dir/layer.cpp.o.d"
+  "/root/repo/src/layer/absval.cpp" "src/CMakeFiles/ncnn.dir/layer/absval.cpp.o" "gcc" "src/CMakeFiles/ncnn.dir/layer/absval.cpp.o.d"
+  "/root/repo/src/layer/batchnorm.cpp" "src/CMakeFiles/ncnn.dir/layer/batchnorm.cpp.o" "gcc" "src/CMakeFiles/ncnn.dir/layer/batchnorm.cpp.o.d"
+  "/root/repo/src/layer/bias.cpp" "src/CMakeFiles/ncnn.dir/layer/bias.cpp.o" "gcc" "src/CMakeFiles/ncnn.dir/layer/bias.cpp.o.d"
+  "/root/repo/src/layer/binaryop.cpp" "src/CMakeFiles/ncnn.dir/layer/binaryop.cpp.o" "gcc" "src/CMakeFiles/ncnn.dir/layer/binaryop.cpp.o.d"
+  "/root/repo/src/layer/bnll.cpp" "src/CMakeFiles/ncnn.dir/layer/bnll.cpp.o" "gcc" "src/CMakeFiles/ncnn.dir/layer/bnll.cpp.o.d"
+  "/root/repo/src/layer/cast.cpp" "src/CMakeFiles/ncnn.dir/layer/cast.cpp.o" "gcc" "src/CMakeFiles/ncnn.dir/layer/cast.cpp.o.d"
+  "/root/repo/src/layer/clip.cpp" "src/CMakeFiles/ncnn.dir/layer/clip.cpp.o" "gcc" "src/CMakeFiles/ncnn.dir/layer/clip.cpp.o.d"
+  "/root/repo/src/layer/concat.cpp" "src/CMakeFiles/ncnn.dir/layer/concat.cpp.o" "gcc" "src/CMakeFiles/ncnn.dir/layer/concat.cpp.o.d"
+  "/root/repo/src/layer/convolution.cpp" "src/CMakeFiles/ncnn.dir/layer/convolution.cpp.o" "gcc" "src/CMakeFiles/ncnn.dir/layer/convolution.cpp.o.d"
+  "/root/repo/src/layer/convolutiondepthwise.cpp" "src/CMakeFiles/ncnn.dir/layer/convolutiondepthwise.cpp.o" "gcc" "src/CMakeFiles/ncnn.dir/layer/convolutiondepthwise.cpp.o.d"
+  "/root/repo/src/layer/crop.cpp" "src/CMakeFiles/ncnn.dir/layer/crop.cpp.o" "gcc" "src/CMakeFiles/ncnn.dir/layer/crop.cpp.o.d"
+  "/root/repo/src/layer/deconvolution.cpp" "src/CMakeFiles/ncnn.dir/layer/deconvolution.cpp.o" "gcc" "src/CMakeFiles/ncnn.dir/layer/deconvolution.cpp.o.d"
+  "/root/repo/src/layer/deconvolutiondepthwise.cpp" "src/CMakeFiles/ncnn.dir/layer/deconvolutiondepthwise.cpp.o" "gcc" "src/CMakeFiles/ncnn.dir/layer/deconvolutiondepthwise.cpp.o.d"
+  "/root/repo/src/layer/deepcopy.cpp" "src/CMakeFiles/ncnn.dir/layer/deepcopy.cpp.o" "gcc" "src/CMakeFiles/ncnn.dir/layer/deepcopy.cpp.o.d"
+  "/root/repo/src/layer/dequantize.cpp" "src/CMakeFiles/ncnn.dir/layer/dequantize.cpp.o" "gcc" "src/CMakeFiles/ncnn.dir/layer/dequantize.cpp.o.d"
+  "/root/repo/src/layer/detectionoutput.cpp" "src/CMakeFiles/ncnn.dir/layer/detectionoutput.cpp.o" "gcc" "src/CMakeFiles/ncnn.dir/layer/detectionoutput.cpp.o.d"
+  "/root/repo/src/layer/dropout.cpp" "src/CMakeFiles/ncnn.dir/layer/dropout.cpp.o" "gcc" "src/CMakeFiles/ncnn.dir/layer/dropout.cpp.o.d"
+  "/root/repo/src/layer/eltwise.cpp" "src/CMakeFiles/ncnn.dir/layer/eltwise.cpp.o" "gcc" "src/CMakeFiles/ncnn.dir/layer/eltwise.cpp.o.d"
+  "/root/repo/src/layer/elu.cpp" "src/CMakeFiles/ncnn.dir/layer/elu.cpp.o" "gcc" "src/CMakeFiles/ncnn.dir/layer/elu.cpp.o.d"
+  "/root/repo/src/layer/embed.cpp" "src/CMakeFiles/ncnn.dir/layer/embed.cpp.o" "gcc" "src/CMakeFiles/ncnn.dir/layer/embed.cpp.o.d"
+  "/root/repo/src/layer/exp.cpp" "src/CMakeFiles/ncnn.dir/layer/exp.cpp.o" "gcc" "src/CMakeFiles/ncnn.dir/layer/exp.cpp.o.d"
+  "/root/repo/src/layer/expanddims.cpp" "src/CMakeFiles/ncnn.dir/layer/expanddims.cpp.o" "gcc" "src/CMakeFiles/ncnn.dir/layer/expanddims.cpp.o.d"
+  "/root/repo/src/layer/flatten.cpp" "src/CMakeFiles/ncnn.dir/layer/flatten.cpp.o" "gcc" "src/CMakeFiles/ncnn.dir/layer/flatten.cpp.o.d"
+  "/root/repo/src/layer/gru.cpp" "src/CMakeFiles/ncnn.dir/layer/gru.cpp.o" "gcc" "src/CMakeFiles/ncnn.dir/layer/gru.cpp.o.d"
+  "/root/repo/src/layer/hardsigmoid.cpp" "src/CMakeFiles/ncnn.dir/layer/hardsigmoid.cpp.o" "gcc" "src/CMakeFiles/ncnn.dir/layer/hardsigmoid.cpp.o.d"
+  "/root/repo/src/layer/hardswish.cpp" "src/CMakeFiles/ncnn.dir/layer/hardswish.cpp.o" "gcc" "src/CMakeFiles/ncnn.dir/layer/hardswish.cpp.o.d"
+  "/root/repo/src/layer/innerproduct.cpp" "src/CMakeFiles/ncnn.dir/layer/innerproduct.cpp.o" "gcc" "src/CMakeFiles/ncnn.dir/layer/innerproduct.cpp.o.d"
+  "/root/repo/src/layer/input.cpp" "src/CMakeFiles/ncnn.dir/layer/input.cpp.o" "gcc" "src/CMakeFiles/ncnn.dir/layer/input.cpp.o.d"
+  "/root/repo/src/layer/instancenorm.cpp" "src/CMakeFiles/ncnn.dir/layer/instancenorm.cpp.o" "gcc" "src/CMakeFiles/ncnn.dir/layer/instancenorm.cpp.o.d"
+  "/root/repo/src/layer/interp.cpp" "src/CMakeFiles/ncnn.dir/layer/interp.cpp.o" "gcc" "src/CMakeFiles/ncnn.dir/layer/interp.cpp.o.d"
+  "/root/repo/src/layer/log.cpp" "src/CMakeFiles/ncnn.dir/layer/log.cpp.o" "gcc" "src/CMakeFiles/ncnn.dir/layer/log.cpp.o.d"
+  "/root/repo/src/layer/lrn.cpp" "src/CMakeFiles/ncnn.dir/layer/lrn.cpp.o" "gcc" "src/CMakeFiles/ncnn.dir/layer/lrn.cpp.o.d"
+  "/root/repo/src/layer/lstm.cpp" "src/CMakeFiles/ncnn.dir/layer/lstm.cpp.o" "gcc" "src/CMakeFiles/ncnn.dir/layer/lstm.cpp.o.d"
+  "/root/repo/src/layer/memorydata.cpp" "src/CMakeFiles/ncnn.dir/layer/memorydata.cpp.o" "gcc" "src/CMakeFiles/ncnn.dir/layer/memorydata.cpp.o.d"
+  "/root/repo/src/layer/mish.cpp" "src/CMakeFiles/ncnn.dir/layer/mish.cpp.o" "gcc" "src/CMakeFiles/ncnn.dir/layer/mish.cpp.o.d"
+  "/root/repo/src/layer/mvn.cpp" "src/CMakeFiles/ncnn.dir/layer/mvn.cpp.o" "gcc" "src/CMakeFiles/ncnn.dir/layer/mvn.cpp.o.d"
+  "/root/repo/src/layer/noop.cpp" "src/CMakeFiles/ncnn.dir/layer/noop.cpp.o" "gcc" "src/CMakeFiles/ncnn.dir/layer/noop.cpp.o.d"
+  "/root/repo/src/layer/normalize.cpp" "src/CMakeFiles/ncnn.dir/layer/normalize.cpp.o" "gcc" "src/CMakeFiles/ncnn.dir/layer/normalize.cpp.o.d"
+  "/root/repo/src/layer/packing.cpp" "src/CMakeFiles/ncnn.dir/layer/packing.cpp.o" "gcc" "src/CMakeFiles/ncnn.dir/layer/packing.cpp.o.d"
+  "/root/repo/src/layer/padding.cpp" "src/CMakeFiles/ncnn.dir/layer/padding.cpp.o" "gcc" "src/CMakeFiles/ncnn.dir/layer/padding.cpp.o.d"
+  "/root/repo/src/layer/permute.cpp" "src/CMakeFiles/ncnn.dir/layer/permute.cpp.o" "gcc" "src/CMakeFiles/ncnn.dir/layer/permute.cpp.o.d"
+  "/root/repo/src/layer/pixelshuffle.cpp" "src/CMakeFiles/ncnn.dir/layer/pixelshuffle.cpp.o" "gcc" "src/CMakeFiles/ncnn.dir/layer/pixelshuffle.cpp.o.d"
+  "/root/repo/src/layer/pooling.cpp" "src/CMakeFiles/ncnn.dir/layer/pooling.cpp.o" "gcc" "src/CMakeFiles/ncnn.dir/layer/pooling.cpp.o.d"
+  "/root/repo/src/layer/power.cpp" "src/CMakeFiles/ncnn.dir/layer/power.cpp.o" "gcc" "src/CMakeFiles/ncnn.dir/layer/power.cpp.o.d"
+  "/root/repo/src/layer/prelu.cpp" "src/CMakeFiles/ncnn.dir/layer/prelu.cpp.o" "gcc" "src/CMakeFiles/ncnn.dir/layer/prelu.cpp.o.d"
+  "/root/repo/src/layer/priorbox.cpp" "src/CMakeFiles/ncnn.dir/layer/priorbox.cpp.o" "gcc" "src/CMakeFiles/ncnn.dir/layer/priorbox.cpp.o.d"
+  "/root/repo/src/layer/proposal.cpp" "src/CMakeFiles/ncnn.dir/layer/proposal.cpp.o" "gcc" "src/CMakeFiles/ncnn.dir/layer/proposal.cpp.o.d"
+  "/root/repo/src/layer/psroipooling.cpp" "src/CMakeFiles/ncnn.dir/layer/psroipooling.cpp.o" "gcc" "src/CMakeFiles/ncnn.dir/layer/psroipooling.cpp.o.d"
+  "/root/repo/src/layer/quantize.cpp" "src/CMakeFiles/ncnn.dir/layer/quantize.cpp.o" "gcc" "src/CMakeFiles/ncnn.dir/layer/quantize.cpp.o.d"
+  "/root/repo/src/layer/reduction.cpp" "src/CMakeFiles/ncnn.dir/layer/reduction.cpp.o" "gcc" "src/CMakeFiles/ncnn.dir/layer/reduction.cpp.o.d"
+  "/root/repo/src/layer/relu.cpp" "src/CMakeFiles/ncnn.dir/layer/relu.cpp.o" "gcc" "src/CMakeFiles/ncnn.dir/layer/relu.cpp.o.d"
+  "/root/repo/src/layer/reorg.cpp" "src/CMakeFiles/ncnn.dir/layer/reorg.cpp.o" "gcc" "src/CMakeFiles/ncnn.dir/layer/reorg.cpp.o.d"
+  "/root/repo/src/layer/requantize.cpp" "src/CMakeFiles/ncnn.dir/layer/requantize.cpp.o" "gcc" "src/CMakeFiles/ncnn.dir/layer/requantize.cpp.o.d"
+  "/root/repo/src/layer/reshape.cpp" "src/CMakeFiles/ncnn.dir/layer/reshape.cpp.o" "gcc" "src/CMakeFiles/ncnn.dir/layer/reshape.cpp.o.d"
+  "/root/repo/src/layer/roialign.cpp" "src/CMakeFiles/ncnn.dir/layer/roialign.cpp.o" "gcc" "src/CMakeFiles/ncnn.dir/layer/roialign.cpp.o.d"
+  "/root/repo/src/layer/roipooling.cpp" "src/CMakeFiles/ncnn.dir/layer/roipooling.cpp.o" "gcc" "src/CMakeFiles/ncnn.dir/layer/roipooling.cpp.o.d"
+  "/root/repo/src/layer/scale.cpp" "src/CMakeFiles/ncnn.dir/layer/scale.cpp.o" "gcc" "src/CMakeFiles/ncnn.dir/layer/scale.cpp.o.d"
+  "/root/repo/src/layer/selu.cpp" "src/CMakeFiles/ncnn.dir/layer/selu.cpp.o" "gcc" "src/CMakeFiles/ncnn.dir/layer/selu.cpp.o.d"
+  "/root/repo/src/layer/shufflechannel.cpp" "src/CMakeFiles/ncnn.dir/layer/shufflechannel.cpp.o" "gcc" "src/CMakeFiles/ncnn.dir/layer/shufflechannel.cpp.o.d"
+  "/root/repo/src/layer/sigmoid.cpp" "src/CMakeFiles/ncnn.dir/layer/sigmoid.cpp.o" "gcc" "src/CMakeFiles/ncnn.dir/layer/sigmoid.cpp.o.d"
+  "/root/repo/src/layer/slice.cpp" "src/CMakeFiles/ncnn.dir/layer/slice.cpp.o" "gcc" "src/CMakeFiles/ncnn.dir/layer/slice.cpp.o.d"
+  "/root/repo/src/layer/softmax.cpp" "src/CMakeFiles/ncnn.dir/layer/softmax.cpp.o" "gcc" "src/CMakeFiles/ncnn.dir/layer/softmax.cpp.o.d"
+  "/root/repo/src/layer/split.cpp" "src/CMakeFiles/ncnn.dir/layer/split.cpp.o" "gcc" "src/CMakeFiles/ncnn.dir/layer/split.cpp.o.d"
+  "/root/repo/src/layer/squeeze.cpp" "src/CMakeFiles/ncnn.dir/layer/squeeze.cpp.o" "gcc" "src/CMakeFiles/ncnn.dir/layer/squeeze.cpp.o.d"
+  "/root/repo/src/layer/statisticspooling.cpp" "src/CMakeFiles/ncnn.dir/layer/statisticspooling.cpp.o" "gcc" "src/CMakeFiles/ncnn.dir/layer/statisticspooling.cpp.o.d"
+  "/root/repo/src/layer/swish.cpp" "src/CMakeFiles/ncnn.dir/layer/swish.cpp.o" "gcc" "src/CMakeFiles/ncnn.dir/layer/swish.cpp.o.d"
+  "/root/repo/src/layer/tanh.cpp" "src/CMakeFiles/ncnn.dir/layer/tanh.cpp.o" "gcc" "src/CMakeFiles/ncnn.dir/layer/tanh.cpp.o.d"
+  "/root/repo/src/layer/threshold.cpp" "src/CMakeFiles/ncnn.dir/layer/threshold.cpp.o" "gcc" "src/CMakeFiles/ncnn.dir/layer/threshold.cpp.o.d"
+  "/root/repo/src/layer/unaryop.cpp" "src/CMakeFiles/ncnn.dir/layer/unaryop.cpp.o" "gcc" "src/CMakeFiles/ncnn.dir/layer/unaryop.cpp.o.d"
+  "/root/repo/src/layer/x86/batchnorm_x86.cpp" "src/CMakeFiles/ncnn.dir/layer/x86/batchnorm_x86.cpp.o" "gcc" "src/CMakeFiles/ncnn.dir/layer/x86/batchnorm_x86.cpp.o.d"
+  "/root/repo/_tp_build/src/layer/x86/batchnorm_x86_avx2.cpp" "src/CMakeFiles/ncnn.dir/layer/x86/batchnorm_x86_avx2.cpp.o" "gcc" "src/CMakeFiles/ncnn.dir/layer/x86/batchnorm_x86_avx2.cpp.o.d"
+  "/root/repo/src/layer/x86/bias_x86.cpp" "src/CMakeFiles/ncnn.dir/layer/x86/bias_x86.cpp.o" "gcc" "src/CMakeFiles/ncnn.dir/layer/x86/bias_x86.cpp.o.d"
+  "/root/repo/_tp_build/src/layer/x86/bias_x86_avx2.cpp" "src/CMakeFiles/ncnn.dir/layer/x86/bias_x86_avx2.cpp.o" "gcc" "src/CMakeFiles/ncnn.dir/layer/x86/bias_x86_avx2.cpp.o.d"
+  "/root/repo/src/layer/x86/binaryop_x86.cpp" "src/CMakeFiles/ncnn.dir/layer/x86/binaryop_x86.cpp.o" "gcc" "src/CMakeFiles/ncnn.dir/layer/x86/binaryop_x86.cpp.o.d"
+  "/root/repo/_tp_build/src/layer/x86/binaryop_x86_avx2.cpp" "src/CMakeFiles/ncnn.dir/layer/x86/binaryop_x86_avx2.cpp.o" "gcc" "src/CMakeFiles/ncnn.dir/layer/x86/binaryop_x86_avx2.cpp.o.d"
+  "/root/repo/src/layer/x86/cast_x86.cpp" "src/CMakeFiles/ncnn.dir/layer/x86/cast_x86.cpp.o" "gcc" "src/CMakeFiles/ncnn.dir/layer/x86/cast_x86.cpp.o.d"
+  "/root/repo/_tp_build/src/layer/x86/cast_x86_avx2.cpp" "src/CMakeFiles/ncnn.dir/layer/x86/cast_x86_avx2.cpp.o" "gcc" "src/CMakeFiles/ncnn.dir/layer/x86/cast_x86_avx2.cpp.o.d"
+  "/root/repo/src/layer/x86/clip_x86.cpp" "src/CMakeFiles/ncnn.dir/layer/x86/clip_x86.cpp.o" "gcc" "src/CMakeFiles/ncnn.dir/layer/x86/clip_x86.cpp.o.d"
+  "/root/repo/_tp_build/src/layer/x86/clip_x86_avx2.cpp" "src/CMakeFiles/ncnn.dir/layer/x86/clip_x86_avx2.cpp.o" "gcc" "src/CMakeFiles/ncnn.dir/layer/x86/clip_x86_avx2.cpp.o.d"
+  "/root/repo/src/layer/x86/concat_x86.cpp" "src/CMakeFiles/ncnn.dir/layer/x86/concat_x86.cpp.o" "gcc" "src/CMakeFiles/ncnn.dir/layer/x86/concat_x86.cpp.o.d"
+  "/root/repo/_tp_build/src/layer/x86/concat_x86_avx2.cpp" "src/CMakeFiles/ncnn.dir/layer/x86/concat_x86_avx2.cpp.o" "gcc" "src/CMakeFiles/ncnn.dir/layer/x86/concat_x86_avx2.cpp.o.d"
+  "/root/repo/src/layer/x86/convolution_x86.cpp" "src/CMakeFiles/ncnn.dir/layer/x86/convolution_x86.cpp.o" "gcc" "src/CMakeFiles/ncnn.dir/layer/x86/convolution_x86.cpp.o.d"
+  "/root/repo/_tp_build/src/layer/x86/convolution_x86_avx2.cpp" "src/CMakeFiles/ncnn.dir/layer/x86/convolution_x86_avx2.cpp.o" "gcc" "src/CMakeFiles/ncnn.dir/layer/x86/convolution_x86_avx2.cpp.o.d"
+  "/root/repo/_tp_build/src/layer/x86/convolution_x86_avx512.cpp" "src/CMakeFiles/ncnn.dir/layer/x86/convolution_x86_avx512.cpp.o" "gcc" "src/CMakeFiles/ncnn.dir/layer/x86/convolution_x86_avx512.cpp.o.d"
+  "/root/repo/src/layer/x86/convolutiondepthwise_x86.cpp" "src/CMakeFiles/ncnn.dir/layer/x86/convolutiondepthwise_x86.cpp.o" "gcc" "src/CMakeFiles/ncnn.dir/layer/x86/convolutiondepthwise_x86.cpp.o.d"
+  "/root/repo/_tp_build/src/layer/x86/convolutiondepthwise_x86_avx2.cpp" "src/CMakeFiles/ncnn.dir/layer/x86/convolutiondepthwise_x86_avx2.cpp.o" "gcc" "src/CMakeFiles/ncnn.dir/layer/x86/convolutiondepthwise_x86_avx2.cpp.o.d"
+  "/root/repo/src/layer/x86/crop_x86.cpp" "src/CMakeFiles/ncnn.dir/layer/x86/crop_x86.cpp.o" "gcc" "src/CMakeFiles/ncnn.dir/layer/x86/crop_x86.cpp.o.d"
+  "/root/repo/_tp_build/src/layer/x86/crop_x86_avx2.cpp" "src/CMakeFiles/ncnn.dir/layer/x86/crop_x86_avx2.cpp.o" "gcc" "src/CMakeFiles/ncnn.dir/layer/x86/crop_x86_avx2.cpp.o.d"
+  "/root/repo/src/layer/x86/deconvolution_x86.cpp" "src/CMakeFiles/ncnn.dir/layer/x86/deconvolution_x86.cpp.o" "gcc" "src/CMakeFiles/ncnn.dir/layer/x86/deconvolution_x86.cpp.o.d"
+  "/root/repo/_tp_build/src/layer/x86/deconvolution_x86_avx2.cpp" "src/CMakeFiles/ncnn.dir/layer/x86/deconvolution_x86_avx2.cpp.o" "gcc" "src/CMakeFiles/ncnn.dir/layer/x86/deconvolution_x86_avx2.cpp.o.d"
+  "/root/repo/src/layer/x86/deconvolutiondepthwise_x86.cpp" "src/CMakeFiles/ncnn.dir/layer/x86/deconvolutiondepthwise_x86.cpp.o" "gcc" "src/CMakeFiles/ncnn.dir/layer/x86/deconvolutiondepthwise_x86.cpp.o.d"
+  "/root/repo/_tp_build/src/layer/x86/deconvolutiondepthwise_x86_avx2.cpp" "src/CMakeFiles/ncnn.dir/layer/x86/deconvolutiondepthwise_x86_avx2.cpp.o" "gcc" "src/CMakeFiles/ncnn.dir/layer/x86/deconvolutiondepthwise_x86_avx2.cpp.o.d"
+  "/root/repo/src/layer/x86/dequantize_x86.cpp" "src/CMakeFiles/ncnn.dir/layer/x86/dequantize_x86.cpp.o" "gcc" "src/CMakeFiles/ncnn.dir/layer/x86/dequantize_x86.cpp.o.d"
+  "/root/repo/_tp_build/src/layer/x86/dequantize_x86_avx2.cpp" "src/CMakeFiles/ncnn.dir/layer/x86/dequantize_x86_avx2.cpp.o" "gcc" "src/CMakeFiles/ncnn.dir/layer/x86/dequantize_x86_avx2.cpp.o.d"
+  "/root/repo/src/layer/x86/dropout_x86.cpp" "src/CMakeFiles/ncnn.dir/layer/x86/dropout_x86.cpp.o" "gcc" "src/CMakeFiles/ncnn.dir/layer/x86/dropout_x86.cpp.o.d"
+  "/root/repo/_tp_build/src/layer/x86/dropout_x86_avx2.cpp" "src/CMakeFiles/ncnn.dir/layer/x86/dropout_x86_avx2.cpp.o" "gcc" "src/CMakeFiles/ncnn.dir/layer/x86/dropout_x86_avx2.cpp.o.d"
+  "/root/repo/src/layer/x86/eltwise_x86.cpp" "src/CMakeFiles/ncnn.dir/layer/x86/eltwise_x86.cpp.o" "gcc" "src/CMakeFiles/ncnn.dir/layer/x86/eltwise_x86.cpp.o.d"
+  "/root/repo/_tp_build/src/layer/x86/eltwise_x86_avx2.cpp" "src/CMakeFiles/ncnn.dir/layer/x86/eltwise_x86_avx2.cpp.o" "gcc" "src/CMakeFiles/ncnn.dir/layer/x86/eltwise_x86_avx2.cpp.o.d"
+  "/root/repo/src/layer/x86/flatten_x86.cpp" "src/CMakeFiles/ncnn.dir/layer/x86/flatten_x86.cpp.o" "gcc" "src/CMakeFiles/ncnn.dir/layer/x86/flatten_x86.cpp.o.d"
+  "/root/repo/_tp_build/src/layer/x86/flatten_x86_avx2.cpp" "src/CMakeFiles/ncnn.dir/layer/x86/flatten_x86_avx2.cpp.o" "gcc" "src/CMakeFiles/ncnn.dir/layer/x86/flatten_x86_avx2.cpp.o.d"
+  "/root/repo/src/layer/x86/gru_x86.cpp" "src/CMakeFiles/ncnn.dir/layer/x86/gru_x86.cpp.o" "gcc" "src/CMakeFiles/ncnn.dir/layer/x86/gru_x86.cpp.o.d"
+  "/root/repo/_tp_build/src/layer/x86/gru_x86_avx2.cpp" "src/CMakeFiles/ncnn.dir/layer/x86/gru_x86_avx2.cpp.o" "gcc" "src/CMakeFiles/ncnn.dir/layer/x86/gru_x86_avx2.cpp.o.d"
+  "/root/repo/src/layer/x86/hardsigmoid_x86.cpp" "src/CMakeFiles/ncnn.dir/layer/x86/hardsigmoid_x86.cpp.o" "gcc" "src/CMakeFiles/ncnn.dir/layer/x86/hardsigmoid_x86.cpp.o.d"
+  "/root/repo/_tp_build/src/layer/x86/hardsigmoid_x86_avx2.cpp" "src/CMakeFiles/ncnn.dir/layer/x86/hardsigmoid_x86_avx2.cpp.o" "gcc" "src/CMakeFiles/ncnn.dir/layer/x86/hardsigmoid_x86_avx2.cpp.o.d"
+  "/root/repo/src/layer/x86/hardswish_x86.cpp" "src/CMakeFiles/ncnn.dir/layer/x86/hardswish_x86.cpp.o" "gcc" "src/CMakeFiles/ncnn.dir/layer/x86/hardswish_x86.cpp.o.d"
+  "/root/repo/_tp_build/src/layer/x86/hardswish_x86_avx2.cpp" "src/CMakeFiles/ncnn.dir/layer/x86/hardswish_x86_avx2.cpp.o" "gcc" "src/CMakeFiles/ncnn.dir/layer/x86/hardswish_x86_avx2.cpp.o.d"
+  "/root/repo/src/layer/x86/innerproduct_x86.cpp" "src/CMakeFiles/ncnn.dir/layer/x86/innerproduct_x86.cpp.o" "gcc" "src/CMakeFiles/ncnn.dir/layer/x86/innerproduct_x86.cpp.o.d"
+  "/root/repo/_tp_build/src/layer/x86/innerproduct_x86_avx2.cpp" "src/CMakeFiles/ncnn.dir/layer/x86/innerproduct_x86_avx2.cpp.o" "gcc" "src/CMakeFiles/ncnn.dir/layer/x86/innerproduct_x86_avx2.cpp.o.d"
+  "/root/repo/_tp_build/src/layer/x86/innerproduct_x86_avx512.cpp" "src/CMakeFiles/ncnn.dir/layer/x86/innerproduct_x86_avx512.cpp.o" "gcc" "src/CMakeFiles/ncnn.dir/layer/x86/innerproduct_x86_avx512.cpp.o.d"
+  "/root/repo/src/layer/x86/instancenorm_x86.cpp" "src/CMakeFiles/ncnn.dir/layer/x86/instancenorm_x86.cpp.o" "gcc" "src/CMakeFiles/ncnn.dir/layer/x86/instancenorm_x86.cpp.o.d"
+  "/root/repo/_tp_build/src/layer/x86/instancenorm_x86_avx2.cpp" "src/CMakeFiles/ncnn.dir/layer/x86/instancenorm_x86_avx2.cpp.o" "gcc" "src/CMakeFiles/ncnn.dir/layer/x86/instancenorm_x86_avx2.cpp.o.d"
+  "/root/repo/src/layer/x86/interp_x86.cpp" "src/CMakeFiles/ncnn.dir/layer/x86/interp_x86.cpp.o" "gcc" "src/CMakeFiles/ncnn.dir/layer/x86/interp_x86.cpp.o.d"
+  "/root/repo/_tp_build/src/layer/x86/interp_x86_avx2.cpp" "src/CMakeFiles/ncnn.dir/layer/x86/interp_x86_avx2.cpp.o" "gcc" "src/CMakeFiles/ncnn.dir/layer/x86/interp_x86_avx2.cpp.o.d"
+  "/root/repo/src/layer/x86/lrn_x86.cpp" "src/CMakeFiles/ncnn.dir/layer/x86/lrn_x86.cpp.o" "gcc" "src/CMakeFiles/ncnn.dir/layer/x86/lrn_x86.cpp.o.d"
+  "/root/repo/_tp_build/src/layer/x86/lrn_x86_avx2.cpp" "src/CMakeFiles/ncnn.dir/layer/x86/lrn_x86_avx2.cpp.o" "gcc" "src/CMakeFiles/ncnn.dir/layer/x86/lrn_x86_avx2.cpp.o.d"
+  "/root/repo/src/layer/x86/lstm_x86.cpp" "src/CMakeFiles/ncnn.dir/layer/x86/lstm_x86.cpp.o" "gcc" "src/CMakeFiles/ncnn.dir/layer/x86/lstm_x86.cpp.o.d"
+  "/root/repo/_tp_build/src/layer/x86/lstm_x86_avx2.cpp" "src/CMakeFiles/ncnn.dir/layer/x86/lstm_x86_avx2.cpp.o" "gcc" "src/CMakeFiles/ncnn.dir/layer/x86/lstm_x86_avx2.cpp.o.d"
+  "/root/repo/src/layer/x86/mish_x86.cpp" "src/CMakeFiles/ncnn.dir/layer/x86/mish_x86.cpp.o" "gcc" "src/CMakeFiles/ncnn.dir/layer/x86/mish_x86.cpp.o.d"
+  "/root/repo/_tp_build/src/layer/x86/mish_x86_avx2.cpp" "src/CMakeFiles/ncnn.dir/layer/x86/mish_x86_avx2.cpp.o" "gcc" "src/CMakeFiles/ncnn.dir/layer/x86/mish_x86_avx2.cpp.o.d"
+  "/root/repo/src/layer/x86/normalize_x86.cpp" "src/CMakeFiles/ncnn.dir/layer/x86/normalize_x86.cpp.o" "gcc" "src/CMakeFiles/ncnn.dir/layer/x86/normalize_x86.cpp.o.d"
+  "/root/repo/_tp_build/src/layer/x86/normalize_x86_avx2.cpp" "src/CMakeFiles/ncnn.dir/layer/x86/normalize_x86_avx2.cpp.o" "gcc" "src/CMakeFiles/ncnn.dir/layer/x86/normalize_x86_avx2.cpp.o.d"
+  "/root/repo/src/layer/x86/packing_x86.cpp" "src/CMakeFiles/ncnn.dir/layer/x86/packing_x86.cpp.o" "gcc" "src/CMakeFiles/ncnn.dir/layer/x86/packing_x86.cpp.o.d"
+  "/root/repo/_tp_build/src/layer/x86/packing_x86_avx2.cpp" "src/CMakeFiles/ncnn.dir/layer/x86/packing_x86_avx2.cpp.o" "gcc" "src/CMakeFiles/ncnn.dir/layer/x86/packing_x86_avx2.cpp.o.d"
+  "/root/repo/src/layer/x86/padding_x86.cpp" "src/CMakeFiles/ncnn.dir/layer/x86/padding_x86.cpp.o" "gcc" "src/CMakeFiles/ncnn.dir/layer/x86/padding_x86.cpp.o.d"
+  "/root/repo/_tp_build/src/layer/x86/padding_x86_avx2.cpp" "src/CMakeFiles/ncnn.dir/layer/x86/padding_x86_avx2.cpp.o" "gcc" "src/CMakeFiles/ncnn.dir/layer/x86/padding_x86_avx2.cpp.o.d"
+  "/root/repo/src/layer/x86/permute_x86.cpp" "src/CMakeFiles/ncnn.dir/layer/x86/permute_x86.cpp.o" "gcc" "src/CMakeFiles/ncnn.dir/layer/x86/permute_x86.cpp.o.d"
+  "/root/repo/_tp_build/src/layer/x86/permute_x86_avx2.cpp" "src/CMakeFiles/ncnn.dir/layer/x86/permute_x86_avx2.cpp.o" "gcc" "src/CMakeFiles/ncnn.dir/layer/x86/permute_x86_avx2.cpp.o.d"
+  "/root/repo/src/layer/x86/pixelshuffle_x86.cpp" "src/CMakeFiles/ncnn.dir/layer/x86/pixelshuffle_x86.cpp.o" "gcc" "src/CMakeFiles/ncnn.dir/layer/x86/pixelshuffle_x86.cpp.o.d"
+  "/root/repo/_tp_build/src/layer/x86/pixelshuffle_x86_avx2.cpp" "src/CMakeFiles/ncnn.dir/layer/x86/pixelshuffle_x86_avx2.cpp.o" "gcc" "src/CMakeFiles/ncnn.dir/layer/x86/pixelshuffle_x86_avx2.cpp.o.d"
+  "/root/repo/src/layer/x86/pooling_x86.cpp" "src/CMakeFiles/ncnn.dir/layer/x86/pooling_x86.cpp.o" "gcc" "src/CMakeFiles/ncnn.dir/layer/x86/pooling_x86.cpp.o.d"
+  "/root/repo/_tp_build/src/layer/x86/pooling_x86_avx2.cpp" "src/CMakeFiles/ncnn.dir/layer/x86/pooling_x86_avx2.cpp.o" "gcc" "src/CMakeFiles/ncnn.dir/layer/x86/pooling_x86_avx2.cpp.o.d"
+  "/root/repo/src/layer/x86/prelu_x86.cpp" "src/CMakeFiles/ncnn.dir/layer/x86/prelu_x86.cpp.o" "gcc" "src/CMakeFiles/ncnn.dir/layer/x86/prelu_x86.cpp.o.d"
+  "/root/repo/_tp_build/src/layer/x86/prelu_x86_avx2.cpp" "src/CMakeFiles/ncnn.dir/layer/x86/prelu_x86_avx2.cpp.o" "gcc" "src/CMakeFiles/ncnn.dir/layer/x86/prelu_x86_avx2.cpp.o.d"
+  "/root/repo/src/layer/x86/quantize_x86.cpp" "src/CMakeFiles/ncnn.dir/layer/x86/quantize_x86.cpp.o" "gcc" "src/CMakeFiles/ncnn.dir/layer/x86/quantize_x86.cpp.o.d"
+  "/root/repo/_tp_build/src/layer/x86/quantize_x86_avx2.cpp" "src/CMakeFiles/ncnn.dir/layer/x86/quantize_x86_avx2.cpp.o" "gcc" "src/CMakeFiles/ncnn.dir/layer/x86/quantize_x86_avx2.cpp.o.d"
+  "/root/repo/src/layer/x86/relu_x86.cpp" "src/CMakeFiles/ncnn.dir/layer/x86/relu_x86.cpp.o" "gcc" "src/CMakeFiles/ncnn.dir/layer/x86/relu_x86.cpp.o.d"
+  "/root/repo/_tp_build/src/layer/x86/relu_x86_avx2.cpp" "src/CMakeFiles/ncnn.dir/layer/x86/relu_x86_avx2.cpp.o" "gcc" "src/CMakeFiles/ncnn.dir/layer/x86/relu_x86_avx2.cpp.o.d"
+  "/root/repo/src/layer/x86/requantize_x86.cpp" "src/CMakeFiles/ncnn.dir/layer/x86/requantize_x86.cpp.o" "gcc" "src/CMakeFiles/ncnn.dir/layer/x86/requantize_x86.cpp.o.d"
+  "/root/repo/_tp_build/src/layer/x86/requantize_x86_avx2.cpp" "src/CMakeFiles/ncnn.dir/layer/x86/requantize_x86_avx2.cpp.o" "gcc" "src/CMakeFiles/ncnn.dir/layer/x86/requantize_x86_avx2.cpp.o.d"
+  "/root/repo/src/layer/x86/reshape_x86.cpp" "src/CMakeFiles/ncnn.dir/layer/x86/reshape_x86.cpp.o" "gcc" "src/CMakeFiles/ncnn.dir/layer/x86/reshape_x86.cpp.o.d"
+  "/root/repo/_tp_build/src/layer/x86/reshape_x86_avx2.cpp" "src/CMakeFiles/ncnn.dir/layer/x86/reshape_x86_avx2.cpp.o" "gcc" "src/CMakeFiles/ncnn.dir/layer/x86/reshape_x86_avx2.cpp.o.d"
+  "/root/repo/src/layer/x86/roialign_x86.cpp" "src/CMakeFiles/ncnn.dir/layer/x86/roialign_x86.cpp.o" "gcc" "src/CMakeFiles/ncnn.dir/layer/x86/roialign_x86.cpp.o.d"
+  "/root/repo/_tp_build/src/layer/x86/roialign_x86_avx2.cpp" "src/CMakeFiles/ncnn.dir/layer/x86/roialign_x86_avx2.cpp.o" "gcc" "src/CMakeFiles/ncnn.dir/layer/x86/roialign_x86_avx2.cpp.o.d"
+  "/root/repo/src/layer/x86/scale_x86.cpp" "src/CMakeFiles/ncnn.dir/layer/x86/scale_x86.cpp.o" "gcc" "src/CMakeFiles/ncnn.dir/layer/x86/scale_x86.cpp.o.d"
+  "/root/repo/_tp_build/src/layer/x86/scale_x86_avx2.cpp" "src/CMakeFiles/ncnn.dir/layer/x86/scale_x86_avx2.cpp.o" "gcc" "src/CMakeFiles/ncnn.dir/layer/x86/scale_x86_avx2.cpp.o.d"
+  "/root/repo/src/layer/x86/sigmoid_x86.cpp" "src/CMakeFiles/ncnn.dir/layer/x86/sigmoid_x86.cpp.o" "gcc" "src/CMakeFiles/ncnn.dir/layer/x86/sigmoid_x86.cpp.o.d"
+  "/root/repo/_tp_build/src/layer/x86/sigmoid_x86_avx2.cpp" "src/CMakeFiles/ncnn.dir/layer/x86/sigmoid_x86_avx2.cpp.o" "gcc" "src/CMakeFiles/ncnn.dir/layer/x86/sigmoid_x86_avx2.cpp.o.d"
+  "/root/repo/src/layer/x86/slice_x86.cpp" "src/CMakeFiles/ncnn.dir/layer/x86/slice_x86.cpp.o" "gcc" "src/CMakeFiles/ncnn.dir/layer/x86/slice_x86.cpp.o.d"
+  "/root/repo/_tp_build/src/layer/x86/slice_x86_avx2.cpp" "src/CMakeFiles/ncnn.dir/layer/x86/slice_x86_avx2.cpp.o" "gcc" "src/CMakeFiles/ncnn.dir/layer/x86/slice_x86_avx2.cpp.o.d"
+  "/root/repo/src/layer/x86/softmax_x86.cpp" "src/CMakeFiles/ncnn.dir/layer/x86/softmax_x86.cpp.o" "gcc" "src/CMakeFiles/ncnn.dir/layer/x86/softmax_x86.cpp.o.d"
+  "/root/repo/_tp_build/src/layer/x86/softmax_x86_avx2.cpp" "src/CMakeFiles/ncnn.dir/layer/x86/softmax_x86_avx2.cpp.o" "gcc" "src/CMakeFiles/ncnn.dir/layer/x86/softmax_x86_avx2.cpp.o.d"
+  "/root/repo/src/layer/x86/swish_x86.cpp" "src/CMakeFiles/ncnn.dir/layer/x86/swish_x86.cpp.o" "gcc" "src/CMakeFiles/ncnn.dir/layer/x86/swish_x86.cpp.o.d"
+  "/root/repo/_tp_build/src/layer/x86/swish_x86_avx2.cpp" "src/CMakeFiles/ncnn.dir/layer/x86/swish_x86_avx2.cpp.o" "gcc" "src/CMakeFiles/ncnn.dir/layer/x86/swish_x86_avx2.cpp.o.d"
+  "/root/repo/src/layer/x86/tanh_x86.cpp" "src/CMakeFiles/ncnn.dir/layer/x86/tanh_x86.cpp.o" "gcc" "src/CMakeFiles/ncnn.dir/layer/x86/tanh_x86.cpp.o.d"
+  "/root/repo/_tp_build/src/layer/x86/tanh_x86_avx2.cpp" "src/CMakeFiles/ncnn.dir/layer/x86/tanh_x86_avx2.cpp.o" "gcc" "src/CMakeFiles/ncnn.dir/layer/x86/tanh_x86_avx2.cpp.o.d"
+  "/root/repo/src/layer/x86/unaryop_x86.cpp" "src/CMakeFiles/ncnn.dir/layer/x86/unaryop_x86.cpp.o" "gcc" "src/CMakeFiles/ncnn.dir/layer/x86/unaryop_x86.cpp.o.d"
+  "/root/repo/_tp_build/src/layer/x86/unaryop_x86_avx2.cpp" "src/CMakeFiles/ncnn.dir/layer/x86/unaryop_x86_avx2.cpp.o" "gcc" "src/CMakeFiles/ncnn.dir/layer/x86/unaryop_x86_avx2.cpp.o.d"
+  "/root/repo/src/layer/yolodetectionoutput.cpp" "src/CMakeFiles/ncnn.dir/layer/yolodetectionoutput.cpp.o" "gcc" "src/CMakeFiles/ncnn.dir/layer/yolodetectionoutput.cpp.o.d"
+  "/root/repo/src/layer/yolov3detectionoutput.cpp" "src/CMakeFiles/ncnn.dir/layer/yolov3detectionoutput.cpp.o" "gcc" "src/CMakeFiles/ncnn.dir/layer/yolov3detectionoutput.cpp.o.d"
+  "/root/repo/src/mat.cpp" "src/CMakeFiles/ncnn.dir/mat.cpp.o" "gcc" "src/CMakeFiles/ncnn.dir/mat.cpp.o.d"
+  "/root/repo/src/mat_pixel.cpp" "src/CMakeFiles/ncnn.dir/mat_pixel.cpp.o" "gcc" "src/CMakeFiles/ncnn.dir/mat_pixel.cpp.o.d"
+  "/root/repo/src/mat_pixel_resize.cpp" "src/CMakeFiles/ncnn.dir/mat_pixel_resize.cpp.o" "gcc" "src/CMakeFiles/ncnn.dir/mat_pixel_resize.cpp.o.d"
+  "/root/repo/src/mat_pixel_rotate.cpp" "src/CMakeFiles/ncnn.dir/mat_pixel_rotate.cpp.o" "gcc" "src/CMakeFiles/ncnn.dir/mat_pixel_rotate.cpp.o.d"
+  "/root/repo/src/modelbin.cpp" "src/CMakeFiles/ncnn.dir/modelbin.cpp.o" "gcc" "src/CMakeFiles/ncnn.dir/modelbin.cpp.o.d"
+  "/root/repo/src/net.cpp" "src/CMakeFiles/ncnn.dir/net.cpp.o" "gcc" "src/CMakeFiles/ncnn.dir/net.cpp.o.d"
+  "/root/repo/src/opencv.cpp" "src/CMakeFiles/ncnn.dir/opencv.cpp.o" "gcc" "src/CMakeFiles/ncnn.dir/opencv.cpp.o.d"
+  "/root/repo/src/option.cpp" "src/CMakeFiles/ncnn.dir/option.cpp.o" "gcc" "src/CMakeFiles/ncnn.dir/option.cpp.o.d"
+  "/root/repo/src/paramdict.cpp" "src/CMakeFiles/ncnn.dir/paramdict.cpp.o" "gcc" "src/CMakeFiles/ncnn.dir/paramdict.cpp.o.d"
+  "/root/repo/src/pipeline.cpp" "src/CMakeFiles/ncnn.dir/pipeline.cpp.o" "gcc" "src/CMakeFiles/ncnn.dir/pipeline.cpp.o.d"
+  "/root/repo/src/profiler.cpp" "src/CMakeFiles/ncnn.dir/profiler.cpp.o" "gcc" "src/CMakeFiles/ncnn.dir/profiler.cpp.o.d"
+  "/root/repo/src/threadpool.cpp" "src/CMakeFiles/ncnn.dir/threadpool.cpp.o" "gcc" "src/CMakeFiles/ncnn.dir/threadpool.cpp.o.d"
+  )
+
+# Targets to which this target links.
+set(CMAKE_TARGET_LINKED_INFO_FILES
+  )
+
+# Fortran module output directory.
+set(CMAKE_Fortran_TARGET_MODULE_DIR "")
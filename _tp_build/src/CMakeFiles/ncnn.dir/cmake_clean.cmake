@@ -0,0 +1,459 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/ncnn.dir/allocator.cpp.o"
+  "CMakeFiles/ncnn.dir/allocator.cpp.o.d"
+  "CMakeFiles/ncnn.dir/benchmark.cpp.o"
+  "CMakeFiles/ncnn.dir/benchmark.cpp.o.d"
+  "CMakeFiles/ncnn.dir/blob.cpp.o"
+  "CMakeFiles/ncnn.dir/blob.cpp.o.d"
+  "CMakeFiles/ncnn.dir/c_api.cpp.o"
+  "CMakeFiles/ncnn.dir/c_api.cpp.o.d"
+  "CMakeFiles/ncnn.dir/command.cpp.o"
+  "CMakeFiles/ncnn.dir/command.cpp.o.d"
+  "CMakeFiles/ncnn.dir/cpu.cpp.o"
+  "CMakeFiles/ncnn.dir/cpu.cpp.o.d"
+  "CMakeFiles/ncnn.dir/datareader.cpp.o"
+  "CMakeFiles/ncnn.dir/datareader.cpp.o.d"
+  "CMakeFiles/ncnn.dir/gpu.cpp.o"
+  "CMakeFiles/ncnn.dir/gpu.cpp.o.d"
+  "CMakeFiles/ncnn.dir/layer.cpp.o"
+  "CMakeFiles/ncnn.dir/layer.cpp.o.d"
+  "CMakeFiles/ncnn.dir/layer/absval.cpp.o"
+  "CMakeFiles/ncnn.dir/layer/absval.cpp.o.d"
+  "CMakeFiles/ncnn.dir/layer/batchnorm.cpp.o"
+  "CMakeFiles/ncnn.dir/layer/batchnorm.cpp.o.d"
+  "CMakeFiles/ncnn.dir/layer/bias.cpp.o"
+  "CMakeFiles/ncnn.dir/layer/bias.cpp.o.d"
+  "CMakeFiles/ncnn.dir/layer/binaryop.cpp.o"
+  "CMakeFiles/ncnn.dir/layer/binaryop.cpp.o.d"
+  "CMakeFiles/ncnn.dir/layer/bnll.cpp.o"
+  "CMakeFiles/ncnn.dir/layer/bnll.cpp.o.d"
+  "CMakeFiles/ncnn.dir/layer/cast.cpp.o"
+  "CMakeFiles/ncnn.dir/layer/cast.cpp.o.d"
+  "CMakeFiles/ncnn.dir/layer/clip.cpp.o"
+  "CMakeFiles/ncnn.dir/layer/clip.cpp.o.d"
+  "CMakeFiles/ncnn.dir/layer/concat.cpp.o"
+  "CMakeFiles/ncnn.dir/layer/concat.cpp.o.d"
+  "CMakeFiles/ncnn.dir/layer/convolution.cpp.o"
+  "CMakeFiles/ncnn.dir/layer/convolution.cpp.o.d"
+  "CMakeFiles/ncnn.dir/layer/convolutiondepthwise.cpp.o"
+  "CMakeFiles/ncnn.dir/layer/convolutiondepthwise.cpp.o.d"
+  "CMakeFiles/ncnn.dir/layer/crop.cpp.o"
+  "CMakeFiles/ncnn.dir/layer/crop.cpp.o.d"
+  "CMakeFiles/ncnn.dir/layer/deconvolution.cpp.o"
+  "CMakeFiles/ncnn.dir/layer/deconvolution.cpp.o.d"
+  "CMakeFiles/ncnn.dir/layer/deconvolutiondepthwise.cpp.o"
+  "CMakeFiles/ncnn.dir/layer/deconvolutiondepthwise.cpp.o.d"
+  "CMakeFiles/ncnn.dir/layer/deepcopy.cpp.o"
+  "CMakeFiles/ncnn.dir/layer/deepcopy.cpp.o.d"
+  "CMakeFiles/ncnn.dir/layer/dequantize.cpp.o"
+  "CMakeFiles/ncnn.dir/layer/dequantize.cpp.o.d"
+  "CMakeFiles/ncnn.dir/layer/detectionoutput.cpp.o"
+  "CMakeFiles/ncnn.dir/layer/detectionoutput.cpp.o.d"
+  "CMakeFiles/ncnn.dir/layer/dropout.cpp.o"
+  "CMakeFiles/ncnn.dir/layer/dropout.cpp.o.d"
+  "CMakeFiles/ncnn.dir/layer/eltwise.cpp.o"
+  "CMakeFiles/ncnn.dir/layer/eltwise.cpp.o.d"
+  "CMakeFiles/ncnn.dir/layer/elu.cpp.o"
+  "CMakeFiles/ncnn.dir/layer/elu.cpp.o.d"
+  "CMakeFiles/ncnn.dir/layer/embed.cpp.o"
+  "CMakeFiles/ncnn.dir/layer/embed.cpp.o.d"
+  "CMakeFiles/ncnn.dir/layer/exp.cpp.o"
+  "CMakeFiles/ncnn.dir/layer/exp.cpp.o.d"
+  "CMakeFiles/ncnn.dir/layer/expanddims.cpp.o"
+  "CMakeFiles/ncnn.dir/layer/expanddims.cpp.o.d"
+  "CMakeFiles/ncnn.dir/layer/flatten.cpp.o"
+  "CMakeFiles/ncnn.dir/layer/flatten.cpp.o.d"
+  "CMakeFiles/ncnn.dir/layer/gru.cpp.o"
+  "CMakeFiles/ncnn.dir/layer/gru.cpp.o.d"
+  "CMakeFiles/ncnn.dir/layer/hardsigmoid.cpp.o"
+  "CMakeFiles/ncnn.dir/layer/hardsigmoid.cpp.o.d"
+  "CMakeFiles/ncnn.dir/layer/hardswish.cpp.o"
+  "CMakeFiles/ncnn.dir/layer/hardswish.cpp.o.d"
+  "CMakeFiles/ncnn.dir/layer/innerproduct.cpp.o"
+  "CMakeFiles/ncnn.dir/layer/innerproduct.cpp.o.d"
+  "CMakeFiles/ncnn.dir/layer/input.cpp.o"
+  "CMakeFiles/ncnn.dir/layer/input.cpp.o.d"
+  "CMakeFiles/ncnn.dir/layer/instancenorm.cpp.o"
+  "CMakeFiles/ncnn.dir/layer/instancenorm.cpp.o.d"
+  "CMakeFiles/ncnn.dir/layer/interp.cpp.o"
+  "CMakeFiles/ncnn.dir/layer/interp.cpp.o.d"
+  "CMakeFiles/ncnn.dir/layer/log.cpp.o"
+  "CMakeFiles/ncnn.dir/layer/log.cpp.o.d"
+  "CMakeFiles/ncnn.dir/layer/lrn.cpp.o"
+  "CMakeFiles/ncnn.dir/layer/lrn.cpp.o.d"
+  "CMakeFiles/ncnn.dir/layer/lstm.cpp.o"
+  "CMakeFiles/ncnn.dir/layer/lstm.cpp.o.d"
+  "CMakeFiles/ncnn.dir/layer/memorydata.cpp.o"
+  "CMakeFiles/ncnn.dir/layer/memorydata.cpp.o.d"
+  "CMakeFiles/ncnn.dir/layer/mish.cpp.o"
+  "CMakeFiles/ncnn.dir/layer/mish.cpp.o.d"
+  "CMakeFiles/ncnn.dir/layer/mvn.cpp.o"
+  "CMakeFiles/ncnn.dir/layer/mvn.cpp.o.d"
+  "CMakeFiles/ncnn.dir/layer/noop.cpp.o"
+  "CMakeFiles/ncnn.dir/layer/noop.cpp.o.d"
+  "CMakeFiles/ncnn.dir/layer/normalize.cpp.o"
+  "CMakeFiles/ncnn.dir/layer/normalize.cpp.o.d"
+  "CMakeFiles/ncnn.dir/layer/packing.cpp.o"
+  "CMakeFiles/ncnn.dir/layer/packing.cpp.o.d"
+  "CMakeFiles/ncnn.dir/layer/padding.cpp.o"
+  "CMakeFiles/ncnn.dir/layer/padding.cpp.o.d"
+  "CMakeFiles/ncnn.dir/layer/permute.cpp.o"
+  "CMakeFiles/ncnn.dir/layer/permute.cpp.o.d"
+  "CMakeFiles/ncnn.dir/layer/pixelshuffle.cpp.o"
+  "CMakeFiles/ncnn.dir/layer/pixelshuffle.cpp.o.d"
+  "CMakeFiles/ncnn.dir/layer/pooling.cpp.o"
+  "CMakeFiles/ncnn.dir/layer/pooling.cpp.o.d"
+  "CMakeFiles/ncnn.dir/layer/power.cpp.o"
+  "CMakeFiles/ncnn.dir/layer/power.cpp.o.d"
+  "CMakeFiles/ncnn.dir/layer/prelu.cpp.o"
+  "CMakeFiles/ncnn.dir/layer/prelu.cpp.o.d"
+  "CMakeFiles/ncnn.dir/layer/priorbox.cpp.o"
+  "CMakeFiles/ncnn.dir/layer/priorbox.cpp.o.d"
+  "CMakeFiles/ncnn.dir/layer/proposal.cpp.o"
+  "CMakeFiles/ncnn.dir/layer/proposal.cpp.o.d"
+  "CMakeFiles/ncnn.dir/layer/psroipooling.cpp.o"
+  "CMakeFiles/ncnn.dir/layer/psroipooling.cpp.o.d"
+  "CMakeFiles/ncnn.dir/layer/quantize.cpp.o"
+  "CMakeFiles/ncnn.dir/layer/quantize.cpp.o.d"
+  "CMakeFiles/ncnn.dir/layer/reduction.cpp.o"
+  "CMakeFiles/ncnn.dir/layer/reduction.cpp.o.d"
+  "CMakeFiles/ncnn.dir/layer/relu.cpp.o"
+  "CMakeFiles/ncnn.dir/layer/relu.cpp.o.d"
+  "CMakeFiles/ncnn.dir/layer/reorg.cpp.o"
+  "CMakeFiles/ncnn.dir/layer/reorg.cpp.o.d"
+  "CMakeFiles/ncnn.dir/layer/requantize.cpp.o"
+  "CMakeFiles/ncnn.dir/layer/requantize.cpp.o.d"
+  "CMakeFiles/ncnn.dir/layer/reshape.cpp.o"
+  "CMakeFiles/ncnn.dir/layer/reshape.cpp.o.d"
+  "CMakeFiles/ncnn.dir/layer/roialign.cpp.o"
+  "CMakeFiles/ncnn.dir/layer/roialign.cpp.o.d"
+  "CMakeFiles/ncnn.dir/layer/roipooling.cpp.o"
+  "CMakeFiles/ncnn.dir/layer/roipooling.cpp.o.d"
+  "CMakeFiles/ncnn.dir/layer/scale.cpp.o"
+  "CMakeFiles/ncnn.dir/layer/scale.cpp.o.d"
+  "CMakeFiles/ncnn.dir/layer/selu.cpp.o"
+  "CMakeFiles/ncnn.dir/layer/selu.cpp.o.d"
+  "CMakeFiles/ncnn.dir/layer/shufflechannel.cpp.o"
+  "CMakeFiles/ncnn.dir/layer/shufflechannel.cpp.o.d"
+  "CMakeFiles/ncnn.dir/layer/sigmoid.cpp.o"
+  "CMakeFiles/ncnn.dir/layer/sigmoid.cpp.o.d"
+  "CMakeFiles/ncnn.dir/layer/slice.cpp.o"
+  "CMakeFiles/ncnn.dir/layer/slice.cpp.o.d"
+  "CMakeFiles/ncnn.dir/layer/softmax.cpp.o"
+  "CMakeFiles/ncnn.dir/layer/softmax.cpp.o.d"
+  "CMakeFiles/ncnn.dir/layer/split.cpp.o"
+  "CMakeFiles/ncnn.dir/layer/split.cpp.o.d"
+  "CMakeFiles/ncnn.dir/layer/squeeze.cpp.o"
+  "CMakeFiles/ncnn.dir/layer/squeeze.cpp.o.d"
+  "CMakeFiles/ncnn.dir/layer/statisticspooling.cpp.o"
+  "CMakeFiles/ncnn.dir/layer/statisticspooling.cpp.o.d"
+  "CMakeFiles/ncnn.dir/layer/swish.cpp.o"
+  "CMakeFiles/ncnn.dir/layer/swish.cpp.o.d"
+  "CMakeFiles/ncnn.dir/layer/tanh.cpp.o"
+  "CMakeFiles/ncnn.dir/layer/tanh.cpp.o.d"
+  "CMakeFiles/ncnn.dir/layer/threshold.cpp.o"
+  "CMakeFiles/ncnn.dir/layer/threshold.cpp.o.d"
+  "CMakeFiles/ncnn.dir/layer/unaryop.cpp.o"
+  "CMakeFiles/ncnn.dir/layer/unaryop.cpp.o.d"
+  "CMakeFiles/ncnn.dir/layer/x86/batchnorm_x86.cpp.o"
+  "CMakeFiles/ncnn.dir/layer/x86/batchnorm_x86.cpp.o.d"
+  "CMakeFiles/ncnn.dir/layer/x86/batchnorm_x86_avx2.cpp.o"
+  "CMakeFiles/ncnn.dir/layer/x86/batchnorm_x86_avx2.cpp.o.d"
+  "CMakeFiles/ncnn.dir/layer/x86/bias_x86.cpp.o"
+  "CMakeFiles/ncnn.dir/layer/x86/bias_x86.cpp.o.d"
+  "CMakeFiles/ncnn.dir/layer/x86/bias_x86_avx2.cpp.o"
+  "CMakeFiles/ncnn.dir/layer/x86/bias_x86_avx2.cpp.o.d"
+  "CMakeFiles/ncnn.dir/layer/x86/binaryop_x86.cpp.o"
+  "CMakeFiles/ncnn.dir/layer/x86/binaryop_x86.cpp.o.d"
+  "CMakeFiles/ncnn.dir/layer/x86/binaryop_x86_avx2.cpp.o"
+  "CMakeFiles/ncnn.dir/layer/x86/binaryop_x86_avx2.cpp.o.d"
+  "CMakeFiles/ncnn.dir/layer/x86/cast_x86.cpp.o"
+  "CMakeFiles/ncnn.dir/layer/x86/cast_x86.cpp.o.d"
+  "CMakeFiles/ncnn.dir/layer/x86/cast_x86_avx2.cpp.o"
+  "CMakeFiles/ncnn.dir/layer/x86/cast_x86_avx2.cpp.o.d"
+  "CMakeFiles/ncnn.dir/layer/x86/clip_x86.cpp.o"
+  "CMakeFiles/ncnn.dir/layer/x86/clip_x86.cpp.o.d"
+  "CMakeFiles/ncnn.dir/layer/x86/clip_x86_avx2.cpp.o"
+  "CMakeFiles/ncnn.dir/layer/x86/clip_x86_avx2.cpp.o.d"
+  "CMakeFiles/ncnn.dir/layer/x86/concat_x86.cpp.o"
+  "CMakeFiles/ncnn.dir/layer/x86/concat_x86.cpp.o.d"
+  "CMakeFiles/ncnn.dir/layer/x86/concat_x86_avx2.cpp.o"
+  "CMakeFiles/ncnn.dir/layer/x86/concat_x86_avx2.cpp.o.d"
+  "CMakeFiles/ncnn.dir/layer/x86/convolution_x86.cpp.o"
+  "CMakeFiles/ncnn.dir/layer/x86/convolution_x86.cpp.o.d"
+  "CMakeFiles/ncnn.dir/layer/x86/convolution_x86_avx2.cpp.o"
+  "CMakeFiles/ncnn.dir/layer/x86/convolution_x86_avx2.cpp.o.d"
+  "CMakeFiles/ncnn.dir/layer/x86/convolution_x86_avx512.cpp.o"
+  "CMakeFiles/ncnn.dir/layer/x86/convolution_x86_avx512.cpp.o.d"
+  "CMakeFiles/ncnn.dir/layer/x86/convolutiondepthwise_x86.cpp.o"
+  "CMakeFiles/ncnn.dir/layer/x86/convolutiondepthwise_x86.cpp.o.d"
+  "CMakeFiles/ncnn.dir/layer/x86/convolutiondepthwise_x86_avx2.cpp.o"
+  "CMakeFiles/ncnn.dir/layer/x86/convolutiondepthwise_x86_avx2.cpp.o.d"
+  "CMakeFiles/ncnn.dir/layer/x86/crop_x86.cpp.o"
+  "CMakeFiles/ncnn.dir/layer/x86/crop_x86.cpp.o.d"
+  "CMakeFiles/ncnn.dir/layer/x86/crop_x86_avx2.cpp.o"
+  "CMakeFiles/ncnn.dir/layer/x86/crop_x86_avx2.cpp.o.d"
+  "CMakeFiles/ncnn.dir/layer/x86/deconvolution_x86.cpp.o"
+  "CMakeFiles/ncnn.dir/layer/x86/deconvolution_x86.cpp.o.d"
+  "CMakeFiles/ncnn.dir/layer/x86/deconvolution_x86_avx2.cpp.o"
+  "CMakeFiles/ncnn.dir/layer/x86/deconvolution_x86_avx2.cpp.o.d"
+  "CMakeFiles/ncnn.dir/layer/x86/deconvolutiondepthwise_x86.cpp.o"
+  "CMakeFiles/ncnn.dir/layer/x86/deconvolutiondepthwise_x86.cpp.o.d"
+  "CMakeFiles/ncnn.dir/layer/x86/deconvolutiondepthwise_x86_avx2.cpp.o"
+  "CMakeFiles/ncnn.dir/layer/x86/deconvolutiondepthwise_x86_avx2.cpp.o.d"
+  "CMakeFiles/ncnn.dir/layer/x86/dequantize_x86.cpp.o"
+  "CMakeFiles/ncnn.dir/layer/x86/dequantize_x86.cpp.o.d"
+  "CMakeFiles/ncnn.dir/layer/x86/dequantize_x86_avx2.cpp.o"
+  "CMakeFiles/ncnn.dir/layer/x86/dequantize_x86_avx2.cpp.o.d"
+  "CMakeFiles/ncnn.dir/layer/x86/dropout_x86.cpp.o"
+  "CMakeFiles/ncnn.dir/layer/x86/dropout_x86.cpp.o.d"
+  "CMakeFiles/ncnn.dir/layer/x86/dropout_x86_avx2.cpp.o"
+  "CMakeFiles/ncnn.dir/layer/x86/dropout_x86_avx2.cpp.o.d"
+  "CMakeFiles/ncnn.dir/layer/x86/eltwise_x86.cpp.o"
+  "CMakeFiles/ncnn.dir/layer/x86/eltwise_x86.cpp.o.d"
+  "CMakeFiles/ncnn.dir/layer/x86/eltwise_x86_avx2.cpp.o"
+  "CMakeFiles/ncnn.dir/layer/x86/eltwise_x86_avx2.cpp.o.d"
+  "CMakeFiles/ncnn.dir/layer/x86/flatten_x86.cpp.o"
+  "CMakeFiles/ncnn.dir/layer/x86/flatten_x86.cpp.o.d"
+  "CMakeFiles/ncnn.dir/layer/x86/flatten_x86_avx2.cpp.o"
+  "CMakeFiles/ncnn.dir/layer/x86/flatten_x86_avx2.cpp.o.d"
+  "CMakeFiles/ncnn.dir/layer/x86/gru_x86.cpp.o"
+  "CMakeFiles/ncnn.dir/layer/x86/gru_x86.cpp.o.d"
+  "CMakeFiles/ncnn.dir/layer/x86/gru_x86_avx2.cpp.o"
+  "CMakeFiles/ncnn.dir/layer/x86/gru_x86_avx2.cpp.o.d"
+  "CMakeFiles/ncnn.dir/layer/x86/hardsigmoid_x86.cpp.o"
+  "CMakeFiles/ncnn.dir/layer/x86/hardsigmoid_x86.cpp.o.d"
+  "CMakeFiles/ncnn.dir/layer/x86/hardsigmoid_x86_avx2.cpp.o"
+  "CMakeFiles/ncnn.dir/layer/x86/hardsigmoid_x86_avx2.cpp.o.d"
+  "CMakeFiles/ncnn.dir/layer/x86/hardswish_x86.cpp.o"
+  "CMakeFiles/ncnn.dir/layer/x86/hardswish_x86.cpp.o.d"
+  "CMakeFiles/ncnn.dir/layer/x86/hardswish_x86_avx2.cpp.o"
+  "CMakeFiles/ncnn.dir/layer/x86/hardswish_x86_avx2.cpp.o.d"
+  "CMakeFiles/ncnn.dir/layer/x86/innerproduct_x86.cpp.o"
+  "CMakeFiles/ncnn.dir/layer/x86/innerproduct_x86.cpp.o.d"
+  "CMakeFiles/ncnn.dir/layer/x86/innerproduct_x86_avx2.cpp.o"
+  "CMakeFiles/ncnn.dir/layer/x86/innerproduct_x86_avx2.cpp.o.d"
+  "CMakeFiles/ncnn.dir/layer/x86/innerproduct_x86_avx512.cpp.o"
+  "CMakeFiles/ncnn.dir/layer/x86/innerproduct_x86_avx512.cpp.o.d"
+  "CMakeFiles/ncnn.dir/layer/x86/instancenorm_x86.cpp.o"
+  "CMakeFiles/ncnn.dir/layer/x86/instancenorm_x86.cpp.o.d"
+  "CMakeFiles/ncnn.dir/layer/x86/instancenorm_x86_avx2.cpp.o"
+  "CMakeFiles/ncnn.dir/layer/x86/instancenorm_x86_avx2.cpp.o.d"
+  "CMakeFiles/ncnn.dir/layer/x86/interp_x86.cpp.o"
+  "CMakeFiles/ncnn.dir/layer/x86/interp_x86.cpp.o.d"
+  "CMakeFiles/ncnn.dir/layer/x86/interp_x86_avx2.cpp.o"
+  "CMakeFiles/ncnn.dir/layer/x86/interp_x86_avx2.cpp.o.d"
+  "CMakeFiles/ncnn.dir/layer/x86/lrn_x86.cpp.o"
+  "CMakeFiles/ncnn.dir/layer/x86/lrn_x86.cpp.o.d"
+  "CMakeFiles/ncnn.dir/layer/x86/lrn_x86_avx2.cpp.o"
+  "CMakeFiles/ncnn.dir/layer/x86/lrn_x86_avx2.cpp.o.d"
+  "CMakeFiles/ncnn.dir/layer/x86/lstm_x86.cpp.o"
+  "CMakeFiles/ncnn.dir/layer/x86/lstm_x86.cpp.o.d"
+  "CMakeFiles/ncnn.dir/layer/x86/lstm_x86_avx2.cpp.o"
+  "CMakeFiles/ncnn.dir/layer/x86/lstm_x86_avx2.cpp.o.d"
+  "CMakeFiles/ncnn.dir/layer/x86/mish_x86.cpp.o"
+  "CMakeFiles/ncnn.dir/layer/x86/mish_x86.cpp.o.d"
+  "CMakeFiles/ncnn.dir/layer/x86/mish_x86_avx2.cpp.o"
+  "CMakeFiles/ncnn.dir/layer/x86/mish_x86_avx2.cpp.o.d"
+  "CMakeFiles/ncnn.dir/layer/x86/normalize_x86.cpp.o"
+  "CMakeFiles/ncnn.dir/layer/x86/normalize_x86.cpp.o.d"
+  "CMakeFiles/ncnn.dir/layer/x86/normalize_x86_avx2.cpp.o"
+  "CMakeFiles/ncnn.dir/layer/x86/normalize_x86_avx2.cpp.o.d"
+  "CMakeFiles/ncnn.dir/layer/x86/packing_x86.cpp.o"
+  "CMakeFiles/ncnn.dir/layer/x86/packing_x86.cpp.o.d"
+  "CMakeFiles/ncnn.dir/layer/x86/packing_x86_avx2.cpp.o"
+  "CMakeFiles/ncnn.dir/layer/x86/packing_x86_avx2.cpp.o.d"
+  "CMakeFiles/ncnn.dir/layer/x86/padding_x86.cpp.o"
+  "CMakeFiles/ncnn.dir/layer/x86/padding_x86.cpp.o.d"
+  "CMakeFiles/ncnn.dir/layer/x86/padding_x86_avx2.cpp.o"
+  "CMakeFiles/ncnn.dir/layer/x86/padding_x86_avx2.cpp.o.d"
+  "CMakeFiles/ncnn.dir/layer/x86/permute_x86.cpp.o"
+  "CMakeFiles/ncnn.dir/layer/x86/permute_x86.cpp.o.d"
+  "CMakeFiles/ncnn.dir/layer/x86/permute_x86_avx2.cpp.o"
+  "CMakeFiles/ncnn.dir/layer/x86/permute_x86_avx2.cpp.o.d"
+  "CMakeFiles/ncnn.dir/layer/x86/pixelshuffle_x86.cpp.o"
+  "CMakeFiles/ncnn.dir/layer/x86/pixelshuffle_x86.cpp.o.d"
+  "CMakeFiles/ncnn.dir/layer/x86/pixelshuffle_x86_avx2.cpp.o"
+  "CMakeFiles/ncnn.dir/layer/x86/pixelshuffle_x86_avx2.cpp.o.d"
+  "CMakeFiles/ncnn.dir/layer/x86/pooling_x86.cpp.o"
+  "CMakeFiles/ncnn.dir/layer/x86/pooling_x86.cpp.o.d"
+  "CMakeFiles/ncnn.dir/layer/x86/pooling_x86_avx2.cpp.o"
+  "CMakeFiles/ncnn.dir/layer/x86/pooling_x86_avx2.cpp.o.d"
+  "CMakeFiles/ncnn.dir/layer/x86/prelu_x86.cpp.o"
+  "CMakeFiles/ncnn.dir/layer/x86/prelu_x86.cpp.o.d"
+  "CMakeFiles/ncnn.dir/layer/x86/prelu_x86_avx2.cpp.o"
+  "CMakeFiles/ncnn.dir/layer/x86/prelu_x86_avx2.cpp.o.d"
+  "CMakeFiles/ncnn.dir/layer/x86/quantize_x86.cpp.o"
+  "CMakeFiles/ncnn.dir/layer/x86/quantize_x86.cpp.o.d"
+  "CMakeFiles/ncnn.dir/layer/x86/quantize_x86_avx2.cpp.o"
+  "CMakeFiles/ncnn.dir/layer/x86/quantize_x86_avx2.cpp.o.d"
+  "CMakeFiles/ncnn.dir/layer/x86/relu_x86.cpp.o"
+  "CMakeFiles/ncnn.dir/layer/x86/relu_x86.cpp.o.d"
+  "CMakeFiles/ncnn.dir/layer/x86/relu_x86_avx2.cpp.o"
+  "CMakeFiles/ncnn.dir/layer/x86/relu_x86_avx2.cpp.o.d"
+  "CMakeFiles/ncnn.dir/layer/x86/requantize_x86.cpp.o"
+  "CMakeFiles/ncnn.dir/layer/x86/requantize_x86.cpp.o.d"
+  "CMakeFiles/ncnn.dir/layer/x86/requantize_x86_avx2.cpp.o"
+  "CMakeFiles/ncnn.dir/layer/x86/requantize_x86_avx2.cpp.o.d"
+  "CMakeFiles/ncnn.dir/layer/x86/reshape_x86.cpp.o"
+  "CMakeFiles/ncnn.dir/layer/x86/reshape_x86.cpp.o.d"
+  "CMakeFiles/ncnn.dir/layer/x86/reshape_x86_avx2.cpp.o"
+  "CMakeFiles/ncnn.dir/layer/x86/reshape_x86_avx2.cpp.o.d"
+  "CMakeFiles/ncnn.dir/layer/x86/roialign_x86.cpp.o"
+  "CMakeFiles/ncnn.dir/layer/x86/roialign_x86.cpp.o.d"
+  "CMakeFiles/ncnn.dir/layer/x86/roialign_x86_avx2.cpp.o"
+  "CMakeFiles/ncnn.dir/layer/x86/roialign_x86_avx2.cpp.o.d"
+  "CMakeFiles/ncnn.dir/layer/x86/scale_x86.cpp.o"
+  "CMakeFiles/ncnn.dir/layer/x86/scale_x86.cpp.o.d"
+  "CMakeFiles/ncnn.dir/layer/x86/scale_x86_avx2.cpp.o"
+  "CMakeFiles/ncnn.dir/layer/x86/scale_x86_avx2.cpp.o.d"
+  "CMakeFiles/ncnn.dir/layer/x86/sigmoid_x86.cpp.o"
+  "CMakeFiles/ncnn.dir/layer/x86/sigmoid_x86.cpp.o.d"
+  "CMakeFiles/ncnn.dir/layer/x86/sigmoid_x86_avx2.cpp.o"
+  "CMakeFiles/ncnn.dir/layer/x86/sigmoid_x86_avx2.cpp.o.d"
+  "CMakeFiles/ncnn.dir/layer/x86/slice_x86.cpp.o"
+  "CMakeFiles/ncnn.dir/layer/x86/slice_x86.cpp.o.d"
+  "CMakeFiles/ncnn.dir/layer/x86/slice_x86_avx2.cpp.o"
+  "CMakeFiles/ncnn.dir/layer/x86/slice_x86_avx2.cpp.o.d"
+  "CMakeFiles/ncnn.dir/layer/x86/softmax_x86.cpp.o"
+  "CMakeFiles/ncnn.dir/layer/x86/softmax_x86.cpp.o.d"
+  "CMakeFiles/ncnn.dir/layer/x86/softmax_x86_avx2.cpp.o"
+  "CMakeFiles/ncnn.dir/layer/x86/softmax_x86_avx2.cpp.o.d"
+  "CMakeFiles/ncnn.dir/layer/x86/swish_x86.cpp.o"
+  "CMakeFiles/ncnn.dir/layer/x86/swish_x86.cpp.o.d"
+  "CMakeFiles/ncnn.dir/layer/x86/swish_x86_avx2.cpp.o"
+  "CMakeFiles/ncnn.dir/layer/x86/swish_x86_avx2.cpp.o.d"
+  "CMakeFiles/ncnn.dir/layer/x86/tanh_x86.cpp.o"
+  "CMakeFiles/ncnn.dir/layer/x86/tanh_x86.cpp.o.d"
+  "CMakeFiles/ncnn.dir/layer/x86/tanh_x86_avx2.cpp.o"
+  "CMakeFiles/ncnn.dir/layer/x86/tanh_x86_avx2.cpp.o.d"
+  "CMakeFiles/ncnn.dir/layer/x86/unaryop_x86.cpp.o"
+  "CMakeFiles/ncnn.dir/layer/x86/unaryop_x86.cpp.o.d"
+  "CMakeFiles/ncnn.dir/layer/x86/unaryop_x86_avx2.cpp.o"
+  "CMakeFiles/ncnn.dir/layer/x86/unaryop_x86_avx2.cpp.o.d"
+  "CMakeFiles/ncnn.dir/layer/yolodetectionoutput.cpp.o"
+  "CMakeFiles/ncnn.dir/layer/yolodetectionoutput.cpp.o.d"
+  "CMakeFiles/ncnn.dir/layer/yolov3detectionoutput.cpp.o"
+  "CMakeFiles/ncnn.dir/layer/yolov3detectionoutput.cpp.o.d"
+  "CMakeFiles/ncnn.dir/mat.cpp.o"
+  "CMakeFiles/ncnn.dir/mat.cpp.o.d"
+  "CMakeFiles/ncnn.dir/mat_pixel.cpp.o"
+  "CMakeFiles/ncnn.dir/mat_pixel.cpp.o.d"
+  "CMakeFiles/ncnn.dir/mat_pixel_resize.cpp.o"
+  "CMakeFiles/ncnn.dir/mat_pixel_resize.cpp.o.d"
+  "CMakeFiles/ncnn.dir/mat_pixel_rotate.cpp.o"
+  "CMakeFiles/ncnn.dir/mat_pixel_rotate.cpp.o.d"
+  "CMakeFiles/ncnn.dir/modelbin.cpp.o"
+  "CMakeFiles/ncnn.dir/modelbin.cpp.o.d"
+  "CMakeFiles/ncnn.dir/net.cpp.o"
+  "CMakeFiles/ncnn.dir/net.cpp.o.d"
+  "CMakeFiles/ncnn.dir/opencv.cpp.o"
+  "CMakeFiles/ncnn.dir/opencv.cpp.o.d"
+  "CMakeFiles/ncnn.dir/option.cpp.o"
+  "CMakeFiles/ncnn.dir/option.cpp.o.d"
+  "CMakeFiles/ncnn.dir/paramdict.cpp.o"
+  "CMakeFiles/ncnn.dir/paramdict.cpp.o.d"
+  "CMakeFiles/ncnn.dir/pipeline.cpp.o"
+  "CMakeFiles/ncnn.dir/pipeline.cpp.o.d"
+  "CMakeFiles/ncnn.dir/profiler.cpp.o"
+  "CMakeFiles/ncnn.dir/profiler.cpp.o.d"
+  "CMakeFiles/ncnn.dir/threadpool.cpp.o"
+  "CMakeFiles/ncnn.dir/threadpool.cpp.o.d"
+  "layer/x86/batchnorm_x86_avx2.cpp"
+  "layer/x86/batchnorm_x86_avx2.h"
+  "layer/x86/bias_x86_avx2.cpp"
+  "layer/x86/bias_x86_avx2.h"
+  "layer/x86/binaryop_x86_avx2.cpp"
+  "layer/x86/binaryop_x86_avx2.h"
+  "layer/x86/cast_x86_avx2.cpp"
+  "layer/x86/cast_x86_avx2.h"
+  "layer/x86/clip_x86_avx2.cpp"
+  "layer/x86/clip_x86_avx2.h"
+  "layer/x86/concat_x86_avx2.cpp"
+  "layer/x86/concat_x86_avx2.h"
+  "layer/x86/convolution_x86_avx2.cpp"
+  "layer/x86/convolution_x86_avx2.h"
+  "layer/x86/convolution_x86_avx512.cpp"
+  "layer/x86/convolution_x86_avx512.h"
+  "layer/x86/convolutiondepthwise_x86_avx2.cpp"
+  "layer/x86/convolutiondepthwise_x86_avx2.h"
+  "layer/x86/crop_x86_avx2.cpp"
+  "layer/x86/crop_x86_avx2.h"
+  "layer/x86/deconvolution_x86_avx2.cpp"
+  "layer/x86/deconvolution_x86_avx2.h"
+  "layer/x86/deconvolutiondepthwise_x86_avx2.cpp"
+  "layer/x86/deconvolutiondepthwise_x86_avx2.h"
+  "layer/x86/dequantize_x86_avx2.cpp"
+  "layer/x86/dequantize_x86_avx2.h"
+  "layer/x86/dropout_x86_avx2.cpp"
+  "layer/x86/dropout_x86_avx2.h"
+  "layer/x86/eltwise_x86_avx2.cpp"
+  "layer/x86/eltwise_x86_avx2.h"
+  "layer/x86/flatten_x86_avx2.cpp"
+  "layer/x86/flatten_x86_avx2.h"
+  "layer/x86/gru_x86_avx2.cpp"
+  "layer/x86/gru_x86_avx2.h"
+  "layer/x86/hardsigmoid_x86_avx2.cpp"
+  "layer/x86/hardsigmoid_x86_avx2.h"
+  "layer/x86/hardswish_x86_avx2.cpp"
+  "layer/x86/hardswish_x86_avx2.h"
+  "layer/x86/innerproduct_x86_avx2.cpp"
+  "layer/x86/innerproduct_x86_avx2.h"
+  "layer/x86/innerproduct_x86_avx512.cpp"
+  "layer/x86/innerproduct_x86_avx512.h"
+  "layer/x86/instancenorm_x86_avx2.cpp"
+  "layer/x86/instancenorm_x86_avx2.h"
+  "layer/x86/interp_x86_avx2.cpp"
+  "layer/x86/interp_x86_avx2.h"
+  "layer/x86/lrn_x86_avx2.cpp"
+  "layer/x86/lrn_x86_avx2.h"
+  "layer/x86/lstm_x86_avx2.cpp"
+  "layer/x86/lstm_x86_avx2.h"
+  "layer/x86/mish_x86_avx2.cpp"
+  "layer/x86/mish_x86_avx2.h"
+  "layer/x86/normalize_x86_avx2.cpp"
+  "layer/x86/normalize_x86_avx2.h"
+  "layer/x86/packing_x86_avx2.cpp"
+  "layer/x86/packing_x86_avx2.h"
+  "layer/x86/padding_x86_avx2.cpp"
+  "layer/x86/padding_x86_avx2.h"
+  "layer/x86/permute_x86_avx2.cpp"
+  "layer/x86/permute_x86_avx2.h"
+  "layer/x86/pixelshuffle_x86_avx2.cpp"
+  "layer/x86/pixelshuffle_x86_avx2.h"
+  "layer/x86/pooling_x86_avx2.cpp"
+  "layer/x86/pooling_x86_avx2.h"
+  "layer/x86/prelu_x86_avx2.cpp"
+  "layer/x86/prelu_x86_avx2.h"
+  "layer/x86/quantize_x86_avx2.cpp"
+  "layer/x86/quantize_x86_avx2.h"
+  "layer/x86/relu_x86_avx2.cpp"
+  "layer/x86/relu_x86_avx2.h"
+  "layer/x86/requantize_x86_avx2.cpp"
+  "layer/x86/requantize_x86_avx2.h"
+  "layer/x86/reshape_x86_avx2.cpp"
+  "layer/x86/reshape_x86_avx2.h"
+  "layer/x86/roialign_x86_avx2.cpp"
+  "layer/x86/roialign_x86_avx2.h"
+  "layer/x86/scale_x86_avx2.cpp"
+  "layer/x86/scale_x86_avx2.h"
+  "layer/x86/sigmoid_x86_avx2.cpp"
+  "layer/x86/sigmoid_x86_avx2.h"
+  "layer/x86/slice_x86_avx2.cpp"
+  "layer/x86/slice_x86_avx2.h"
+  "layer/x86/softmax_x86_avx2.cpp"
+  "layer/x86/softmax_x86_avx2.h"
+  "layer/x86/swish_x86_avx2.cpp"
+  "layer/x86/swish_x86_avx2.h"
+  "layer/x86/tanh_x86_avx2.cpp"
+  "layer/x86/tanh_x86_avx2.h"
+  "layer/x86/unaryop_x86_avx2.cpp"
+  "layer/x86/unaryop_x86_avx2.h"
+  "libncnn.a"
+  "libncnn.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/ncnn.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,525 @@
+// Tencent is pleased to support the open source community by making ncnn available.
+//
+// Copyright (C) 2020 THL A29 Limited, a Tencent company. All rights reserved.
+//
+// Licensed under the BSD 3-Clause License (the "License"); you may not use this file except
+// in compliance with the License. You may obtain a copy of the License at
+//
+// https://opensource.org/licenses/BSD-3-Clause
+//
+// Unless required by applicable law or agreed to in writing, software distributed
+// under the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR
+// CONDITIONS OF ANY KIND, either express or implied. See the License for the
+// specific language governing permissions and limitations under the License.
+
+#if __AVX__
+#include "avx_activation.h"
+#include "avx_usability.h"
+#endif
+
+#include "deconvolution_x86_avx2.h"
+
+namespace ncnn {
+
+DEFINE_LAYER_CREATOR(Deconvolution_x86_avx2)
+
+Deconvolution_x86_avx2::Deconvolution_x86_avx2()
+{
+#if __AVX__
+    support_packing = true;
+#endif // __AVX__
+}
+
+int Deconvolution_x86_avx2::create_pipeline(const Option& opt)
+{
+    if (opt.use_int8_inference && int8_scale_term)
+    {
+        // int8 weights go through the generic int8 path
+        return Deconvolution::create_pipeline(opt);
+    }
+
+#if __AVX__
+    const int maxk = kernel_w * kernel_h;
+    int num_input = weight_data_size / maxk / num_output;
+
+    int elempack = (support_packing && opt.use_packing_layout && num_input % 8 == 0) ? 8 : 1;
+    int out_elempack = (support_packing && opt.use_packing_layout && num_output % 8 == 0) ? 8 : 1;
+
+    if (elempack == 1 && out_elempack == 1)
+        return 0;
+
+    if (!weight_data_pack8.empty() || !weight_data_pack1to8.empty() || !weight_data_pack8to1.empty())
+        return 0;
+
+    // the output gathers its inputs, flip the kernel
+    Mat weight_data_transposed(weight_data.w);
+    {
+        float* pt = weight_data_transposed;
+        const float* p = weight_data;
+
+        for (int i = 0; i < num_input * num_output; i++)
+        {
+            for (int k = 0; k < maxk; k++)
+            {
+                pt[maxk - 1 - k] = p[k];
+            }
+
+            p += maxk;
+            pt += maxk;
+        }
+    }
+
+    Mat weight_data_r2 = weight_data_transposed.reshape(maxk, num_input, num_output);
+
+    // pack8
+    if (elempack == 8 && out_elempack == 8)
+    {
+        // src = kw-kh-inch-outch
+        // dst = 8b-8a-kw-kh-inch/8a-outch/8b
+        weight_data_pack8.create(maxk, num_input / 8, num_output / 8, (size_t)4 * 64, 64);
+
+        for (int q = 0; q + 7 < num_output; q += 8)
+        {
+            Mat g0 = weight_data_pack8.channel(q / 8);
+
+            for (int p = 0; p + 7 < num_input; p += 8)
+            {
+                float* g00 = g0.row(p / 8);
+
+                for (int k = 0; k < maxk; k++)
+                {
+                    for (int i = 0; i < 8; i++)
+                    {
+                        for (int j = 0; j < 8; j++)
+                        {
+                            const float* k00 = weight_data_r2.channel(q + j).row(p + i);
+
+                            g00[0] = k00[k];
+
+                            g00++;
+                        }
+                    }
+                }
+            }
+        }
+    }
+
+    // pack1to8
+    if (elempack == 1 && out_elempack == 8)
+    {
+        // src = kw-kh-inch-outch
+        // dst = 8b-kw-kh-inch-outch/8b
+        weight_data_pack1to8.create(maxk, num_input, num_output / 8, (size_t)4 * 8, 8);
+
+        for (int q = 0; q + 7 < num_output; q += 8)
+        {
+            Mat g0 = weight_data_pack1to8.channel(q / 8);
+
+            for (int p = 0; p < num_input; p++)
+            {
+                float* g00 = g0.row(p);
+
+                for (int k = 0; k < maxk; k++)
+                {
+                    for (int j = 0; j < 8; j++)
+                    {
+                        const float* k00 = weight_data_r2.channel(q + j).row(p);
+
+                        g00[0] = k00[k];
+
+                        g00++;
+                    }
+                }
+            }
+        }
+    }
+
+    // pack8to1
+    if (elempack == 8 && out_elempack == 1)
+    {
+        // src = kw-kh-inch-outch
+        // dst = 8a-kw-kh-inch/8a-outch
+        weight_data_pack8to1.create(maxk, num_input / 8, num_output, (size_t)4 * 8, 8);
+
+        for (int q = 0; q < num_output; q++)
+        {
+            const Mat k0 = weight_data_r2.channel(q);
+            Mat g0 = weight_data_pack8to1.channel(q);
+
+            for (int p = 0; p + 7 < num_input; p += 8)
+            {
+                float* g00 = g0.row(p / 8);
+
+                for (int k = 0; k < maxk; k++)
+                {
+                    for (int i = 0; i < 8; i++)
+                    {
+                        const float* k00 = k0.row(p + i);
+
+                        g00[0] = k00[k];
+
+                        g00++;
+                    }
+                }
+            }
+        }
+    }
+#endif // __AVX__
+
+    return 0;
+}
+
+int Deconvolution_x86_avx2::destroy_pipeline(const Option& /*opt*/)
+{
+    weight_data_pack8.release();
+    weight_data_pack1to8.release();
+    weight_data_pack8to1.release();
+
+    return 0;
+}
+
+int Deconvolution_x86_avx2::get_pipeline_weights(std::vector<Mat*>& weights)
+{
+    weights.push_back(&weight_data_pack8);
+    weights.push_back(&weight_data_pack1to8);
+    weights.push_back(&weight_data_pack8to1);
+
+    return 0;
+}
+
+int Deconvolution_x86_avx2::forward(const Mat& bottom_blob, Mat& top_blob, const Option& opt) const
+{
+    // deconvolv with NxN kernel
+    // value = value + bias
+
+    if (opt.use_int8_inference && weight_data.elemsize == (size_t)1u)
+    {
+        Mat bottom_blob_unpacked = bottom_blob;
+        if (bottom_blob.elempack != 1)
+        {
+            Option opt_pack1 = opt;
+            opt_pack1.blob_allocator = opt.workspace_allocator;
+
+            convert_packing(bottom_blob, bottom_blob_unpacked, 1, opt_pack1);
+        }
+
+        return Deconvolution::forward(bottom_blob_unpacked, top_blob, opt);
+    }
+
+    int w = bottom_blob.w;
+    int h = bottom_blob.h;
+    size_t elemsize = bottom_blob.elemsize;
+    int elempack = bottom_blob.elempack;
+
+    const int kernel_extent_w = dilation_w * (kernel_w - 1) + 1;
+    const int kernel_extent_h = dilation_h * (kernel_h - 1) + 1;
+
+    int outw = (w - 1) * stride_w + kernel_extent_w;
+    int outh = (h - 1) * stride_h + kernel_extent_h;
+    int out_elempack = (support_packing && opt.use_packing_layout && num_output % 8 == 0) ? 8 : 1;
+    size_t out_elemsize = elemsize / elempack * out_elempack;
+
+    if (elempack == 1 && out_elempack == 1)
+    {
+        return Deconvolution::forward(bottom_blob, top_blob, opt);
+    }
+
+    Mat top_blob_bordered;
+    if (pad_left > 0 || pad_right > 0 || pad_top > 0 || pad_bottom > 0 || output_pad_right > 0 || output_pad_bottom > 0 || (output_w > 0 && output_h > 0))
+    {
+        top_blob_bordered.create(outw, outh, num_output / out_elempack, out_elemsize, out_elempack, opt.workspace_allocator);
+    }
+    else
+    {
+        top_blob_bordered = top_blob;
+        top_blob_bordered.create(outw, outh, num_output / out_elempack, out_elemsize, out_elempack, opt.blob_allocator);
+    }
+    if (top_blob_bordered.empty())
+        return -100;
+
+#if __AVX__
+    int channels = bottom_blob.c;
+
+    const int maxk = kernel_w * kernel_h;
+
+    if (elempack == 8 && out_elempack == 8)
+    {
+        // num_output
+        #pragma omp parallel for num_threads(opt.num_threads)
+        for (int p = 0; p < num_output / out_elempack; p++)
+        {
+            float* outptr = top_blob_bordered.channel(p);
+
+            for (int i = 0; i < outh; i++)
+            {
+                for (int j = 0; j < outw; j++)
+                {
+                    __m256 _sum = _mm256_setzero_ps();
+
+                    if (bias_term)
+                    {
+                        _sum = _mm256_loadu_ps(((const float*)bias_data) + p * 8);
+                    }
+
+                    const float* kptr = (const float*)weight_data_pack8 + maxk * channels * p * 64;
+
+                    // channels
+                    for (int q = 0; q < channels; q++)
+                    {
+                        const Mat m = bottom_blob.channel(q);
+
+                        for (int y = 0; y < kernel_h; y++)
+                        {
+                            int sys = (i + y * dilation_h - (kernel_extent_h - 1));
+                            if (sys < 0 || sys % stride_h != 0)
+                                continue;
+
+                            int sy = sys / stride_h;
+                            if (sy >= h)
+                                continue;
+
+                            for (int x = 0; x < kernel_w; x++)
+                            {
+                                int sxs = (j + x * dilation_w - (kernel_extent_w - 1));
+                                if (sxs < 0 || sxs % stride_w != 0)
+                                    continue;
+
+                                int sx = sxs / stride_w;
+                                if (sx >= w)
+                                    continue;
+
+                                const float* sptr = m.row(sy) + sx * 8;
+
+                                int k = y * kernel_w + x;
+
+                                const float* w0 = kptr + k * 64;
+
+                                _sum = _mm256_fmadd_ps(_mm256_set1_ps(sptr[0]), _mm256_loadu_ps(w0), _sum);
+                                _sum = _mm256_fmadd_ps(_mm256_set1_ps(sptr[1]), _mm256_loadu_ps(w0 + 8), _sum);
+                                _sum = _mm256_fmadd_ps(_mm256_set1_ps(sptr[2]), _mm256_loadu_ps(w0 + 16), _sum);
+                                _sum = _mm256_fmadd_ps(_mm256_set1_ps(sptr[3]), _mm256_loadu_ps(w0 + 24), _sum);
+                                _sum = _mm256_fmadd_ps(_mm256_set1_ps(sptr[4]), _mm256_loadu_ps(w0 + 32), _sum);
+                                _sum = _mm256_fmadd_ps(_mm256_set1_ps(sptr[5]), _mm256_loadu_ps(w0 + 40), _sum);
+                                _sum = _mm256_fmadd_ps(_mm256_set1_ps(sptr[6]), _mm256_loadu_ps(w0 + 48), _sum);
+                                _sum = _mm256_fmadd_ps(_mm256_set1_ps(sptr[7]), _mm256_loadu_ps(w0 + 56), _sum);
+                            }
+                        }
+
+                        kptr += maxk * 64;
+                    }
+
+                    _sum = activation_ps(_sum, activation_type, activation_params);
+
+                    _mm256_storeu_ps(outptr + j * 8, _sum);
+                }
+
+                outptr += outw * 8;
+            }
+        }
+    }
+
+    if (elempack == 1 && out_elempack == 8)
+    {
+        // num_output
+        #pragma omp parallel for num_threads(opt.num_threads)
+        for (int p = 0; p < num_output / out_elempack; p++)
+        {
+            float* outptr = top_blob_bordered.channel(p);
+
+            for (int i = 0; i < outh; i++)
+            {
+                for (int j = 0; j < outw; j++)
+                {
+                    __m256 _sum = _mm256_setzero_ps();
+
+                    if (bias_term)
+                    {
+                        _sum = _mm256_loadu_ps(((const float*)bias_data) + p * 8);
+                    }
+
+                    const float* kptr = (const float*)weight_data_pack1to8 + maxk * channels * p * 8;
+
+                    // channels
+                    for (int q = 0; q < channels; q++)
+                    {
+                        const Mat m = bottom_blob.channel(q);
+
+                        for (int y = 0; y < kernel_h; y++)
+                        {
+                            int sys = (i + y * dilation_h - (kernel_extent_h - 1));
+                            if (sys < 0 || sys % stride_h != 0)
+                                continue;
+
+                            int sy = sys / stride_h;
+                            if (sy >= h)
+                                continue;
+
+                            const float* sptr = m.row(sy);
+
+                            for (int x = 0; x < kernel_w; x++)
+                            {
+                                int sxs = (j + x * dilation_w - (kernel_extent_w - 1));
+                                if (sxs < 0 || sxs % stride_w != 0)
+                                    continue;
+
+                                int sx = sxs / stride_w;
+                                if (sx >= w)
+                                    continue;
+
+                                __m256 _val = _mm256_set1_ps(sptr[sx]);
+
+                                int k = y * kernel_w + x;
+
+                                __m256 _w = _mm256_loadu_ps(kptr + k * 8);
+
+                                _sum = _mm256_fmadd_ps(_val, _w, _sum);
+                            }
+                        }
+
+                        kptr += maxk * 8;
+                    }
+
+                    _sum = activation_ps(_sum, activation_type, activation_params);
+
+                    _mm256_storeu_ps(outptr + j * 8, _sum);
+                }
+
+                outptr += outw * 8;
+            }
+        }
+    }
+
+    if (elempack == 8 && out_elempack == 1)
+    {
+        // num_output
+        #pragma omp parallel for num_threads(opt.num_threads)
+        for (int p = 0; p < num_output; p++)
+        {
+            float* outptr = top_blob_bordered.channel(p);
+
+            for (int i = 0; i < outh; i++)
+            {
+                for (int j = 0; j < outw; j++)
+                {
+                    __m256 _sum = _mm256_setzero_ps();
+
+                    const float* kptr = (const float*)weight_data_pack8to1 + maxk * channels * p * 8;
+
+                    // channels
+                    for (int q = 0; q < channels; q++)
+                    {
+                        const Mat m = bottom_blob.channel(q);
+
+                        for (int y = 0; y < kernel_h; y++)
+                        {
+                            int sys = (i + y * dilation_h - (kernel_extent_h - 1));
+                            if (sys < 0 || sys % stride_h != 0)
+                                continue;
+
+                            int sy = sys / stride_h;
+                            if (sy >= h)
+                                continue;
+
+                            for (int x = 0; x < kernel_w; x++)
+                            {
+                                int sxs = (j + x * dilation_w - (kernel_extent_w - 1));
+                                if (sxs < 0 || sxs % stride_w != 0)
+                                    continue;
+
+                                int sx = sxs / stride_w;
+                                if (sx >= w)
+                                    continue;
+
+                                const float* sptr = m.row(sy) + sx * 8;
+
+                                __m256 _val = _mm256_loadu_ps(sptr);
+
+                                int k = y * kernel_w + x;
+
+                                __m256 _w = _mm256_loadu_ps(kptr + k * 8);
+
+                                _sum = _mm256_fmadd_ps(_val, _w, _sum);
+                            }
+                        }
+
+                        kptr += maxk * 8;
+                    }
+
+                    float sum = _mm256_reduce_add_ps(_sum);
+
+                    if (bias_term)
+                    {
+                        sum += bias_data[p];
+                    }
+
+                    outptr[j] = activation_ss(sum, activation_type, activation_params);
+                }
+
+                outptr += outw;
+            }
+        }
+    }
+#endif // __AVX__
+
+    if (pad_left > 0 || pad_right > 0 || pad_top > 0 || pad_bottom > 0)
+    {
+        Mat top_blob_bordered_adj = top_blob_bordered;
+        if (output_pad_right > 0 || output_pad_bottom > 0)
+        {
+            Option opt_b = opt;
+            opt_b.blob_allocator = opt.workspace_allocator;
+            copy_make_border(top_blob_bordered, top_blob_bordered_adj, 0, output_pad_bottom, 0, output_pad_right, BORDER_CONSTANT, 0.f, opt_b);
+            if (top_blob_bordered_adj.empty())
+                return -100;
+        }
+
+        copy_cut_border(top_blob_bordered_adj, top_blob, pad_top, pad_bottom, pad_left, pad_right, opt);
+        if (top_blob.empty())
+            return -100;
+    }
+    else if (output_w > 0 && output_h > 0)
+    {
+        Mat top_blob_bordered_adj = top_blob_bordered;
+        if (output_pad_right > 0 || output_pad_bottom > 0)
+        {
+            Option opt_b = opt;
+            opt_b.blob_allocator = opt.workspace_allocator;
+            copy_make_border(top_blob_bordered, top_blob_bordered_adj, 0, output_pad_bottom, 0, output_pad_right, BORDER_CONSTANT, 0.f, opt_b);
+            if (top_blob_bordered_adj.empty())
+                return -100;
+        }
+
+        int wcut = top_blob_bordered_adj.w - output_w;
+        int hcut = top_blob_bordered_adj.h - output_h;
+
+        if (pad_left == -233 || pad_right == -233 || pad_top == -233 || pad_bottom == -233)
+        {
+            // onnx padding=SAME_UPPER
+            copy_cut_border(top_blob_bordered_adj, top_blob, hcut / 2, hcut - hcut / 2, wcut / 2, wcut - wcut / 2, opt);
+        }
+        else if (pad_left == -234 || pad_right == -234 || pad_top == -234 || pad_bottom == -234)
+        {
+            // onnx padding=SAME_LOWER
+            copy_cut_border(top_blob_bordered_adj, top_blob, hcut - hcut / 2, hcut / 2, wcut - wcut / 2, wcut / 2, opt);
+        }
+        if (top_blob.empty())
+            return -100;
+    }
+    else
+    {
+        if (output_pad_right > 0 || output_pad_bottom > 0)
+        {
+            copy_make_border(top_blob_bordered, top_blob, 0, output_pad_bottom, 0, output_pad_right, BORDER_CONSTANT, 0.f, opt);
+            if (top_blob.empty())
+                return -100;
+        }
+        else
+        {
+            top_blob = top_blob_bordered;
+        }
+    }
+
+    return 0;
+}
+
+} // namespace ncnn
@@ -0,0 +1,248 @@
+// Tencent is pleased to support the open source community by making ncnn available.
+//
+// Copyright (C) 2020 THL A29 Limited, a Tencent company. All rights reserved.
+//
+// Licensed under the BSD 3-Clause License (the "License"); you may not use this file except
+// in compliance with the License. You may obtain a copy of the License at
+//
+// https://opensource.org/licenses/BSD-3-Clause
+//
+// Unless required by applicable law or agreed to in writing, software distributed
+// under the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR
+// CONDITIONS OF ANY KIND, either express or implied. See the License for the
+// specific language governing permissions and limitations under the License.
+
+#if __AVX__
+#include "avx_activation.h"
+#include "avx_usability.h"
+#endif
+
+#include "deconvolutiondepthwise_x86_avx2.h"
+
+namespace ncnn {
+
+DEFINE_LAYER_CREATOR(DeconvolutionDepthWise_x86_avx2)
+
+DeconvolutionDepthWise_x86_avx2::DeconvolutionDepthWise_x86_avx2()
+{
+#if __AVX__
+    support_packing = true;
+#endif // __AVX__
+}
+
+int DeconvolutionDepthWise_x86_avx2::create_pipeline(const Option& opt)
+{
+#if __AVX__
+    const int maxk = kernel_w * kernel_h;
+    int channels = (weight_data_size / group) / maxk / (num_output / group) * group;
+
+    // depth-wise
+    if (channels == group && group == num_output && support_packing && opt.use_packing_layout && channels % 8 == 0 && weight_data_pack8.empty())
+    {
+        // the output gathers its inputs, flip the kernel
+        Mat weight_data_transposed(weight_data.w);
+        {
+            float* pt = weight_data_transposed;
+            const float* p = weight_data;
+
+            for (int i = 0; i < channels; i++)
+            {
+                for (int k = 0; k < maxk; k++)
+                {
+                    pt[maxk - 1 - k] = p[k];
+                }
+
+                p += maxk;
+                pt += maxk;
+            }
+        }
+
+        Mat weight_data_r2 = weight_data_transposed.reshape(maxk, group);
+        convert_packing(weight_data_r2, weight_data_pack8, 8);
+    }
+#else
+    (void)opt;
+#endif // __AVX__
+
+    return 0;
+}
+
+int DeconvolutionDepthWise_x86_avx2::destroy_pipeline(const Option& /*opt*/)
+{
+    weight_data_pack8.release();
+
+    return 0;
+}
+
+int DeconvolutionDepthWise_x86_avx2::get_pipeline_weights(std::vector<Mat*>& weights)
+{
+    weights.push_back(&weight_data_pack8);
+
+    return 0;
+}
+
+int DeconvolutionDepthWise_x86_avx2::forward(const Mat& bottom_blob, Mat& top_blob, const Option& opt) const
+{
+    int w = bottom_blob.w;
+    int h = bottom_blob.h;
+    int channels = bottom_blob.c;
+    int elempack = bottom_blob.elempack;
+
+    // group deconvolution and packing disabled run unpacked
+    if (elempack != 8 || channels * elempack != group || group != num_output || weight_data_pack8.empty())
+    {
+        Mat bottom_blob_unpacked = bottom_blob;
+        if (elempack != 1)
+        {
+            Option opt_p = opt;
+            opt_p.blob_allocator = opt.workspace_allocator;
+            convert_packing(bottom_blob, bottom_blob_unpacked, 1, opt_p);
+        }
+
+        return DeconvolutionDepthWise::forward(bottom_blob_unpacked, top_blob, opt);
+    }
+
+    const int kernel_extent_w = dilation_w * (kernel_w - 1) + 1;
+    const int kernel_extent_h = dilation_h * (kernel_h - 1) + 1;
+
+    int outw = (w - 1) * stride_w + kernel_extent_w;
+    int outh = (h - 1) * stride_h + kernel_extent_h;
+
+    Mat top_blob_bordered;
+    if (pad_left > 0 || pad_right > 0 || pad_top > 0 || pad_bottom > 0 || output_pad_right > 0 || output_pad_bottom > 0 || (output_w > 0 && output_h > 0))
+    {
+        top_blob_bordered.create(outw, outh, channels, bottom_blob.elemsize, elempack, opt.workspace_allocator);
+    }
+    else
+    {
+        top_blob_bordered = top_blob;
+        top_blob_bordered.create(outw, outh, channels, bottom_blob.elemsize, elempack, opt.blob_allocator);
+    }
+    if (top_blob_bordered.empty())
+        return -100;
+
+#if __AVX__
+    const int maxk = kernel_w * kernel_h;
+
+    #pragma omp parallel for num_threads(opt.num_threads)
+    for (int g = 0; g < channels; g++)
+    {
+        float* outptr = top_blob_bordered.channel(g);
+        const float* kptr = (const float*)weight_data_pack8 + maxk * g * 8;
+        const Mat m = bottom_blob.channel(g);
+
+        for (int i = 0; i < outh; i++)
+        {
+            for (int j = 0; j < outw; j++)
+            {
+                __m256 _sum = _mm256_setzero_ps();
+
+                if (bias_term)
+                {
+                    _sum = _mm256_loadu_ps((const float*)bias_data + g * 8);
+                }
+
+                for (int y = 0; y < kernel_h; y++)
+                {
+                    int sys = (i + y * dilation_h - (kernel_extent_h - 1));
+                    if (sys < 0 || sys % stride_h != 0)
+                        continue;
+
+                    int sy = sys / stride_h;
+                    if (sy >= h)
+                        continue;
+
+                    for (int x = 0; x < kernel_w; x++)
+                    {
+                        int sxs = (j + x * dilation_w - (kernel_extent_w - 1));
+                        if (sxs < 0 || sxs % stride_w != 0)
+                            continue;
+
+                        int sx = sxs / stride_w;
+                        if (sx >= w)
+                            continue;
+
+                        const float* sptr = m.row(sy) + sx * 8;
+
+                        __m256 _val = _mm256_loadu_ps(sptr);
+
+                        int k = y * kernel_w + x;
+
+                        __m256 _w = _mm256_loadu_ps(kptr + k * 8);
+
+                        _sum = _mm256_fmadd_ps(_val, _w, _sum);
+                    }
+                }
+
+                _sum = activation_ps(_sum, activation_type, activation_params);
+
+                _mm256_storeu_ps(outptr + j * 8, _sum);
+            }
+
+            outptr += outw * 8;
+        }
+    }
+#endif // __AVX__
+
+    if (pad_left > 0 || pad_right > 0 || pad_top > 0 || pad_bottom > 0)
+    {
+        Mat top_blob_bordered_adj = top_blob_bordered;
+        if (output_pad_right > 0 || output_pad_bottom > 0)
+        {
+            Option opt_b = opt;
+            opt_b.blob_allocator = opt.workspace_allocator;
+            copy_make_border(top_blob_bordered, top_blob_bordered_adj, 0, output_pad_bottom, 0, output_pad_right, BORDER_CONSTANT, 0.f, opt_b);
+            if (top_blob_bordered_adj.empty())
+                return -100;
+        }
+
+        copy_cut_border(top_blob_bordered_adj, top_blob, pad_top, pad_bottom, pad_left, pad_right, opt);
+        if (top_blob.empty())
+            return -100;
+    }
+    else if (output_w > 0 && output_h > 0)
+    {
+        Mat top_blob_bordered_adj = top_blob_bordered;
+        if (output_pad_right > 0 || output_pad_bottom > 0)
+        {
+            Option opt_b = opt;
+            opt_b.blob_allocator = opt.workspace_allocator;
+            copy_make_border(top_blob_bordered, top_blob_bordered_adj, 0, output_pad_bottom, 0, output_pad_right, BORDER_CONSTANT, 0.f, opt_b);
+            if (top_blob_bordered_adj.empty())
+                return -100;
+        }
+
+        int wcut = top_blob_bordered_adj.w - output_w;
+        int hcut = top_blob_bordered_adj.h - output_h;
+
+        if (pad_left == -233 || pad_right == -233 || pad_top == -233 || pad_bottom == -233)
+        {
+            // onnx padding=SAME_UPPER
+            copy_cut_border(top_blob_bordered_adj, top_blob, hcut / 2, hcut - hcut / 2, wcut / 2, wcut - wcut / 2, opt);
+        }
+        else if (pad_left == -234 || pad_right == -234 || pad_top == -234 || pad_bottom == -234)
+        {
+            // onnx padding=SAME_LOWER
+            copy_cut_border(top_blob_bordered_adj, top_blob, hcut - hcut / 2, hcut / 2, wcut - wcut / 2, wcut / 2, opt);
+        }
+        if (top_blob.empty())
+            return -100;
+    }
+    else
+    {
+        if (output_pad_right > 0 || output_pad_bottom > 0)
+        {
+            copy_make_border(top_blob_bordered, top_blob, 0, output_pad_bottom, 0, output_pad_right, BORDER_CONSTANT, 0.f, opt);
+            if (top_blob.empty())
+                return -100;
+        }
+        else
+        {
+            top_blob = top_blob_bordered;
+        }
+    }
+
+    return 0;
+}
+
+} // namespace ncnn
@@ -0,0 +1,119 @@
+// Tencent is pleased to support the open source community by making ncnn available.
+//
+// Copyright (C) 2020 THL A29 Limited, a Tencent company. All rights reserved.
+//
+// Licensed under the BSD 3-Clause License (the "License"); you may not use this file except
+// in compliance with the License. You may obtain a copy of the License at
+//
+// https://opensource.org/licenses/BSD-3-Clause
+//
+// Unless required by applicable law or agreed to in writing, software distributed
+// under the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR
+// CONDITIONS OF ANY KIND, either express or implied. See the License for the
+// specific language governing permissions and limitations under the License.
+
+
+#include "dequantize_x86_avx2.h"
+
+#if __AVX__
+#include <immintrin.h>
+#endif // __AVX__
+
+namespace ncnn {
+
+DEFINE_LAYER_CREATOR(Dequantize_x86_avx2)
+
+Dequantize_x86_avx2::Dequantize_x86_avx2()
+{
+#if __AVX__
+    support_packing = true;
+#endif // __AVX__
+}
+
+int Dequantize_x86_avx2::forward_inplace(Mat& bottom_top_blob, const Option& opt) const
+{
+#if __AVX__
+    int elempack = bottom_top_blob.elempack;
+
+    if (elempack == 8)
+    {
+        // int32 pack8 to fp32 pack8 in place
+        int dims = bottom_top_blob.dims;
+        int w = bottom_top_blob.w;
+        int h = bottom_top_blob.h;
+        int channels = bottom_top_blob.c;
+
+        const __m256 _scale = _mm256_set1_ps(scale);
+
+        if (dims == 1)
+        {
+            float* ptr = bottom_top_blob;
+
+            #pragma omp parallel for num_threads(opt.num_threads)
+            for (int i = 0; i < w; i++)
+            {
+                __m256 _bias = _mm256_setzero_ps();
+                if (bias_term)
+                {
+                    _bias = bias_data_size > 1 ? _mm256_loadu_ps((const float*)bias_data + i * 8) : _mm256_set1_ps(bias_data[0]);
+                }
+
+                __m256 _v = _mm256_cvtepi32_ps(_mm256_loadu_si256((const __m256i*)(ptr + i * 8)));
+                _mm256_storeu_ps(ptr + i * 8, _mm256_add_ps(_mm256_mul_ps(_v, _scale), _bias));
+            }
+        }
+
+        if (dims == 2)
+        {
+            #pragma omp parallel for num_threads(opt.num_threads)
+            for (int i = 0; i < h; i++)
+            {
+                float* ptr = bottom_top_blob.row(i);
+
+                __m256 _bias = _mm256_setzero_ps();
+                if (bias_term)
+                {
+                    _bias = bias_data_size > 1 ? _mm256_loadu_ps((const float*)bias_data + i * 8) : _mm256_set1_ps(bias_data[0]);
+                }
+
+                for (int j = 0; j < w; j++)
+                {
+                    __m256 _v = _mm256_cvtepi32_ps(_mm256_loadu_si256((const __m256i*)ptr));
+                    _mm256_storeu_ps(ptr, _mm256_add_ps(_mm256_mul_ps(_v, _scale), _bias));
+                    ptr += 8;
+                }
+            }
+        }
+
+        if (dims == 3)
+        {
+            int size = w * h;
+
+            #pragma omp parallel for num_threads(opt.num_threads)
+            for (int q = 0; q < channels; q++)
+            {
+                float* ptr = bottom_top_blob.channel(q);
+
+                __m256 _bias = _mm256_setzero_ps();
+                if (bias_term)
+                {
+                    _bias = bias_data_size > 1 ? _mm256_loadu_ps((const float*)bias_data + q * 8) : _mm256_set1_ps(bias_data[0]);
+                }
+
+                for (int i = 0; i < size; i++)
+                {
+                    __m256 _v = _mm256_cvtepi32_ps(_mm256_loadu_si256((const __m256i*)ptr));
+                    _mm256_storeu_ps(ptr, _mm256_add_ps(_mm256_mul_ps(_v, _scale), _bias));
+                    ptr += 8;
+                }
+            }
+        }
+
+        return 0;
+    }
+#endif // __AVX__
+
+    return Dequantize::forward_inplace(bottom_top_blob, opt);
+}
+
+} // namespace ncnn
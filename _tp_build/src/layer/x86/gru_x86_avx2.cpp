@@ -0,0 +1,271 @@
+// Tencent is pleased to support the open source community by making ncnn available.
+//
+// Copyright (C) 2020 THL A29 Limited, a Tencent company. All rights reserved.
+//
+// Licensed under the BSD 3-Clause License (the "License"); you may not use this file except
+// in compliance with the License. You may obtain a copy of the License at
+//
+// https://opensource.org/licenses/BSD-3-Clause
+//
+// Unless required by applicable law or agreed to in writing, software distributed
+// under the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR
+// CONDITIONS OF ANY KIND, either express or implied. See the License for the
+// specific language governing permissions and limitations under the License.
+#ifdef __AVX__
+#include "avx_activation.h"
+#include "avx_usability.h"
+#endif // __AVX__
+
+#include "gru_x86_avx2.h"
+
+#include <math.h>
+#include <string.h>
+
+#include <algorithm>
+
+#include "layer_type.h"
+
+namespace ncnn {
+
+#ifdef __AVX__
+#include "rnn_gemm.h"
+#endif // __AVX__
+
+DEFINE_LAYER_CREATOR(GRU_x86_avx2)
+
+GRU_x86_avx2::GRU_x86_avx2()
+{
+    one_blob_only = false;
+    support_inplace = false;
+    support_batch = true;
+}
+int GRU_x86_avx2::create_pipeline(const Option& opt)
+{
+#if __AVX__
+    if (opt.use_fp16_storage && weight_xc_data.elemsize == 4u)
+    {
+        ncnn::cast_float32_to_float16(weight_xc_data, weight_xc_data_fp16, opt);
+        ncnn::cast_float32_to_float16(weight_hc_data, weight_hc_data_fp16, opt);
+    }
+#else
+    (void)opt;
+#endif // __AVX__
+
+    return 0;
+}
+#ifdef __AVX__
+
+// runs all sequences in all directions together, one timestep after another
+// the recurrent part of a timestep is split over blocks of 8 hidden units of every sequence
+template<typename WT>
+static int gru(const std::vector<Mat>& bottom_blobs, std::vector<Mat>& top_blobs, std::vector<Mat>& hidden_states, int direction, const Mat& weight_xc, const Mat& bias_c, const Mat& weight_hc, const Option& opt)
+{
+    const int num_directions = direction == 2 ? 2 : 1;
+    const int num_sequences = (int)bottom_blobs.size() * num_directions;
+
+    const int num_output = weight_hc.w;
+
+    // 3 x num_output gates of every timestep, the input part of R U N
+    std::vector<Mat> gates(num_sequences);
+    int max_T = 0;
+    for (int s = 0; s < num_sequences; s++)
+    {
+        const Mat& bottom_blob = bottom_blobs[s / num_directions];
+        const int d = s % num_directions;
+
+        gates[s].create(num_output * 3, bottom_blob.h, 4u, opt.workspace_allocator);
+        if (gates[s].empty())
+            return -100;
+
+        rnn_input_gemm<WT>(bottom_blob, gates[s], weight_xc.channel(d), bias_c.channel(d), opt);
+
+        max_T = std::max(max_T, bottom_blob.h);
+    }
+
+    const int nn_num_output = (num_output + 7) / 8;
+
+    // unroll
+    for (int t = 0; t < max_T; t++)
+    {
+        #pragma omp parallel for num_threads(opt.num_threads)
+        for (int i = 0; i < num_sequences * nn_num_output; i++)
+        {
+            const int s = i / nn_num_output;
+            int q = (i % nn_num_output) * 8;
+
+            const int T = gates[s].h;
+            if (t >= T)
+                continue;
+
+            const int b = s / num_directions;
+            const int d = s % num_directions;
+            const int reverse = direction == 2 ? d : direction;
+            const int ti = reverse ? T - 1 - t : t;
+
+            // the previous hidden state is the output of the previous timestep
+            const float* hidden_ptr = t == 0 ? (const float*)hidden_states[b].row(d) : (const float*)top_blobs[b].row(reverse ? ti + 1 : ti - 1) + d * num_output;
+
+            const Mat weight_hc_d = weight_hc.channel(d);
+            const float* bias_c_BN = bias_c.channel(d).row(3);
+
+            // gate reset update new
+            const float* gates_data = gates[s].row(ti);
+            float* output_data = (float*)top_blobs[b].row(ti) + d * num_output;
+
+            // gru unit
+            // sigmoid(R)
+            // sigmoid(U)
+            // n_t := tanh(W_xn * x_t + b_wn + r_t .* (W_hn * h_{t-1} + b_bn))
+            // h_t := (1 - u_t) .* n_t + u_t .* h_{t-1}
+            if (q + 7 < num_output)
+            {
+                __m256 _R = _mm256_add_ps(_mm256_loadu_ps(gates_data + num_output * 0 + q), rnn_dot8<WT>(weight_hc_d, num_output * 0 + q, hidden_ptr, num_output));
+                __m256 _U = _mm256_add_ps(_mm256_loadu_ps(gates_data + num_output * 1 + q), rnn_dot8<WT>(weight_hc_d, num_output * 1 + q, hidden_ptr, num_output));
+                __m256 _N = _mm256_add_ps(_mm256_loadu_ps(bias_c_BN + q), rnn_dot8<WT>(weight_hc_d, num_output * 2 + q, hidden_ptr, num_output));
+
+                _R = sigmoid_avx(_R);
+                _U = sigmoid_avx(_U);
+                _N = tanh_avx(_mm256_add_ps(_mm256_loadu_ps(gates_data + num_output * 2 + q), _mm256_mul_ps(_R, _N)));
+
+                // (1 - u) * n + u * h  ==  n + u * (h - n)
+                __m256 _H = _mm256_add_ps(_N, _mm256_mul_ps(_U, _mm256_sub_ps(_mm256_loadu_ps(hidden_ptr + q), _N)));
+                _mm256_storeu_ps(output_data + q, _H);
+                continue;
+            }
+
+            for (; q < num_output; q++)
+            {
+                float R = gates_data[num_output * 0 + q] + rnn_dot(weight_hc_d.row<const WT>(num_output * 0 + q), hidden_ptr, num_output);
+                float U = gates_data[num_output * 1 + q] + rnn_dot(weight_hc_d.row<const WT>(num_output * 1 + q), hidden_ptr, num_output);
+
+                R = 1.f / (1.f + exp(-R));
+                U = 1.f / (1.f + exp(-U));
+
+                float N = bias_c_BN[q] + rnn_dot(weight_hc_d.row<const WT>(num_output * 2 + q), hidden_ptr, num_output);
+
+                N = tanh(gates_data[num_output * 2 + q] + R * N);
+
+                output_data[q] = (1.f - U) * N + U * hidden_ptr[q];
+            }
+        }
+    }
+
+    // keep the last hidden state
+    for (int s = 0; s < num_sequences; s++)
+    {
+        const int T = gates[s].h;
+        if (T == 0)
+            continue;
+
+        const int b = s / num_directions;
+        const int d = s % num_directions;
+        const int reverse = direction == 2 ? d : direction;
+
+        const float* ptr = (const float*)top_blobs[b].row(reverse ? 0 : T - 1) + d * num_output;
+        memcpy(hidden_states[b].row(d), ptr, num_output * sizeof(float));
+    }
+
+    return 0;
+}
+#endif // __AVX__
+
+int GRU_x86_avx2::forward(const Mat& bottom_blob, Mat& top_blob, const Option& opt) const
+{
+    std::vector<Mat> bottom_blobs(1, bottom_blob);
+    std::vector<Mat> top_blobs(1);
+    int ret = GRU_x86_avx2::forward_batch(bottom_blobs, top_blobs, opt);
+    if (ret != 0)
+        return ret;
+
+    top_blob = top_blobs[0];
+
+    return 0;
+}
+
+int GRU_x86_avx2::forward(const std::vector<Mat>& bottom_blobs, std::vector<Mat>& top_blobs, const Option& opt) const
+{
+#if __AVX__
+    if (weight_xc_data.elemsize == 1u)
+    {
+        return GRU::forward(bottom_blobs, top_blobs, opt);
+    }
+
+    if (bottom_blobs.size() != 2 || top_blobs.size() != 2)
+    {
+        return forward(bottom_blobs[0], top_blobs[0], opt);
+    }
+    const Mat& bottom_blob = bottom_blobs[0];
+    int T = bottom_blob.h;
+
+    //Copy previous states
+    std::vector<Mat> hidden_states(1);
+    hidden_states[0] = bottom_blobs[1].clone(opt.blob_allocator);
+    if (hidden_states[0].empty())
+        return -100;
+
+    std::vector<Mat> top_blobs0(1);
+    top_blobs0[0].create(num_output, T, 4u, opt.blob_allocator);
+    if (top_blobs0[0].empty())
+        return -100;
+
+    // Uni directional
+    int ret = 0;
+    if (opt.use_fp16_storage)
+    {
+        ret = gru<unsigned short>(std::vector<Mat>(1, bottom_blob), top_blobs0, hidden_states, direction, weight_xc_data_fp16, bias_c_data, weight_hc_data_fp16, opt);
+    }
+    else
+    {
+        ret = gru<float>(std::vector<Mat>(1, bottom_blob), top_blobs0, hidden_states, direction, weight_xc_data, bias_c_data, weight_hc_data, opt);
+    }
+    if (ret != 0)
+        return ret;
+
+    top_blobs[0] = top_blobs0[0];
+    top_blobs[1] = hidden_states[0];
+
+    return 0;
+#else
+    return GRU::forward(bottom_blobs, top_blobs, opt);
+#endif
+}
+
+int GRU_x86_avx2::forward_batch(const std::vector<Mat>& bottom_blobs, std::vector<Mat>& top_blobs, const Option& opt) const
+{
+#if __AVX__
+    if (weight_xc_data.elemsize == 1u)
+    {
+        return GRU::forward_batch(bottom_blobs, top_blobs, opt);
+    }
+
+    const int batch = (int)bottom_blobs.size();
+    const int num_directions = direction == 2 ? 2 : 1;
+
+    top_blobs.resize(batch);
+
+    // initial hidden state
+    std::vector<Mat> hidden_states(batch);
+    for (int n = 0; n < batch; n++)
+    {
+        hidden_states[n].create(num_output, num_directions, 4u, opt.workspace_allocator);
+        if (hidden_states[n].empty())
+            return -100;
+        hidden_states[n].fill(0.f);
+
+        top_blobs[n].create(num_output * num_directions, bottom_blobs[n].h, 4u, opt.blob_allocator);
+        if (top_blobs[n].empty())
+            return -100;
+    }
+
+    if (opt.use_fp16_storage)
+    {
+        return gru<unsigned short>(bottom_blobs, top_blobs, hidden_states, direction, weight_xc_data_fp16, bias_c_data, weight_hc_data_fp16, opt);
+    }
+
+    return gru<float>(bottom_blobs, top_blobs, hidden_states, direction, weight_xc_data, bias_c_data, weight_hc_data, opt);
+#else
+    return GRU::forward_batch(bottom_blobs, top_blobs, opt);
+#endif
+}
+
+} // namespace ncnn
@@ -0,0 +1,94 @@
+// Tencent is pleased to support the open source community by making ncnn available.
+//
+// Copyright (C) 2020 THL A29 Limited, a Tencent company. All rights reserved.
+//
+// Licensed under the BSD 3-Clause License (the "License"); you may not use this file except
+// in compliance with the License. You may obtain a copy of the License at
+//
+// https://opensource.org/licenses/BSD-3-Clause
+//
+// Unless required by applicable law or agreed to in writing, software distributed
+// under the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR
+// CONDITIONS OF ANY KIND, either express or implied. See the License for the
+// specific language governing permissions and limitations under the License.
+
+#include "instancenorm_x86_avx2.h"
+
+#include <math.h>
+
+#if __AVX__
+#include <immintrin.h>
+#endif // __AVX__
+
+namespace ncnn {
+
+DEFINE_LAYER_CREATOR(InstanceNorm_x86_avx2)
+
+InstanceNorm_x86_avx2::InstanceNorm_x86_avx2()
+{
+#if __AVX__
+    support_packing = true;
+#endif // __AVX__
+}
+
+int InstanceNorm_x86_avx2::forward_inplace(Mat& bottom_top_blob, const Option& opt) const
+{
+#if __AVX__
+    int elempack = bottom_top_blob.elempack;
+
+    if (elempack == 8)
+    {
+        // x = (x - mean) / (sqrt(var) + eps) * gamma + beta
+
+        int w = bottom_top_blob.w;
+        int h = bottom_top_blob.h;
+        int c = bottom_top_blob.c;
+        int size = w * h;
+
+        const __m256 _size = _mm256_set1_ps((float)size);
+        const __m256 _eps = _mm256_set1_ps(eps);
+
+        #pragma omp parallel for num_threads(opt.num_threads)
+        for (int q = 0; q < c; q++)
+        {
+            float* ptr = bottom_top_blob.channel(q);
+
+            // mean and var
+            __m256 _sum = _mm256_setzero_ps();
+            for (int i = 0; i < size; i++)
+            {
+                _sum = _mm256_add_ps(_sum, _mm256_loadu_ps(ptr + i * 8));
+            }
+            __m256 _mean = _mm256_div_ps(_sum, _size);
+
+            __m256 _sqsum = _mm256_setzero_ps();
+            for (int i = 0; i < size; i++)
+            {
+                __m256 _tmp = _mm256_sub_ps(_mm256_loadu_ps(ptr + i * 8), _mean);
+                _sqsum = _mm256_fmadd_ps(_tmp, _tmp, _sqsum);
+            }
+            __m256 _var = _mm256_div_ps(_sqsum, _size);
+
+            __m256 _gamma = _mm256_loadu_ps((const float*)gamma_data + q * 8);
+            __m256 _beta = _mm256_loadu_ps((const float*)beta_data + q * 8);
+
+            __m256 _a = _mm256_div_ps(_gamma, _mm256_sqrt_ps(_mm256_add_ps(_var, _eps)));
+            __m256 _b = _mm256_sub_ps(_beta, _mm256_mul_ps(_mean, _a));
+
+            for (int i = 0; i < size; i++)
+            {
+                __m256 _p = _mm256_loadu_ps(ptr);
+                _p = _mm256_fmadd_ps(_p, _a, _b);
+                _mm256_storeu_ps(ptr, _p);
+                ptr += 8;
+            }
+        }
+
+        return 0;
+    }
+#endif // __AVX__
+
+    return InstanceNorm::forward_inplace(bottom_top_blob, opt);
+}
+
+} // namespace ncnn
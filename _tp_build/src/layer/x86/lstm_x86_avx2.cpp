@@ -0,0 +1,289 @@
+// Tencent is pleased to support the open source community by making ncnn available.
+//
+// Copyright (C) 2017 THL A29 Limited, a Tencent company. All rights reserved.
+//
+// Licensed under the BSD 3-Clause License (the "License"); you may not use this file except
+// in compliance with the License. You may obtain a copy of the License at
+//
+// https://opensource.org/licenses/BSD-3-Clause
+//
+// Unless required by applicable law or agreed to in writing, software distributed
+// under the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR
+// CONDITIONS OF ANY KIND, either express or implied. See the License for the
+// specific language governing permissions and limitations under the License.
+#ifdef __AVX__
+#include "avx_activation.h"
+#include "avx_usability.h"
+#endif // __AVX__
+
+#include "lstm_x86_avx2.h"
+
+#include <math.h>
+#include <string.h>
+
+#include <algorithm>
+
+#include "layer_type.h"
+
+namespace ncnn {
+
+#ifdef __AVX__
+#include "rnn_gemm.h"
+#endif // __AVX__
+
+DEFINE_LAYER_CREATOR(LSTM_x86_avx2)
+
+LSTM_x86_avx2::LSTM_x86_avx2()
+{
+    one_blob_only = false;
+    support_inplace = false;
+    support_batch = true;
+}
+int LSTM_x86_avx2::create_pipeline(const Option& opt)
+{
+#if __AVX__
+    if (opt.use_fp16_storage && weight_xc_data.elemsize == 4u)
+    {
+        ncnn::cast_float32_to_float16(weight_xc_data, weight_xc_data_fp16, opt);
+        ncnn::cast_float32_to_float16(weight_hc_data, weight_hc_data_fp16, opt);
+    }
+#else
+    (void)opt;
+#endif // __AVX__
+
+    return 0;
+}
+#ifdef __AVX__
+
+// runs all sequences in all directions together, one timestep after another
+// the recurrent part of a timestep is split over blocks of 8 hidden units of every sequence
+template<typename WT>
+static int lstm(const std::vector<Mat>& bottom_blobs, std::vector<Mat>& top_blobs, std::vector<Mat>& hidden_states, std::vector<Mat>& cell_states, int direction, const Mat& weight_xc, const Mat& bias_c, const Mat& weight_hc, const Option& opt)
+{
+    const int num_directions = direction == 2 ? 2 : 1;
+    const int num_sequences = (int)bottom_blobs.size() * num_directions;
+
+    const int num_output = weight_hc.w;
+
+    // 4 x num_output gates of every timestep
+    std::vector<Mat> gates(num_sequences);
+    int max_T = 0;
+    for (int s = 0; s < num_sequences; s++)
+    {
+        const Mat& bottom_blob = bottom_blobs[s / num_directions];
+        const int d = s % num_directions;
+
+        gates[s].create(num_output * 4, bottom_blob.h, 4u, opt.workspace_allocator);
+        if (gates[s].empty())
+            return -100;
+
+        rnn_input_gemm<WT>(bottom_blob, gates[s], weight_xc.channel(d), bias_c.channel(d), opt);
+
+        max_T = std::max(max_T, bottom_blob.h);
+    }
+
+    const int nn_num_output = (num_output + 7) / 8;
+
+    // unroll
+    for (int t = 0; t < max_T; t++)
+    {
+        #pragma omp parallel for num_threads(opt.num_threads)
+        for (int i = 0; i < num_sequences * nn_num_output; i++)
+        {
+            const int s = i / nn_num_output;
+            int q = (i % nn_num_output) * 8;
+
+            const int T = gates[s].h;
+            if (t >= T)
+                continue;
+
+            const int b = s / num_directions;
+            const int d = s % num_directions;
+            const int reverse = direction == 2 ? d : direction;
+            const int ti = reverse ? T - 1 - t : t;
+
+            // the previous hidden state is the output of the previous timestep
+            const float* hidden_ptr = t == 0 ? (const float*)hidden_states[b].row(d) : (const float*)top_blobs[b].row(reverse ? ti + 1 : ti - 1) + d * num_output;
+
+            const Mat weight_hc_d = weight_hc.channel(d);
+
+            // gate I F O G
+            const float* gates_data = gates[s].row(ti);
+            float* cell_ptr = cell_states[b].row(d);
+            float* output_data = (float*)top_blobs[b].row(ti) + d * num_output;
+
+            // lstm unit
+            // sigmoid(I)
+            // sigmoid(F)
+            // sigmoid(O)
+            // tanh(G)
+            // c_t := f_t .* c_{t-1} + i_t .* g_t
+            // h_t := o_t .* tanh[c_t]
+            if (q + 7 < num_output)
+            {
+                __m256 _I = _mm256_add_ps(_mm256_loadu_ps(gates_data + num_output * 0 + q), rnn_dot8<WT>(weight_hc_d, num_output * 0 + q, hidden_ptr, num_output));
+                __m256 _F = _mm256_add_ps(_mm256_loadu_ps(gates_data + num_output * 1 + q), rnn_dot8<WT>(weight_hc_d, num_output * 1 + q, hidden_ptr, num_output));
+                __m256 _O = _mm256_add_ps(_mm256_loadu_ps(gates_data + num_output * 2 + q), rnn_dot8<WT>(weight_hc_d, num_output * 2 + q, hidden_ptr, num_output));
+                __m256 _G = _mm256_add_ps(_mm256_loadu_ps(gates_data + num_output * 3 + q), rnn_dot8<WT>(weight_hc_d, num_output * 3 + q, hidden_ptr, num_output));
+
+                _I = sigmoid_avx(_I);
+                _F = sigmoid_avx(_F);
+                _O = sigmoid_avx(_O);
+                _G = tanh_avx(_G);
+
+                __m256 _cell2 = _mm256_add_ps(_mm256_mul_ps(_F, _mm256_loadu_ps(cell_ptr + q)), _mm256_mul_ps(_I, _G));
+                __m256 _H = _mm256_mul_ps(_O, tanh_avx(_cell2));
+                _mm256_storeu_ps(cell_ptr + q, _cell2);
+                _mm256_storeu_ps(output_data + q, _H);
+                continue;
+            }
+
+            for (; q < num_output; q++)
+            {
+                float I = gates_data[num_output * 0 + q] + rnn_dot(weight_hc_d.row<const WT>(num_output * 0 + q), hidden_ptr, num_output);
+                float F = gates_data[num_output * 1 + q] + rnn_dot(weight_hc_d.row<const WT>(num_output * 1 + q), hidden_ptr, num_output);
+                float O = gates_data[num_output * 2 + q] + rnn_dot(weight_hc_d.row<const WT>(num_output * 2 + q), hidden_ptr, num_output);
+                float G = gates_data[num_output * 3 + q] + rnn_dot(weight_hc_d.row<const WT>(num_output * 3 + q), hidden_ptr, num_output);
+
+                I = 1.f / (1.f + exp(-I));
+                F = 1.f / (1.f + exp(-F));
+                O = 1.f / (1.f + exp(-O));
+                G = tanh(G);
+
+                float cell2 = F * cell_ptr[q] + I * G;
+                float H = O * tanh(cell2);
+                cell_ptr[q] = cell2;
+                output_data[q] = H;
+            }
+        }
+    }
+
+    // keep the last hidden state
+    for (int s = 0; s < num_sequences; s++)
+    {
+        const int T = gates[s].h;
+        if (T == 0)
+            continue;
+
+        const int b = s / num_directions;
+        const int d = s % num_directions;
+        const int reverse = direction == 2 ? d : direction;
+
+        const float* ptr = (const float*)top_blobs[b].row(reverse ? 0 : T - 1) + d * num_output;
+        memcpy(hidden_states[b].row(d), ptr, num_output * sizeof(float));
+    }
+
+    return 0;
+}
+#endif // __AVX__
+
+int LSTM_x86_avx2::forward(const Mat& bottom_blob, Mat& top_blob, const Option& opt) const
+{
+    std::vector<Mat> bottom_blobs(1, bottom_blob);
+    std::vector<Mat> top_blobs(1);
+    int ret = LSTM_x86_avx2::forward_batch(bottom_blobs, top_blobs, opt);
+    if (ret != 0)
+        return ret;
+
+    top_blob = top_blobs[0];
+
+    return 0;
+}
+
+int LSTM_x86_avx2::forward(const std::vector<Mat>& bottom_blobs, std::vector<Mat>& top_blobs, const Option& opt) const
+{
+#if __AVX__
+    if (weight_xc_data.elemsize == 1u)
+    {
+        return LSTM::forward(bottom_blobs, top_blobs, opt);
+    }
+
+    if (bottom_blobs.size() != 3 || top_blobs.size() != 3)
+    {
+        return forward(bottom_blobs[0], top_blobs[0], opt);
+    }
+    const Mat& bottom_blob = bottom_blobs[0];
+    int T = bottom_blob.h;
+
+    std::vector<Mat> hidden_states(1);
+    std::vector<Mat> cell_states(1);
+
+    //Copy previous states
+    hidden_states[0] = bottom_blobs[1].clone(opt.blob_allocator);
+    cell_states[0] = bottom_blobs[2].clone(opt.blob_allocator);
+    if (hidden_states[0].empty() || cell_states[0].empty())
+        return -100;
+
+    std::vector<Mat> top_blobs0(1);
+    top_blobs0[0].create(num_output, T, 4u, opt.blob_allocator);
+    if (top_blobs0[0].empty())
+        return -100;
+
+    // Uni directional
+    int ret = 0;
+    if (opt.use_fp16_storage)
+    {
+        ret = lstm<unsigned short>(std::vector<Mat>(1, bottom_blob), top_blobs0, hidden_states, cell_states, direction, weight_xc_data_fp16, bias_c_data, weight_hc_data_fp16, opt);
+    }
+    else
+    {
+        ret = lstm<float>(std::vector<Mat>(1, bottom_blob), top_blobs0, hidden_states, cell_states, direction, weight_xc_data, bias_c_data, weight_hc_data, opt);
+    }
+    if (ret != 0)
+        return ret;
+
+    top_blobs[0] = top_blobs0[0];
+    top_blobs[1] = hidden_states[0];
+    top_blobs[2] = cell_states[0];
+
+    return 0;
+#else
+    return LSTM::forward(bottom_blobs, top_blobs, opt);
+#endif
+}
+
+int LSTM_x86_avx2::forward_batch(const std::vector<Mat>& bottom_blobs, std::vector<Mat>& top_blobs, const Option& opt) const
+{
+#if __AVX__
+    if (weight_xc_data.elemsize == 1u)
+    {
+        return LSTM::forward_batch(bottom_blobs, top_blobs, opt);
+    }
+
+    const int batch = (int)bottom_blobs.size();
+    const int num_directions = direction == 2 ? 2 : 1;
+
+    top_blobs.resize(batch);
+
+    // initial hidden and cell state
+    std::vector<Mat> hidden_states(batch);
+    std::vector<Mat> cell_states(batch);
+    for (int n = 0; n < batch; n++)
+    {
+        hidden_states[n].create(num_output, num_directions, 4u, opt.workspace_allocator);
+        if (hidden_states[n].empty())
+            return -100;
+        hidden_states[n].fill(0.f);
+
+        cell_states[n].create(num_output, num_directions, 4u, opt.workspace_allocator);
+        if (cell_states[n].empty())
+            return -100;
+        cell_states[n].fill(0.f);
+
+        top_blobs[n].create(num_output * num_directions, bottom_blobs[n].h, 4u, opt.blob_allocator);
+        if (top_blobs[n].empty())
+            return -100;
+    }
+
+    if (opt.use_fp16_storage)
+    {
+        return lstm<unsigned short>(bottom_blobs, top_blobs, hidden_states, cell_states, direction, weight_xc_data_fp16, bias_c_data, weight_hc_data_fp16, opt);
+    }
+
+    return lstm<float>(bottom_blobs, top_blobs, hidden_states, cell_states, direction, weight_xc_data, bias_c_data, weight_hc_data, opt);
+#else
+    return LSTM::forward_batch(bottom_blobs, top_blobs, opt);
+#endif
+}
+
+} // namespace ncnn
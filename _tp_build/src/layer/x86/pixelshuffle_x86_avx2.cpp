@@ -0,0 +1,92 @@
+// Tencent is pleased to support the open source community by making ncnn available.
+//
+// Copyright (C) 2020 THL A29 Limited, a Tencent company. All rights reserved.
+//
+// Licensed under the BSD 3-Clause License (the "License"); you may not use this file except
+// in compliance with the License. You may obtain a copy of the License at
+//
+// https://opensource.org/licenses/BSD-3-Clause
+//
+// Unless required by applicable law or agreed to in writing, software distributed
+// under the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR
+// CONDITIONS OF ANY KIND, either express or implied. See the License for the
+// specific language governing permissions and limitations under the License.
+
+
+#include "pixelshuffle_x86_avx2.h"
+
+namespace ncnn {
+
+DEFINE_LAYER_CREATOR(PixelShuffle_x86_avx2)
+
+PixelShuffle_x86_avx2::PixelShuffle_x86_avx2()
+{
+#if __AVX__
+    support_packing = true;
+#endif // __AVX__
+}
+
+int PixelShuffle_x86_avx2::forward(const Mat& bottom_blob, Mat& top_blob, const Option& opt) const
+{
+#if __AVX__
+    int elempack = bottom_blob.elempack;
+
+    if (elempack == 8)
+    {
+        int w = bottom_blob.w;
+        int h = bottom_blob.h;
+        int channels = bottom_blob.c * elempack;
+        size_t elemsize = bottom_blob.elemsize;
+
+        int outw = w * upscale_factor;
+        int outh = h * upscale_factor;
+        int outc = channels / (upscale_factor * upscale_factor);
+
+        int out_elempack = opt.use_packing_layout && outc % 8 == 0 ? 8 : 1;
+        size_t out_elemsize = elemsize / elempack * out_elempack;
+
+        top_blob.create(outw, outh, outc / out_elempack, out_elemsize, out_elempack, opt.blob_allocator);
+        if (top_blob.empty())
+            return -100;
+
+        // the source channels of one output pack are upscale_factor^2 apart,
+        // so each output lane is gathered from its own input pack and lane
+        #pragma omp parallel for num_threads(opt.num_threads)
+        for (int p = 0; p < top_blob.c; p++)
+        {
+            Mat m = top_blob.channel(p);
+
+            for (int k = 0; k < out_elempack; k++)
+            {
+                for (int sh = 0; sh < upscale_factor; sh++)
+                {
+                    for (int sw = 0; sw < upscale_factor; sw++)
+                    {
+                        int q = (p * out_elempack + k) * upscale_factor * upscale_factor + sh * upscale_factor + sw;
+
+                        const float* sptr = (const float*)bottom_blob.channel(q / 8) + q % 8;
+
+                        for (int i = 0; i < h; i++)
+                        {
+                            float* outptr = (float*)m.row(i * upscale_factor + sh) + sw * out_elempack + k;
+                            for (int j = 0; j < w; j++)
+                            {
+                                outptr[0] = sptr[0];
+
+                                sptr += 8;
+                                outptr += upscale_factor * out_elempack;
+                            }
+                        }
+                    }
+                }
+            }
+        }
+
+        return 0;
+    }
+#endif // __AVX__
+
+    return PixelShuffle::forward(bottom_blob, top_blob, opt);
+}
+
+} // namespace ncnn
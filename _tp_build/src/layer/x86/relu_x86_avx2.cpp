@@ -0,0 +1,160 @@
+// Tencent is pleased to support the open source community by making ncnn available.
+//
+// Copyright (C) 2017 THL A29 Limited, a Tencent company. All rights reserved.
+//
+// Licensed under the BSD 3-Clause License (the "License"); you may not use this file except
+// in compliance with the License. You may obtain a copy of the License at
+//
+// https://opensource.org/licenses/BSD-3-Clause
+//
+// Unless required by applicable law or agreed to in writing, software distributed
+// under the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR
+// CONDITIONS OF ANY KIND, either express or implied. See the License for the
+// specific language governing permissions and limitations under the License.
+#include <algorithm>
+
+#include <emmintrin.h>
+
+#if __AVX__
+#include "avx_activation.h"
+#endif // __AVX__
+
+#include "relu_x86_avx2.h"
+
+namespace ncnn {
+
+DEFINE_LAYER_CREATOR(ReLU_x86_avx2)
+
+ReLU_x86_avx2::ReLU_x86_avx2()
+{
+#if __AVX__
+    support_packing = true;
+#endif // __AVX__
+}
+
+int ReLU_x86_avx2::forward_inplace(Mat& bottom_top_blob, const Option& opt) const
+{
+    if (bottom_top_blob.elemsize / bottom_top_blob.elempack == 1u)
+        return forward_inplace_int8_x86(bottom_top_blob, opt);
+
+    int w = bottom_top_blob.w;
+    int h = bottom_top_blob.h;
+    int channels = bottom_top_blob.c;
+    int size = w * h;
+    int elempack = bottom_top_blob.elempack;
+
+#if __AVX__
+    if (elempack == 8)
+    {
+        if (slope == 0.f)
+        {
+            #pragma omp parallel for num_threads(opt.num_threads)
+            for (int q = 0; q < channels; q++)
+            {
+                float* ptr = bottom_top_blob.channel(q);
+                __m256 _zero = _mm256_set1_ps(0.f);
+                for (int i = 0; i < size; i++)
+                {
+                    __m256 _p = _mm256_loadu_ps(ptr);
+                    _mm256_storeu_ps(ptr, _mm256_max_ps(_zero, _p));
+                    ptr += 8;
+                }
+            }
+        }
+        else
+        {
+            #pragma omp parallel for num_threads(opt.num_threads)
+            for (int q = 0; q < channels; q++)
+            {
+                float* ptr = bottom_top_blob.channel(q);
+                __m256 _zero = _mm256_set1_ps(0.f);
+                for (int i = 0; i < size; i++)
+                {
+                    __m256 _p = _mm256_loadu_ps(ptr);
+                    _mm256_storeu_ps(ptr, lrelu_avx(_p, slope));
+                    ptr += 8;
+                }
+            }
+        }
+
+        return 0;
+    }
+#endif // __AVX__
+
+    if (slope == 0.f)
+    {
+        #pragma omp parallel for num_threads(opt.num_threads)
+        for (int q = 0; q < channels; q++)
+        {
+            float* ptr = bottom_top_blob.channel(q);
+
+            int remain = size;
+            for (; remain > 0; remain--)
+            {
+                *ptr = std::max(*ptr, 0.f);
+
+                ptr++;
+            }
+        }
+    }
+    else
+    {
+        #pragma omp parallel for num_threads(opt.num_threads)
+        for (int q = 0; q < channels; q++)
+        {
+            float* ptr = bottom_top_blob.channel(q);
+            int remain = size;
+            for (; remain > 0; remain--)
+            {
+                if (*ptr < 0)
+                    *ptr *= slope;
+
+                ptr++;
+            }
+        }
+    }
+
+    return 0;
+}
+int ReLU_x86_avx2::forward_inplace_int8_x86(Mat& bottom_top_blob, const Option& opt) const
+{
+    int w = bottom_top_blob.w;
+    int h = bottom_top_blob.h;
+    int channels = bottom_top_blob.c;
+    int size = w * h * bottom_top_blob.elempack;
+
+    if (slope == 0.f)
+    {
+        #pragma omp parallel for num_threads(opt.num_threads)
+        for (int q = 0; q < channels; q++)
+        {
+            signed char* ptr = bottom_top_blob.channel(q);
+
+            int nn = size >> 4;
+            int remain = size - (nn << 4);
+
+            __m128i _zero = _mm_setzero_si128();
+            for (; nn > 0; nn--)
+            {
+                __m128i _p = _mm_loadu_si128((const __m128i*)ptr);
+                _p = _mm_and_si128(_p, _mm_cmpgt_epi8(_p, _zero));
+                _mm_storeu_si128((__m128i*)ptr, _p);
+
+                ptr += 16;
+            }
+            for (; remain > 0; remain--)
+            {
+                if (*ptr < 0)
+                    *ptr = 0;
+
+                ptr++;
+            }
+        }
+
+        return 0;
+    }
+
+    return ReLU::forward_inplace_int8(bottom_top_blob, opt);
+}
+
+} //namespace ncnn
@@ -0,0 +1,448 @@
+// Tencent is pleased to support the open source community by making ncnn available.
+//
+// Copyright (C) 2020 THL A29 Limited, a Tencent company. All rights reserved.
+//
+// Licensed under the BSD 3-Clause License (the "License"); you may not use this file except
+// in compliance with the License. You may obtain a copy of the License at
+//
+// https://opensource.org/licenses/BSD-3-Clause
+//
+// Unless required by applicable law or agreed to in writing, software distributed
+// under the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR
+// CONDITIONS OF ANY KIND, either express or implied. See the License for the
+// specific language governing permissions and limitations under the License.
+
+#include "softmax_x86_avx2.h"
+
+#include <algorithm>
+#include <float.h>
+#include <math.h>
+
+#if __AVX__
+#include "avx_mathfun.h"
+#include "avx_usability.h"
+#endif // __AVX__
+
+namespace ncnn {
+
+DEFINE_LAYER_CREATOR(Softmax_x86_avx2)
+
+Softmax_x86_avx2::Softmax_x86_avx2()
+{
+#if __AVX__
+    support_packing = true;
+#endif // __AVX__
+}
+
+int Softmax_x86_avx2::forward_inplace(Mat& bottom_top_blob, const Option& opt) const
+{
+#if __AVX__
+    int dims = bottom_top_blob.dims;
+    size_t elemsize = bottom_top_blob.elemsize;
+    int elempack = bottom_top_blob.elempack;
+
+    if (elempack == 8)
+    {
+        if (dims == 1) // axis == 0
+        {
+            int w = bottom_top_blob.w;
+
+            float* ptr = bottom_top_blob;
+
+            __m256 _max = _mm256_set1_ps(-FLT_MAX);
+            for (int i = 0; i < w; i++)
+            {
+                __m256 _p = _mm256_loadu_ps(ptr + i * 8);
+                _max = _mm256_max_ps(_max, _p);
+            }
+            _max = _mm256_set1_ps(_mm256_reduce_max_ps(_max));
+
+            __m256 _sum = _mm256_setzero_ps();
+            for (int i = 0; i < w; i++)
+            {
+                __m256 _p = _mm256_loadu_ps(ptr + i * 8);
+                _p = exp256_ps(_mm256_sub_ps(_p, _max));
+                _mm256_storeu_ps(ptr + i * 8, _p);
+                _sum = _mm256_add_ps(_sum, _p);
+            }
+            _sum = _mm256_set1_ps(_mm256_reduce_add_ps(_sum));
+
+            for (int i = 0; i < w; i++)
+            {
+                __m256 _p = _mm256_loadu_ps(ptr + i * 8);
+                _p = _mm256_div_ps(_p, _sum);
+                _mm256_storeu_ps(ptr + i * 8, _p);
+            }
+
+            return 0;
+        }
+
+        if (dims == 2 && axis == 0)
+        {
+            int w = bottom_top_blob.w;
+            int h = bottom_top_blob.h;
+
+            Mat max;
+            max.create(w, 4u, 1, opt.workspace_allocator);
+            if (max.empty())
+                return -100;
+            max.fill(-FLT_MAX);
+
+            for (int i = 0; i < h; i++)
+            {
+                const float* ptr = bottom_top_blob.row(i);
+                for (int j = 0; j < w; j++)
+                {
+                    __m256 _p = _mm256_loadu_ps(ptr);
+                    max[j] = std::max(max[j], _mm256_reduce_max_ps(_p));
+                    ptr += 8;
+                }
+            }
+
+            Mat sum;
+            sum.create(w, 4u, 1, opt.workspace_allocator);
+            if (sum.empty())
+                return -100;
+            sum.fill(0.f);
+
+            for (int i = 0; i < h; i++)
+            {
+                float* ptr = bottom_top_blob.row(i);
+                for (int j = 0; j < w; j++)
+                {
+                    __m256 _p = _mm256_loadu_ps(ptr);
+                    __m256 _max = _mm256_set1_ps(max[j]);
+                    _p = exp256_ps(_mm256_sub_ps(_p, _max));
+                    _mm256_storeu_ps(ptr, _p);
+                    sum[j] += _mm256_reduce_add_ps(_p);
+                    ptr += 8;
+                }
+            }
+
+            for (int i = 0; i < h; i++)
+            {
+                float* ptr = bottom_top_blob.row(i);
+                for (int j = 0; j < w; j++)
+                {
+                    __m256 _p = _mm256_loadu_ps(ptr);
+                    __m256 _sum = _mm256_set1_ps(sum[j]);
+                    _p = _mm256_div_ps(_p, _sum);
+                    _mm256_storeu_ps(ptr, _p);
+                    ptr += 8;
+                }
+            }
+
+            return 0;
+        }
+
+        if (dims == 2 && axis == 1)
+        {
+            int w = bottom_top_blob.w;
+            int h = bottom_top_blob.h;
+
+            #pragma omp parallel for num_threads(opt.num_threads)
+            for (int i = 0; i < h; i++)
+            {
+                float* ptr = bottom_top_blob.row(i);
+
+                __m256 _max = _mm256_set1_ps(-FLT_MAX);
+                for (int j = 0; j < w; j++)
+                {
+                    __m256 _p = _mm256_loadu_ps(ptr + j * 8);
+                    _max = _mm256_max_ps(_max, _p);
+                }
+
+                __m256 _sum = _mm256_setzero_ps();
+                for (int j = 0; j < w; j++)
+                {
+                    __m256 _p = _mm256_loadu_ps(ptr + j * 8);
+                    _p = exp256_ps(_mm256_sub_ps(_p, _max));
+                    _mm256_storeu_ps(ptr + j * 8, _p);
+                    _sum = _mm256_add_ps(_sum, _p);
+                }
+
+                for (int j = 0; j < w; j++)
+                {
+                    __m256 _p = _mm256_loadu_ps(ptr + j * 8);
+                    _p = _mm256_div_ps(_p, _sum);
+                    _mm256_storeu_ps(ptr + j * 8, _p);
+                }
+            }
+
+            return 0;
+        }
+
+        if (dims == 3 && axis == 0)
+        {
+            int w = bottom_top_blob.w;
+            int h = bottom_top_blob.h;
+            int channels = bottom_top_blob.c;
+            int size = w * h;
+
+            Mat max;
+            max.create(w, h, 4u, 1, opt.workspace_allocator);
+            if (max.empty())
+                return -100;
+            max.fill(-FLT_MAX);
+            for (int q = 0; q < channels; q++)
+            {
+                const float* ptr = bottom_top_blob.channel(q);
+
+                for (int i = 0; i < size; i++)
+                {
+                    __m256 _p = _mm256_loadu_ps(ptr);
+                    max[i] = std::max(max[i], _mm256_reduce_max_ps(_p));
+                    ptr += 8;
+                }
+            }
+
+            Mat sum;
+            sum.create(w, h, 4u, 1, opt.workspace_allocator);
+            if (sum.empty())
+                return -100;
+            sum.fill(0.f);
+            for (int q = 0; q < channels; q++)
+            {
+                float* ptr = bottom_top_blob.channel(q);
+
+                for (int i = 0; i < size; i++)
+                {
+                    __m256 _p = _mm256_loadu_ps(ptr);
+                    __m256 _max = _mm256_set1_ps(max[i]);
+                    _p = exp256_ps(_mm256_sub_ps(_p, _max));
+                    _mm256_storeu_ps(ptr, _p);
+                    sum[i] += _mm256_reduce_add_ps(_p);
+                    ptr += 8;
+                }
+            }
+
+            #pragma omp parallel for num_threads(opt.num_threads)
+            for (int q = 0; q < channels; q++)
+            {
+                float* ptr = bottom_top_blob.channel(q);
+
+                for (int i = 0; i < size; i++)
+                {
+                    __m256 _p = _mm256_loadu_ps(ptr);
+                    __m256 _sum = _mm256_set1_ps(sum[i]);
+                    _p = _mm256_div_ps(_p, _sum);
+                    _mm256_storeu_ps(ptr, _p);
+                    ptr += 8;
+                }
+            }
+
+            return 0;
+        }
+
+        if (dims == 3 && axis == 1)
+        {
+            int w = bottom_top_blob.w;
+            int h = bottom_top_blob.h;
+            int channels = bottom_top_blob.c;
+
+            Mat max;
+            max.create(w, channels, elemsize, elempack, opt.workspace_allocator);
+            if (max.empty())
+                return -100;
+            max.fill(_mm256_set1_ps(-FLT_MAX));
+            #pragma omp parallel for num_threads(opt.num_threads)
+            for (int q = 0; q < channels; q++)
+            {
+                const float* ptr = bottom_top_blob.channel(q);
+
+                for (int i = 0; i < h; i++)
+                {
+                    float* maxptr = max.row(q);
+
+                    for (int j = 0; j < w; j++)
+                    {
+                        __m256 _p = _mm256_loadu_ps(ptr);
+                        __m256 _max = _mm256_loadu_ps(maxptr);
+                        _max = _mm256_max_ps(_max, _p);
+                        _mm256_storeu_ps(maxptr, _max);
+                        ptr += 8;
+                        maxptr += 8;
+                    }
+                }
+            }
+
+            Mat sum;
+            sum.create(w, channels, elemsize, elempack, opt.workspace_allocator);
+            if (sum.empty())
+                return -100;
+            sum.fill(_mm256_setzero_ps());
+            #pragma omp parallel for num_threads(opt.num_threads)
+            for (int q = 0; q < channels; q++)
+            {
+                float* ptr = bottom_top_blob.channel(q);
+
+                for (int i = 0; i < h; i++)
+                {
+                    float* maxptr = max.row(q);
+                    float* sumptr = sum.row(q);
+
+                    for (int j = 0; j < w; j++)
+                    {
+                        __m256 _p = _mm256_loadu_ps(ptr);
+                        __m256 _max = _mm256_loadu_ps(maxptr);
+                        _p = exp256_ps(_mm256_sub_ps(_p, _max));
+                        _mm256_storeu_ps(ptr, _p);
+                        __m256 _sum = _mm256_loadu_ps(sumptr);
+                        _sum = _mm256_add_ps(_sum, _p);
+                        _mm256_storeu_ps(sumptr, _sum);
+                        ptr += 8;
+                        maxptr += 8;
+                        sumptr += 8;
+                    }
+                }
+            }
+
+            #pragma omp parallel for num_threads(opt.num_threads)
+            for (int q = 0; q < channels; q++)
+            {
+                float* ptr = bottom_top_blob.channel(q);
+
+                for (int i = 0; i < h; i++)
+                {
+                    float* sumptr = sum.row(q);
+
+                    for (int j = 0; j < w; j++)
+                    {
+                        __m256 _p = _mm256_loadu_ps(ptr);
+                        __m256 _sum = _mm256_loadu_ps(sumptr);
+                        _p = _mm256_div_ps(_p, _sum);
+                        _mm256_storeu_ps(ptr, _p);
+                        ptr += 8;
+                        sumptr += 8;
+                    }
+                }
+            }
+
+            return 0;
+        }
+
+        if (dims == 3 && axis == 2)
+        {
+            int w = bottom_top_blob.w;
+            int h = bottom_top_blob.h;
+            int channels = bottom_top_blob.c;
+
+            #pragma omp parallel for num_threads(opt.num_threads)
+            for (int q = 0; q < channels; q++)
+            {
+                float* ptr = bottom_top_blob.channel(q);
+
+                for (int i = 0; i < h; i++)
+                {
+                    __m256 _max = _mm256_set1_ps(-FLT_MAX);
+                    for (int j = 0; j < w; j++)
+                    {
+                        __m256 _p = _mm256_loadu_ps(ptr + j * 8);
+                        _max = _mm256_max_ps(_max, _p);
+                    }
+
+                    __m256 _sum = _mm256_setzero_ps();
+                    for (int j = 0; j < w; j++)
+                    {
+                        __m256 _p = _mm256_loadu_ps(ptr + j * 8);
+                        _p = exp256_ps(_mm256_sub_ps(_p, _max));
+                        _mm256_storeu_ps(ptr + j * 8, _p);
+                        _sum = _mm256_add_ps(_sum, _p);
+                    }
+
+                    for (int j = 0; j < w; j++)
+                    {
+                        __m256 _p = _mm256_loadu_ps(ptr + j * 8);
+                        _p = _mm256_div_ps(_p, _sum);
+                        _mm256_storeu_ps(ptr + j * 8, _p);
+                    }
+
+                    ptr += w * 8;
+                }
+            }
+
+            return 0;
+        }
+
+        return 0;
+    }
+
+    if (dims == 3 && axis == 0)
+    {
+        // vectorize across the spatial positions, each reduced over the channels
+        int w = bottom_top_blob.w;
+        int h = bottom_top_blob.h;
+        int channels = bottom_top_blob.c;
+        int size = w * h;
+
+        Mat max;
+        max.create(w, h, elemsize, opt.workspace_allocator);
+        if (max.empty())
+            return -100;
+        max.fill(-FLT_MAX);
+        for (int q = 0; q < channels; q++)
+        {
+            const float* ptr = bottom_top_blob.channel(q);
+            float* maxptr = max;
+
+            int i = 0;
+            for (; i + 7 < size; i += 8)
+            {
+                _mm256_storeu_ps(maxptr + i, _mm256_max_ps(_mm256_loadu_ps(maxptr + i), _mm256_loadu_ps(ptr + i)));
+            }
+            for (; i < size; i++)
+            {
+                maxptr[i] = std::max(maxptr[i], ptr[i]);
+            }
+        }
+
+        Mat sum;
+        sum.create(w, h, elemsize, opt.workspace_allocator);
+        if (sum.empty())
+            return -100;
+        sum.fill(0.f);
+        for (int q = 0; q < channels; q++)
+        {
+            float* ptr = bottom_top_blob.channel(q);
+            const float* maxptr = max;
+            float* sumptr = sum;
+
+            int i = 0;
+            for (; i + 7 < size; i += 8)
+            {
+                __m256 _p = exp256_ps(_mm256_sub_ps(_mm256_loadu_ps(ptr + i), _mm256_loadu_ps(maxptr + i)));
+                _mm256_storeu_ps(ptr + i, _p);
+                _mm256_storeu_ps(sumptr + i, _mm256_add_ps(_mm256_loadu_ps(sumptr + i), _p));
+            }
+            for (; i < size; i++)
+            {
+                ptr[i] = (float)exp(ptr[i] - maxptr[i]);
+                sumptr[i] += ptr[i];
+            }
+        }
+
+        #pragma omp parallel for num_threads(opt.num_threads)
+        for (int q = 0; q < channels; q++)
+        {
+            float* ptr = bottom_top_blob.channel(q);
+            const float* sumptr = sum;
+
+            int i = 0;
+            for (; i + 7 < size; i += 8)
+            {
+                _mm256_storeu_ps(ptr + i, _mm256_div_ps(_mm256_loadu_ps(ptr + i), _mm256_loadu_ps(sumptr + i)));
+            }
+            for (; i < size; i++)
+            {
+                ptr[i] /= sumptr[i];
+            }
+        }
+
+        return 0;
+    }
+#endif // __AVX__
+
+    return Softmax::forward_inplace(bottom_top_blob, opt);
+}
+
+} // namespace ncnn
@@ -0,0 +1,6 @@
+// Layer Shader Spv Data header
+//
+// This file is auto-generated by cmake, don't edit it.
+
+
+
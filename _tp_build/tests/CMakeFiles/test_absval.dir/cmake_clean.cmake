@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/test_absval.dir/test_absval.cpp.o"
+  "CMakeFiles/test_absval.dir/test_absval.cpp.o.d"
+  "test_absval"
+  "test_absval.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/test_absval.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/test_crop.dir/test_crop.cpp.o"
+  "CMakeFiles/test_crop.dir/test_crop.cpp.o.d"
+  "test_crop"
+  "test_crop.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/test_crop.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
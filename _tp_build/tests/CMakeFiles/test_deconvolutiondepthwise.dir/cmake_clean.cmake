@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/test_deconvolutiondepthwise.dir/test_deconvolutiondepthwise.cpp.o"
+  "CMakeFiles/test_deconvolutiondepthwise.dir/test_deconvolutiondepthwise.cpp.o.d"
+  "test_deconvolutiondepthwise"
+  "test_deconvolutiondepthwise.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/test_deconvolutiondepthwise.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/test_hardsigmoid.dir/test_hardsigmoid.cpp.o"
+  "CMakeFiles/test_hardsigmoid.dir/test_hardsigmoid.cpp.o.d"
+  "test_hardsigmoid"
+  "test_hardsigmoid.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/test_hardsigmoid.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/test_instancenorm.dir/test_instancenorm.cpp.o"
+  "CMakeFiles/test_instancenorm.dir/test_instancenorm.cpp.o.d"
+  "test_instancenorm"
+  "test_instancenorm.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/test_instancenorm.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/test_mat_pixel_rotate.dir/test_mat_pixel_rotate.cpp.o"
+  "CMakeFiles/test_mat_pixel_rotate.dir/test_mat_pixel_rotate.cpp.o.d"
+  "test_mat_pixel_rotate"
+  "test_mat_pixel_rotate.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/test_mat_pixel_rotate.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
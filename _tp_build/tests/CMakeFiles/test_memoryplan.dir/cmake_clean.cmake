@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/test_memoryplan.dir/test_memoryplan.cpp.o"
+  "CMakeFiles/test_memoryplan.dir/test_memoryplan.cpp.o.d"
+  "test_memoryplan"
+  "test_memoryplan.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/test_memoryplan.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
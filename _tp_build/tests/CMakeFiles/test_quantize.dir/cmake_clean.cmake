@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/test_quantize.dir/test_quantize.cpp.o"
+  "CMakeFiles/test_quantize.dir/test_quantize.cpp.o.d"
+  "test_quantize"
+  "test_quantize.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/test_quantize.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
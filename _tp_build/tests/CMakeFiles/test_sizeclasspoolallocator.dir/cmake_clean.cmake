@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/test_sizeclasspoolallocator.dir/test_sizeclasspoolallocator.cpp.o"
+  "CMakeFiles/test_sizeclasspoolallocator.dir/test_sizeclasspoolallocator.cpp.o.d"
+  "test_sizeclasspoolallocator"
+  "test_sizeclasspoolallocator.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/test_sizeclasspoolallocator.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
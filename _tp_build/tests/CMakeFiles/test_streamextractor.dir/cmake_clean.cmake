@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/test_streamextractor.dir/test_streamextractor.cpp.o"
+  "CMakeFiles/test_streamextractor.dir/test_streamextractor.cpp.o.d"
+  "test_streamextractor"
+  "test_streamextractor.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/test_streamextractor.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/ncnn2container.dir/ncnn2container.cpp.o"
+  "CMakeFiles/ncnn2container.dir/ncnn2container.cpp.o.d"
+  "ncnn2container"
+  "ncnn2container.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/ncnn2container.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/ncnn2mem.dir/ncnn2mem.cpp.o"
+  "CMakeFiles/ncnn2mem.dir/ncnn2mem.cpp.o.d"
+  "ncnn2mem"
+  "ncnn2mem.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/ncnn2mem.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,15 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/caffe2ncnn.dir/caffe.pb.cc.o"
+  "CMakeFiles/caffe2ncnn.dir/caffe.pb.cc.o.d"
+  "CMakeFiles/caffe2ncnn.dir/caffe2ncnn.cpp.o"
+  "CMakeFiles/caffe2ncnn.dir/caffe2ncnn.cpp.o.d"
+  "caffe.pb.cc"
+  "caffe.pb.h"
+  "caffe2ncnn"
+  "caffe2ncnn.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/caffe2ncnn.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/darknet2ncnn.dir/darknet2ncnn.cpp.o"
+  "CMakeFiles/darknet2ncnn.dir/darknet2ncnn.cpp.o.d"
+  "darknet2ncnn"
+  "darknet2ncnn.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/darknet2ncnn.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,130 @@
+// Tencent is pleased to support the open source community by making ncnn available.
+//
+// Copyright (C) 2020 THL A29 Limited, a Tencent company. All rights reserved.
+//
+// Licensed under the BSD 3-Clause License (the "License"); you may not use this file except
+// in compliance with the License. You may obtain a copy of the License at
+//
+// https://opensource.org/licenses/BSD-3-Clause
+//
+// Unless required by applicable law or agreed to in writing, software distributed
+// under the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR
+// CONDITIONS OF ANY KIND, either express or implied. See the License for the
+// specific language governing permissions and limitations under the License.
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "benchmark.h"
+#include "layer.h"
+#include "layer_type.h"
+#include "mat.h"
+
+// the conversion path before layers were shared, one layer built per call
+static void convert_with_new_layer(int typeindex, const ncnn::ParamDict& pd, const ncnn::Mat& src, ncnn::Mat& dst, const ncnn::Option& opt)
+{
+    ncnn::Layer* op = ncnn::create_layer(typeindex);
+
+    op->load_param(pd);
+
+    op->create_pipeline(opt);
+
+    op->forward(src, dst, opt);
+
+    op->destroy_pipeline(opt);
+
+    delete op;
+}
+
+static void bench_packing(const ncnn::Mat& a, int elempack, int loop_count, const ncnn::Option& opt)
+{
+    ncnn::ParamDict pd;
+    pd.set(0, elempack);
+
+    ncnn::Mat b;
+
+    double start = ncnn::get_current_time();
+    for (int i = 0; i < loop_count; i++)
+    {
+        convert_with_new_layer(ncnn::LayerType::Packing, pd, a, b, opt);
+    }
+    double time_layer = (ncnn::get_current_time() - start) * 1000 / loop_count;
+
+    start = ncnn::get_current_time();
+    for (int i = 0; i < loop_count; i++)
+    {
+        ncnn::convert_packing(a, b, elempack, opt);
+    }
+    double time_shared = (ncnn::get_current_time() - start) * 1000 / loop_count;
+
+    fprintf(stderr, "packing %d -> %d  %4d x %4d x %4d   new layer = %8.2fus  shared = %8.2fus\n", a.elempack, elempack, a.w, a.h, a.c, time_layer, time_shared);
+}
+
+static void bench_cast(const ncnn::Mat& a, int type_from, int type_to, int loop_count, const ncnn::Option& opt)
+{
+    ncnn::ParamDict pd;
+    pd.set(0, type_from);
+    pd.set(1, type_to);
+
+    ncnn::Mat b;
+
+    double start = ncnn::get_current_time();
+    for (int i = 0; i < loop_count; i++)
+    {
+        convert_with_new_layer(ncnn::LayerType::Cast, pd, a, b, opt);
+    }
+    double time_layer = (ncnn::get_current_time() - start) * 1000 / loop_count;
+
+    start = ncnn::get_current_time();
+    for (int i = 0; i < loop_count; i++)
+    {
+        if (type_to == 4)
+            ncnn::cast_float32_to_bfloat16(a, b, opt);
+        else
+            ncnn::cast_bfloat16_to_float32(a, b, opt);
+    }
+    double time_shared = (ncnn::get_current_time() - start) * 1000 / loop_count;
+
+    fprintf(stderr, "cast %d -> %d     %4d x %4d x %4d   new layer = %8.2fus  shared = %8.2fus\n", type_from, type_to, a.w, a.h, a.c, time_layer, time_shared);
+}
+
+int main(int argc, char** argv)
+{
+    int loop_count = 10000;
+    if (argc >= 2)
+    {
+        loop_count = atoi(argv[1]);
+    }
+
+    ncnn::Option opt;
+    opt.num_threads = 1;
+
+#if __AVX__
+    const int elempack = 8;
+#else
+    const int elempack = 4;
+#endif
+
+    fprintf(stderr, "loop_count = %d\n", loop_count);
+
+    // layout conversion cost is dominated by setup for small blobs
+    const int sizes[3][3] = {{1, 1, 64}, {7, 7, 256}, {28, 28, 64}};
+    for (int i = 0; i < 3; i++)
+    {
+        ncnn::Mat a(sizes[i][0], sizes[i][1], sizes[i][2]);
+        a.fill(0.5f);
+
+        ncnn::Mat a_packed;
+        ncnn::convert_packing(a, a_packed, elempack, opt);
+
+        ncnn::Mat a_bf16;
+        ncnn::cast_float32_to_bfloat16(a, a_bf16, opt);
+
+        bench_packing(a, elempack, loop_count, opt);
+        bench_packing(a_packed, 1, loop_count, opt);
+        bench_cast(a, 1, 4, loop_count, opt);
+        bench_cast(a_bf16, 4, 1, loop_count, opt);
+    }
+
+    return 0;
+}
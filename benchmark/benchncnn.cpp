@@ -16,11 +16,13 @@
 #include <stdio.h>
 #include <string.h>
 
-#ifdef _WIN32
 #include <algorithm>
+#include <vector>
+
+#ifdef _WIN32
 #include <windows.h> // Sleep()
 #else
-#include <unistd.h> // sleep()
+#include <unistd.h> // sleep() usleep()
 #endif
 
 #include "benchmark.h"
@@ -47,8 +49,16 @@ static int g_warmup_loop_count = 8;
 static int g_loop_count = 4;
 static bool g_enable_cooling_down = true;
 
+// concurrent throughput mode
+static int g_concurrent_workers = 0;
+static double g_concurrent_duration = 10000;
+static FILE* g_json_fp = 0;
+static int g_json_count = 0;
+
 static ncnn::UnlockedPoolAllocator g_blob_pool_allocator;
 static ncnn::PoolAllocator g_workspace_pool_allocator;
+// concurrent branches allocate blobs from several threads
+static ncnn::PoolAllocator g_blob_locked_pool_allocator;
 
 #if NCNN_VULKAN
 static ncnn::VulkanDevice* g_vkdev = 0;
@@ -56,6 +66,143 @@ static ncnn::VkAllocator* g_blob_vkallocator = 0;
 static ncnn::VkAllocator* g_staging_vkallocator = 0;
 #endif // NCNN_VULKAN
 
+struct concurrent_worker
+{
+    const ncnn::Net* net;
+    const ncnn::Mat* in;
+    double end_time;
+
+    std::vector<double> latencies;
+};
+
+static void* concurrent_worker_func(void* args)
+{
+    concurrent_worker* worker = (concurrent_worker*)args;
+
+    // the net is shared, every worker keeps one extractor across requests
+    ncnn::Extractor ex = worker->net->create_extractor();
+
+    for (;;)
+    {
+        double start = ncnn::get_current_time();
+        if (start >= worker->end_time)
+            break;
+
+        {
+            ex.clear();
+            ex.input("data", *worker->in);
+
+            ncnn::Mat out;
+            ex.extract("output", out);
+        }
+
+        double end = ncnn::get_current_time();
+
+        worker->latencies.push_back(end - start);
+    }
+
+    return 0;
+}
+
+// nearest-rank percentile of sorted latencies
+static double percentile(const std::vector<double>& sorted, double p)
+{
+    if (sorted.empty())
+        return 0;
+
+    int index = (int)(p * sorted.size() + 0.999999) - 1;
+    index = std::min(std::max(index, 0), (int)sorted.size() - 1);
+
+    return sorted[index];
+}
+
+static void benchmark_concurrent(const char* comment, const ncnn::Net& net, const ncnn::Mat& in, const ncnn::Option& opt)
+{
+    const int workers_count = g_concurrent_workers;
+
+    std::vector<concurrent_worker> workers(workers_count);
+    std::vector<ncnn::Thread*> threads(workers_count);
+
+    double cpu_start = ncnn::get_process_cpu_time();
+    double start = ncnn::get_current_time();
+
+    for (int i = 0; i < workers_count; i++)
+    {
+        workers[i].net = &net;
+        workers[i].in = &in;
+        workers[i].end_time = start + g_concurrent_duration;
+
+        threads[i] = new ncnn::Thread(concurrent_worker_func, &workers[i]);
+    }
+
+    // ru_maxrss would cover the models run before, sample the resident memory while this one runs
+    size_t peak_rss = ncnn::get_current_memory_usage();
+    while (ncnn::get_current_time() < start + g_concurrent_duration)
+    {
+#ifdef _WIN32
+        Sleep(10);
+#else
+        usleep(10 * 1000);
+#endif
+        peak_rss = std::max(peak_rss, ncnn::get_current_memory_usage());
+    }
+
+    for (int i = 0; i < workers_count; i++)
+    {
+        threads[i]->join();
+        delete threads[i];
+    }
+
+    double end = ncnn::get_current_time();
+    double cpu_end = ncnn::get_process_cpu_time();
+
+    peak_rss = std::max(peak_rss, ncnn::get_current_memory_usage());
+
+    std::vector<double> latencies;
+    for (int i = 0; i < workers_count; i++)
+    {
+        latencies.insert(latencies.end(), workers[i].latencies.begin(), workers[i].latencies.end());
+    }
+
+    std::sort(latencies.begin(), latencies.end());
+
+    const int requests = (int)latencies.size();
+    const double elapsed = end - start;
+
+    double time_avg = 0;
+    for (int i = 0; i < requests; i++)
+    {
+        time_avg += latencies[i];
+    }
+    if (requests > 0)
+        time_avg /= requests;
+
+    double qps = requests * 1000.0 / elapsed;
+    double p50 = percentile(latencies, 0.50);
+    double p90 = percentile(latencies, 0.90);
+    double p99 = percentile(latencies, 0.99);
+    double p999 = percentile(latencies, 0.999);
+
+    // share of all cpus kept busy
+    double cpu_utilization = (cpu_end - cpu_start) / (elapsed * ncnn::get_cpu_count()) * 100.0;
+
+    fprintf(stderr, "%20s  qps = %8.2f  p50 = %7.2f  p90 = %7.2f  p99 = %7.2f  p999 = %7.2f  cpu = %5.1f%%  rss = %6.1fM\n",
+            comment, qps, p50, p90, p99, p999, cpu_utilization, peak_rss / 1048576.0);
+
+    if (g_json_fp)
+    {
+        fprintf(g_json_fp, "%s\n  {\"model\": \"%s\", \"workers\": %d, \"num_threads\": %d, \"duration_ms\": %.2f, \"requests\": %d, \"qps\": %.2f, "
+                "\"latency_ms\": {\"min\": %.2f, \"avg\": %.2f, \"p50\": %.2f, \"p90\": %.2f, \"p99\": %.2f, \"p999\": %.2f, \"max\": %.2f}, "
+                "\"cpu_utilization\": %.2f, \"peak_rss_bytes\": %lu}",
+                g_json_count == 0 ? "" : ",", comment, workers_count, opt.num_threads, elapsed, requests, qps,
+                requests ? latencies[0] : 0.0, time_avg, p50, p90, p99, p999, requests ? latencies[requests - 1] : 0.0,
+                cpu_utilization, (unsigned long)peak_rss);
+        fflush(g_json_fp);
+
+        g_json_count++;
+    }
+}
+
 void benchmark(const char* comment, const ncnn::Mat& _in, const ncnn::Option& opt)
 {
     ncnn::Mat in = _in;
@@ -79,8 +226,14 @@ void benchmark(const char* comment, const ncnn::Mat& _in, const ncnn::Option& op
     DataReaderFromEmpty dr;
     net.load_model(dr);
 
+    if (net.opt.use_static_layout)
+    {
+        fprintf(stderr, "%20s  runtime conversions = %d  conversion layers = %d\n", comment, net.runtime_conversion_count(), net.conversion_layer_count());
+    }
+
     g_blob_pool_allocator.clear();
     g_workspace_pool_allocator.clear();
+    g_blob_locked_pool_allocator.clear();
 
 #if NCNN_VULKAN
     if (net.opt.use_vulkan_compute)
@@ -110,6 +263,12 @@ void benchmark(const char* comment, const ncnn::Mat& _in, const ncnn::Option& op
         ex.extract("output", out);
     }
 
+    if (g_concurrent_workers > 0)
+    {
+        benchmark_concurrent(comment, net, in, opt);
+        return;
+    }
+
     double time_min = DBL_MAX;
     double time_max = -DBL_MAX;
     double time_avg = 0;
@@ -145,6 +304,11 @@ int main(int argc, char** argv)
     int powersave = 0;
     int gpu_device = -1;
     int cooling_down = 1;
+    int num_inter_threads = 1;
+    int concurrent_workers = 0;
+    int concurrent_duration = 10;
+    const char* json_path = 0;
+    int use_static_layout = 0;
 
     if (argc >= 2)
     {
@@ -166,15 +330,57 @@ int main(int argc, char** argv)
     {
         cooling_down = atoi(argv[5]);
     }
+    if (argc >= 7)
+    {
+        num_inter_threads = atoi(argv[6]);
+    }
+    if (argc >= 8)
+    {
+        concurrent_workers = atoi(argv[7]);
+    }
+    if (argc >= 9)
+    {
+        concurrent_duration = atoi(argv[8]);
+    }
+    if (argc >= 10 && argv[9][0] != '\0')
+    {
+        json_path = argv[9];
+    }
+    if (argc >= 11)
+    {
+        use_static_layout = atoi(argv[10]);
+    }
 
     bool use_vulkan_compute = gpu_device != -1;
 
+    if (use_vulkan_compute && concurrent_workers > 0)
+    {
+        fprintf(stderr, "concurrent workers run on cpu only\n");
+        return -1;
+    }
+
     g_enable_cooling_down = cooling_down != 0;
 
     g_loop_count = loop_count;
 
+    g_concurrent_workers = concurrent_workers;
+    g_concurrent_duration = concurrent_duration * 1000.0;
+
+    if (json_path)
+    {
+        g_json_fp = fopen(json_path, "wb");
+        if (!g_json_fp)
+        {
+            fprintf(stderr, "fopen %s failed\n", json_path);
+            return -1;
+        }
+
+        fprintf(g_json_fp, "[");
+    }
+
     g_blob_pool_allocator.set_size_compare_ratio(0.0f);
     g_workspace_pool_allocator.set_size_compare_ratio(0.5f);
+    g_blob_locked_pool_allocator.set_size_compare_ratio(0.0f);
 
 #if NCNN_VULKAN
     if (use_vulkan_compute)
@@ -192,7 +398,10 @@ int main(int argc, char** argv)
     ncnn::Option opt;
     opt.lightmode = true;
     opt.num_threads = num_threads;
-    opt.blob_allocator = &g_blob_pool_allocator;
+    if (num_inter_threads > 1 || concurrent_workers > 0)
+        opt.blob_allocator = &g_blob_locked_pool_allocator;
+    else
+        opt.blob_allocator = &g_blob_pool_allocator;
     opt.workspace_allocator = &g_workspace_pool_allocator;
 #if NCNN_VULKAN
     opt.blob_vkallocator = g_blob_vkallocator;
@@ -209,6 +418,8 @@ int main(int argc, char** argv)
     opt.use_int8_storage = true;
     opt.use_int8_arithmetic = true;
     opt.use_packing_layout = true;
+    opt.use_static_layout = use_static_layout != 0;
+    opt.num_inter_threads = num_inter_threads;
     opt.use_shader_pack8 = false;
     opt.use_image_storage = false;
 
@@ -222,6 +433,13 @@ int main(int argc, char** argv)
     fprintf(stderr, "powersave = %d\n", ncnn::get_cpu_powersave());
     fprintf(stderr, "gpu_device = %d\n", gpu_device);
     fprintf(stderr, "cooling_down = %d\n", (int)g_enable_cooling_down);
+    fprintf(stderr, "num_inter_threads = %d\n", num_inter_threads);
+    fprintf(stderr, "use_static_layout = %d\n", use_static_layout);
+    if (concurrent_workers > 0)
+    {
+        fprintf(stderr, "concurrent_workers = %d\n", concurrent_workers);
+        fprintf(stderr, "concurrent_duration = %d\n", concurrent_duration);
+    }
 
     // run
     benchmark("squeezenet", ncnn::Mat(227, 227, 3), opt);
@@ -330,5 +548,11 @@ int main(int argc, char** argv)
     delete g_staging_vkallocator;
 #endif // NCNN_VULKAN
 
+    if (g_json_fp)
+    {
+        fprintf(g_json_fp, "\n]\n");
+        fclose(g_json_fp);
+    }
+
     return 0;
 }
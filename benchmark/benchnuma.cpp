@@ -0,0 +1,256 @@
+// Tencent is pleased to support the open source community by making ncnn available.
+//
+// Copyright (C) 2020 THL A29 Limited, a Tencent company. All rights reserved.
+//
+// Licensed under the BSD 3-Clause License (the "License"); you may not use this file except
+// in compliance with the License. You may obtain a copy of the License at
+//
+// https://opensource.org/licenses/BSD-3-Clause
+//
+// Unless required by applicable law or agreed to in writing, software distributed
+// under the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR
+// CONDITIONS OF ANY KIND, either express or implied. See the License for the
+// specific language governing permissions and limitations under the License.
+
+#include <stdio.h>
+#include <string.h>
+
+#include "benchmark.h"
+#include "cpu.h"
+#include "datareader.h"
+#include "net.h"
+
+class DataReaderFromEmpty : public ncnn::DataReader
+{
+public:
+    virtual int scan(const char* format, void* p) const
+    {
+        return 0;
+    }
+    virtual size_t read(void* buf, size_t size) const
+    {
+        memset(buf, 0, size);
+        return size;
+    }
+};
+
+static double g_duration = 10000;
+static int g_workers_per_node = 1;
+static int g_num_threads = 1;
+
+struct numa_worker
+{
+    const ncnn::Net* net;
+    const ncnn::Mat* in;
+    // node to bind to, -1 when the net binds it
+    int node;
+    ncnn::Allocator* blob_allocator;
+    ncnn::Allocator* workspace_allocator;
+    double end_time;
+
+    int count;
+};
+
+static void* numa_worker_func(void* args)
+{
+    numa_worker* worker = (numa_worker*)args;
+
+    if (worker->node >= 0)
+    {
+        ncnn::set_numa_thread_affinity(worker->node);
+    }
+
+    ncnn::Extractor ex = worker->net->create_extractor();
+    ex.set_num_threads(g_num_threads);
+    ex.set_blob_allocator(worker->blob_allocator);
+    ex.set_workspace_allocator(worker->workspace_allocator);
+
+    worker->count = 0;
+    while (ncnn::get_current_time() < worker->end_time)
+    {
+        ex.clear();
+        ex.input("data", *worker->in);
+
+        ncnn::Mat out;
+        ex.extract("output", out);
+
+        worker->count++;
+    }
+
+    return 0;
+}
+
+// run g_workers_per_node workers on every node for g_duration, nets[node] serves the workers of node
+// return requests per second
+static double run_workers(const std::vector<ncnn::Net*>& nets, const ncnn::Mat& in, bool bind)
+{
+    const int node_count = (int)nets.size();
+    const int workers_count = node_count * g_workers_per_node;
+
+    // blobs come from the node of the worker in every mode
+    std::vector<ncnn::PoolAllocator> blob_allocators(node_count);
+    std::vector<ncnn::PoolAllocator> workspace_allocators(node_count);
+
+    std::vector<numa_worker> workers(workers_count);
+    std::vector<ncnn::Thread*> threads(workers_count);
+
+    double start = ncnn::get_current_time();
+
+    for (int i = 0; i < workers_count; i++)
+    {
+        const int node = i / g_workers_per_node;
+
+        workers[i].net = nets[node];
+        workers[i].in = &in;
+        workers[i].node = bind ? node : -1;
+        workers[i].blob_allocator = &blob_allocators[node];
+        workers[i].workspace_allocator = &workspace_allocators[node];
+        workers[i].end_time = start + g_duration;
+
+        threads[i] = new ncnn::Thread(numa_worker_func, &workers[i]);
+    }
+
+    int count = 0;
+    for (int i = 0; i < workers_count; i++)
+    {
+        threads[i]->join();
+        delete threads[i];
+
+        count += workers[i].count;
+    }
+
+    double end = ncnn::get_current_time();
+
+    return count * 1000.0 / (end - start);
+}
+
+static ncnn::Net* load_net(const char* comment, const ncnn::Option& opt)
+{
+    ncnn::Net* net = new ncnn::Net;
+
+    net->opt = opt;
+
+    char parampath[256];
+    sprintf(parampath, "%s.param", comment);
+    net->load_param(parampath);
+
+    DataReaderFromEmpty dr;
+    net->load_model(dr);
+
+    return net;
+}
+
+void benchmark(const char* comment, const ncnn::Mat& _in, const ncnn::Option& opt)
+{
+    ncnn::Mat in = _in;
+    in.fill(0.01f);
+
+    const int node_count = ncnn::get_numa_node_count();
+
+    // one copy of the weights on node 0, the workers of other nodes read it across the interconnect
+    double remote_qps = 0;
+    {
+        ncnn::Option opt_remote = opt;
+        opt_remote.numa_node = 0;
+
+        ncnn::Net* net = load_net(comment, opt_remote);
+
+        // keep the weights where they are and let the workers bind themselves
+        net->opt.numa_node = -1;
+
+        remote_qps = run_workers(std::vector<ncnn::Net*>(node_count, net), in, true);
+
+        delete net;
+    }
+
+    // one copy spread over all nodes
+    double interleave_qps = 0;
+    {
+        ncnn::Option opt_interleave = opt;
+        opt_interleave.use_numa_interleave = true;
+
+        ncnn::Net* net = load_net(comment, opt_interleave);
+
+        interleave_qps = run_workers(std::vector<ncnn::Net*>(node_count, net), in, true);
+
+        delete net;
+    }
+
+    // one copy per node, read by the workers of that node only
+    double local_qps = 0;
+    {
+        std::vector<ncnn::Net*> nets(node_count);
+        for (int i = 0; i < node_count; i++)
+        {
+            ncnn::Option opt_local = opt;
+            opt_local.numa_node = i;
+
+            nets[i] = load_net(comment, opt_local);
+        }
+
+        local_qps = run_workers(nets, in, false);
+
+        for (int i = 0; i < node_count; i++)
+        {
+            delete nets[i];
+        }
+    }
+
+    fprintf(stderr, "%20s  remote = %7.2f qps  interleave = %7.2f qps  local = %7.2f qps  local/remote = %.2f\n", comment, remote_qps, interleave_qps, local_qps, local_qps / remote_qps);
+}
+
+int main(int argc, char** argv)
+{
+    int duration = 10;
+    int workers_per_node = 1;
+    int num_threads = 1;
+
+    if (argc >= 2)
+    {
+        duration = atoi(argv[1]);
+    }
+    if (argc >= 3)
+    {
+        workers_per_node = atoi(argv[2]);
+    }
+    if (argc >= 4)
+    {
+        num_threads = atoi(argv[3]);
+    }
+
+    g_duration = duration * 1000.0;
+    g_workers_per_node = workers_per_node;
+    g_num_threads = num_threads;
+
+    ncnn::Option opt;
+    opt.lightmode = true;
+    opt.num_threads = num_threads;
+    opt.use_winograd_convolution = true;
+    opt.use_sgemm_convolution = true;
+    opt.use_int8_inference = true;
+    opt.use_packing_layout = true;
+
+    ncnn::set_omp_dynamic(0);
+
+    const int node_count = ncnn::get_numa_node_count();
+
+    fprintf(stderr, "numa_node_count = %d\n", node_count);
+    for (int i = 0; i < node_count; i++)
+    {
+        fprintf(stderr, "numa_node %d cpus = %d\n", i, ncnn::get_numa_node_cpuset(i).num_enabled());
+    }
+    fprintf(stderr, "duration = %d\n", duration);
+    fprintf(stderr, "workers_per_node = %d\n", g_workers_per_node);
+    fprintf(stderr, "num_threads = %d\n", g_num_threads);
+
+    benchmark("squeezenet", ncnn::Mat(227, 227, 3), opt);
+    benchmark("mobilenet", ncnn::Mat(224, 224, 3), opt);
+    benchmark("mobilenet_v2", ncnn::Mat(224, 224, 3), opt);
+    benchmark("shufflenet_v2", ncnn::Mat(224, 224, 3), opt);
+    benchmark("googlenet", ncnn::Mat(224, 224, 3), opt);
+    benchmark("resnet18", ncnn::Mat(224, 224, 3), opt);
+    benchmark("vgg16", ncnn::Mat(224, 224, 3), opt);
+    benchmark("resnet50", ncnn::Mat(224, 224, 3), opt);
+
+    return 0;
+}
@@ -0,0 +1,205 @@
+// Tencent is pleased to support the open source community by making ncnn available.
+//
+// Copyright (C) 2020 THL A29 Limited, a Tencent company. All rights reserved.
+//
+// Licensed under the BSD 3-Clause License (the "License"); you may not use this file except
+// in compliance with the License. You may obtain a copy of the License at
+//
+// https://opensource.org/licenses/BSD-3-Clause
+//
+// Unless required by applicable law or agreed to in writing, software distributed
+// under the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR
+// CONDITIONS OF ANY KIND, either express or implied. See the License for the
+// specific language governing permissions and limitations under the License.
+
+#include <stdio.h>
+#include <string.h>
+
+#ifdef _WIN32
+#include <windows.h> // Sleep()
+#else
+#include <unistd.h> // sleep()
+#endif
+
+#include "benchmark.h"
+#include "cpu.h"
+#include "datareader.h"
+#include "net.h"
+
+class DataReaderFromEmpty : public ncnn::DataReader
+{
+public:
+    virtual int scan(const char* format, void* p) const
+    {
+        return 0;
+    }
+    virtual size_t read(void* buf, size_t size) const
+    {
+        memset(buf, 0, size);
+        return size;
+    }
+};
+
+static int g_frame_count = 32;
+static int g_num_threads = 1;
+static int g_stage_count = 4;
+static bool g_enable_cooling_down = true;
+
+void benchmark(const char* comment, const ncnn::Mat& _in, const ncnn::Option& opt)
+{
+    ncnn::Mat in = _in;
+    in.fill(0.01f);
+
+    ncnn::Net net;
+
+    net.opt = opt;
+
+    char parampath[256];
+    sprintf(parampath, "%s.param", comment);
+    net.load_param(parampath);
+
+    DataReaderFromEmpty dr;
+    net.load_model(dr);
+
+    if (g_enable_cooling_down)
+    {
+        // sleep 10 seconds for cooling down SOC  :(
+#ifdef _WIN32
+        Sleep(10 * 1000);
+#else
+        sleep(10);
+#endif
+    }
+
+    ncnn::Mat out;
+
+    // frame by frame, every layer with all the threads the stages have together
+    double sequential_fps = 0;
+    {
+        for (int i = 0; i < 2; i++)
+        {
+            ncnn::Extractor ex = net.create_extractor();
+            ex.input("data", in);
+            ex.extract("output", out);
+        }
+
+        double start = ncnn::get_current_time();
+
+        for (int i = 0; i < g_frame_count; i++)
+        {
+            ncnn::Extractor ex = net.create_extractor();
+            ex.set_num_threads(g_num_threads * g_stage_count);
+            ex.input("data", in);
+            ex.extract("output", out);
+        }
+
+        double end = ncnn::get_current_time();
+
+        sequential_fps = g_frame_count * 1000.0 / (end - start);
+    }
+
+    // pipelined stages
+    double stream_fps = 0;
+    int stage_count = 0;
+    {
+        ncnn::StreamExtractor stream(&net, "data", "output", g_stage_count, g_num_threads);
+
+        // the first frame places the stage boundaries
+        stream.push(in);
+        stream.pull(out);
+        stage_count = stream.stage_count();
+
+        const int max_inflight = g_stage_count * 2;
+
+        double start = ncnn::get_current_time();
+
+        int pulled = 0;
+        for (int i = 0; i < g_frame_count; i++)
+        {
+            if (i - pulled >= max_inflight)
+            {
+                stream.pull(out);
+                pulled++;
+            }
+
+            stream.push(in);
+        }
+
+        for (; pulled < g_frame_count; pulled++)
+        {
+            stream.pull(out);
+        }
+
+        double end = ncnn::get_current_time();
+
+        stream_fps = g_frame_count * 1000.0 / (end - start);
+    }
+
+    fprintf(stderr, "%20s  sequential = %7.2f fps  stream = %7.2f fps  stages = %d  speedup = %.2f\n", comment, sequential_fps, stream_fps, stage_count, stream_fps / sequential_fps);
+}
+
+int main(int argc, char** argv)
+{
+    int frame_count = 32;
+    int num_threads = 1;
+    int stage_count = 4;
+    int cooling_down = 1;
+
+    if (argc >= 2)
+    {
+        frame_count = atoi(argv[1]);
+    }
+    if (argc >= 3)
+    {
+        num_threads = atoi(argv[2]);
+    }
+    if (argc >= 4)
+    {
+        stage_count = atoi(argv[3]);
+    }
+    if (argc >= 5)
+    {
+        cooling_down = atoi(argv[4]);
+    }
+
+    g_frame_count = frame_count;
+    g_num_threads = num_threads;
+    g_stage_count = stage_count;
+    g_enable_cooling_down = cooling_down != 0;
+
+    // stages free the blobs of the stages before them from other threads
+    static ncnn::PoolAllocator g_blob_pool_allocator;
+    static ncnn::PoolAllocator g_workspace_pool_allocator;
+    g_blob_pool_allocator.set_size_compare_ratio(0.0f);
+    g_workspace_pool_allocator.set_size_compare_ratio(0.5f);
+
+    ncnn::Option opt;
+    opt.lightmode = true;
+    opt.num_threads = num_threads;
+    opt.blob_allocator = &g_blob_pool_allocator;
+    opt.workspace_allocator = &g_workspace_pool_allocator;
+    opt.use_winograd_convolution = true;
+    opt.use_sgemm_convolution = true;
+    opt.use_int8_inference = true;
+    opt.use_packing_layout = true;
+
+    ncnn::set_omp_dynamic(0);
+
+    fprintf(stderr, "frame_count = %d\n", g_frame_count);
+    fprintf(stderr, "num_threads = %d\n", g_num_threads);
+    fprintf(stderr, "stage_count = %d\n", g_stage_count);
+    fprintf(stderr, "cooling_down = %d\n", (int)g_enable_cooling_down);
+
+    benchmark("squeezenet", ncnn::Mat(227, 227, 3), opt);
+    benchmark("mobilenet", ncnn::Mat(224, 224, 3), opt);
+    benchmark("mobilenet_v2", ncnn::Mat(224, 224, 3), opt);
+    benchmark("shufflenet_v2", ncnn::Mat(224, 224, 3), opt);
+    benchmark("googlenet", ncnn::Mat(224, 224, 3), opt);
+    benchmark("resnet18", ncnn::Mat(224, 224, 3), opt);
+    benchmark("resnet50", ncnn::Mat(224, 224, 3), opt);
+    benchmark("squeezenet_ssd", ncnn::Mat(300, 300, 3), opt);
+    benchmark("mobilenet_ssd", ncnn::Mat(300, 300, 3), opt);
+    benchmark("mobilenet_yolo", ncnn::Mat(416, 416, 3), opt);
+
+    return 0;
+}
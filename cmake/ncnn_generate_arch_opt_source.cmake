@@ -0,0 +1,16 @@
+
+# must define SRC DST CLASS NAME ARCH OPT
+
+file(READ ${SRC} source_data)
+
+string(TOUPPER ${NAME} NAME_UPPER)
+string(TOUPPER ${ARCH} ARCH_UPPER)
+string(TOUPPER ${OPT} OPT_UPPER)
+
+# rename the arch class, its header and include guard
+string(REPLACE "${CLASS}_${ARCH}" "${CLASS}_${ARCH}_${OPT}" source_data "${source_data}")
+string(REPLACE "\"${NAME}_${ARCH}.h\"" "\"${NAME}_${ARCH}_${OPT}.h\"" source_data "${source_data}")
+string(REPLACE "LAYER_${NAME_UPPER}_${ARCH_UPPER}_H" "LAYER_${NAME_UPPER}_${ARCH_UPPER}_${OPT_UPPER}_H" source_data "${source_data}")
+string(REPLACE "LAYER_${NAME_UPPER}_${ARCH}_H" "LAYER_${NAME_UPPER}_${ARCH_UPPER}_${OPT_UPPER}_H" source_data "${source_data}")
+
+file(WRITE ${DST} "${source_data}")
@@ -18,6 +18,7 @@
 #include "pipeline.h"
 
 #include <algorithm>
+#include <string.h>
 
 #if __ANDROID_API__ >= 26
 #include <android/hardware_buffer.h>
@@ -245,6 +246,471 @@ void UnlockedPoolAllocator::fastFree(void* ptr)
     ncnn::fastFree(ptr);
 }
 
+// size class of block, 4 classes per power of two
+static inline int size_class_index(size_t size)
+{
+    if (size <= 64)
+        return 0;
+
+    int k = 0;
+    while (((size - 1) >> k) > 1)
+        k++;
+
+    int m = (int)((size - 1) >> (k - 2)); // 4 ~ 7
+    return 1 + (k - 6) * 4 + (m - 4);
+}
+
+static inline size_t size_class_size(int index)
+{
+    if (index == 0)
+        return 64;
+
+    int k = 6 + (index - 1) / 4;
+    int m = 4 + (index - 1) % 4;
+    return (size_t)(m + 1) << (k - 2);
+}
+
+// the header lives in the MALLOC_ALIGN bytes right before the returned pointer
+#define SIZE_CLASS_MAGIC 0x0053435a
+
+static inline int* size_class_header(void* ptr)
+{
+    return (int*)ptr - 2;
+}
+
+struct SizeClassPoolAllocator::ThreadCache
+{
+    SizeClassPoolAllocator* allocator;
+    // taken by the owner thread, contended only by clear() and statistics()
+    Mutex lock;
+    int counts[BIN_COUNT];
+    void* blocks[BIN_COUNT][THREAD_CACHE_DEPTH];
+    size_t bytes_cached;
+    size_t hits;
+};
+
+SizeClassPoolAllocator::SizeClassPoolAllocator()
+    : thread_cache_tls(thread_cache_exit)
+{
+    thread_cache_size = 16 * 1024 * 1024;
+
+    for (int i = 0; i < BIN_COUNT; i++)
+    {
+        bin_hits[i] = 0;
+    }
+
+    retired_hits = 0;
+    misses = 0;
+    bytes_system = 0;
+    bytes_high_water = 0;
+}
+
+SizeClassPoolAllocator::~SizeClassPoolAllocator()
+{
+    clear();
+
+    // clear() released the blocks of every thread cache
+    for (size_t i = 0; i < thread_caches.size(); i++)
+    {
+        delete thread_caches[i];
+    }
+    thread_caches.clear();
+
+    if (bytes_system != 0)
+    {
+        NCNN_LOGE("FATAL ERROR! size class pool allocator destroyed too early, %zu bytes still in use", bytes_system);
+    }
+}
+
+void SizeClassPoolAllocator::set_thread_cache_size(size_t size)
+{
+    thread_cache_size = size;
+}
+
+void SizeClassPoolAllocator::clear()
+{
+    size_t released = 0;
+
+    for (int i = 0; i < BIN_COUNT; i++)
+    {
+        bin_locks[i].lock();
+
+        for (size_t j = 0; j < bins[i].size(); j++)
+        {
+            ncnn::fastFree((unsigned char*)bins[i][j] - MALLOC_ALIGN);
+        }
+        released += size_class_size(i) * bins[i].size();
+        bins[i].clear();
+
+        bin_locks[i].unlock();
+    }
+
+    system_lock.lock();
+
+    for (size_t i = 0; i < thread_caches.size(); i++)
+    {
+        ThreadCache* tc = thread_caches[i];
+
+        tc->lock.lock();
+        released += release_thread_cache(tc);
+        tc->lock.unlock();
+    }
+
+    bytes_system -= released;
+
+    system_lock.unlock();
+}
+
+AllocatorStatistics SizeClassPoolAllocator::statistics() const
+{
+    AllocatorStatistics s;
+    s.hits = 0;
+    s.bytes_cached = 0;
+
+    system_lock.lock();
+
+    s.hits = retired_hits;
+    s.misses = misses;
+    s.high_water_mark = bytes_high_water;
+
+    size_t system = bytes_system;
+    for (size_t i = 0; i < thread_caches.size(); i++)
+    {
+        ThreadCache* tc = thread_caches[i];
+
+        tc->lock.lock();
+        s.hits += tc->hits;
+        s.bytes_cached += tc->bytes_cached;
+        tc->lock.unlock();
+    }
+
+    system_lock.unlock();
+
+    for (int i = 0; i < BIN_COUNT; i++)
+    {
+        bin_locks[i].lock();
+
+        s.hits += bin_hits[i];
+        s.bytes_cached += size_class_size(i) * bins[i].size();
+
+        bin_locks[i].unlock();
+    }
+
+    s.bytes_in_use = system > s.bytes_cached ? system - s.bytes_cached : 0;
+
+    return s;
+}
+
+SizeClassPoolAllocator::ThreadCache* SizeClassPoolAllocator::thread_cache()
+{
+    ThreadCache* tc = (ThreadCache*)thread_cache_tls.get();
+    if (tc)
+        return tc;
+
+    if (!thread_cache_tls.valid())
+    {
+        // out of keys, every allocation goes through the shared free lists
+        return 0;
+    }
+
+    tc = new ThreadCache;
+    tc->allocator = this;
+    memset(tc->counts, 0, sizeof(tc->counts));
+    tc->bytes_cached = 0;
+    tc->hits = 0;
+
+    thread_cache_tls.set(tc);
+
+    system_lock.lock();
+    thread_caches.push_back(tc);
+    system_lock.unlock();
+
+    return tc;
+}
+
+size_t SizeClassPoolAllocator::release_thread_cache(ThreadCache* tc)
+{
+    size_t released = 0;
+
+    for (int i = 0; i < BIN_COUNT; i++)
+    {
+        for (int j = 0; j < tc->counts[i]; j++)
+        {
+            ncnn::fastFree((unsigned char*)tc->blocks[i][j] - MALLOC_ALIGN);
+        }
+        released += size_class_size(i) * tc->counts[i];
+        tc->counts[i] = 0;
+    }
+    tc->bytes_cached = 0;
+
+    return released;
+}
+
+void SizeClassPoolAllocator::thread_cache_exit(void* ptr)
+{
+    ThreadCache* tc = (ThreadCache*)ptr;
+    SizeClassPoolAllocator* allocator = tc->allocator;
+
+    // unlisted, clear() and statistics() no longer reach it
+    allocator->system_lock.lock();
+
+    allocator->thread_caches.erase(std::find(allocator->thread_caches.begin(), allocator->thread_caches.end(), tc));
+    allocator->retired_hits += tc->hits;
+
+    allocator->system_lock.unlock();
+
+    for (int i = 0; i < BIN_COUNT; i++)
+    {
+        if (tc->counts[i] == 0)
+            continue;
+
+        allocator->bin_locks[i].lock();
+        allocator->bins[i].insert(allocator->bins[i].end(), tc->blocks[i], tc->blocks[i] + tc->counts[i]);
+        allocator->bin_locks[i].unlock();
+    }
+
+    delete tc;
+}
+
+void* SizeClassPoolAllocator::fastMalloc(size_t size)
+{
+    const int bin = size_class_index(size);
+    const size_t bin_size = size_class_size(bin);
+
+    // thread cache, its lock is uncontended unless clear() or statistics() runs
+    ThreadCache* tc = thread_cache();
+    if (tc)
+    {
+        tc->lock.lock();
+
+        if (tc->counts[bin] > 0)
+        {
+            tc->counts[bin]--;
+            tc->bytes_cached -= bin_size;
+            tc->hits++;
+            void* ptr = tc->blocks[bin][tc->counts[bin]];
+
+            tc->lock.unlock();
+
+            return ptr;
+        }
+
+        tc->lock.unlock();
+    }
+
+    // shared free list
+    bin_locks[bin].lock();
+
+    if (!bins[bin].empty())
+    {
+        void* ptr = bins[bin].back();
+        bins[bin].pop_back();
+        bin_hits[bin]++;
+
+        bin_locks[bin].unlock();
+
+        return ptr;
+    }
+
+    bin_locks[bin].unlock();
+
+    // new
+    unsigned char* udata = (unsigned char*)ncnn::fastMalloc(bin_size + MALLOC_ALIGN);
+    if (!udata)
+        return 0;
+
+    void* ptr = udata + MALLOC_ALIGN;
+    size_class_header(ptr)[0] = bin;
+    size_class_header(ptr)[1] = SIZE_CLASS_MAGIC;
+
+    system_lock.lock();
+
+    misses++;
+    bytes_system += bin_size;
+    bytes_high_water = std::max(bytes_high_water, bytes_system);
+
+    system_lock.unlock();
+
+    return ptr;
+}
+
+void SizeClassPoolAllocator::fastFree(void* ptr)
+{
+    if (!ptr)
+        return;
+
+    const int* header = size_class_header(ptr);
+    if (header[1] != SIZE_CLASS_MAGIC || header[0] < 0 || header[0] >= BIN_COUNT)
+    {
+        NCNN_LOGE("FATAL ERROR! size class pool allocator get wild %p", ptr);
+        ncnn::fastFree(ptr);
+        return;
+    }
+
+    const int bin = header[0];
+    const size_t bin_size = size_class_size(bin);
+
+    ThreadCache* tc = thread_cache();
+    if (tc)
+    {
+        tc->lock.lock();
+
+        if (tc->counts[bin] < THREAD_CACHE_DEPTH && tc->bytes_cached + bin_size <= thread_cache_size)
+        {
+            tc->blocks[bin][tc->counts[bin]] = ptr;
+            tc->counts[bin]++;
+            tc->bytes_cached += bin_size;
+
+            tc->lock.unlock();
+
+            return;
+        }
+
+        tc->lock.unlock();
+    }
+
+    bin_locks[bin].lock();
+    bins[bin].push_back(ptr);
+    bin_locks[bin].unlock();
+}
+
+ArenaAllocator::ArenaAllocator()
+{
+    arena = 0;
+    arena_size = 0;
+    fallback = 0;
+    fallback_allocations = 0;
+}
+
+ArenaAllocator::~ArenaAllocator()
+{
+    if (!payouts.empty())
+    {
+        NCNN_LOGE("FATAL ERROR! arena allocator destroyed too early");
+        for (size_t i = 0; i < payouts.size(); i++)
+        {
+            NCNN_LOGE("%p still in use", arena + payouts[i].first);
+        }
+    }
+
+    ncnn::fastFree(arena);
+}
+
+void ArenaAllocator::reserve(size_t size, Allocator* _fallback)
+{
+    if (!payouts.empty())
+    {
+        NCNN_LOGE("arena allocator reserve while in use");
+        return;
+    }
+
+    ncnn::fastFree(arena);
+
+    arena = size ? (unsigned char*)ncnn::fastMalloc(size) : 0;
+    arena_size = arena ? size : 0;
+    fallback = _fallback;
+    fallback_allocations = 0;
+    planned.clear();
+}
+
+void ArenaAllocator::push_planned(size_t offset, size_t size)
+{
+    planned.push_back(std::make_pair(offset, size));
+}
+
+void ArenaAllocator::clear_planned()
+{
+    planned.clear();
+}
+
+bool ArenaAllocator::owns(const void* ptr) const
+{
+    return (const unsigned char*)ptr >= arena && (const unsigned char*)ptr < arena + arena_size;
+}
+
+int ArenaAllocator::fallback_count() const
+{
+    return fallback_allocations;
+}
+
+void* ArenaAllocator::fastMalloc(size_t size)
+{
+    // planned offset first, the plan is a hint so verify it against live payouts
+    for (size_t i = 0; i < planned.size(); i++)
+    {
+        size_t offset = planned[i].first;
+        if (size > planned[i].second || offset + size > arena_size)
+            continue;
+
+        std::vector<std::pair<size_t, size_t> >::iterator it = payouts.begin();
+        for (; it != payouts.end(); it++)
+        {
+            if (it->first >= offset + size)
+                break;
+
+            if (it->first + it->second > offset)
+                break;
+        }
+
+        if (it != payouts.end() && it->first < offset + size)
+            continue;
+
+        planned.erase(planned.begin() + i);
+
+        payouts.insert(it, std::make_pair(offset, size));
+
+        return arena + offset;
+    }
+
+    // first fit
+    size_t offset = 0;
+    std::vector<std::pair<size_t, size_t> >::iterator it = payouts.begin();
+    for (; it != payouts.end(); it++)
+    {
+        if (it->first >= offset + size)
+            break;
+
+        offset = alignSize(it->first + it->second, MALLOC_ALIGN);
+    }
+
+    if (offset + size <= arena_size)
+    {
+        payouts.insert(it, std::make_pair(offset, size));
+
+        return arena + offset;
+    }
+
+    fallback_allocations++;
+
+    return fallback ? fallback->fastMalloc(size) : ncnn::fastMalloc(size);
+}
+
+void ArenaAllocator::fastFree(void* ptr)
+{
+    if (!owns(ptr))
+    {
+        if (fallback)
+            fallback->fastFree(ptr);
+        else
+            ncnn::fastFree(ptr);
+        return;
+    }
+
+    size_t offset = (unsigned char*)ptr - arena;
+
+    std::vector<std::pair<size_t, size_t> >::iterator it = payouts.begin();
+    for (; it != payouts.end(); it++)
+    {
+        if (it->first == offset)
+        {
+            payouts.erase(it);
+            return;
+        }
+    }
+
+    NCNN_LOGE("FATAL ERROR! arena allocator get wild %p", ptr);
+}
+
 #if NCNN_VULKAN
 VkAllocator::VkAllocator(const VulkanDevice* _vkdev)
     : vkdev(_vkdev)
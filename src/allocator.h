@@ -37,7 +37,7 @@
 
 namespace ncnn {
 
-#if __AVX__
+#if __AVX__ || NCNN_RUNTIME_CPU
 // the alignment of all the allocated buffers
 #define MALLOC_ALIGN 256
 #else
@@ -186,6 +186,107 @@ private:
     std::list<std::pair<size_t, void*> > payouts;
 };
 
+class AllocatorStatistics
+{
+public:
+    // allocations served from cached blocks
+    size_t hits;
+    // allocations served by fastMalloc
+    size_t misses;
+    // bytes cached in free lists
+    size_t bytes_cached;
+    // bytes handed out and not freed yet
+    size_t bytes_in_use;
+    // peak bytes obtained by fastMalloc
+    size_t high_water_mark;
+};
+
+class SizeClassPoolAllocator : public Allocator
+{
+public:
+    SizeClassPoolAllocator();
+    ~SizeClassPoolAllocator();
+
+    // bytes each thread may keep in its private cache
+    // default 16M
+    void set_thread_cache_size(size_t size);
+
+    // release the shared free lists and the caches of all threads
+    void clear();
+
+    // snapshot of counters, it may be outdated by other threads allocating meanwhile
+    AllocatorStatistics statistics() const;
+
+    virtual void* fastMalloc(size_t size);
+    virtual void fastFree(void* ptr);
+
+public:
+    // 4 size classes per power of two, 64 bytes at least
+    enum { BIN_COUNT = 240 };
+    enum { THREAD_CACHE_DEPTH = 8 };
+
+private:
+    struct ThreadCache;
+    // null when no thread local storage key is left
+    ThreadCache* thread_cache();
+    // return the bytes released, the caller updates bytes_system
+    size_t release_thread_cache(ThreadCache* tc);
+    // the cache of an exiting thread goes to the shared free lists
+    static void thread_cache_exit(void* ptr);
+
+    size_t thread_cache_size;
+    ThreadLocalStorage thread_cache_tls;
+
+    mutable Mutex bin_locks[BIN_COUNT];
+    std::vector<void*> bins[BIN_COUNT];
+    size_t bin_hits[BIN_COUNT];
+
+    mutable Mutex system_lock;
+    std::vector<ThreadCache*> thread_caches;
+    // hits of the caches of exited threads
+    size_t retired_hits;
+    size_t misses;
+    size_t bytes_system;
+    size_t bytes_high_water;
+};
+
+class ArenaAllocator : public Allocator
+{
+public:
+    ArenaAllocator();
+    ~ArenaAllocator();
+
+    // reserve one arena of size bytes
+    // allocations that do not fit are redirected to fallback allocator
+    // default fallback is fastMalloc
+    void reserve(size_t size, Allocator* fallback = 0);
+
+    // place the next allocation of at most size bytes at offset
+    void push_planned(size_t offset, size_t size);
+
+    // drop the pending planned offsets
+    void clear_planned();
+
+    // whether ptr points into the arena
+    bool owns(const void* ptr) const;
+
+    // allocations served by fallback allocator since reserve
+    int fallback_count() const;
+
+    virtual void* fastMalloc(size_t size);
+    virtual void fastFree(void* ptr);
+
+private:
+    unsigned char* arena;
+    size_t arena_size;
+    Allocator* fallback;
+    int fallback_allocations;
+    // pending offset and size
+    std::vector<std::pair<size_t, size_t> > planned;
+    // live offset and size, sorted by offset
+    std::vector<std::pair<size_t, size_t> > payouts;
+};
+
 #if NCNN_VULKAN
 
 class VulkanDevice;
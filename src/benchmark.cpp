@@ -15,8 +15,20 @@
 #ifdef _WIN32
 #define WIN32_LEAN_AND_MEAN
 #include <windows.h>
+#include <psapi.h>
+#ifdef _MSC_VER
+#pragma comment(lib, "psapi.lib")
+#endif
 #else // _WIN32
+#include <sys/resource.h>
 #include <sys/time.h>
+#include <time.h>
+#include <unistd.h>
+#ifdef __APPLE__
+#include <mach/mach.h>
+#else
+#include <stdio.h>
+#endif
 #endif // _WIN32
 
 #include "benchmark.h"
@@ -42,6 +54,58 @@ double get_current_time()
 
     return pc.QuadPart * 1000.0 / freq.QuadPart;
 }
+
+static double filetime_to_ms(const FILETIME& ft)
+{
+    ULARGE_INTEGER t;
+    t.LowPart = ft.dwLowDateTime;
+    t.HighPart = ft.dwHighDateTime;
+
+    // 100ns units
+    return t.QuadPart / 10000.0;
+}
+
+double get_thread_cpu_time()
+{
+    FILETIME creation_time;
+    FILETIME exit_time;
+    FILETIME kernel_time;
+    FILETIME user_time;
+    if (!GetThreadTimes(GetCurrentThread(), &creation_time, &exit_time, &kernel_time, &user_time))
+        return 0;
+
+    return filetime_to_ms(kernel_time) + filetime_to_ms(user_time);
+}
+
+double get_process_cpu_time()
+{
+    FILETIME creation_time;
+    FILETIME exit_time;
+    FILETIME kernel_time;
+    FILETIME user_time;
+    if (!GetProcessTimes(GetCurrentProcess(), &creation_time, &exit_time, &kernel_time, &user_time))
+        return 0;
+
+    return filetime_to_ms(kernel_time) + filetime_to_ms(user_time);
+}
+
+size_t get_peak_memory_usage()
+{
+    PROCESS_MEMORY_COUNTERS pmc;
+    if (!GetProcessMemoryInfo(GetCurrentProcess(), &pmc, sizeof(pmc)))
+        return 0;
+
+    return pmc.PeakWorkingSetSize;
+}
+
+size_t get_current_memory_usage()
+{
+    PROCESS_MEMORY_COUNTERS pmc;
+    if (!GetProcessMemoryInfo(GetCurrentProcess(), &pmc, sizeof(pmc)))
+        return 0;
+
+    return pmc.WorkingSetSize;
+}
 #else  // _WIN32
 double get_current_time()
 {
@@ -50,6 +114,67 @@ double get_current_time()
 
     return tv.tv_sec * 1000.0 + tv.tv_usec / 1000.0;
 }
+
+static double clock_time(clockid_t clock_id)
+{
+    struct timespec ts;
+    if (clock_gettime(clock_id, &ts) != 0)
+        return 0;
+
+    return ts.tv_sec * 1000.0 + ts.tv_nsec / 1000000.0;
+}
+
+double get_thread_cpu_time()
+{
+    return clock_time(CLOCK_THREAD_CPUTIME_ID);
+}
+
+double get_process_cpu_time()
+{
+    return clock_time(CLOCK_PROCESS_CPUTIME_ID);
+}
+
+size_t get_peak_memory_usage()
+{
+    struct rusage usage;
+    if (getrusage(RUSAGE_SELF, &usage) != 0)
+        return 0;
+
+#ifdef __APPLE__
+    // bytes on darwin
+    return usage.ru_maxrss;
+#else
+    // kilobytes elsewhere
+    return usage.ru_maxrss * 1024;
+#endif
+}
+
+size_t get_current_memory_usage()
+{
+#ifdef __APPLE__
+    mach_task_basic_info_data_t info;
+    mach_msg_type_number_t count = MACH_TASK_BASIC_INFO_COUNT;
+    if (task_info(mach_task_self(), MACH_TASK_BASIC_INFO, (task_info_t)&info, &count) != KERN_SUCCESS)
+        return 0;
+
+    return info.resident_size;
+#else
+    // total and resident pages
+    FILE* fp = fopen("/proc/self/statm", "rb");
+    if (!fp)
+        return 0;
+
+    unsigned long size = 0;
+    unsigned long resident = 0;
+    int nscan = fscanf(fp, "%lu %lu", &size, &resident);
+    fclose(fp);
+
+    if (nscan != 2)
+        return 0;
+
+    return (size_t)resident * sysconf(_SC_PAGESIZE);
+#endif
+}
 #endif // _WIN32
 
 #if NCNN_BENCHMARK
@@ -24,6 +24,18 @@ namespace ncnn {
 // get now timestamp in ms
 double get_current_time();
 
+// get cpu time in ms consumed by the calling thread
+double get_thread_cpu_time();
+
+// get cpu time in ms consumed by the whole process
+double get_process_cpu_time();
+
+// get peak resident memory in bytes of the whole process
+size_t get_peak_memory_usage();
+
+// get resident memory in bytes of the whole process at the moment, 0 if unknown
+size_t get_current_memory_usage();
+
 #if NCNN_BENCHMARK
 
 void benchmark(const Layer* layer, double start, double end);
@@ -15,6 +15,7 @@
 #include "cpu.h"
 
 #include "platform.h"
+#include "threadpool.h"
 
 #include <limits.h>
 #include <string.h>
@@ -23,12 +24,21 @@
 #include <omp.h>
 #endif
 
-#ifdef __ANDROID__
+#if defined __ANDROID__ || defined __linux__
 #include <stdint.h>
 #include <sys/syscall.h>
 #include <unistd.h>
 #endif
 
+#if defined(__i386__) || defined(__x86_64__) || defined(_M_IX86) || defined(_M_X64)
+#ifdef _MSC_VER
+#include <intrin.h>
+#include <immintrin.h>
+#else
+#include <cpuid.h>
+#endif
+#endif
+
 #if __APPLE__
 #include "TargetConditionals.h"
 #if TARGET_OS_IPHONE
@@ -200,6 +210,111 @@ int cpu_support_arm_asimdhp()
 #endif
 }
 
+#if defined(__i386__) || defined(__x86_64__) || defined(_M_IX86) || defined(_M_X64)
+static void x86_cpuid(int level, int count, unsigned int out[4])
+{
+#ifdef _MSC_VER
+    __cpuidex((int*)out, level, count);
+#else
+    __cpuid_count(level, count, out[0], out[1], out[2], out[3]);
+#endif
+}
+
+static unsigned int x86_get_xcr0()
+{
+#ifdef _MSC_VER
+    return (unsigned int)_xgetbv(0);
+#else
+    unsigned int eax = 0;
+    unsigned int edx = 0;
+    __asm__ volatile("xgetbv"
+                     : "=a"(eax), "=d"(edx)
+                     : "c"(0));
+    return eax;
+#endif
+}
+
+static int get_cpu_support_x86_avx2()
+{
+    unsigned int regs[4];
+    x86_cpuid(0, 0, regs);
+    if (regs[0] < 7)
+        return 0;
+
+    x86_cpuid(1, 0, regs);
+
+    // fma, osxsave, avx, f16c
+    const unsigned int ecx_mask = (1u << 12) | (1u << 27) | (1u << 28) | (1u << 29);
+    if ((regs[2] & ecx_mask) != ecx_mask)
+        return 0;
+
+    // the os saves xmm and ymm state
+    if ((x86_get_xcr0() & 6) != 6)
+        return 0;
+
+    x86_cpuid(7, 0, regs);
+    return regs[1] & (1u << 5) ? 1 : 0;
+}
+
+static int get_cpu_support_x86_avx512()
+{
+    if (!get_cpu_support_x86_avx2())
+        return 0;
+
+    // the os saves opmask and zmm state
+    if ((x86_get_xcr0() & 0xe6) != 0xe6)
+        return 0;
+
+    unsigned int regs[4];
+    x86_cpuid(7, 0, regs);
+
+    // avx512 f, dq, cd, bw, vl
+    const unsigned int ebx_mask = (1u << 16) | (1u << 17) | (1u << 28) | (1u << 30) | (1u << 31);
+    return (regs[1] & ebx_mask) == ebx_mask ? 1 : 0;
+}
+
+static int get_cpu_support_x86_avx512_vnni()
+{
+    if (!get_cpu_support_x86_avx512())
+        return 0;
+
+    unsigned int regs[4];
+    x86_cpuid(7, 0, regs);
+    return regs[2] & (1u << 11) ? 1 : 0;
+}
+
+static int g_cpu_support_x86_avx2 = get_cpu_support_x86_avx2();
+static int g_cpu_support_x86_avx512 = get_cpu_support_x86_avx512();
+static int g_cpu_support_x86_avx512_vnni = get_cpu_support_x86_avx512_vnni();
+#endif // defined(__i386__) || defined(__x86_64__) || defined(_M_IX86) || defined(_M_X64)
+
+int cpu_support_x86_avx2()
+{
+#if defined(__i386__) || defined(__x86_64__) || defined(_M_IX86) || defined(_M_X64)
+    return g_cpu_support_x86_avx2;
+#else
+    return 0;
+#endif
+}
+
+int cpu_support_x86_avx512()
+{
+#if defined(__i386__) || defined(__x86_64__) || defined(_M_IX86) || defined(_M_X64)
+    return g_cpu_support_x86_avx512;
+#else
+    return 0;
+#endif
+}
+
+int cpu_support_x86_avx512_vnni()
+{
+#if defined(__i386__) || defined(__x86_64__) || defined(_M_IX86) || defined(_M_X64)
+    return g_cpu_support_x86_avx512_vnni;
+#else
+    return 0;
+#endif
+}
+
 static int get_cpucount()
 {
     int count = 0;
@@ -323,24 +438,71 @@ static int get_max_freq_khz(int cpuid)
 
     return max_freq_khz;
 }
+#endif // __ANDROID__
 
-static int set_sched_affinity(size_t thread_affinity_mask)
+CpuSet::CpuSet()
 {
-    // cpu_set_t definition
-    // ref http://stackoverflow.com/questions/16319725/android-set-thread-affinity
-#define CPU_SETSIZE 1024
-#define __NCPUBITS  (8 * sizeof(unsigned long))
-    typedef struct
+    disable_all();
+}
+
+void CpuSet::enable(int cpu)
+{
+    if (cpu < 0 || cpu >= MAX_CPU_COUNT)
+        return;
+
+    bits[cpu / (8 * sizeof(unsigned long))] |= 1UL << (cpu % (8 * sizeof(unsigned long)));
+}
+
+void CpuSet::disable(int cpu)
+{
+    if (cpu < 0 || cpu >= MAX_CPU_COUNT)
+        return;
+
+    bits[cpu / (8 * sizeof(unsigned long))] &= ~(1UL << (cpu % (8 * sizeof(unsigned long))));
+}
+
+void CpuSet::disable_all()
+{
+    memset(bits, 0, sizeof(bits));
+}
+
+bool CpuSet::is_enabled(int cpu) const
+{
+    if (cpu < 0 || cpu >= MAX_CPU_COUNT)
+        return false;
+
+    return bits[cpu / (8 * sizeof(unsigned long))] & (1UL << (cpu % (8 * sizeof(unsigned long))));
+}
+
+int CpuSet::num_enabled() const
+{
+    int num = 0;
+    for (int i = 0; i < MAX_CPU_COUNT; i++)
     {
-        unsigned long __bits[CPU_SETSIZE / __NCPUBITS];
-    } cpu_set_t;
+        if (is_enabled(i))
+            num++;
+    }
 
-#define NCNN_CPU_SET(cpu, cpusetp) \
-    ((cpusetp)->__bits[(cpu) / __NCPUBITS] |= (1UL << ((cpu) % __NCPUBITS)))
+    return num;
+}
 
-#define NCNN_CPU_ZERO(cpusetp) \
-    memset((cpusetp), 0, sizeof(cpu_set_t))
+#if defined __ANDROID__ || defined __linux__
+static CpuSet cpuset_from_mask(size_t thread_affinity_mask)
+{
+    CpuSet cpuset;
+    for (int i = 0; i < (int)sizeof(size_t) * 8; i++)
+    {
+        if (thread_affinity_mask & ((size_t)1 << i))
+            cpuset.enable(i);
+    }
 
+    return cpuset;
+}
+
+// ref http://stackoverflow.com/questions/16319725/android-set-thread-affinity
+// CpuSet bits are passed as cpu_set_t
+static int set_sched_affinity(const CpuSet& thread_affinity_cpuset)
+{
     // set affinity for thread
 #ifdef __GLIBC__
     pid_t pid = syscall(SYS_gettid);
@@ -351,17 +513,7 @@ static int set_sched_affinity(size_t thread_affinity_mask)
     pid_t pid = gettid();
 #endif
 #endif
-    cpu_set_t mask;
-    NCNN_CPU_ZERO(&mask);
-    for (int i = 0; i < (int)sizeof(size_t) * 8; i++)
-    {
-        if (thread_affinity_mask & (1ul << i))
-        {
-            NCNN_CPU_SET(i, &mask);
-        }
-    }
-
-    int syscallret = syscall(__NR_sched_setaffinity, pid, sizeof(mask), &mask);
+    int syscallret = syscall(__NR_sched_setaffinity, pid, sizeof(thread_affinity_cpuset.bits), thread_affinity_cpuset.bits);
     if (syscallret)
     {
         NCNN_LOGE("syscall error %d", syscallret);
@@ -370,7 +522,45 @@ static int set_sched_affinity(size_t thread_affinity_mask)
 
     return 0;
 }
-#endif // __ANDROID__
+
+#if NCNN_THREADPOOL
+// as set_worker_affinity takes it
+static int set_sched_affinity(size_t thread_affinity_mask)
+{
+    return set_sched_affinity(cpuset_from_mask(thread_affinity_mask));
+}
+#endif // NCNN_THREADPOOL
+
+// the cpus the calling thread may run on
+// return 0 if success
+static int get_sched_affinity(CpuSet& thread_affinity_cpuset)
+{
+    thread_affinity_cpuset.disable_all();
+
+    int syscallret = syscall(__NR_sched_getaffinity, 0, sizeof(thread_affinity_cpuset.bits), thread_affinity_cpuset.bits);
+    if (syscallret < 0)
+        return -1;
+
+    return 0;
+}
+
+// the first cpus the calling thread may run on, 0 if unknown
+static size_t get_sched_affinity()
+{
+    CpuSet cpuset;
+    if (get_sched_affinity(cpuset) != 0)
+        return 0;
+
+    size_t thread_affinity_mask = 0;
+    for (int i = 0; i < (int)sizeof(size_t) * 8; i++)
+    {
+        if (cpuset.is_enabled(i))
+            thread_affinity_mask |= (size_t)1 << i;
+    }
+
+    return thread_affinity_mask;
+}
+#endif // __ANDROID__ || __linux__
 
 static int g_powersave = 0;
 
@@ -440,6 +630,13 @@ static int setup_thread_affinity_masks()
             g_thread_affinity_mask_big |= (1ul << i);
     }
 #else
+#if __linux__
+    // stay within the cpus the process was started on, as taskset or numactl leaves them
+    size_t process_affinity_mask = get_sched_affinity();
+    if (process_affinity_mask != 0)
+        g_thread_affinity_mask_all = process_affinity_mask;
+#endif
+
     // TODO implement me for other platforms
     g_thread_affinity_mask_little = 0;
     g_thread_affinity_mask_big = g_thread_affinity_mask_all;
@@ -477,15 +674,11 @@ size_t get_cpu_thread_affinity_mask(int powersave)
     return g_thread_affinity_mask_all;
 }
 
-int set_cpu_thread_affinity(size_t thread_affinity_mask)
+#if defined __ANDROID__ || defined __linux__
+// the calling thread and the threads of its openmp team
+static int set_openmp_thread_affinity(const CpuSet& thread_affinity_cpuset)
 {
-#ifdef __ANDROID__
-    int num_threads = 0;
-    for (int i = 0; i < (int)sizeof(size_t) * 8; i++)
-    {
-        if (thread_affinity_mask & (1ul << i))
-            num_threads++;
-    }
+    int num_threads = thread_affinity_cpuset.num_enabled();
 
 #ifdef _OPENMP
     // set affinity for each thread
@@ -494,7 +687,7 @@ int set_cpu_thread_affinity(size_t thread_affinity_mask)
     #pragma omp parallel for num_threads(num_threads)
     for (int i = 0; i < num_threads; i++)
     {
-        ssarets[i] = set_sched_affinity(thread_affinity_mask);
+        ssarets[i] = set_sched_affinity(thread_affinity_cpuset);
     }
     for (int i = 0; i < num_threads; i++)
     {
@@ -502,12 +695,25 @@ int set_cpu_thread_affinity(size_t thread_affinity_mask)
             return -1;
     }
 #else
-    int ssaret = set_sched_affinity(thread_affinity_mask);
+    (void)num_threads;
+    int ssaret = set_sched_affinity(thread_affinity_cpuset);
     if (ssaret != 0)
         return -1;
 #endif
 
     return 0;
+}
+#endif // defined __ANDROID__ || defined __linux__
+
+int set_cpu_thread_affinity(size_t thread_affinity_mask)
+{
+#if defined __ANDROID__ || defined __linux__
+#if NCNN_THREADPOOL
+    // the parallel_for loops run on the shared pool
+    get_shared_thread_pool()->set_worker_affinity(set_sched_affinity, thread_affinity_mask);
+#endif
+
+    return set_openmp_thread_affinity(cpuset_from_mask(thread_affinity_mask));
 #elif __IOS__
     // thread affinity not supported on ios
     (void)thread_affinity_mask;
@@ -519,6 +725,206 @@ int set_cpu_thread_affinity(size_t thread_affinity_mask)
 #endif
 }
 
+int get_cpu_thread_affinity(CpuSet& thread_affinity_cpuset)
+{
+#if defined __ANDROID__ || defined __linux__
+    return get_sched_affinity(thread_affinity_cpuset);
+#else
+    thread_affinity_cpuset.disable_all();
+    return -1;
+#endif
+}
+
+int set_cpu_thread_affinity(const CpuSet& thread_affinity_cpuset)
+{
+    if (thread_affinity_cpuset.num_enabled() == 0)
+        return -1;
+
+#if defined __ANDROID__ || defined __linux__
+    return set_openmp_thread_affinity(thread_affinity_cpuset);
+#else
+    return -1;
+#endif
+}
+
+static int g_numa_node_count = 0;
+static std::vector<CpuSet> g_numa_node_cpusets;
+
+static void setup_numa_nodes()
+{
+    // the cpus the process may run on, as taskset or numactl leaves them
+    CpuSet process_cpuset;
+#if defined __ANDROID__ || defined __linux__
+    if (get_sched_affinity(process_cpuset) != 0 || process_cpuset.num_enabled() == 0)
+#endif
+    {
+        for (int i = 0; i < g_cpucount; i++)
+        {
+            process_cpuset.enable(i);
+        }
+    }
+
+#if defined __ANDROID__ || defined __linux__
+    for (int i = 0;; i++)
+    {
+        char path[256];
+        sprintf(path, "/sys/devices/system/node/node%d/cpulist", i);
+
+        FILE* fp = fopen(path, "rb");
+        if (!fp)
+            break;
+
+        // cpulist reads like 0-15,32-47
+        CpuSet cpuset;
+        int begin = 0;
+        int end = 0;
+        while (fscanf(fp, "%d", &begin) == 1)
+        {
+            end = begin;
+            int c = fgetc(fp);
+            if (c == '-')
+            {
+                if (fscanf(fp, "%d", &end) != 1)
+                    break;
+
+                c = fgetc(fp);
+            }
+
+            for (int j = begin; j <= end && j < CpuSet::MAX_CPU_COUNT; j++)
+            {
+                if (process_cpuset.is_enabled(j))
+                    cpuset.enable(j);
+            }
+
+            if (c != ',')
+                break;
+        }
+
+        fclose(fp);
+
+        g_numa_node_cpusets.push_back(cpuset);
+    }
+#endif
+
+    if (g_numa_node_cpusets.empty())
+    {
+        g_numa_node_cpusets.push_back(process_cpuset);
+    }
+
+    g_numa_node_count = (int)g_numa_node_cpusets.size();
+}
+
+int get_numa_node_count()
+{
+    if (g_numa_node_count == 0)
+    {
+        setup_numa_nodes();
+    }
+
+    return g_numa_node_count;
+}
+
+const CpuSet& get_numa_node_cpuset(int node)
+{
+    if (g_numa_node_count == 0)
+    {
+        setup_numa_nodes();
+    }
+
+    if (node < 0 || node >= g_numa_node_count)
+    {
+        NCNN_LOGE("numa node %d not found", node);
+
+        static const CpuSet empty_cpuset;
+        return empty_cpuset;
+    }
+
+    return g_numa_node_cpusets[node];
+}
+
+int set_numa_thread_affinity(int node)
+{
+    // with NCNN_THREADPOOL the shared pool is left alone, it serves every node
+    return set_cpu_thread_affinity(get_numa_node_cpuset(node));
+}
+
+NumaMemoryPolicy::NumaMemoryPolicy()
+{
+    mode = 0;
+    memset(nodemask, 0, sizeof(nodemask));
+}
+
+int set_numa_memory_policy(int policy, int node)
+{
+    // linux/mempolicy.h modes
+    const int MPOL_DEFAULT = 0;
+    const int MPOL_PREFERRED = 1;
+    const int MPOL_INTERLEAVE = 3;
+
+    NumaMemoryPolicy mempolicy;
+    mempolicy.mode = MPOL_DEFAULT;
+    if (policy == 1)
+    {
+        if (node < 0 || node >= get_numa_node_count() || node >= NumaMemoryPolicy::MAX_NODE_COUNT)
+        {
+            NCNN_LOGE("numa node %d not found", node);
+            return -1;
+        }
+
+        // preferred rather than bind, a full node falls back to the others instead of failing
+        mempolicy.mode = MPOL_PREFERRED;
+        mempolicy.nodemask[node / (8 * sizeof(unsigned long))] |= 1UL << (node % (8 * sizeof(unsigned long)));
+    }
+    else if (policy == 2)
+    {
+        mempolicy.mode = MPOL_INTERLEAVE;
+        for (int i = 0; i < get_numa_node_count() && i < NumaMemoryPolicy::MAX_NODE_COUNT; i++)
+        {
+            mempolicy.nodemask[i / (8 * sizeof(unsigned long))] |= 1UL << (i % (8 * sizeof(unsigned long)));
+        }
+    }
+
+    return set_numa_memory_policy(mempolicy);
+}
+
+int get_numa_memory_policy(NumaMemoryPolicy& policy)
+{
+#if defined __linux__ && defined __NR_get_mempolicy
+    policy = NumaMemoryPolicy();
+
+    // the policy of the calling thread rather than of an address
+    long syscallret = syscall(__NR_get_mempolicy, &policy.mode, policy.nodemask, (unsigned long)NumaMemoryPolicy::MAX_NODE_COUNT, NULL, 0UL);
+    if (syscallret)
+    {
+        // kernels without numa support
+        return -1;
+    }
+
+    return 0;
+#else
+    (void)policy;
+    return -1;
+#endif
+}
+
+int set_numa_memory_policy(const NumaMemoryPolicy& policy)
+{
+#if defined __linux__ && defined __NR_set_mempolicy
+    // the kernel reads one bit less than maxnode says
+    long syscallret = syscall(__NR_set_mempolicy, policy.mode, policy.nodemask, (unsigned long)NumaMemoryPolicy::MAX_NODE_COUNT + 1);
+    if (syscallret)
+    {
+        // kernels without numa support
+        return -1;
+    }
+
+    return 0;
+#else
+    (void)policy;
+    return -1;
+#endif
+}
+
 int get_omp_num_threads()
 {
 #ifdef _OPENMP
@@ -564,4 +970,13 @@ int get_omp_thread_num()
 #endif
 }
 
+int get_omp_max_threads()
+{
+#ifdef _OPENMP
+    return omp_get_max_threads();
+#else
+    return 1;
+#endif
+}
+
 } // namespace ncnn
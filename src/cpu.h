@@ -26,6 +26,12 @@ int cpu_support_arm_neon();
 int cpu_support_arm_vfpv4();
 // asimdhp = aarch64 asimd half precision
 int cpu_support_arm_asimdhp();
+// avx2 = x86 avx2 + fma + f16c
+int cpu_support_x86_avx2();
+// avx512 = x86 avx512 f + cd + bw + dq + vl, on top of avx2
+int cpu_support_x86_avx512();
+// avx512vnni = x86 avx512 vnni, on top of avx512
+int cpu_support_x86_avx512_vnni();
 
 // cpu info
 int get_cpu_count();
@@ -47,6 +53,67 @@ size_t get_cpu_thread_affinity_mask(int powersave);
 // set explicit thread affinity
 int set_cpu_thread_affinity(size_t thread_affinity_mask);
 
+// a set of cpus, not limited to the bits of size_t like the masks above
+class CpuSet
+{
+public:
+    CpuSet();
+    void enable(int cpu);
+    void disable(int cpu);
+    void disable_all();
+    bool is_enabled(int cpu) const;
+    int num_enabled() const;
+
+public:
+    enum { MAX_CPU_COUNT = 1024 };
+    // laid out as the linux cpu_set_t
+    unsigned long bits[MAX_CPU_COUNT / (8 * sizeof(unsigned long))];
+};
+
+// the cpus the calling thread may run on, to put back with set_cpu_thread_affinity later
+// return 0 if success
+int get_cpu_thread_affinity(CpuSet& thread_affinity_cpuset);
+// bind the calling thread and the threads of its parallel loops to the cpus in thread_affinity_cpuset
+// with NCNN_THREADPOOL the shared pool of parallel_for is left alone
+// return 0 if success
+int set_cpu_thread_affinity(const CpuSet& thread_affinity_cpuset);
+
+// numa topology
+// only implemented on linux at the moment, elsewhere all cpus form node 0
+int get_numa_node_count();
+// the cpus of numa node, within the cpus the process may run on
+// empty for a node not found
+const CpuSet& get_numa_node_cpuset(int node);
+
+// bind the calling thread and the threads of its parallel loops to the cpus of numa node
+// with NCNN_THREADPOOL the shared pool of parallel_for is left alone, it serves every node
+// return 0 if success
+int set_numa_thread_affinity(int node);
+
+// where the memory the calling thread touches first from now on is placed
+// 0 = default, 1 = on numa node, 2 = interleaved page by page over all nodes
+// memory touched before keeps its place
+// return 0 if success
+int set_numa_memory_policy(int policy, int node);
+
+// the memory policy of a thread as the kernel keeps it
+class NumaMemoryPolicy
+{
+public:
+    NumaMemoryPolicy();
+
+    // mode and mode flags
+    int mode;
+
+    enum { MAX_NODE_COUNT = 1024 };
+    unsigned long nodemask[MAX_NODE_COUNT / (8 * sizeof(unsigned long))];
+};
+
+// save the memory policy of the calling thread and put it back later
+// return 0 if success
+int get_numa_memory_policy(NumaMemoryPolicy& policy);
+int set_numa_memory_policy(const NumaMemoryPolicy& policy);
+
 // misc function wrapper for openmp routines
 int get_omp_num_threads();
 void set_omp_num_threads(int num_threads);
@@ -56,6 +123,9 @@ void set_omp_dynamic(int dynamic);
 
 int get_omp_thread_num();
 
+// the thread count of the next parallel region, as set_omp_num_threads sets it
+int get_omp_max_threads();
+
 } // namespace ncnn
 
 #endif // NCNN_CPU_H
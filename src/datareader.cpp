@@ -14,8 +14,16 @@
 
 #include "datareader.h"
 
+#include <algorithm>
 #include <string.h>
 
+#if NCNN_STDIO && !(defined _WIN32 && !(defined __MINGW32__))
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
 namespace ncnn {
 
 DataReader::~DataReader()
@@ -34,6 +42,11 @@ size_t DataReader::read(void* /*buf*/, size_t /*size*/) const
     return 0;
 }
 
+size_t DataReader::reference(size_t /*size*/, const void** /*buf*/) const
+{
+    return 0;
+}
+
 #if NCNN_STDIO
 DataReaderFromStdio::DataReaderFromStdio(FILE* _fp)
     : fp(_fp)
@@ -51,6 +64,98 @@ size_t DataReaderFromStdio::read(void* buf, size_t size) const
 {
     return fread(buf, 1, size, fp);
 }
+
+DataReaderFromMmap::DataReaderFromMmap(const char* path)
+    : data(0), data_size(0), offset(0)
+{
+#if (defined _WIN32 && !(defined __MINGW32__))
+    mapping = 0;
+    file = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+    if (file == INVALID_HANDLE_VALUE)
+        return;
+
+    LARGE_INTEGER file_size;
+    if (!GetFileSizeEx(file, &file_size) || file_size.QuadPart == 0)
+        return;
+
+    mapping = CreateFileMappingA(file, NULL, PAGE_WRITECOPY, 0, 0, NULL);
+    if (!mapping)
+        return;
+
+    void* ptr = MapViewOfFile(mapping, FILE_MAP_COPY, 0, 0, 0);
+    if (!ptr)
+        return;
+
+    data = (const unsigned char*)ptr;
+    data_size = (size_t)file_size.QuadPart;
+#else
+    int fd = open(path, O_RDONLY);
+    if (fd < 0)
+        return;
+
+    struct stat st;
+    if (fstat(fd, &st) != 0 || st.st_size == 0)
+    {
+        close(fd);
+        return;
+    }
+
+    // private writable mapping, a layer touching its weights gets its own page copy
+    void* ptr = mmap(0, st.st_size, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (ptr == MAP_FAILED)
+        return;
+
+    data = (const unsigned char*)ptr;
+    data_size = st.st_size;
+#endif
+}
+
+DataReaderFromMmap::~DataReaderFromMmap()
+{
+#if (defined _WIN32 && !(defined __MINGW32__))
+    if (data)
+        UnmapViewOfFile(data);
+    if (mapping)
+        CloseHandle(mapping);
+    if (file != INVALID_HANDLE_VALUE)
+        CloseHandle(file);
+#else
+    if (data)
+        munmap((void*)data, data_size);
+#endif
+}
+
+bool DataReaderFromMmap::mapped() const
+{
+    return data != 0;
+}
+
+const unsigned char* DataReaderFromMmap::mapped_data() const
+{
+    return data;
+}
+
+size_t DataReaderFromMmap::mapped_size() const
+{
+    return data_size;
+}
+
+size_t DataReaderFromMmap::read(void* buf, size_t size) const
+{
+    size = std::min(size, data_size - offset);
+    memcpy(buf, data + offset, size);
+    offset += size;
+    return size;
+}
+
+size_t DataReaderFromMmap::reference(size_t size, const void** buf) const
+{
+    size = std::min(size, data_size - offset);
+    *buf = data + offset;
+    offset += size;
+    return size;
+}
 #endif // NCNN_STDIO
 
 DataReaderFromMemory::DataReaderFromMemory(const unsigned char*& _mem)
@@ -83,6 +188,13 @@ size_t DataReaderFromMemory::read(void* buf, size_t size) const
     return size;
 }
 
+size_t DataReaderFromMemory::reference(size_t size, const void** buf) const
+{
+    *buf = mem;
+    mem += size;
+    return size;
+}
+
 #if __ANDROID_API__ >= 9
 DataReaderFromAndroidAsset::DataReaderFromAndroidAsset(AAsset* _asset)
     : asset(_asset), mem(0)
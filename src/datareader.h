@@ -41,6 +41,11 @@ public:
     // read binary param and model data
     // return bytes read
     virtual size_t read(void* buf, size_t size) const;
+
+    // get model data reference in place without copy
+    // the data stays valid as long as the reader source
+    // return bytes referenced, 0 if referencing is not supported
+    virtual size_t reference(size_t size, const void** buf) const;
 };
 
 #if NCNN_STDIO
@@ -57,6 +62,40 @@ public:
 protected:
     FILE* fp;
 };
+
+// map the whole model file into memory
+// weight data is referenced in the mapping, processes loading the same file share the page cache
+// pages are copy-on-write, so writes never reach the file
+class DataReaderFromMmap : public DataReader
+{
+public:
+    DataReaderFromMmap(const char* path);
+    virtual ~DataReaderFromMmap();
+
+    // return true if the file is mapped
+    bool mapped() const;
+
+    // the whole mapping, for formats addressed by file offset
+    const unsigned char* mapped_data() const;
+    size_t mapped_size() const;
+
+    virtual size_t read(void* buf, size_t size) const;
+    virtual size_t reference(size_t size, const void** buf) const;
+
+private:
+    // not copyable
+    DataReaderFromMmap(const DataReaderFromMmap&);
+    DataReaderFromMmap& operator=(const DataReaderFromMmap&);
+
+protected:
+    const unsigned char* data;
+    size_t data_size;
+    mutable size_t offset;
+#if (defined _WIN32 && !(defined __MINGW32__))
+    HANDLE file;
+    HANDLE mapping;
+#endif
+};
 #endif // NCNN_STDIO
 
 class DataReaderFromMemory : public DataReader
@@ -68,6 +107,7 @@ public:
     virtual int scan(const char* format, void* p) const;
 #endif // NCNN_STRING
     virtual size_t read(void* buf, size_t size) const;
+    virtual size_t reference(size_t size, const void** buf) const;
 
 protected:
     const unsigned char*& mem;
@@ -41,9 +41,13 @@ Layer::Layer()
     support_bf16_storage = false;
     support_image_storage = false;
 
+    support_batch = false;
+
 #if NCNN_VULKAN
     vkdev = 0;
 #endif // NCNN_VULKAN
+
+    typeindex = -1;
 }
 
 Layer::~Layer()
@@ -70,6 +74,12 @@ int Layer::destroy_pipeline(const Option& /*opt*/)
     return 0;
 }
 
+int Layer::get_pipeline_weights(std::vector<Mat*>& weights)
+{
+    weights.clear();
+    return 0;
+}
+
 int Layer::forward(const std::vector<Mat>& bottom_blobs, std::vector<Mat>& top_blobs, const Option& opt) const
 {
     if (!support_inplace)
@@ -108,6 +118,19 @@ int Layer::forward_inplace(Mat& /*bottom_top_blob*/, const Option& /*opt*/) cons
     return -1;
 }
 
+int Layer::forward_batch(const std::vector<Mat>& bottom_blobs, std::vector<Mat>& top_blobs, const Option& opt) const
+{
+    top_blobs.resize(bottom_blobs.size());
+    for (size_t i = 0; i < bottom_blobs.size(); i++)
+    {
+        int ret = forward(bottom_blobs[i], top_blobs[i], opt);
+        if (ret != 0)
+            return ret;
+    }
+
+    return 0;
+}
+
 #if NCNN_VULKAN
 int Layer::upload_model(VkTransfer& /*cmd*/, const Option& /*opt*/)
 {
@@ -187,6 +210,18 @@ static const layer_registry_entry layer_registry[] = {
 #include "layer_registry.h"
 };
 
+#if NCNN_RUNTIME_CPU
+static const layer_registry_entry layer_registry_avx2[] = {
+#include "layer_registry_avx2.h"
+};
+#endif // NCNN_RUNTIME_CPU
+
+#if NCNN_RUNTIME_CPU_AVX512
+static const layer_registry_entry layer_registry_avx512[] = {
+#include "layer_registry_avx512.h"
+};
+#endif // NCNN_RUNTIME_CPU_AVX512
+
 static const int layer_registry_entry_count = sizeof(layer_registry) / sizeof(layer_registry_entry);
 
 #if NCNN_STRING
@@ -217,6 +252,18 @@ Layer* create_layer(int index)
         return 0;
 
     layer_creator_func layer_creator = layer_registry[index].creator;
+#if NCNN_RUNTIME_CPU
+    if (cpu_support_x86_avx2())
+    {
+        layer_creator = layer_registry_avx2[index].creator;
+    }
+#endif // NCNN_RUNTIME_CPU
+#if NCNN_RUNTIME_CPU_AVX512
+    if (cpu_support_x86_avx512())
+    {
+        layer_creator = layer_registry_avx512[index].creator;
+    }
+#endif // NCNN_RUNTIME_CPU_AVX512
     if (!layer_creator)
         return 0;
 
@@ -56,6 +56,11 @@ public:
     // return 0 if success
     virtual int destroy_pipeline(const Option& opt);
 
+    // weights transformed by create_pipeline, saved and restored by the pipeline cache
+    // create_pipeline keeps a restored non-empty weight as is instead of transforming again
+    // return 0 if success
+    virtual int get_pipeline_weights(std::vector<Mat*>& weights);
+
 public:
     // one input and one output blob
     bool one_blob_only;
@@ -75,6 +80,9 @@ public:
     // shader image storage
     bool support_image_storage;
 
+    // process all samples of a batch in one forward_batch call
+    bool support_batch;
+
 public:
     // implement inference
     // return 0 if success
@@ -86,6 +94,11 @@ public:
     virtual int forward_inplace(std::vector<Mat>& bottom_top_blobs, const Option& opt) const;
     virtual int forward_inplace(Mat& bottom_top_blob, const Option& opt) const;
 
+    // batched forward for layer with one bottom and one top, one mat of each per sample
+    // layer sharing one weight pass across samples should override this
+    // return 0 if success
+    virtual int forward_batch(const std::vector<Mat>& bottom_blobs, std::vector<Mat>& top_blobs, const Option& opt) const;
+
 #if NCNN_VULKAN
 public:
     // upload weight blob from host to device
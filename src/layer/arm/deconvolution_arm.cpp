@@ -41,6 +41,12 @@ Deconvolution_arm::Deconvolution_arm()
 
 int Deconvolution_arm::create_pipeline(const Option& opt)
 {
+    if (opt.use_int8_inference && int8_scale_term)
+    {
+        // int8 weights go through the generic int8 path
+        return Deconvolution::create_pipeline(opt);
+    }
+
     if (activation_type == 1)
     {
         activation = ncnn::create_layer(ncnn::LayerType::ReLU);
@@ -281,6 +287,20 @@ int Deconvolution_arm::forward(const Mat& bottom_blob, Mat& top_blob, const Opti
     // deconvolv with NxN kernel
     // value = value + bias
 
+    if (opt.use_int8_inference && weight_data.elemsize == (size_t)1u)
+    {
+        Mat bottom_blob_unpacked = bottom_blob;
+        if (bottom_blob.elempack != 1)
+        {
+            Option opt_pack1 = opt;
+            opt_pack1.blob_allocator = opt.workspace_allocator;
+
+            convert_packing(bottom_blob, bottom_blob_unpacked, 1, opt_pack1);
+        }
+
+        return Deconvolution::forward(bottom_blob_unpacked, top_blob, opt);
+    }
+
     int w = bottom_blob.w;
     int h = bottom_blob.h;
     int channels = bottom_blob.c;
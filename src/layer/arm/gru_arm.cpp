@@ -0,0 +1,394 @@
+// Tencent is pleased to support the open source community by making ncnn available.
+//
+// Copyright (C) 2020 THL A29 Limited, a Tencent company. All rights reserved.
+//
+// Licensed under the BSD 3-Clause License (the "License"); you may not use this file except
+// in compliance with the License. You may obtain a copy of the License at
+//
+// https://opensource.org/licenses/BSD-3-Clause
+//
+// Unless required by applicable law or agreed to in writing, software distributed
+// under the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR
+// CONDITIONS OF ANY KIND, either express or implied. See the License for the
+// specific language governing permissions and limitations under the License.
+
+#include "gru_arm.h"
+
+#include <math.h>
+#include <string.h>
+
+#include <algorithm>
+
+#if __ARM_NEON
+#include "neon_mathfun.h"
+#include "neon_activation.h"
+#endif // __ARM_NEON
+
+#include "cpu.h"
+
+namespace ncnn {
+
+DEFINE_LAYER_CREATOR(GRU_arm)
+
+GRU_arm::GRU_arm()
+{
+    one_blob_only = false;
+    support_inplace = false;
+    support_batch = true;
+}
+
+int GRU_arm::create_pipeline(const Option& opt)
+{
+#if __ARM_NEON
+    if (opt.use_fp16_storage && weight_xc_data.elemsize == 4u)
+    {
+        ncnn::cast_float32_to_float16(weight_xc_data, weight_xc_data_fp16, opt);
+        ncnn::cast_float32_to_float16(weight_hc_data, weight_hc_data_fp16, opt);
+    }
+#endif // __ARM_NEON
+
+    return 0;
+}
+
+#if __ARM_NEON
+static inline float32x4_t gru_loadw(const float* ptr)
+{
+    return vld1q_f32(ptr);
+}
+
+static inline float gru_w2f(float v)
+{
+    return v;
+}
+
+#if (__ARM_FP & 2)
+static inline float32x4_t gru_loadw(const unsigned short* ptr)
+{
+    return loadfp16(ptr);
+}
+
+static inline float gru_w2f(unsigned short v)
+{
+    return float16_to_float32(v);
+}
+#endif // (__ARM_FP & 2)
+
+// weight rows r to r+3 times x, one lane per row
+template<typename WT>
+static float32x4_t gru_dot4(const Mat& weight, int r, const float* x, int size)
+{
+    const WT* w0 = weight.row<const WT>(r);
+    const WT* w1 = weight.row<const WT>(r + 1);
+    const WT* w2 = weight.row<const WT>(r + 2);
+    const WT* w3 = weight.row<const WT>(r + 3);
+
+    float32x4_t _sum0 = vdupq_n_f32(0.f);
+    float32x4_t _sum1 = vdupq_n_f32(0.f);
+    float32x4_t _sum2 = vdupq_n_f32(0.f);
+    float32x4_t _sum3 = vdupq_n_f32(0.f);
+
+    int i = 0;
+    for (; i + 3 < size; i += 4)
+    {
+        float32x4_t _x = vld1q_f32(x + i);
+        _sum0 = vmlaq_f32(_sum0, gru_loadw(w0 + i), _x);
+        _sum1 = vmlaq_f32(_sum1, gru_loadw(w1 + i), _x);
+        _sum2 = vmlaq_f32(_sum2, gru_loadw(w2 + i), _x);
+        _sum3 = vmlaq_f32(_sum3, gru_loadw(w3 + i), _x);
+    }
+
+    float32x2_t _sum0ss = vadd_f32(vget_low_f32(_sum0), vget_high_f32(_sum0));
+    float32x2_t _sum1ss = vadd_f32(vget_low_f32(_sum1), vget_high_f32(_sum1));
+    float32x2_t _sum2ss = vadd_f32(vget_low_f32(_sum2), vget_high_f32(_sum2));
+    float32x2_t _sum3ss = vadd_f32(vget_low_f32(_sum3), vget_high_f32(_sum3));
+
+    float32x4_t _sum = vcombine_f32(vpadd_f32(_sum0ss, _sum1ss), vpadd_f32(_sum2ss, _sum3ss));
+
+    if (i < size)
+    {
+        float sums[4] = {0.f};
+        for (; i < size; i++)
+        {
+            float xi = x[i];
+            sums[0] += gru_w2f(w0[i]) * xi;
+            sums[1] += gru_w2f(w1[i]) * xi;
+            sums[2] += gru_w2f(w2[i]) * xi;
+            sums[3] += gru_w2f(w3[i]) * xi;
+        }
+
+        _sum = vaddq_f32(_sum, vld1q_f32(sums));
+    }
+
+    return _sum;
+}
+
+// weight row times x
+template<typename WT>
+static float gru_dot(const WT* w, const float* x, int size)
+{
+    float sum = 0.f;
+    for (int i = 0; i < size; i++)
+    {
+        sum += gru_w2f(w[i]) * x[i];
+    }
+
+    return sum;
+}
+
+// gates := W_xc * x_t + b_c for all timesteps in one pass over the weight
+// 4 weight rows stay in cache while the whole sequence streams through
+template<typename WT>
+static void gru_input_gemm(const Mat& bottom_blob, Mat& gates, const Mat& weight_xc, const float* bias_c, const Option& opt)
+{
+    int size = bottom_blob.w;
+    int T = bottom_blob.h;
+
+    int rows = gates.w;
+
+    int nn_rows = rows >> 2;
+    int remain_rows_start = nn_rows << 2;
+
+    #pragma omp parallel for num_threads(opt.num_threads)
+    for (int pp = 0; pp < nn_rows; pp++)
+    {
+        int r = pp * 4;
+
+        float32x4_t _bias = vld1q_f32(bias_c + r);
+
+        for (int t = 0; t < T; t++)
+        {
+            float32x4_t _sum = gru_dot4<WT>(weight_xc, r, bottom_blob.row(t), size);
+            vst1q_f32(gates.row(t) + r, vaddq_f32(_sum, _bias));
+        }
+    }
+
+    #pragma omp parallel for num_threads(opt.num_threads)
+    for (int r = remain_rows_start; r < rows; r++)
+    {
+        const WT* w = weight_xc.row<const WT>(r);
+
+        for (int t = 0; t < T; t++)
+        {
+            gates.row(t)[r] = bias_c[r] + gru_dot(w, bottom_blob.row(t), size);
+        }
+    }
+}
+
+// runs all sequences in all directions together, one timestep after another
+// the recurrent part of a timestep is split over blocks of 4 hidden units of every sequence
+template<typename WT>
+static int gru(const std::vector<Mat>& bottom_blobs, std::vector<Mat>& top_blobs, std::vector<Mat>& hidden_states, int direction, const Mat& weight_xc, const Mat& bias_c, const Mat& weight_hc, const Option& opt)
+{
+    const int num_directions = direction == 2 ? 2 : 1;
+    const int num_sequences = (int)bottom_blobs.size() * num_directions;
+
+    const int num_output = weight_hc.w;
+
+    // 3 x num_output gates of every timestep, the input part of R U N
+    std::vector<Mat> gates(num_sequences);
+    int max_T = 0;
+    for (int s = 0; s < num_sequences; s++)
+    {
+        const Mat& bottom_blob = bottom_blobs[s / num_directions];
+        const int d = s % num_directions;
+
+        gates[s].create(num_output * 3, bottom_blob.h, 4u, opt.workspace_allocator);
+        if (gates[s].empty())
+            return -100;
+
+        gru_input_gemm<WT>(bottom_blob, gates[s], weight_xc.channel(d), bias_c.channel(d), opt);
+
+        max_T = std::max(max_T, bottom_blob.h);
+    }
+
+    const int nn_num_output = (num_output + 3) / 4;
+
+    // unroll
+    for (int t = 0; t < max_T; t++)
+    {
+        #pragma omp parallel for num_threads(opt.num_threads)
+        for (int i = 0; i < num_sequences * nn_num_output; i++)
+        {
+            const int s = i / nn_num_output;
+            int q = (i % nn_num_output) * 4;
+
+            const int T = gates[s].h;
+            if (t >= T)
+                continue;
+
+            const int b = s / num_directions;
+            const int d = s % num_directions;
+            const int reverse = direction == 2 ? d : direction;
+            const int ti = reverse ? T - 1 - t : t;
+
+            // the previous hidden state is the output of the previous timestep
+            const float* hidden_ptr = t == 0 ? (const float*)hidden_states[b].row(d) : (const float*)top_blobs[b].row(reverse ? ti + 1 : ti - 1) + d * num_output;
+
+            const Mat weight_hc_d = weight_hc.channel(d);
+            const float* bias_c_BN = bias_c.channel(d).row(3);
+
+            // gate reset update new
+            const float* gates_data = gates[s].row(ti);
+            float* output_data = (float*)top_blobs[b].row(ti) + d * num_output;
+
+            // gru unit
+            // sigmoid(R)
+            // sigmoid(U)
+            // n_t := tanh(W_xn * x_t + b_wn + r_t .* (W_hn * h_{t-1} + b_bn))
+            // h_t := (1 - u_t) .* n_t + u_t .* h_{t-1}
+            if (q + 3 < num_output)
+            {
+                float32x4_t _R = vaddq_f32(vld1q_f32(gates_data + num_output * 0 + q), gru_dot4<WT>(weight_hc_d, num_output * 0 + q, hidden_ptr, num_output));
+                float32x4_t _U = vaddq_f32(vld1q_f32(gates_data + num_output * 1 + q), gru_dot4<WT>(weight_hc_d, num_output * 1 + q, hidden_ptr, num_output));
+                float32x4_t _N = vaddq_f32(vld1q_f32(bias_c_BN + q), gru_dot4<WT>(weight_hc_d, num_output * 2 + q, hidden_ptr, num_output));
+
+                _R = sigmoid_ps(_R);
+                _U = sigmoid_ps(_U);
+                _N = tanh_ps(vmlaq_f32(vld1q_f32(gates_data + num_output * 2 + q), _R, _N));
+
+                // (1 - u) * n + u * h  ==  n + u * (h - n)
+                float32x4_t _H = vmlaq_f32(_N, _U, vsubq_f32(vld1q_f32(hidden_ptr + q), _N));
+                vst1q_f32(output_data + q, _H);
+                continue;
+            }
+
+            for (; q < num_output; q++)
+            {
+                float R = gates_data[num_output * 0 + q] + gru_dot(weight_hc_d.row<const WT>(num_output * 0 + q), hidden_ptr, num_output);
+                float U = gates_data[num_output * 1 + q] + gru_dot(weight_hc_d.row<const WT>(num_output * 1 + q), hidden_ptr, num_output);
+
+                R = 1.f / (1.f + exp(-R));
+                U = 1.f / (1.f + exp(-U));
+
+                float N = bias_c_BN[q] + gru_dot(weight_hc_d.row<const WT>(num_output * 2 + q), hidden_ptr, num_output);
+
+                N = tanh(gates_data[num_output * 2 + q] + R * N);
+
+                output_data[q] = (1.f - U) * N + U * hidden_ptr[q];
+            }
+        }
+    }
+
+    // keep the last hidden state
+    for (int s = 0; s < num_sequences; s++)
+    {
+        const int T = gates[s].h;
+        if (T == 0)
+            continue;
+
+        const int b = s / num_directions;
+        const int d = s % num_directions;
+        const int reverse = direction == 2 ? d : direction;
+
+        const float* ptr = (const float*)top_blobs[b].row(reverse ? 0 : T - 1) + d * num_output;
+        memcpy(hidden_states[b].row(d), ptr, num_output * sizeof(float));
+    }
+
+    return 0;
+}
+#endif // __ARM_NEON
+
+int GRU_arm::forward(const Mat& bottom_blob, Mat& top_blob, const Option& opt) const
+{
+    std::vector<Mat> bottom_blobs(1, bottom_blob);
+    std::vector<Mat> top_blobs(1);
+    int ret = GRU_arm::forward_batch(bottom_blobs, top_blobs, opt);
+    if (ret != 0)
+        return ret;
+
+    top_blob = top_blobs[0];
+
+    return 0;
+}
+
+int GRU_arm::forward(const std::vector<Mat>& bottom_blobs, std::vector<Mat>& top_blobs, const Option& opt) const
+{
+#if __ARM_NEON
+    if (weight_xc_data.elemsize == 1u)
+    {
+        return GRU::forward(bottom_blobs, top_blobs, opt);
+    }
+
+    if (bottom_blobs.size() != 2 || top_blobs.size() != 2)
+    {
+        return forward(bottom_blobs[0], top_blobs[0], opt);
+    }
+    const Mat& bottom_blob = bottom_blobs[0];
+    int T = bottom_blob.h;
+
+    //Copy previous states
+    std::vector<Mat> hidden_states(1);
+    hidden_states[0] = bottom_blobs[1].clone(opt.blob_allocator);
+    if (hidden_states[0].empty())
+        return -100;
+
+    std::vector<Mat> top_blobs0(1);
+    top_blobs0[0].create(num_output, T, 4u, opt.blob_allocator);
+    if (top_blobs0[0].empty())
+        return -100;
+
+    // Uni directional
+    int ret = 0;
+#if (__ARM_FP & 2)
+    if (opt.use_fp16_storage && cpu_support_arm_vfpv4())
+    {
+        ret = gru<unsigned short>(std::vector<Mat>(1, bottom_blob), top_blobs0, hidden_states, direction, weight_xc_data_fp16, bias_c_data, weight_hc_data_fp16, opt);
+    }
+    else
+#endif
+    {
+        ret = gru<float>(std::vector<Mat>(1, bottom_blob), top_blobs0, hidden_states, direction, weight_xc_data, bias_c_data, weight_hc_data, opt);
+    }
+    if (ret != 0)
+        return ret;
+
+    top_blobs[0] = top_blobs0[0];
+    top_blobs[1] = hidden_states[0];
+
+    return 0;
+#else
+    return GRU::forward(bottom_blobs, top_blobs, opt);
+#endif
+}
+
+int GRU_arm::forward_batch(const std::vector<Mat>& bottom_blobs, std::vector<Mat>& top_blobs, const Option& opt) const
+{
+#if __ARM_NEON
+    if (weight_xc_data.elemsize == 1u)
+    {
+        return GRU::forward_batch(bottom_blobs, top_blobs, opt);
+    }
+
+    const int batch = (int)bottom_blobs.size();
+    const int num_directions = direction == 2 ? 2 : 1;
+
+    top_blobs.resize(batch);
+
+    // initial hidden state
+    std::vector<Mat> hidden_states(batch);
+    for (int n = 0; n < batch; n++)
+    {
+        hidden_states[n].create(num_output, num_directions, 4u, opt.workspace_allocator);
+        if (hidden_states[n].empty())
+            return -100;
+        hidden_states[n].fill(0.f);
+
+        top_blobs[n].create(num_output * num_directions, bottom_blobs[n].h, 4u, opt.blob_allocator);
+        if (top_blobs[n].empty())
+            return -100;
+    }
+
+#if (__ARM_FP & 2)
+    if (opt.use_fp16_storage && cpu_support_arm_vfpv4())
+    {
+        return gru<unsigned short>(bottom_blobs, top_blobs, hidden_states, direction, weight_xc_data_fp16, bias_c_data, weight_hc_data_fp16, opt);
+    }
+#endif
+
+    return gru<float>(bottom_blobs, top_blobs, hidden_states, direction, weight_xc_data, bias_c_data, weight_hc_data, opt);
+#else
+    return GRU::forward_batch(bottom_blobs, top_blobs, opt);
+#endif
+}
+
+} // namespace ncnn
@@ -314,7 +314,16 @@ int InnerProduct_arm::forward(const Mat& bottom_blob, Mat& top_blob, const Optio
     if (opt.use_int8_inference && weight_data.elemsize == (size_t)1u)
     {
         // TODO
-        return InnerProduct::forward(bottom_blob, top_blob, opt);
+        Mat bottom_blob_unpacked = bottom_blob;
+        if (bottom_blob.elempack != 1)
+        {
+            Option opt_pack1 = opt;
+            opt_pack1.blob_allocator = opt.workspace_allocator;
+
+            convert_packing(bottom_blob, bottom_blob_unpacked, 1, opt_pack1);
+        }
+
+        return InnerProduct::forward(bottom_blob_unpacked, top_blob, opt);
     }
 
     if (opt.use_bf16_storage)
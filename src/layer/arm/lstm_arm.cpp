@@ -35,7 +35,7 @@ LSTM_arm::LSTM_arm()
 int LSTM_arm::create_pipeline(const Option& opt)
 {
 #if __ARM_NEON
-    if (opt.use_fp16_storage)
+    if (opt.use_fp16_storage && weight_xc_data.elemsize == 4u)
     {
         ncnn::cast_float32_to_float16(weight_xc_data, weight_xc_data_fp16, opt);
         ncnn::cast_float32_to_float16(weight_hc_data, weight_hc_data_fp16, opt);
@@ -469,6 +469,11 @@ static int lstm_fp16(const Mat& bottom_blob, Mat& top_blob, int reverse, const M
 int LSTM_arm::forward(const Mat& bottom_blob, Mat& top_blob, const Option& opt) const
 {
 #if __ARM_NEON
+    if (weight_xc_data.elemsize == 1u)
+    {
+        return LSTM::forward(bottom_blob, top_blob, opt);
+    }
+
     int T = bottom_blob.h;
     int num_directions = direction == 2 ? 2 : 1;
 
@@ -564,6 +569,11 @@ int LSTM_arm::forward(const Mat& bottom_blob, Mat& top_blob, const Option& opt)
 int LSTM_arm::forward(const std::vector<Mat>& bottom_blobs, std::vector<Mat>& top_blobs, const Option& opt) const
 {
 #if __ARM_NEON
+    if (weight_xc_data.elemsize == 1u)
+    {
+        return LSTM::forward(bottom_blobs, top_blobs, opt);
+    }
+
     if (bottom_blobs.size() != 3 || top_blobs.size() != 3)
     {
         return forward(bottom_blobs[0], top_blobs[0], opt);
@@ -96,6 +96,12 @@ int ConvolutionDepthWise::load_model(const ModelBin& mb)
         bottom_blob_int8_scales = Mat(group);
         bottom_blob_int8_scales.fill(bottom_blob_int8_scale);
     }
+    else if (int8_scale_term == 3)
+    {
+        // groups never mix channels, so the input may be quantized per group
+        weight_data_int8_scales = mb.load(group, 1);
+        bottom_blob_int8_scales = mb.load(group, 1);
+    }
 
     return 0;
 }
@@ -26,6 +26,8 @@ Deconvolution::Deconvolution()
 {
     one_blob_only = true;
     support_inplace = false;
+
+    use_int8_requantize = false;
 }
 
 int Deconvolution::load_param(const ParamDict& pd)
@@ -47,6 +49,7 @@ int Deconvolution::load_param(const ParamDict& pd)
     output_h = pd.get(21, output_w);
     bias_term = pd.get(5, 0);
     weight_data_size = pd.get(6, 0);
+    int8_scale_term = pd.get(8, 0);
     activation_type = pd.get(9, 0);
     activation_params = pd.get(10, Mat());
 
@@ -66,6 +69,39 @@ int Deconvolution::load_model(const ModelBin& mb)
             return -100;
     }
 
+    if (int8_scale_term)
+    {
+        weight_data_int8_scales = mb.load(num_output, 1);
+        bottom_blob_int8_scale = mb.load(1, 1)[0];
+    }
+
+    return 0;
+}
+
+int Deconvolution::create_pipeline(const Option& opt)
+{
+    // runtime quantize the weight data
+    if (opt.use_int8_inference && weight_data.elemsize == (size_t)4u && int8_scale_term)
+    {
+        Mat int8_weight_data(weight_data_size, (size_t)1u);
+        if (int8_weight_data.empty())
+            return -100;
+
+        const int weight_data_size_output = weight_data_size / num_output;
+
+        for (int p = 0; p < num_output; p++)
+        {
+            Option opt_q = opt;
+            opt_q.blob_allocator = int8_weight_data.allocator;
+
+            const Mat weight_data_n = weight_data.range(weight_data_size_output * p, weight_data_size_output);
+            Mat int8_weight_data_n = int8_weight_data.range(weight_data_size_output * p, weight_data_size_output);
+            quantize_float32_to_int8(weight_data_n, int8_weight_data_n, weight_data_int8_scales[p], opt_q);
+        }
+
+        weight_data = int8_weight_data;
+    }
+
     return 0;
 }
 
@@ -74,6 +110,11 @@ int Deconvolution::forward(const Mat& bottom_blob, Mat& top_blob, const Option&
     // backward strided convolv with NxN kernel
     // value = value + bias
 
+    if (opt.use_int8_inference && weight_data.elemsize == (size_t)1u)
+    {
+        return forward_int8(bottom_blob, top_blob, opt);
+    }
+
     int w = bottom_blob.w;
     int h = bottom_blob.h;
     int channels = bottom_blob.c;
@@ -204,6 +245,180 @@ int Deconvolution::forward(const Mat& bottom_blob, Mat& top_blob, const Option&
         }
     }
 
+    return cut_padding(top_blob_bordered, top_blob, opt);
+}
+
+static inline signed char float2int8(float v)
+{
+    int int32 = static_cast<int>(round(v));
+    if (int32 > 127) return 127;
+    if (int32 < -127) return -127;
+    return (signed char)int32;
+}
+
+static inline float activation(float v, int activation_type, const Mat& activation_params)
+{
+    if (activation_type == 1)
+    {
+        v = std::max(v, 0.f);
+    }
+    else if (activation_type == 2)
+    {
+        float slope = activation_params[0];
+        v = v > 0.f ? v : v * slope;
+    }
+    else if (activation_type == 3)
+    {
+        float min = activation_params[0];
+        float max = activation_params[1];
+        if (v < min)
+            v = min;
+        if (v > max)
+            v = max;
+    }
+    else if (activation_type == 4)
+    {
+        v = static_cast<float>(1.f / (1.f + exp(-v)));
+    }
+
+    return v;
+}
+
+int Deconvolution::forward_int8(const Mat& bottom_blob, Mat& top_blob, const Option& opt) const
+{
+    int w = bottom_blob.w;
+    int h = bottom_blob.h;
+    int channels = bottom_blob.c;
+
+    Mat bottom_blob_int8 = bottom_blob;
+    if (bottom_blob.elemsize != 1)
+    {
+        Option opt_g = opt;
+        opt_g.blob_allocator = opt.workspace_allocator;
+
+        quantize_float32_to_int8(bottom_blob, bottom_blob_int8, bottom_blob_int8_scale, opt_g);
+    }
+
+    const int kernel_extent_w = dilation_w * (kernel_w - 1) + 1;
+    const int kernel_extent_h = dilation_h * (kernel_h - 1) + 1;
+
+    int outw = (w - 1) * stride_w + kernel_extent_w;
+    int outh = (h - 1) * stride_h + kernel_extent_h;
+
+    // every input pixel scatters into the int32 sums
+    Mat top_blob_int32(outw, outh, num_output, (size_t)4u, opt.workspace_allocator);
+    if (top_blob_int32.empty())
+        return -100;
+
+    // int8 output when the next layer takes it
+    size_t out_elemsize = use_int8_requantize ? 1u : 4u;
+
+    Mat top_blob_bordered;
+    if (pad_left > 0 || pad_right > 0 || pad_top > 0 || pad_bottom > 0 || output_pad_right > 0 || output_pad_bottom > 0 || (output_w > 0 && output_h > 0))
+    {
+        top_blob_bordered.create(outw, outh, num_output, out_elemsize, opt.workspace_allocator);
+    }
+    else
+    {
+        top_blob_bordered = top_blob;
+        top_blob_bordered.create(outw, outh, num_output, out_elemsize, opt.blob_allocator);
+    }
+    if (top_blob_bordered.empty())
+        return -100;
+
+    const int maxk = kernel_w * kernel_h;
+
+    // kernel offsets
+    std::vector<int> _space_ofs(maxk);
+    int* space_ofs = &_space_ofs[0];
+    {
+        int p1 = 0;
+        int p2 = 0;
+        int gap = outw * dilation_h - kernel_w * dilation_w;
+        for (int i = 0; i < kernel_h; i++)
+        {
+            for (int j = 0; j < kernel_w; j++)
+            {
+                space_ofs[p1] = p2;
+                p1++;
+                p2 += dilation_w;
+            }
+            p2 += gap;
+        }
+    }
+
+    const int size = outw * outh;
+
+    // num_output
+    #pragma omp parallel for num_threads(opt.num_threads)
+    for (int p = 0; p < num_output; p++)
+    {
+        Mat out = top_blob_int32.channel(p);
+
+        out.fill(0);
+
+        for (int i = 0; i < h; i++)
+        {
+            for (int j = 0; j < w; j++)
+            {
+                int* outptr = out.row<int>(i * stride_h) + j * stride_w;
+
+                const signed char* kptr = (const signed char*)weight_data + maxk * channels * p;
+
+                // channels
+                for (int q = 0; q < channels; q++)
+                {
+                    const Mat m = bottom_blob_int8.channel(q);
+                    int val = *(m.row<const signed char>(i) + j);
+
+                    for (int k = 0; k < maxk; k++)
+                    {
+                        int w = kptr[k];
+                        outptr[space_ofs[k]] += val * w;
+                    }
+
+                    kptr += maxk;
+                }
+            }
+        }
+
+        // dequantize, add bias and activate
+        float scale_in;
+        if (weight_data_int8_scales[p] == 0)
+            scale_in = 0;
+        else
+            scale_in = 1.f / (bottom_blob_int8_scale * weight_data_int8_scales[p]);
+
+        const float bias = bias_term ? bias_data[p] : 0.f;
+
+        const int* sumptr = out;
+
+        if (use_int8_requantize)
+        {
+            signed char* outptr = top_blob_bordered.channel(p);
+
+            for (int i = 0; i < size; i++)
+            {
+                float sumfp32 = activation(sumptr[i] * scale_in + bias, activation_type, activation_params);
+                outptr[i] = float2int8(sumfp32 * top_blob_int8_scale);
+            }
+        }
+        else
+        {
+            float* outptr = top_blob_bordered.channel(p);
+
+            for (int i = 0; i < size; i++)
+            {
+                outptr[i] = activation(sumptr[i] * scale_in + bias, activation_type, activation_params);
+            }
+        }
+    }
+
+    return cut_padding(top_blob_bordered, top_blob, opt);
+}
+
+int Deconvolution::cut_padding(const Mat& top_blob_bordered, Mat& top_blob, const Option& opt) const
+{
     if (pad_left > 0 || pad_right > 0 || pad_top > 0 || pad_bottom > 0)
     {
         Mat top_blob_bordered_adj = top_blob_bordered;
@@ -219,9 +434,6 @@ int Deconvolution::forward(const Mat& bottom_blob, Mat& top_blob, const Option&
         copy_cut_border(top_blob_bordered_adj, top_blob, pad_top, pad_bottom, pad_left, pad_right, opt);
         if (top_blob.empty())
             return -100;
-
-        outw = top_blob.w;
-        outh = top_blob.h;
     }
     else if (output_w > 0 && output_h > 0)
     {
@@ -250,9 +462,6 @@ int Deconvolution::forward(const Mat& bottom_blob, Mat& top_blob, const Option&
         }
         if (top_blob.empty())
             return -100;
-
-        outw = top_blob.w;
-        outh = top_blob.h;
     }
     else
     {
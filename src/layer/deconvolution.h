@@ -28,8 +28,16 @@ public:
 
     virtual int load_model(const ModelBin& mb);
 
+    virtual int create_pipeline(const Option& opt);
+
     virtual int forward(const Mat& bottom_blob, Mat& top_blob, const Option& opt) const;
 
+protected:
+    int forward_int8(const Mat& bottom_blob, Mat& top_blob, const Option& opt) const;
+
+    // apply pad and output_pad, or cut to output_w and output_h
+    int cut_padding(const Mat& top_blob_bordered, Mat& top_blob, const Option& opt) const;
+
 public:
     // param
     int num_output;
@@ -51,6 +59,8 @@ public:
 
     int weight_data_size;
 
+    int int8_scale_term;
+
     // 0=none 1=relu 2=leakyrelu 3=clip 4=sigmoid
     int activation_type;
     Mat activation_params;
@@ -58,6 +68,12 @@ public:
     // model
     Mat weight_data;
     Mat bias_data;
+
+    Mat weight_data_int8_scales;
+    float bottom_blob_int8_scale;
+    float top_blob_int8_scale;
+
+    bool use_int8_requantize;
 };
 
 } // namespace ncnn
@@ -0,0 +1,283 @@
+// Tencent is pleased to support the open source community by making ncnn available.
+//
+// Copyright (C) 2020 THL A29 Limited, a Tencent company. All rights reserved.
+//
+// Licensed under the BSD 3-Clause License (the "License"); you may not use this file except
+// in compliance with the License. You may obtain a copy of the License at
+//
+// https://opensource.org/licenses/BSD-3-Clause
+//
+// Unless required by applicable law or agreed to in writing, software distributed
+// under the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR
+// CONDITIONS OF ANY KIND, either express or implied. See the License for the
+// specific language governing permissions and limitations under the License.
+
+#include "gru.h"
+
+#include <math.h>
+#include <string.h>
+
+#include <algorithm>
+
+namespace ncnn {
+
+DEFINE_LAYER_CREATOR(GRU)
+
+GRU::GRU()
+{
+    one_blob_only = false;
+    support_inplace = false;
+    support_batch = true;
+}
+
+int GRU::load_param(const ParamDict& pd)
+{
+    num_output = pd.get(0, 0);
+    weight_data_size = pd.get(1, 0);
+    direction = pd.get(2, 0);
+    int8_scale_term = pd.get(8, 0);
+    if (direction == 2)
+        one_blob_only = true;
+    return 0;
+}
+
+int GRU::load_model(const ModelBin& mb)
+{
+    int num_directions = direction == 2 ? 2 : 1;
+
+    int size = weight_data_size / num_directions / num_output / 3;
+
+    // raw weight data
+    weight_xc_data = mb.load(size, num_output * 3, num_directions, 0);
+    if (weight_xc_data.empty())
+        return -100;
+
+    // bias R U WN BN
+    bias_c_data = mb.load(num_output, 4, num_directions, 0);
+    if (bias_c_data.empty())
+        return -100;
+
+    weight_hc_data = mb.load(num_output, num_output * 3, num_directions, 0);
+    if (weight_hc_data.empty())
+        return -100;
+
+    if (int8_scale_term)
+    {
+        weight_xc_data_int8_scales = mb.load(num_output * 3, num_directions, 1);
+        weight_hc_data_int8_scales = mb.load(num_output * 3, num_directions, 1);
+    }
+
+    return 0;
+}
+
+static inline float dot(const float* weight, const float* x, int size)
+{
+    float sum = 0.f;
+    for (int i = 0; i < size; i++)
+    {
+        sum += weight[i] * x[i];
+    }
+    return sum;
+}
+
+static inline float dot(const signed char* weight, const float* x, int size)
+{
+    float sum = 0.f;
+    for (int i = 0; i < size; i++)
+    {
+        sum += weight[i] * x[i];
+    }
+    return sum;
+}
+
+// weight row r times the input row, dequantized when the weight is int8
+static inline float dot_row(const Mat& weight, const float* int8_scales, int r, const float* x, int size)
+{
+    if (weight.elemsize == 1u)
+    {
+        return dot(weight.row<const signed char>(r), x, size) / int8_scales[r];
+    }
+
+    return dot(weight.row(r), x, size);
+}
+
+// gates := W_xc * x_t + b_c for all timesteps
+// every weight row is read once for the whole sequence
+static void gru_input_gemm(const Mat& bottom_blob, Mat& gates, const Mat& weight_xc, const float* bias_c, const float* weight_xc_int8_scales, const Option& opt)
+{
+    int size = bottom_blob.w;
+    int T = bottom_blob.h;
+
+    int rows = gates.w;
+
+    #pragma omp parallel for num_threads(opt.num_threads)
+    for (int r = 0; r < rows; r++)
+    {
+        for (int t = 0; t < T; t++)
+        {
+            gates.row(t)[r] = bias_c[r] + dot_row(weight_xc, weight_xc_int8_scales, r, bottom_blob.row(t), size);
+        }
+    }
+}
+
+// runs all sequences in all directions together, one timestep after another
+// the recurrent part of a timestep is split over the hidden units of every sequence
+// hidden_states are num_output x num_directions per sequence
+static int gru(const std::vector<Mat>& bottom_blobs, std::vector<Mat>& top_blobs, std::vector<Mat>& hidden_states, int direction, const Mat& weight_xc, const Mat& bias_c, const Mat& weight_hc, const Mat& weight_xc_int8_scales, const Mat& weight_hc_int8_scales, const Option& opt)
+{
+    const int num_directions = direction == 2 ? 2 : 1;
+    const int num_sequences = (int)bottom_blobs.size() * num_directions;
+
+    const int num_output = weight_hc.w;
+
+    // 3 x num_output gates of every timestep, the input part of R U N
+    std::vector<Mat> gates(num_sequences);
+    int max_T = 0;
+    for (int s = 0; s < num_sequences; s++)
+    {
+        const Mat& bottom_blob = bottom_blobs[s / num_directions];
+        const int d = s % num_directions;
+
+        gates[s].create(num_output * 3, bottom_blob.h, 4u, opt.workspace_allocator);
+        if (gates[s].empty())
+            return -100;
+
+        const float* xc_int8_scales = weight_xc.elemsize == 1u ? weight_xc_int8_scales.row(d) : 0;
+        gru_input_gemm(bottom_blob, gates[s], weight_xc.channel(d), bias_c.channel(d), xc_int8_scales, opt);
+
+        max_T = std::max(max_T, bottom_blob.h);
+    }
+
+    // unroll
+    for (int t = 0; t < max_T; t++)
+    {
+        #pragma omp parallel for num_threads(opt.num_threads)
+        for (int i = 0; i < num_sequences * num_output; i++)
+        {
+            const int s = i / num_output;
+            const int q = i % num_output;
+
+            const int T = gates[s].h;
+            if (t >= T)
+                continue;
+
+            const int b = s / num_directions;
+            const int d = s % num_directions;
+            const int reverse = direction == 2 ? d : direction;
+            const int ti = reverse ? T - 1 - t : t;
+
+            // the previous hidden state is the output of the previous timestep
+            const float* hidden_ptr = t == 0 ? (const float*)hidden_states[b].row(d) : (const float*)top_blobs[b].row(reverse ? ti + 1 : ti - 1) + d * num_output;
+
+            const Mat weight_hc_d = weight_hc.channel(d);
+            const float* hc_int8_scales = weight_hc.elemsize == 1u ? weight_hc_int8_scales.row(d) : 0;
+
+            const float* bias_c_BN = bias_c.channel(d).row(3);
+
+            // gate reset update
+            const float* gates_data = gates[s].row(ti);
+            float R = gates_data[num_output * 0 + q] + dot_row(weight_hc_d, hc_int8_scales, num_output * 0 + q, hidden_ptr, num_output);
+            float U = gates_data[num_output * 1 + q] + dot_row(weight_hc_d, hc_int8_scales, num_output * 1 + q, hidden_ptr, num_output);
+
+            R = 1.f / (1.f + exp(-R));
+            U = 1.f / (1.f + exp(-U));
+
+            // gate new
+            float N = bias_c_BN[q] + dot_row(weight_hc_d, hc_int8_scales, num_output * 2 + q, hidden_ptr, num_output);
+
+            N = tanh(gates_data[num_output * 2 + q] + R * N);
+
+            // h_t := (1 - u_t) .* n_t + u_t .* h_{t-1}
+            float H = (1.f - U) * N + U * hidden_ptr[q];
+
+            top_blobs[b].row(ti)[d * num_output + q] = H;
+        }
+    }
+
+    // keep the last hidden state
+    for (int s = 0; s < num_sequences; s++)
+    {
+        const int T = gates[s].h;
+        if (T == 0)
+            continue;
+
+        const int b = s / num_directions;
+        const int d = s % num_directions;
+        const int reverse = direction == 2 ? d : direction;
+
+        const float* ptr = (const float*)top_blobs[b].row(reverse ? 0 : T - 1) + d * num_output;
+        memcpy(hidden_states[b].row(d), ptr, num_output * sizeof(float));
+    }
+
+    return 0;
+}
+
+int GRU::forward(const Mat& bottom_blob, Mat& top_blob, const Option& opt) const
+{
+    std::vector<Mat> bottom_blobs(1, bottom_blob);
+    std::vector<Mat> top_blobs(1);
+    int ret = GRU::forward_batch(bottom_blobs, top_blobs, opt);
+    if (ret != 0)
+        return ret;
+
+    top_blob = top_blobs[0];
+
+    return 0;
+}
+
+int GRU::forward(const std::vector<Mat>& bottom_blobs, std::vector<Mat>& top_blobs, const Option& opt) const
+{
+    if (bottom_blobs.size() != 2 || top_blobs.size() != 2)
+    {
+        return forward(bottom_blobs[0], top_blobs[0], opt);
+    }
+    const Mat& bottom_blob = bottom_blobs[0];
+    int T = bottom_blob.h;
+
+    //Copy previous states
+    std::vector<Mat> hidden_states(1);
+    hidden_states[0] = bottom_blobs[1].clone(opt.blob_allocator);
+    if (hidden_states[0].empty())
+        return -100;
+
+    std::vector<Mat> top_blobs0(1);
+    top_blobs0[0].create(num_output, T, 4u, opt.blob_allocator);
+    if (top_blobs0[0].empty())
+        return -100;
+
+    // Uni directional
+    int ret = gru(std::vector<Mat>(1, bottom_blob), top_blobs0, hidden_states, direction, weight_xc_data, bias_c_data, weight_hc_data, weight_xc_data_int8_scales, weight_hc_data_int8_scales, opt);
+    if (ret != 0)
+        return ret;
+
+    top_blobs[0] = top_blobs0[0];
+    top_blobs[1] = hidden_states[0];
+
+    return 0;
+}
+
+int GRU::forward_batch(const std::vector<Mat>& bottom_blobs, std::vector<Mat>& top_blobs, const Option& opt) const
+{
+    const int batch = (int)bottom_blobs.size();
+    const int num_directions = direction == 2 ? 2 : 1;
+
+    top_blobs.resize(batch);
+
+    // initial hidden state
+    std::vector<Mat> hidden_states(batch);
+    for (int n = 0; n < batch; n++)
+    {
+        hidden_states[n].create(num_output, num_directions, 4u, opt.workspace_allocator);
+        if (hidden_states[n].empty())
+            return -100;
+        hidden_states[n].fill(0.f);
+
+        top_blobs[n].create(num_output * num_directions, bottom_blobs[n].h, 4u, opt.blob_allocator);
+        if (top_blobs[n].empty())
+            return -100;
+    }
+
+    return gru(bottom_blobs, top_blobs, hidden_states, direction, weight_xc_data, bias_c_data, weight_hc_data, weight_xc_data_int8_scales, weight_hc_data_int8_scales, opt);
+}
+
+} // namespace ncnn
@@ -0,0 +1,54 @@
+// Tencent is pleased to support the open source community by making ncnn available.
+//
+// Copyright (C) 2020 THL A29 Limited, a Tencent company. All rights reserved.
+//
+// Licensed under the BSD 3-Clause License (the "License"); you may not use this file except
+// in compliance with the License. You may obtain a copy of the License at
+//
+// https://opensource.org/licenses/BSD-3-Clause
+//
+// Unless required by applicable law or agreed to in writing, software distributed
+// under the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR
+// CONDITIONS OF ANY KIND, either express or implied. See the License for the
+// specific language governing permissions and limitations under the License.
+
+#ifndef LAYER_GRU_H
+#define LAYER_GRU_H
+
+#include "layer.h"
+
+namespace ncnn {
+
+class GRU : public Layer
+{
+public:
+    GRU();
+
+    virtual int load_param(const ParamDict& pd);
+
+    virtual int load_model(const ModelBin& mb);
+
+    virtual int forward(const Mat& bottom_blob, Mat& top_blob, const Option& opt) const;
+
+    virtual int forward(const std::vector<Mat>& bottom_blobs, std::vector<Mat>& top_blobs, const Option& opt) const;
+
+    virtual int forward_batch(const std::vector<Mat>& bottom_blobs, std::vector<Mat>& top_blobs, const Option& opt) const;
+
+public:
+    int num_output;
+    int weight_data_size;
+    int direction; // 0=forward 1=reverse 2=bidirectional
+    int int8_scale_term;
+
+    Mat weight_hc_data;
+    Mat weight_xc_data;
+    Mat bias_c_data;
+
+    // int8 weight storage, one scale per weight row
+    Mat weight_xc_data_int8_scales;
+    Mat weight_hc_data_int8_scales;
+};
+
+} // namespace ncnn
+
+#endif // LAYER_GRU_H
@@ -26,6 +26,9 @@ InnerProduct::InnerProduct()
 {
     one_blob_only = true;
     support_inplace = false;
+    support_batch = true;
+
+    use_int8_requantize = false;
 }
 
 int InnerProduct::load_param(const ParamDict& pd)
@@ -89,6 +92,34 @@ int InnerProduct::create_pipeline(const Option& opt)
     return 0;
 }
 
+static inline float activation(float v, int activation_type, const Mat& activation_params)
+{
+    if (activation_type == 1)
+    {
+        v = std::max(v, 0.f);
+    }
+    else if (activation_type == 2)
+    {
+        float slope = activation_params[0];
+        v = v > 0.f ? v : v * slope;
+    }
+    else if (activation_type == 3)
+    {
+        float min = activation_params[0];
+        float max = activation_params[1];
+        if (v < min)
+            v = min;
+        if (v > max)
+            v = max;
+    }
+    else if (activation_type == 4)
+    {
+        v = static_cast<float>(1.f / (1.f + exp(-v)));
+    }
+
+    return v;
+}
+
 int InnerProduct::forward(const Mat& bottom_blob, Mat& top_blob, const Option& opt) const
 {
     if (opt.use_int8_inference && weight_data.elemsize == (size_t)1u)
@@ -126,35 +157,90 @@ int InnerProduct::forward(const Mat& bottom_blob, Mat& top_blob, const Option& o
                 sum += m[i] * w[i];
             }
         }
-        if (activation_type == 1)
-        {
-            sum = std::max(sum, 0.f);
-        }
-        else if (activation_type == 2)
-        {
-            float slope = activation_params[0];
-            sum = sum > 0.f ? sum : sum * slope;
-        }
-        else if (activation_type == 3)
+        sum = activation(sum, activation_type, activation_params);
+
+        top_blob[p] = sum;
+    }
+
+    return 0;
+}
+
+int InnerProduct::forward_batch(const std::vector<Mat>& bottom_blobs, std::vector<Mat>& top_blobs, const Option& opt) const
+{
+    const int batch = (int)bottom_blobs.size();
+    const int size = weight_data_size / num_output;
+
+    // int8, packed and low precision samples go one by one
+    bool batchable = !(opt.use_int8_inference && weight_data.elemsize == (size_t)1u);
+    for (int n = 0; n < batch && batchable; n++)
+    {
+        const Mat& m = bottom_blobs[n];
+        batchable = m.elemsize == 4u && m.elempack == 1 && m.w * m.h * m.c == size;
+    }
+
+    if (!batchable)
+        return Layer::forward_batch(bottom_blobs, top_blobs, opt);
+
+    // gather the samples as rows of a batch x size matrix
+    Mat bottom_rows(size, batch, 4u, opt.workspace_allocator);
+    if (bottom_rows.empty())
+        return -100;
+
+    for (int n = 0; n < batch; n++)
+    {
+        const Mat& m = bottom_blobs[n];
+        const int channel_size = m.w * m.h;
+
+        float* outptr = bottom_rows.row(n);
+        for (int q = 0; q < m.c; q++)
         {
-            float min = activation_params[0];
-            float max = activation_params[1];
-            if (sum < min)
-                sum = min;
-            if (sum > max)
-                sum = max;
+            memcpy(outptr + channel_size * q, m.channel(q), channel_size * sizeof(float));
         }
-        else if (activation_type == 4)
+    }
+
+    top_blobs.resize(batch);
+    for (int n = 0; n < batch; n++)
+    {
+        top_blobs[n].create(num_output, 4u, opt.blob_allocator);
+        if (top_blobs[n].empty())
+            return -100;
+    }
+
+    // every weight row is read once for the whole batch
+    #pragma omp parallel for num_threads(opt.num_threads)
+    for (int p = 0; p < num_output; p++)
+    {
+        const float* w = (const float*)weight_data + size * p;
+
+        for (int n = 0; n < batch; n++)
         {
-            sum = static_cast<float>(1.f / (1.f + exp(-sum)));
-        }
+            const float* m = bottom_rows.row(n);
 
-        top_blob[p] = sum;
+            float sum = 0.f;
+
+            if (bias_term)
+                sum = bias_data[p];
+
+            for (int i = 0; i < size; i++)
+            {
+                sum += m[i] * w[i];
+            }
+
+            top_blobs[n][p] = activation(sum, activation_type, activation_params);
+        }
     }
 
     return 0;
 }
 
+static inline signed char float2int8(float v)
+{
+    int int32 = static_cast<int>(round(v));
+    if (int32 > 127) return 127;
+    if (int32 < -127) return -127;
+    return (signed char)int32;
+}
+
 int InnerProduct::forward_int8(const Mat& bottom_blob, Mat& top_blob, const Option& opt) const
 {
     int w = bottom_blob.w;
@@ -172,7 +258,10 @@ int InnerProduct::forward_int8(const Mat& bottom_blob, Mat& top_blob, const Opti
         quantize_float32_to_int8(bottom_blob, bottom_blob_tm, bottom_blob_int8_scale, opt_g);
     }
 
-    top_blob.create(num_output, 4u, opt.blob_allocator);
+    // int8 output when the next layer takes it
+    size_t out_elemsize = use_int8_requantize ? 1u : 4u;
+
+    top_blob.create(num_output, out_elemsize, opt.blob_allocator);
     if (top_blob.empty())
         return -100;
 
@@ -180,8 +269,6 @@ int InnerProduct::forward_int8(const Mat& bottom_blob, Mat& top_blob, const Opti
     #pragma omp parallel for num_threads(opt.num_threads)
     for (int p = 0; p < num_output; p++)
     {
-        float* outptr = top_blob;
-
         int sum = 0;
 
         // channels
@@ -213,7 +300,16 @@ int InnerProduct::forward_int8(const Mat& bottom_blob, Mat& top_blob, const Opti
             sumfp32 = std::max(sumfp32, 0.f);
         }
 
-        outptr[p] = sumfp32;
+        if (use_int8_requantize)
+        {
+            signed char* outptr = top_blob;
+            outptr[p] = float2int8(sumfp32 * top_blob_int8_scale);
+        }
+        else
+        {
+            float* outptr = top_blob;
+            outptr[p] = sumfp32;
+        }
     }
 
     return 0;
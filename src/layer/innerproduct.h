@@ -31,6 +31,7 @@ public:
     virtual int create_pipeline(const Option& opt);
 
     virtual int forward(const Mat& bottom_blob, Mat& top_blob, const Option& opt) const;
+    virtual int forward_batch(const std::vector<Mat>& bottom_blobs, std::vector<Mat>& top_blobs, const Option& opt) const;
     virtual int forward_int8(const Mat& bottom_blob, Mat& top_blob, const Option& opt) const;
 
 public:
@@ -52,6 +53,9 @@ public:
 
     Mat weight_data_int8_scales;
     float bottom_blob_int8_scale;
+    float top_blob_int8_scale;
+
+    bool use_int8_requantize;
 };
 
 } // namespace ncnn
@@ -15,6 +15,9 @@
 #include "lstm.h"
 
 #include <math.h>
+#include <string.h>
+
+#include <algorithm>
 
 namespace ncnn {
 
@@ -24,6 +27,7 @@ LSTM::LSTM()
 {
     one_blob_only = false;
     support_inplace = false;
+    support_batch = true;
 }
 
 int LSTM::load_param(const ParamDict& pd)
@@ -31,6 +35,7 @@ int LSTM::load_param(const ParamDict& pd)
     num_output = pd.get(0, 0);
     weight_data_size = pd.get(1, 0);
     direction = pd.get(2, 0);
+    int8_scale_term = pd.get(8, 0);
     if (direction == 2)
         one_blob_only = true;
     return 0;
@@ -55,180 +60,173 @@ int LSTM::load_model(const ModelBin& mb)
     if (weight_hc_data.empty())
         return -100;
 
+    if (int8_scale_term)
+    {
+        weight_xc_data_int8_scales = mb.load(num_output * 4, num_directions, 1);
+        weight_hc_data_int8_scales = mb.load(num_output * 4, num_directions, 1);
+    }
+
     return 0;
 }
 
-static int lstm(const Mat& bottom_blob, Mat& top_blob, int reverse, const Mat& weight_xc, const Mat& bias_c, const Mat& weight_hc, Mat& hidden_state, Mat& cell_state, const Option& opt)
+static inline float dot(const float* weight, const float* x, int size)
 {
-    int size = bottom_blob.w;
-    int T = bottom_blob.h;
-
-    int num_output = top_blob.w;
-
-    // 4 x num_output
-    Mat gates(4, num_output, 4u, opt.workspace_allocator);
-    if (gates.empty())
-        return -100;
+    float sum = 0.f;
+    for (int i = 0; i < size; i++)
+    {
+        sum += weight[i] * x[i];
+    }
+    return sum;
+}
 
-    // unroll
-    for (int t = 0; t < T; t++)
+static inline float dot(const signed char* weight, const float* x, int size)
+{
+    float sum = 0.f;
+    for (int i = 0; i < size; i++)
     {
-        // clip hidden by continuation indicator
-        // h_cont_{t-1} = cont_t * h_{t-1}
-        // h_cont_{t-1} = h_{t-1} if cont_t == 1
-        //                0       otherwise
-        // calculate hidden
-        // gate_input_t := W_hc * h_conted_{t-1} + W_xc * x_t + b_c
+        sum += weight[i] * x[i];
+    }
+    return sum;
+}
 
-        int ti = reverse ? T - 1 - t : t;
+// weight row r times the input row, dequantized when the weight is int8
+static inline float dot_row(const Mat& weight, const float* int8_scales, int r, const float* x, int size)
+{
+    if (weight.elemsize == 1u)
+    {
+        return dot(weight.row<const signed char>(r), x, size) / int8_scales[r];
+    }
 
-        const float* x = bottom_blob.row(ti);
-        for (int q = 0; q < num_output; q++)
-        {
-            const float* bias_c_I = bias_c.row(0);
-            const float* bias_c_F = bias_c.row(1);
-            const float* bias_c_O = bias_c.row(2);
-            const float* bias_c_G = bias_c.row(3);
+    return dot(weight.row(r), x, size);
+}
 
-            float* gates_data = gates.row(q);
+// gates := W_xc * x_t + b_c for all timesteps
+// every weight row is read once for the whole sequence
+static void lstm_input_gemm(const Mat& bottom_blob, Mat& gates, const Mat& weight_xc, const float* bias_c, const float* weight_xc_int8_scales, const Option& opt)
+{
+    int size = bottom_blob.w;
+    int T = bottom_blob.h;
 
-            // gate I F O G
-            const float* weight_xc_I = weight_xc.row(num_output * 0 + q);
-            const float* weight_xc_F = weight_xc.row(num_output * 1 + q);
-            const float* weight_xc_O = weight_xc.row(num_output * 2 + q);
-            const float* weight_xc_G = weight_xc.row(num_output * 3 + q);
-
-            const float* weight_hc_I = weight_hc.row(num_output * 0 + q);
-            const float* weight_hc_F = weight_hc.row(num_output * 1 + q);
-            const float* weight_hc_O = weight_hc.row(num_output * 2 + q);
-            const float* weight_hc_G = weight_hc.row(num_output * 3 + q);
-
-            float I = bias_c_I[q];
-            float F = bias_c_F[q];
-            float O = bias_c_O[q];
-            float G = bias_c_G[q];
-
-            for (int i = 0; i < size; i++)
-            {
-                float xi = x[i];
-
-                I += weight_xc_I[i] * xi;
-                F += weight_xc_F[i] * xi;
-                O += weight_xc_O[i] * xi;
-                G += weight_xc_G[i] * xi;
-            }
-
-            for (int i = 0; i < num_output; i++)
-            {
-                float h_cont = hidden_state[i];
-
-                I += weight_hc_I[i] * h_cont;
-                F += weight_hc_F[i] * h_cont;
-                O += weight_hc_O[i] * h_cont;
-                G += weight_hc_G[i] * h_cont;
-            }
-
-            gates_data[0] = I;
-            gates_data[1] = F;
-            gates_data[2] = O;
-            gates_data[3] = G;
-        }
+    int rows = gates.w;
 
-        // lstm unit
-        // sigmoid(I)
-        // sigmoid(F)
-        // sigmoid(O)
-        // tanh(G)
-        // c_t := f_t .* c_{t-1} + i_t .* g_t
-        // h_t := o_t .* tanh[c_t]
-        float* output_data = top_blob.row(ti);
-        for (int q = 0; q < num_output; q++)
+    #pragma omp parallel for num_threads(opt.num_threads)
+    for (int r = 0; r < rows; r++)
+    {
+        for (int t = 0; t < T; t++)
         {
-            const float* gates_data = gates.row(q);
-
-            float I = gates_data[0];
-            float F = gates_data[1];
-            float O = gates_data[2];
-            float G = gates_data[3];
-
-            I = 1.f / (1.f + exp(-I));
-            F = 1.f / (1.f + exp(-F));
-            O = 1.f / (1.f + exp(-O));
-            G = tanh(G);
-
-            float cell2 = F * cell_state[q] + I * G;
-            float H = O * tanh(cell2);
-            cell_state[q] = cell2;
-            hidden_state[q] = H;
-            output_data[q] = H;
+            gates.row(t)[r] = bias_c[r] + dot_row(weight_xc, weight_xc_int8_scales, r, bottom_blob.row(t), size);
         }
     }
-
-    return 0;
 }
 
-int LSTM::forward(const Mat& bottom_blob, Mat& top_blob, const Option& opt) const
+// runs all sequences in all directions together, one timestep after another
+// the recurrent part of a timestep is split over the hidden units of every sequence
+// hidden_states and cell_states are num_output x num_directions per sequence
+static int lstm(const std::vector<Mat>& bottom_blobs, std::vector<Mat>& top_blobs, std::vector<Mat>& hidden_states, std::vector<Mat>& cell_states, int direction, const Mat& weight_xc, const Mat& bias_c, const Mat& weight_hc, const Mat& weight_xc_int8_scales, const Mat& weight_hc_int8_scales, const Option& opt)
 {
-    int T = bottom_blob.h;
+    const int num_directions = direction == 2 ? 2 : 1;
+    const int num_sequences = (int)bottom_blobs.size() * num_directions;
 
-    int num_directions = direction == 2 ? 2 : 1;
+    const int num_output = weight_hc.w;
 
-    // initial hidden state
-    Mat hidden(num_output, 4u, opt.workspace_allocator);
-    if (hidden.empty())
-        return -100;
-    hidden.fill(0.f);
+    // 4 x num_output gates of every timestep
+    std::vector<Mat> gates(num_sequences);
+    int max_T = 0;
+    for (int s = 0; s < num_sequences; s++)
+    {
+        const Mat& bottom_blob = bottom_blobs[s / num_directions];
+        const int d = s % num_directions;
 
-    Mat cell(num_output, 4u, opt.workspace_allocator);
-    if (cell.empty())
-        return -100;
-    cell.fill(0.f);
+        gates[s].create(num_output * 4, bottom_blob.h, 4u, opt.workspace_allocator);
+        if (gates[s].empty())
+            return -100;
 
-    top_blob.create(num_output * num_directions, T, 4u, opt.blob_allocator);
-    if (top_blob.empty())
-        return -100;
+        const float* xc_int8_scales = weight_xc.elemsize == 1u ? weight_xc_int8_scales.row(d) : 0;
+        lstm_input_gemm(bottom_blob, gates[s], weight_xc.channel(d), bias_c.channel(d), xc_int8_scales, opt);
 
-    // Uni directional
-    if (direction == 0 || direction == 1)
-    {
-        int ret = lstm(bottom_blob, top_blob, direction, weight_xc_data.channel(0), bias_c_data.channel(0), weight_hc_data.channel(0), hidden, cell, opt);
-        if (ret != 0)
-            return ret;
+        max_T = std::max(max_T, bottom_blob.h);
     }
 
-    if (direction == 2)
+    // unroll
+    for (int t = 0; t < max_T; t++)
     {
-        Mat top_blob_forward(num_output, T, 4u, opt.workspace_allocator);
-        if (top_blob_forward.empty())
-            return -100;
+        #pragma omp parallel for num_threads(opt.num_threads)
+        for (int i = 0; i < num_sequences * num_output; i++)
+        {
+            const int s = i / num_output;
+            const int q = i % num_output;
 
-        Mat top_blob_reverse(num_output, T, 4u, opt.workspace_allocator);
-        if (top_blob_reverse.empty())
-            return -100;
+            const int T = gates[s].h;
+            if (t >= T)
+                continue;
 
-        int ret0 = lstm(bottom_blob, top_blob_forward, 0, weight_xc_data.channel(0), bias_c_data.channel(0), weight_hc_data.channel(0), hidden, cell, opt);
-        if (ret0 != 0)
-            return ret0;
+            const int b = s / num_directions;
+            const int d = s % num_directions;
+            const int reverse = direction == 2 ? d : direction;
+            const int ti = reverse ? T - 1 - t : t;
 
-        hidden.fill(0.0f);
-        cell.fill(0.0f);
+            // the previous hidden state is the output of the previous timestep
+            const float* hidden_ptr = t == 0 ? (const float*)hidden_states[b].row(d) : (const float*)top_blobs[b].row(reverse ? ti + 1 : ti - 1) + d * num_output;
 
-        int ret1 = lstm(bottom_blob, top_blob_reverse, 1, weight_xc_data.channel(1), bias_c_data.channel(1), weight_hc_data.channel(1), hidden, cell, opt);
-        if (ret1 != 0)
-            return ret1;
+            const Mat weight_hc_d = weight_hc.channel(d);
+            const float* hc_int8_scales = weight_hc.elemsize == 1u ? weight_hc_int8_scales.row(d) : 0;
 
-        // concat w
-        for (int i = 0; i < T; i++)
-        {
-            const float* pf = top_blob_forward.row(i);
-            const float* pr = top_blob_reverse.row(i);
-            float* ptr = top_blob.row(i);
+            // gate I F O G
+            const float* gates_data = gates[s].row(ti);
+            float I = gates_data[num_output * 0 + q] + dot_row(weight_hc_d, hc_int8_scales, num_output * 0 + q, hidden_ptr, num_output);
+            float F = gates_data[num_output * 1 + q] + dot_row(weight_hc_d, hc_int8_scales, num_output * 1 + q, hidden_ptr, num_output);
+            float O = gates_data[num_output * 2 + q] + dot_row(weight_hc_d, hc_int8_scales, num_output * 2 + q, hidden_ptr, num_output);
+            float G = gates_data[num_output * 3 + q] + dot_row(weight_hc_d, hc_int8_scales, num_output * 3 + q, hidden_ptr, num_output);
+
+            // lstm unit
+            // sigmoid(I)
+            // sigmoid(F)
+            // sigmoid(O)
+            // tanh(G)
+            // c_t := f_t .* c_{t-1} + i_t .* g_t
+            // h_t := o_t .* tanh[c_t]
+            I = 1.f / (1.f + exp(-I));
+            F = 1.f / (1.f + exp(-F));
+            O = 1.f / (1.f + exp(-O));
+            G = tanh(G);
 
-            memcpy(ptr, pf, num_output * sizeof(float));
-            memcpy(ptr + num_output, pr, num_output * sizeof(float));
+            float* cell_ptr = cell_states[b].row(d);
+
+            float cell2 = F * cell_ptr[q] + I * G;
+            float H = O * tanh(cell2);
+            cell_ptr[q] = cell2;
+            top_blobs[b].row(ti)[d * num_output + q] = H;
         }
     }
 
+    // keep the last hidden state
+    for (int s = 0; s < num_sequences; s++)
+    {
+        const int T = gates[s].h;
+        if (T == 0)
+            continue;
+
+        const int b = s / num_directions;
+        const int d = s % num_directions;
+        const int reverse = direction == 2 ? d : direction;
+
+        const float* ptr = (const float*)top_blobs[b].row(reverse ? 0 : T - 1) + d * num_output;
+        memcpy(hidden_states[b].row(d), ptr, num_output * sizeof(float));
+    }
+
+    return 0;
+}
+
+int LSTM::forward(const Mat& bottom_blob, Mat& top_blob, const Option& opt) const
+{
+    std::vector<Mat> bottom_blobs(1, bottom_blob);
+    std::vector<Mat> top_blobs(1);
+    int ret = LSTM::forward_batch(bottom_blobs, top_blobs, opt);
+    if (ret != 0)
+        return ret;
+
+    top_blob = top_blobs[0];
+
     return 0;
 }
 
@@ -240,27 +238,61 @@ int LSTM::forward(const std::vector<Mat>& bottom_blobs, std::vector<Mat>& top_bl
     }
     const Mat& bottom_blob = bottom_blobs[0];
     int T = bottom_blob.h;
-    Mat& top_blob = top_blobs[0];
-    Mat& hidden_state = top_blobs[1];
-    Mat& cell_state = top_blobs[2];
+
+    std::vector<Mat> hidden_states(1);
+    std::vector<Mat> cell_states(1);
 
     //Copy previous states
-    hidden_state = bottom_blobs[1].clone(opt.blob_allocator);
-    cell_state = bottom_blobs[2].clone(opt.blob_allocator);
+    hidden_states[0] = bottom_blobs[1].clone(opt.blob_allocator);
+    cell_states[0] = bottom_blobs[2].clone(opt.blob_allocator);
+    if (hidden_states[0].empty() || cell_states[0].empty())
+        return -100;
 
-    top_blob.create(num_output, T, 4u, opt.blob_allocator);
-    if (top_blob.empty())
+    std::vector<Mat> top_blobs0(1);
+    top_blobs0[0].create(num_output, T, 4u, opt.blob_allocator);
+    if (top_blobs0[0].empty())
         return -100;
 
     // Uni directional
-    if (direction == 0 || direction == 1)
+    int ret = lstm(std::vector<Mat>(1, bottom_blob), top_blobs0, hidden_states, cell_states, direction, weight_xc_data, bias_c_data, weight_hc_data, weight_xc_data_int8_scales, weight_hc_data_int8_scales, opt);
+    if (ret != 0)
+        return ret;
+
+    top_blobs[0] = top_blobs0[0];
+    top_blobs[1] = hidden_states[0];
+    top_blobs[2] = cell_states[0];
+
+    return 0;
+}
+
+int LSTM::forward_batch(const std::vector<Mat>& bottom_blobs, std::vector<Mat>& top_blobs, const Option& opt) const
+{
+    const int batch = (int)bottom_blobs.size();
+    const int num_directions = direction == 2 ? 2 : 1;
+
+    top_blobs.resize(batch);
+
+    // initial hidden and cell state
+    std::vector<Mat> hidden_states(batch);
+    std::vector<Mat> cell_states(batch);
+    for (int n = 0; n < batch; n++)
     {
-        int ret = lstm(bottom_blob, top_blob, direction, weight_xc_data.channel(0), bias_c_data.channel(0), weight_hc_data.channel(0), hidden_state, cell_state, opt);
-        if (ret != 0)
-            return ret;
+        hidden_states[n].create(num_output, num_directions, 4u, opt.workspace_allocator);
+        if (hidden_states[n].empty())
+            return -100;
+        hidden_states[n].fill(0.f);
+
+        cell_states[n].create(num_output, num_directions, 4u, opt.workspace_allocator);
+        if (cell_states[n].empty())
+            return -100;
+        cell_states[n].fill(0.f);
+
+        top_blobs[n].create(num_output * num_directions, bottom_blobs[n].h, 4u, opt.blob_allocator);
+        if (top_blobs[n].empty())
+            return -100;
     }
 
-    return 0;
+    return lstm(bottom_blobs, top_blobs, hidden_states, cell_states, direction, weight_xc_data, bias_c_data, weight_hc_data, weight_xc_data_int8_scales, weight_hc_data_int8_scales, opt);
 }
 
 } // namespace ncnn
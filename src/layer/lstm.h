@@ -32,14 +32,21 @@ public:
 
     virtual int forward(const std::vector<Mat>& bottom_blobs, std::vector<Mat>& top_blobs, const Option& opt) const;
 
+    virtual int forward_batch(const std::vector<Mat>& bottom_blobs, std::vector<Mat>& top_blobs, const Option& opt) const;
+
 public:
     int num_output;
     int weight_data_size;
     int direction; // 0=forward 1=reverse 2=bidirectional
+    int int8_scale_term;
 
     Mat weight_hc_data;
     Mat weight_xc_data;
     Mat bias_c_data;
+
+    // int8 weight storage, one scale per weight row
+    Mat weight_xc_data_int8_scales;
+    Mat weight_hc_data_int8_scales;
 };
 
 } // namespace ncnn
@@ -66,6 +66,10 @@ int Requantize::forward(const Mat& bottom_blob, Mat& top_blob, const Option& opt
     {
         int w = bottom_blob.w;
 
+        top_blob.create(w, (size_t)1u, opt.blob_allocator);
+        if (top_blob.empty())
+            return -100;
+
         const int* intptr = bottom_blob;
         signed char* ptr = top_blob;
 
@@ -110,6 +114,10 @@ int Requantize::forward(const Mat& bottom_blob, Mat& top_blob, const Option& opt
         int w = bottom_blob.w;
         int h = bottom_blob.h;
 
+        top_blob.create(w, h, (size_t)1u, opt.blob_allocator);
+        if (top_blob.empty())
+            return -100;
+
         if (bias_term)
         {
             #pragma omp parallel for num_threads(opt.num_threads)
@@ -153,6 +161,10 @@ int Requantize::forward(const Mat& bottom_blob, Mat& top_blob, const Option& opt
         int channels = bottom_blob.c;
         int size = w * h;
 
+        top_blob.create(w, h, channels, (size_t)1u, opt.blob_allocator);
+        if (top_blob.empty())
+            return -100;
+
         if (bias_term)
         {
             #pragma omp parallel for num_threads(opt.num_threads)
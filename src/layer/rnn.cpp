@@ -85,6 +85,44 @@ int RNN::forward(const std::vector<Mat>& bottom_blobs, std::vector<Mat>& top_blo
     if (top_blob.empty())
         return -100;
 
+    // W_xh * x_t + b_h for all timesteps
+    // every weight row is read once for the whole sequence
+    Mat gates(num_output, T, 4u, opt.workspace_allocator);
+    if (gates.empty())
+        return -100;
+
+    // the row sums of W_hh, the recurrent term is W_hh * h_cont_{t-1}[q] per unit
+    Mat weight_hh_sum(num_output, 4u, opt.workspace_allocator);
+    if (weight_hh_sum.empty())
+        return -100;
+
+    #pragma omp parallel for num_threads(opt.num_threads)
+    for (int q = 0; q < num_output; q++)
+    {
+        const float* weight_hh_data_ptr = weight_hh_data.row(q);
+        const float* weight_xh_data_ptr = weight_xh_data.row(q);
+
+        float hh_sum = 0.f;
+        for (int i = 0; i < size; i++)
+        {
+            hh_sum += weight_hh_data_ptr[i];
+        }
+        weight_hh_sum[q] = hh_sum;
+
+        for (int t = 0; t < T; t++)
+        {
+            const float* x_data = input_blob.channel(t);
+
+            float s0 = bias_h_data[q];
+            for (int i = 0; i < size; i++)
+            {
+                s0 += weight_xh_data_ptr[i] * x_data[i];
+            }
+
+            gates.row(t)[q] = s0;
+        }
+    }
+
     // unroll
     for (int t = 0; t < T; t++)
     {
@@ -95,35 +133,28 @@ int RNN::forward(const std::vector<Mat>& bottom_blobs, std::vector<Mat>& top_blo
         // calculate hidden
         // h_t = tanh( W_hh * h_cont_{t-1} + W_xh * x_t + b_h )
         const float cont = cont_blob[t];
-        const Mat x = input_blob.channel(t);
+        const float* gates_data = gates.row(t);
         float* hidden_data = hidden;
+
+        #pragma omp parallel for num_threads(opt.num_threads)
         for (int q = 0; q < num_output; q++)
         {
             float h_cont = cont ? hidden_data[q] : 0.f;
 
-            const float* weight_hh_data_ptr = (const float*)weight_hh_data + weight_hh_data.w * q;
-            const float* weight_xh_data_ptr = (const float*)weight_xh_data + weight_xh_data.w * q;
-            const float* x_data = x;
-
-            float s0 = bias_h_data[q];
-            for (int i = 0; i < size; i++)
-            {
-                s0 += weight_hh_data_ptr[i] * h_cont + weight_xh_data_ptr[i] * x_data[i];
-            }
-
-            hidden_data[q] = tanh(s0);
+            hidden_data[q] = tanh(gates_data[q] + weight_hh_sum[q] * h_cont);
         }
 
         // calculate output
         // o_t = tanh( W_ho * h_t + b_o )
-        Mat output = top_blob.channel(t);
-        float* output_data = output;
+        float* output_data = top_blob.channel(t);
+
+        #pragma omp parallel for num_threads(opt.num_threads)
         for (int q = 0; q < num_output; q++)
         {
-            const float* weight_ho_data_ptr = (const float*)weight_ho_data + weight_ho_data.w * q;
+            const float* weight_ho_data_ptr = weight_ho_data.row(q);
 
             float s0 = bias_o_data[q];
-            for (int i = 0; i < size; i++)
+            for (int i = 0; i < num_output; i++)
             {
                 s0 += weight_ho_data_ptr[i] * hidden_data[i];
             }
@@ -112,10 +112,52 @@ static inline float _mm256_reduce_add_ps(__m256 x)
     return _mm_cvtss_f32(x32);
 }
 
+static inline float _mm256_reduce_max_ps(__m256 x)
+{
+    const __m128 x128 = _mm_max_ps(_mm256_extractf128_ps(x, 1), _mm256_castps256_ps128(x));
+    const __m128 x64 = _mm_max_ps(x128, _mm_movehl_ps(x128, x128));
+    const __m128 x32 = _mm_max_ss(x64, _mm_shuffle_ps(x64, x64, 0x55));
+    return _mm_cvtss_f32(x32);
+}
+
 static inline float _mm_reduce_add_ps(__m128 x128)
 {
     const __m128 x64 = _mm_add_ps(x128, _mm_movehl_ps(x128, x128));
     const __m128 x32 = _mm_add_ss(x64, _mm_shuffle_ps(x64, x64, 0x55));
     return _mm_cvtss_f32(x32);
 }
+
+// round half away from zero and saturate to [-127, 127] as float2int8 does
+// the 8 int8 land in the low 64 bits
+static inline __m128i float2int8_avx(__m256 _v)
+{
+    const __m256 _sign = _mm256_set1_ps(-0.f);
+    _v = _mm256_add_ps(_v, _mm256_or_ps(_mm256_and_ps(_v, _sign), _mm256_set1_ps(0.49999997f)));
+    _v = _mm256_round_ps(_v, _MM_FROUND_TO_ZERO | _MM_FROUND_NO_EXC);
+    _v = _mm256_min_ps(_mm256_max_ps(_v, _mm256_set1_ps(-127.f)), _mm256_set1_ps(127.f));
+
+    __m256i _v32 = _mm256_cvttps_epi32(_v);
+    __m128i _v16 = _mm_packs_epi32(_mm256_castsi256_si128(_v32), _mm256_extractf128_si256(_v32, 1));
+    return _mm_packs_epi16(_v16, _v16);
+}
+
+#if __AVX512F__
+static inline __m512 loadfp16_avx512(const unsigned short* ptr)
+{
+    return _mm512_cvtph_ps(_mm256_loadu_si256((const __m256i*)ptr));
+}
+
+// add the high half onto the low half
+static inline __m256 fold_avx512_ps(__m512 x)
+{
+    return _mm256_add_ps(_mm512_castps512_ps256(x), _mm512_extractf32x8_ps(x, 1));
+}
+
+// vnni code is compiled per function and must only run when the cpu supports it
+#if defined(__GNUC__) || defined(__clang__)
+#define NCNN_AVX512VNNI_TARGET __attribute__((target("avx512vnni")))
+#else
+#define NCNN_AVX512VNNI_TARGET
+#endif
+#endif // __AVX512F__
 #endif
\ No newline at end of file
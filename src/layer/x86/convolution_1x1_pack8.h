@@ -353,6 +353,9 @@ static void conv1x1s1_sgemm_pack8_avx(const Mat& bottom_blob, Mat& top_blob, con
             }
         }
     }
+#if __AVX512F__
+    conv1x1s1_sgemm_pack8to16_avx512<float>(tmp, top_blob, kernel, _bias, inch, opt);
+#else
     #pragma omp parallel for num_threads(opt.num_threads)
     for (int p = 0; p < outch; p++)
     {
@@ -997,6 +1000,7 @@ static void conv1x1s1_sgemm_pack8_avx(const Mat& bottom_blob, Mat& top_blob, con
             outptr += 8;
         }
     }
+#endif // __AVX512F__
 }
 
 static void conv1x1s2_pack8_avx(const Mat& bottom_blob, Mat& top_blob, const Mat& kernel, const Mat& _bias, const Option& opt)
@@ -257,7 +257,9 @@ static void conv3x3s1_winograd64_pack8_avx(const Mat& bottom_blob, Mat& top_blob
 
     w = outw + 2;
     h = outh + 2;
-    copy_make_border(bottom_blob, bottom_blob_bordered, 0, h - bottom_blob.h, 0, w - bottom_blob.w, BORDER_CONSTANT, 0.f, opt);
+    Option opt_b = opt;
+    opt_b.blob_allocator = opt.workspace_allocator;
+    copy_make_border(bottom_blob, bottom_blob_bordered, 0, h - bottom_blob.h, 0, w - bottom_blob.w, BORDER_CONSTANT, 0.f, opt_b);
 
     const float* bias = _bias;
     // BEGIN transform input
@@ -624,6 +626,9 @@ static void conv3x3s1_winograd64_pack8_avx(const Mat& bottom_blob, Mat& top_blob
 
         top_blob_tm.create(tiles, 64, outch, elemsize, elempack, opt.workspace_allocator);
 
+#if __AVX512F__
+        conv3x3s1_winograd64_dot_pack8to16_avx512(bottom_blob_tm2, top_blob_tm, kernel_tm, tiles, inch, opt);
+#else
         #pragma omp parallel for num_threads(opt.num_threads)
         for (int p = 0; p < outch; p++)
         {
@@ -1301,6 +1306,7 @@ static void conv3x3s1_winograd64_pack8_avx(const Mat& bottom_blob, Mat& top_blob
                 }
             }
         }
+#endif // __AVX512F__
     }
     bottom_blob_tm = Mat();
     // END dot
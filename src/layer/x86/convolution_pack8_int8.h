@@ -0,0 +1,203 @@
+// Tencent is pleased to support the open source community by making ncnn available.
+//
+// Copyright (C) 2020 THL A29 Limited, a Tencent company. All rights reserved.
+//
+// Licensed under the BSD 3-Clause License (the "License"); you may not use this file except
+// in compliance with the License. You may obtain a copy of the License at
+//
+// https://opensource.org/licenses/BSD-3-Clause
+//
+// Unless required by applicable law or agreed to in writing, software distributed
+// under the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR
+// CONDITIONS OF ANY KIND, either express or implied. See the License for the
+// specific language governing permissions and limitations under the License.
+
+// int8 pack8 blobs hold 8 channels of one pixel in 8 bytes
+// pmaddwd sums two input channels into int32 for 8 output channels at once
+
+static void convolution_transform_kernel_pack8_int8_avx2(const Mat& weight_data, Mat& weight_data_pack8, int num_input, int num_output, int kernel_w, int kernel_h)
+{
+    const int maxk = kernel_w * kernel_h;
+
+    // src = kw-kh-inch-outch
+    // dst = 2a-8b-4a-kw-kh-inch/8a-outch/8b
+    Mat weight_data_r2 = weight_data.reshape(maxk, num_input, num_output);
+
+    weight_data_pack8.create(maxk, num_input / 8, num_output / 8, (size_t)2u * 64, 64);
+
+    for (int q = 0; q + 7 < num_output; q += 8)
+    {
+        Mat g0 = weight_data_pack8.channel(q / 8);
+
+        for (int p = 0; p + 7 < num_input; p += 8)
+        {
+            short* g00 = g0.row<short>(p / 8);
+
+            for (int k = 0; k < maxk; k++)
+            {
+                for (int i = 0; i < 4; i++)
+                {
+                    for (int j = 0; j < 8; j++)
+                    {
+                        const signed char* k00 = weight_data_r2.channel(q + j).row<const signed char>(p + i * 2);
+                        const signed char* k01 = weight_data_r2.channel(q + j).row<const signed char>(p + i * 2 + 1);
+
+                        g00[0] = k00[k];
+                        g00[1] = k01[k];
+
+                        g00 += 2;
+                    }
+                }
+            }
+        }
+    }
+}
+
+// accumulate one pixel of 8 input channels against the 8x8 kernel of one tap
+static inline __m256i convolution_dot_pack8_int8_avx2(__m256i _sum, const signed char* sptr, __m256i _w0, __m256i _w1, __m256i _w2, __m256i _w3)
+{
+    __m128i _val16 = _mm_cvtepi8_epi16(_mm_loadl_epi64((const __m128i*)sptr));
+    __m256i _val = _mm256_broadcastsi128_si256(_val16);
+
+    _sum = _mm256_add_epi32(_sum, _mm256_madd_epi16(_mm256_shuffle_epi32(_val, _MM_SHUFFLE(0, 0, 0, 0)), _w0));
+    _sum = _mm256_add_epi32(_sum, _mm256_madd_epi16(_mm256_shuffle_epi32(_val, _MM_SHUFFLE(1, 1, 1, 1)), _w1));
+    _sum = _mm256_add_epi32(_sum, _mm256_madd_epi16(_mm256_shuffle_epi32(_val, _MM_SHUFFLE(2, 2, 2, 2)), _w2));
+    _sum = _mm256_add_epi32(_sum, _mm256_madd_epi16(_mm256_shuffle_epi32(_val, _MM_SHUFFLE(3, 3, 3, 3)), _w3));
+
+    return _sum;
+}
+
+// dequantize, add bias, activate and store fp32 pack8, or requantize into int8 pack8 when scale_requant_out is non-zero
+static inline void convolution_store_pack8_int8_avx2(__m256i _sum, __m256 _scale_in, __m256 _bias, int activation_type, const Mat& activation_params, float scale_requant_out, void* outptr)
+{
+    __m256 _v = _mm256_fmadd_ps(_mm256_cvtepi32_ps(_sum), _scale_in, _bias);
+    _v = activation_ps(_v, activation_type, activation_params);
+
+    if (scale_requant_out != 0.f)
+    {
+        _v = _mm256_mul_ps(_v, _mm256_set1_ps(scale_requant_out));
+        _mm_storel_epi64((__m128i*)outptr, float2int8_avx(_v));
+    }
+    else
+    {
+        _mm256_storeu_ps((float*)outptr, _v);
+    }
+}
+
+static void convolution_pack8_int8_avx2(const Mat& bottom_blob, Mat& top_blob, const Mat& weight_data_pack8, const Mat& bias_data, int kernel_w, int kernel_h, int dilation_w, int dilation_h, int stride_w, int stride_h,
+                                        const std::vector<float>& scale_dequant, float scale_requant_out, int activation_type, const Mat& activation_params, const Option& opt)
+{
+    int w = bottom_blob.w;
+    int channels = bottom_blob.c;
+
+    int outw = top_blob.w;
+    int outh = top_blob.h;
+    int outch = top_blob.c;
+    size_t out_elemsize = top_blob.elemsize;
+
+    const int maxk = kernel_w * kernel_h;
+
+    // kernel offsets
+    std::vector<int> _space_ofs(maxk);
+    int* space_ofs = &_space_ofs[0];
+    {
+        int p1 = 0;
+        int p2 = 0;
+        int gap = w * dilation_h - kernel_w * dilation_w;
+        for (int i = 0; i < kernel_h; i++)
+        {
+            for (int j = 0; j < kernel_w; j++)
+            {
+                space_ofs[p1] = p2 * 8;
+                p1++;
+                p2 += dilation_w;
+            }
+            p2 += gap;
+        }
+    }
+
+    const float* bias_data_ptr = bias_data;
+
+    #pragma omp parallel for num_threads(opt.num_threads)
+    for (int p = 0; p < outch; p++)
+    {
+        unsigned char* outptr = top_blob.channel(p);
+
+        __m256 _scale_in = _mm256_loadu_ps(&scale_dequant[p * 8]);
+        __m256 _bias = bias_data_ptr ? _mm256_loadu_ps(bias_data_ptr + p * 8) : _mm256_setzero_ps();
+
+        const short* kptr0 = weight_data_pack8.channel(p);
+
+        for (int i = 0; i < outh; i++)
+        {
+            int j = 0;
+            for (; j + 3 < outw; j += 4)
+            {
+                __m256i _sum0 = _mm256_setzero_si256();
+                __m256i _sum1 = _mm256_setzero_si256();
+                __m256i _sum2 = _mm256_setzero_si256();
+                __m256i _sum3 = _mm256_setzero_si256();
+
+                const short* kptr = kptr0;
+
+                for (int q = 0; q < channels; q++)
+                {
+                    const Mat m = bottom_blob.channel(q);
+                    const signed char* sptr = m.row<const signed char>(i * stride_h) + j * stride_w * 8;
+
+                    for (int k = 0; k < maxk; k++)
+                    {
+                        const signed char* slptr = sptr + space_ofs[k];
+
+                        __m256i _w0 = _mm256_loadu_si256((const __m256i*)kptr);
+                        __m256i _w1 = _mm256_loadu_si256((const __m256i*)(kptr + 16));
+                        __m256i _w2 = _mm256_loadu_si256((const __m256i*)(kptr + 32));
+                        __m256i _w3 = _mm256_loadu_si256((const __m256i*)(kptr + 48));
+
+                        _sum0 = convolution_dot_pack8_int8_avx2(_sum0, slptr, _w0, _w1, _w2, _w3);
+                        _sum1 = convolution_dot_pack8_int8_avx2(_sum1, slptr + stride_w * 8, _w0, _w1, _w2, _w3);
+                        _sum2 = convolution_dot_pack8_int8_avx2(_sum2, slptr + stride_w * 16, _w0, _w1, _w2, _w3);
+                        _sum3 = convolution_dot_pack8_int8_avx2(_sum3, slptr + stride_w * 24, _w0, _w1, _w2, _w3);
+
+                        kptr += 64;
+                    }
+                }
+
+                convolution_store_pack8_int8_avx2(_sum0, _scale_in, _bias, activation_type, activation_params, scale_requant_out, outptr);
+                convolution_store_pack8_int8_avx2(_sum1, _scale_in, _bias, activation_type, activation_params, scale_requant_out, outptr + out_elemsize);
+                convolution_store_pack8_int8_avx2(_sum2, _scale_in, _bias, activation_type, activation_params, scale_requant_out, outptr + out_elemsize * 2);
+                convolution_store_pack8_int8_avx2(_sum3, _scale_in, _bias, activation_type, activation_params, scale_requant_out, outptr + out_elemsize * 3);
+
+                outptr += out_elemsize * 4;
+            }
+            for (; j < outw; j++)
+            {
+                __m256i _sum = _mm256_setzero_si256();
+
+                const short* kptr = kptr0;
+
+                for (int q = 0; q < channels; q++)
+                {
+                    const Mat m = bottom_blob.channel(q);
+                    const signed char* sptr = m.row<const signed char>(i * stride_h) + j * stride_w * 8;
+
+                    for (int k = 0; k < maxk; k++)
+                    {
+                        __m256i _w0 = _mm256_loadu_si256((const __m256i*)kptr);
+                        __m256i _w1 = _mm256_loadu_si256((const __m256i*)(kptr + 16));
+                        __m256i _w2 = _mm256_loadu_si256((const __m256i*)(kptr + 32));
+                        __m256i _w3 = _mm256_loadu_si256((const __m256i*)(kptr + 48));
+
+                        _sum = convolution_dot_pack8_int8_avx2(_sum, sptr + space_ofs[k], _w0, _w1, _w2, _w3);
+
+                        kptr += 64;
+                    }
+                }
+
+                convolution_store_pack8_int8_avx2(_sum, _scale_in, _bias, activation_type, activation_params, scale_requant_out, outptr);
+
+                outptr += out_elemsize;
+            }
+        }
+    }
+}
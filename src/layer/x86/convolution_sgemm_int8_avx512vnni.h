@@ -0,0 +1,264 @@
+// Tencent is pleased to support the open source community by making ncnn available.
+//
+// Copyright (C) 2020 THL A29 Limited, a Tencent company. All rights reserved.
+//
+// Licensed under the BSD 3-Clause License (the "License"); you may not use this file except
+// in compliance with the License. You may obtain a copy of the License at
+//
+// https://opensource.org/licenses/BSD-3-Clause
+//
+// Unless required by applicable law or agreed to in writing, software distributed
+// under the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR
+// CONDITIONS OF ANY KIND, either express or implied. See the License for the
+// specific language governing permissions and limitations under the License.
+
+// vpdpbusd multiplies unsigned by signed bytes, the input is shifted by 128 into u8
+// and 128 * sum(w) is subtracted back per output channel
+
+static void conv_im2col_sgemm_transform_kernel_int8_avx512vnni(const Mat& _kernel, Mat& kernel_tm, int inch, int outch, int kernel_size)
+{
+    // src = kw-kh-inch-outch
+    // dst = 4a-16b-kw-kh-inch/4a-outch/16b, followed by 16 int compensations per group
+    const int K = inch * kernel_size;
+    const int K4 = (K + 3) / 4;
+
+    const signed char* kernel = _kernel;
+
+    kernel_tm.create(K4 * 64 + 64, (outch + 15) / 16, (size_t)1u);
+
+    for (int g = 0; g < kernel_tm.h; g++)
+    {
+        signed char* g0 = kernel_tm.row<signed char>(g);
+
+        for (int k4 = 0; k4 < K4; k4++)
+        {
+            for (int o = 0; o < 16; o++)
+            {
+                const int p = g * 16 + o;
+
+                for (int j = 0; j < 4; j++)
+                {
+                    const int k = k4 * 4 + j;
+                    g0[o * 4 + j] = p < outch && k < K ? kernel[p * K + k] : 0;
+                }
+            }
+
+            g0 += 64;
+        }
+
+        int* comp = (int*)g0;
+        for (int o = 0; o < 16; o++)
+        {
+            const int p = g * 16 + o;
+
+            int sum = 0;
+            for (int k = 0; p < outch && k < K; k++)
+            {
+                sum += kernel[p * K + k];
+            }
+
+            comp[o] = sum * 128;
+        }
+    }
+}
+
+// four rows of 16 bytes to 16 pixels of 4 bytes, shifted into u8
+static inline void transpose_4x16_u8_sse(const signed char* r0, const signed char* r1, const signed char* r2, const signed char* r3, unsigned char* outptr)
+{
+    const __m128i _shift = _mm_set1_epi8((char)0x80);
+
+    __m128i _r0 = _mm_xor_si128(_mm_loadu_si128((const __m128i*)r0), _shift);
+    __m128i _r1 = _mm_xor_si128(_mm_loadu_si128((const __m128i*)r1), _shift);
+    __m128i _r2 = _mm_xor_si128(_mm_loadu_si128((const __m128i*)r2), _shift);
+    __m128i _r3 = _mm_xor_si128(_mm_loadu_si128((const __m128i*)r3), _shift);
+
+    __m128i _r01l = _mm_unpacklo_epi8(_r0, _r1);
+    __m128i _r01h = _mm_unpackhi_epi8(_r0, _r1);
+    __m128i _r23l = _mm_unpacklo_epi8(_r2, _r3);
+    __m128i _r23h = _mm_unpackhi_epi8(_r2, _r3);
+
+    _mm_storeu_si128((__m128i*)outptr, _mm_unpacklo_epi16(_r01l, _r23l));
+    _mm_storeu_si128((__m128i*)(outptr + 16), _mm_unpackhi_epi16(_r01l, _r23l));
+    _mm_storeu_si128((__m128i*)(outptr + 32), _mm_unpacklo_epi16(_r01h, _r23h));
+    _mm_storeu_si128((__m128i*)(outptr + 48), _mm_unpackhi_epi16(_r01h, _r23h));
+}
+
+NCNN_AVX512VNNI_TARGET
+static void conv_im2col_sgemm_int8_avx512vnni(const Mat& bottom_blob, Mat& top_blob, const Mat& kernel_tm,
+        const int kernel_w, const int kernel_h, const int stride_w, const int stride_h, const Mat& _bias,
+        const std::vector<float>& scale_dequant, const std::vector<float>& scale_requant_out, const Option& opt)
+{
+    int inch = bottom_blob.c;
+
+    int outw = top_blob.w;
+    int outh = top_blob.h;
+    int outch = top_blob.c;
+
+    const int size = outw * outh;
+    const int maxk = kernel_w * kernel_h;
+    const int K = inch * maxk;
+    const int K4 = (K + 3) / 4;
+
+    const float* bias = _bias;
+
+    // int8 output when requantizing
+    const bool requantize = !scale_requant_out.empty();
+
+    // im2row, one row per k
+    // the input channels are the rows already for 1x1 stride 1
+    Mat bottom_im2row;
+    const signed char* im2row = bottom_blob;
+    size_t im2row_step = bottom_blob.cstep;
+    if (maxk != 1 || stride_w != 1 || stride_h != 1)
+    {
+        bottom_im2row.create(size, K, (size_t)1u, opt.workspace_allocator);
+
+        #pragma omp parallel for num_threads(opt.num_threads)
+        for (int q = 0; q < inch; q++)
+        {
+            const Mat img = bottom_blob.channel(q);
+
+            for (int u = 0; u < kernel_h; u++)
+            {
+                for (int v = 0; v < kernel_w; v++)
+                {
+                    signed char* ptr = bottom_im2row.row<signed char>(q * maxk + u * kernel_w + v);
+
+                    for (int i = 0; i < outh; i++)
+                    {
+                        const signed char* sptr = img.row<const signed char>(i * stride_h + u) + v;
+
+                        if (stride_w == 1)
+                        {
+                            memcpy(ptr, sptr, outw);
+                        }
+                        else
+                        {
+                            for (int j = 0; j < outw; j++)
+                            {
+                                ptr[j] = sptr[j * stride_w];
+                            }
+                        }
+
+                        ptr += outw;
+                    }
+                }
+            }
+        }
+
+        im2row = bottom_im2row;
+        im2row_step = bottom_im2row.w;
+    }
+
+    // interleave 16 pixels by 4 k
+    const int tiles = (size + 15) / 16;
+
+    Mat tmp(K4 * 64, tiles, (size_t)1u, opt.workspace_allocator);
+
+    #pragma omp parallel for num_threads(opt.num_threads)
+    for (int t = 0; t < tiles; t++)
+    {
+        unsigned char* tmpptr = tmp.row<unsigned char>(t);
+
+        const int i = t * 16;
+        const int n = std::min(size - i, 16);
+
+        // padded with zero k and repeated tail pixels
+        signed char r[4][16];
+
+        for (int k4 = 0; k4 < K4; k4++)
+        {
+            const signed char* rptr[4];
+            for (int j = 0; j < 4; j++)
+            {
+                const int k = k4 * 4 + j;
+
+                if (k < K && n == 16)
+                {
+                    rptr[j] = im2row + k * im2row_step + i;
+                }
+                else
+                {
+                    for (int l = 0; l < 16; l++)
+                    {
+                        r[j][l] = k < K ? im2row[k * im2row_step + i + std::min(l, n - 1)] : 0;
+                    }
+
+                    rptr[j] = r[j];
+                }
+            }
+
+            transpose_4x16_u8_sse(rptr[0], rptr[1], rptr[2], rptr[3], tmpptr);
+
+            tmpptr += 64;
+        }
+    }
+
+    bottom_im2row.release();
+
+    const int groups = kernel_tm.h;
+
+    #pragma omp parallel for num_threads(opt.num_threads)
+    for (int ij = 0; ij < tiles * groups; ij++)
+    {
+        // neighbouring iterations share the input tile
+        const int t = ij / groups;
+        const int g = ij % groups;
+
+        const unsigned char* tmpptr = tmp.row<const unsigned char>(t);
+        const signed char* kptr = kernel_tm.row<const signed char>(g);
+
+        __m512i _sum[16];
+        for (int o = 0; o < 16; o++)
+        {
+            _sum[o] = _mm512_setzero_si512();
+        }
+
+        for (int k4 = 0; k4 < K4; k4++)
+        {
+            __m512i _val = _mm512_loadu_si512((const __m512i*)tmpptr);
+
+            for (int o = 0; o < 16; o++)
+            {
+                _sum[o] = _mm512_dpbusd_epi32(_sum[o], _val, _mm512_set1_epi32(*(const int*)(kptr + o * 4)));
+            }
+
+            tmpptr += 64;
+            kptr += 64;
+        }
+
+        const int* comp = (const int*)kptr;
+
+        const int i = t * 16;
+        const __mmask16 _mask = (__mmask16)(0xffff >> (16 - std::min(size - i, 16)));
+
+        for (int o = 0; o < 16; o++)
+        {
+            const int p = g * 16 + o;
+            if (p >= outch)
+                break;
+
+            __m512 _v = _mm512_cvtepi32_ps(_mm512_sub_epi32(_sum[o], _mm512_set1_epi32(comp[o])));
+            _v = _mm512_fmadd_ps(_v, _mm512_set1_ps(scale_dequant[p]), _mm512_set1_ps(bias ? bias[p] : 0.f));
+
+            if (requantize)
+            {
+                _v = _mm512_mul_ps(_v, _mm512_set1_ps(scale_requant_out[p]));
+
+                // round half away from zero and saturate to [-127, 127] as float2int8 does
+                const __m512 _sign = _mm512_castsi512_ps(_mm512_set1_epi32(0x80000000));
+                _v = _mm512_add_ps(_v, _mm512_or_ps(_mm512_and_ps(_v, _sign), _mm512_set1_ps(0.49999997f)));
+                _v = _mm512_roundscale_ps(_v, _MM_FROUND_TO_ZERO | _MM_FROUND_NO_EXC);
+                _v = _mm512_min_ps(_mm512_max_ps(_v, _mm512_set1_ps(-127.f)), _mm512_set1_ps(127.f));
+
+                signed char* outptr = top_blob.channel(p);
+                _mm_mask_storeu_epi8(outptr + i, _mask, _mm512_cvtepi32_epi8(_mm512_cvtps_epi32(_v)));
+            }
+            else
+            {
+                float* outptr = top_blob.channel(p);
+                _mm512_mask_storeu_ps(outptr + i, _mask, _v);
+            }
+        }
+    }
+}
@@ -0,0 +1,176 @@
+// Tencent is pleased to support the open source community by making ncnn available.
+//
+// Copyright (C) 2020 THL A29 Limited, a Tencent company. All rights reserved.
+//
+// Licensed under the BSD 3-Clause License (the "License"); you may not use this file except
+// in compliance with the License. You may obtain a copy of the License at
+//
+// https://opensource.org/licenses/BSD-3-Clause
+//
+// Unless required by applicable law or agreed to in writing, software distributed
+// under the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR
+// CONDITIONS OF ANY KIND, either express or implied. See the License for the
+// specific language governing permissions and limitations under the License.
+
+// blobs stay pack8, the kernel pairs up two output groups so one zmm covers 16 outputs
+
+static void convert_kernel_pack8to16_avx512(const Mat& kernel_pack8, Mat& kernel_pack16)
+{
+    // src = 8b-8a-inch/8a-outch/8b
+    // dst = 16b-8a-inch/8a-outch/16b, the odd last group padded with zero
+    const size_t row_size = kernel_pack8.elemsize / 8;
+
+    kernel_pack16.create(kernel_pack8.w, kernel_pack8.h, (kernel_pack8.c + 1) / 2, kernel_pack8.elemsize * 2, kernel_pack8.elempack * 2);
+
+    for (int q = 0; q < kernel_pack16.c; q++)
+    {
+        const unsigned char* k0 = kernel_pack8.channel(q * 2);
+        const unsigned char* k1 = q * 2 + 1 < kernel_pack8.c ? (const unsigned char*)kernel_pack8.channel(q * 2 + 1) : 0;
+
+        unsigned char* g0 = kernel_pack16.channel(q);
+
+        for (int i = 0; i < kernel_pack8.w * kernel_pack8.h * 8; i++)
+        {
+            memcpy(g0, k0, row_size);
+            if (k1)
+                memcpy(g0 + row_size, k1, row_size);
+            else
+                memset(g0 + row_size, 0, row_size);
+
+            k0 += row_size;
+            if (k1)
+                k1 += row_size;
+            g0 += row_size * 2;
+        }
+    }
+}
+
+static inline __m512 load_kernel_pack16_avx512(const float* ptr)
+{
+    return _mm512_loadu_ps(ptr);
+}
+
+static inline __m512 load_kernel_pack16_avx512(const unsigned short* ptr)
+{
+    return loadfp16_avx512(ptr);
+}
+
+template<int N, typename T>
+static inline void sgemm_pack8to16_tile_avx512(const float* tmpptr, const T* kptr, int inch, __m512 _bias, float* outptr0, float* outptr1)
+{
+    __m512 _sum[N];
+    for (int n = 0; n < N; n++)
+    {
+        _sum[n] = _bias;
+    }
+
+    for (int q = 0; q < inch; q++)
+    {
+        for (int k = 0; k < 8; k++)
+        {
+            __m512 _w = load_kernel_pack16_avx512(kptr + k * 16);
+
+            for (int n = 0; n < N; n++)
+            {
+                _sum[n] = _mm512_fmadd_ps(_w, _mm512_set1_ps(tmpptr[n * 8 + k]), _sum[n]);
+            }
+        }
+
+        tmpptr += N * 8;
+        kptr += 128;
+    }
+
+    for (int n = 0; n < N; n++)
+    {
+        _mm256_storeu_ps(outptr0 + n * 8, _mm512_castps512_ps256(_sum[n]));
+    }
+    if (outptr1)
+    {
+        for (int n = 0; n < N; n++)
+        {
+            _mm256_storeu_ps(outptr1 + n * 8, _mm512_extractf32x8_ps(_sum[n], 1));
+        }
+    }
+}
+
+// tmp is interleaved by 12, 8, 4, 2 and 1 pixels as the pack8 sgemm does, tmpstep floats apart
+// kptr points to the pack16 kernel of one output group pair, outptr1 is null for the odd last group
+template<typename T>
+static void sgemm_pack8to16_avx512(const float* tmp, size_t tmpstep, int size, int inch, const T* kptr, __m512 _bias, float* outptr0, float* outptr1)
+{
+    int i = 0;
+    for (; i + 11 < size; i += 12)
+    {
+        const float* tmpptr = tmp + (i / 12) * tmpstep;
+        sgemm_pack8to16_tile_avx512<12>(tmpptr, kptr, inch, _bias, outptr0 + i * 8, outptr1 ? outptr1 + i * 8 : 0);
+    }
+    for (; i + 7 < size; i += 8)
+    {
+        const float* tmpptr = tmp + (i / 12 + (i % 12) / 8) * tmpstep;
+        sgemm_pack8to16_tile_avx512<8>(tmpptr, kptr, inch, _bias, outptr0 + i * 8, outptr1 ? outptr1 + i * 8 : 0);
+    }
+    for (; i + 3 < size; i += 4)
+    {
+        const float* tmpptr = tmp + (i / 12 + (i % 12) / 8 + (i % 12 % 8) / 4) * tmpstep;
+        sgemm_pack8to16_tile_avx512<4>(tmpptr, kptr, inch, _bias, outptr0 + i * 8, outptr1 ? outptr1 + i * 8 : 0);
+    }
+    for (; i + 1 < size; i += 2)
+    {
+        const float* tmpptr = tmp + (i / 12 + (i % 12) / 8 + (i % 12 % 8) / 4 + (i % 12 % 4) / 2) * tmpstep;
+        sgemm_pack8to16_tile_avx512<2>(tmpptr, kptr, inch, _bias, outptr0 + i * 8, outptr1 ? outptr1 + i * 8 : 0);
+    }
+    for (; i < size; i++)
+    {
+        const float* tmpptr = tmp + (i / 12 + (i % 12) / 8 + (i % 12 % 8) / 4 + (i % 12 % 4) / 2 + i % 12 % 2) * tmpstep;
+        sgemm_pack8to16_tile_avx512<1>(tmpptr, kptr, inch, _bias, outptr0 + i * 8, outptr1 ? outptr1 + i * 8 : 0);
+    }
+}
+
+template<typename T>
+static void conv1x1s1_sgemm_pack8to16_avx512(const Mat& tmp, Mat& top_blob, const Mat& kernel, const Mat& _bias, int inch, const Option& opt)
+{
+    int outch = top_blob.c;
+    int size = top_blob.w * top_blob.h;
+
+    const float* bias = _bias;
+
+    const size_t tmpstep = tmp.cstep * tmp.elemsize / 4;
+
+    #pragma omp parallel for num_threads(opt.num_threads)
+    for (int p = 0; p < (outch + 1) / 2; p++)
+    {
+        float* outptr0 = top_blob.channel(p * 2);
+        float* outptr1 = p * 2 + 1 < outch ? (float*)top_blob.channel(p * 2 + 1) : 0;
+
+        const __mmask16 _bias_mask = outptr1 ? 0xffff : 0x00ff;
+        __m512 _bias0 = bias ? _mm512_maskz_loadu_ps(_bias_mask, bias + p * 16) : _mm512_setzero_ps();
+
+        const T* kptr = (const T*)kernel.channel(p);
+
+        sgemm_pack8to16_avx512((const float*)tmp, tmpstep, size, inch, kptr, _bias0, outptr0, outptr1);
+    }
+}
+
+static void conv3x3s1_winograd64_dot_pack8to16_avx512(const Mat& bottom_blob_tm2, Mat& top_blob_tm, const Mat& kernel_tm, int tiles, int inch, const Option& opt)
+{
+    int outch = top_blob_tm.c;
+
+    #pragma omp parallel for num_threads(opt.num_threads)
+    for (int p = 0; p < (outch + 1) / 2; p++)
+    {
+        float* output0_tm = top_blob_tm.channel(p * 2);
+        float* output1_tm = p * 2 + 1 < outch ? (float*)top_blob_tm.channel(p * 2 + 1) : 0;
+
+        const Mat kernel0_tm = kernel_tm.channel(p);
+
+        for (int r = 0; r < 64; r++)
+        {
+            const Mat bb2 = bottom_blob_tm2.channel(r);
+            const size_t tmpstep = bb2.w * bb2.elemsize / 4;
+
+            const float* k01 = kernel0_tm.row(r);
+
+            sgemm_pack8to16_avx512((const float*)bb2, tmpstep, tiles, inch, k01, _mm512_setzero_ps(), output0_tm + r * tiles * 8, output1_tm ? output1_tm + r * tiles * 8 : 0);
+        }
+    }
+}
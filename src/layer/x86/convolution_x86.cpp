@@ -28,12 +28,22 @@
 #include "convolution_x86.h"
 
 #include "benchmark.h"
+#include "cpu.h"
 #include "layer_type.h"
 
 namespace ncnn {
 
 #include "convolution_sgemm.h"
 #include "convolution_sgemm_int8.h"
+#if __AVX512F__
+#include "convolution_sgemm_pack8_avx512.h"
+#if NCNN_RUNTIME_CPU_AVX512VNNI
+#include "convolution_sgemm_int8_avx512vnni.h"
+#endif
+#endif
+#if __AVX2__
+#include "convolution_pack8_int8.h"
+#endif
 #if __AVX__
 #include "convolution_3x3_pack1to8.h"
 #include "convolution_3x3_pack8to1.h"
@@ -119,7 +129,6 @@ int Convolution_x86::create_pipeline(const Option& opt)
 
     if (opt.use_int8_inference && weight_data.elemsize == (size_t)1u)
     {
-        support_packing = false;
         return create_pipeline_int8_x86(opt);
     }
 
@@ -178,7 +187,7 @@ int Convolution_x86::create_pipeline(const Option& opt)
 
 #if __AVX__
     // pack8
-    if (elempack == 8 && out_elempack == 8)
+    if (elempack == 8 && out_elempack == 8 && weight_data_pack8.empty())
     {
         if (opt.use_fp16_storage && kernel_w == 1 && kernel_h == 1 && dilation_w == 1 && dilation_h == 1 && stride_w == 1 && stride_h == 1)
         {
@@ -382,9 +391,20 @@ int Convolution_x86::create_pipeline(const Option& opt)
                 }
             }
         }
+
+#if __AVX512F__
+        // the 1x1 sgemm and 3x3 winograd dot read two output groups at once
+        if ((kernel_w == 1 && kernel_h == 1 && dilation_w == 1 && dilation_h == 1 && ((stride_w == 1 && stride_h == 1) || (stride_w == 2 && stride_h == 2)))
+                || (kernel_w == 3 && kernel_h == 3 && dilation_w == 1 && dilation_h == 1 && stride_w == 1 && stride_h == 1))
+        {
+            Mat weight_data_pack16;
+            convert_kernel_pack8to16_avx512(weight_data_pack8, weight_data_pack16);
+            weight_data_pack8 = weight_data_pack16;
+        }
+#endif // __AVX512F__
     }
     // pack1to8
-    if (elempack == 1 && out_elempack == 8)
+    if (elempack == 1 && out_elempack == 8 && weight_data_pack1to8.empty())
     {
         // src = kw-kh-inch-outch
         // dst = 8b-kw-kh-inch-outch/8
@@ -437,7 +457,7 @@ int Convolution_x86::create_pipeline(const Option& opt)
         }
     }
     // pack8to1
-    if (elempack == 8 && out_elempack == 1)
+    if (elempack == 8 && out_elempack == 1 && weight_data_pack8to1.empty())
     {
         // src = kw-kh-inch-outch
         // dst = 4a-kw-kh-inch/4a-outch
@@ -489,13 +509,19 @@ int Convolution_x86::create_pipeline(const Option& opt)
             // winograd is slow on small channel count
             use_winograd3x3 = true;
 
-            conv3x3s1_winograd23_transform_kernel_sse(weight_data, weight_3x3_winograd23_data, num_input, num_output);
+            if (weight_3x3_winograd23_data.empty())
+            {
+                conv3x3s1_winograd23_transform_kernel_sse(weight_data, weight_3x3_winograd23_data, num_input, num_output);
+            }
             // conv3x3s1_winograd43_transform_kernel_sse(weight_data, weight_3x3_winograd43_data, num_input, num_output);
 
             // for small size
-            conv_im2col_sgemm_transform_kernel_sse(weight_data, weight_sgemm_data, num_input, num_output, kernel_size);
+            if (weight_sgemm_data.empty())
+            {
+                conv_im2col_sgemm_transform_kernel_sse(weight_data, weight_sgemm_data, num_input, num_output, kernel_size);
+            }
         }
-        else
+        else if (weight_sgemm_data.empty())
         {
             conv_im2col_sgemm_transform_kernel_sse(weight_data, weight_sgemm_data, num_input, num_output, kernel_size);
         }
@@ -520,6 +546,30 @@ int Convolution_x86::destroy_pipeline(const Option& opt)
         convolution_dilation1 = 0;
     }
 
+    weight_data_pack8.release();
+    weight_data_pack1to8.release();
+    weight_data_pack8to1.release();
+    weight_3x3_winograd23_data.release();
+    weight_sgemm_data.release();
+    weight_3x3_winograd23_data_int8.release();
+    weight_sgemm_data_int8_vnni.release();
+    weight_data_pack8_int8.release();
+
+    return 0;
+}
+
+int Convolution_x86::get_pipeline_weights(std::vector<Mat*>& weights)
+{
+    weights.clear();
+    weights.push_back(&weight_data_pack8);
+    weights.push_back(&weight_data_pack1to8);
+    weights.push_back(&weight_data_pack8to1);
+    weights.push_back(&weight_3x3_winograd23_data);
+    weights.push_back(&weight_sgemm_data);
+    weights.push_back(&weight_3x3_winograd23_data_int8);
+    weights.push_back(&weight_sgemm_data_int8_vnni);
+    weights.push_back(&weight_data_pack8_int8);
+
     return 0;
 }
 
@@ -530,7 +580,16 @@ int Convolution_x86::forward(const Mat& bottom_blob, Mat& top_blob, const Option
 
     if (bottom_blob.dims != 3)
     {
-        return Convolution::forward(bottom_blob, top_blob, opt);
+        Mat bottom_blob_unpacked = bottom_blob;
+        if (bottom_blob.elempack != 1)
+        {
+            Option opt_pack1 = opt;
+            opt_pack1.blob_allocator = opt.workspace_allocator;
+
+            convert_packing(bottom_blob, bottom_blob_unpacked, 1, opt_pack1);
+        }
+
+        return Convolution::forward(bottom_blob_unpacked, top_blob, opt);
     }
 
     if (opt.use_int8_inference && weight_data.elemsize == (size_t)1u)
@@ -967,6 +1026,40 @@ int Convolution_x86::create_pipeline_int8_x86(const Option& opt)
     int num_input = weight_data_size / kernel_size / num_output;
 
     use_winograd3x3_int8 = false;
+    use_int8_vnni = false;
+
+    // the int8 kernels below take elempack=1 only
+    support_packing = false;
+
+#if __AVX512F__ && NCNN_RUNTIME_CPU_AVX512VNNI
+    if (cpu_support_x86_avx512_vnni() && dilation_w == 1 && dilation_h == 1)
+    {
+        // vnni im2col sgemm beats int8 winograd
+        use_int8_vnni = true;
+
+        if (weight_sgemm_data_int8_vnni.empty())
+        {
+            conv_im2col_sgemm_transform_kernel_int8_avx512vnni(weight_data, weight_sgemm_data_int8_vnni, num_input, num_output, kernel_size);
+        }
+
+        return 0;
+    }
+#endif // __AVX512F__ && NCNN_RUNTIME_CPU_AVX512VNNI
+
+#if __AVX2__
+    if (opt.use_packing_layout && num_input % 8 == 0 && num_output % 8 == 0)
+    {
+        // int8 blobs stay pack8 between layers
+        support_packing = true;
+
+        if (weight_data_pack8_int8.empty())
+        {
+            convolution_transform_kernel_pack8_int8_avx2(weight_data, weight_data_pack8_int8, num_input, num_output, kernel_w, kernel_h);
+        }
+
+        return 0;
+    }
+#endif // __AVX2__
 
     if (opt.use_winograd_convolution && kernel_w == 3 && kernel_h == 3 && dilation_w == 1 && dilation_h == 1 && stride_w == 1 && stride_h == 1
             && num_input >= 16 && num_output >= 16)
@@ -974,7 +1067,10 @@ int Convolution_x86::create_pipeline_int8_x86(const Option& opt)
         // winograd is slow on small channel count
         use_winograd3x3_int8 = true;
 
-        conv3x3s1_winograd23_transform_kernel_int8_sse(weight_data, weight_3x3_winograd23_data_int8, num_input, num_output);
+        if (weight_3x3_winograd23_data_int8.empty())
+        {
+            conv3x3s1_winograd23_transform_kernel_int8_sse(weight_data, weight_3x3_winograd23_data_int8, num_input, num_output);
+        }
         //         conv3x3s1_winograd43_transform_kernel_int8_sse(weight_data, weight_3x3_winograd23_data_int8, num_input, num_output);
     }
     else
@@ -987,6 +1083,13 @@ int Convolution_x86::create_pipeline_int8_x86(const Option& opt)
 
 int Convolution_x86::forward_int8_x86(const Mat& bottom_blob, Mat& top_blob, const Option& opt) const
 {
+#if __AVX2__
+    if (bottom_blob.elempack == 8)
+    {
+        return forward_int8_pack8_x86(bottom_blob, top_blob, opt);
+    }
+#endif // __AVX2__
+
     if (dilation_w > 1 || dilation_h > 1)
     {
         return Convolution::forward(bottom_blob, top_blob, opt);
@@ -1026,6 +1129,34 @@ int Convolution_x86::forward_int8_x86(const Mat& bottom_blob, Mat& top_blob, con
     if (top_blob.empty())
         return -100;
 
+#if __AVX512F__ && NCNN_RUNTIME_CPU_AVX512VNNI
+    if (use_int8_vnni)
+    {
+        std::vector<float> scale_dequant(num_output);
+        std::vector<float> scale_requant_out;
+        for (int p = 0; p < num_output; p++)
+        {
+            if (weight_data_int8_scales[p] == 0)
+                scale_dequant[p] = 0;
+            else
+                scale_dequant[p] = 1.f / (bottom_blob_int8_scale * weight_data_int8_scales[p]);
+        }
+        if (use_int8_requantize)
+        {
+            scale_requant_out.resize(num_output, top_blob_int8_scale);
+        }
+
+        conv_im2col_sgemm_int8_avx512vnni(bottom_blob_bordered, top_blob, weight_sgemm_data_int8_vnni, kernel_w, kernel_h, stride_w, stride_h, bias_data, scale_dequant, scale_requant_out, opt);
+
+        if (activation)
+        {
+            activation->forward_inplace(top_blob, opt);
+        }
+
+        return 0;
+    }
+#endif // __AVX512F__ && NCNN_RUNTIME_CPU_AVX512VNNI
+
     // int8
     if (use_int8_requantize)
     {
@@ -1135,6 +1266,81 @@ int Convolution_x86::forward_int8_x86(const Mat& bottom_blob, Mat& top_blob, con
     return 0;
 }
 
+#if __AVX2__
+int Convolution_x86::forward_int8_pack8_x86(const Mat& bottom_blob, Mat& top_blob, const Option& opt) const
+{
+    int w = bottom_blob.w;
+    int h = bottom_blob.h;
+    int channels = bottom_blob.c;
+    size_t elemsize = bottom_blob.elemsize;
+
+    const int kernel_extent_w = dilation_w * (kernel_w - 1) + 1;
+    const int kernel_extent_h = dilation_h * (kernel_h - 1) + 1;
+
+    Mat bottom_blob_unbordered = bottom_blob;
+    if (elemsize != 8u)
+    {
+        // quantize fp32 pack8 to int8 pack8
+        bottom_blob_unbordered.create(w, h, channels, (size_t)8u, 8, opt.workspace_allocator);
+        if (bottom_blob_unbordered.empty())
+            return -100;
+
+        const int size = w * h;
+        const __m256 _scale = _mm256_set1_ps(bottom_blob_int8_scale);
+
+        #pragma omp parallel for num_threads(opt.num_threads)
+        for (int q = 0; q < channels; q++)
+        {
+            const float* ptr = bottom_blob.channel(q);
+            signed char* outptr = bottom_blob_unbordered.channel(q);
+
+            for (int i = 0; i < size; i++)
+            {
+                __m256 _p = _mm256_mul_ps(_mm256_loadu_ps(ptr), _scale);
+                _mm_storel_epi64((__m128i*)outptr, float2int8_avx(_p));
+
+                ptr += 8;
+                outptr += 8;
+            }
+        }
+    }
+
+    Mat bottom_blob_bordered;
+    make_padding(bottom_blob_unbordered, bottom_blob_bordered, opt);
+    if (bottom_blob_bordered.empty())
+        return -100;
+
+    w = bottom_blob_bordered.w;
+    h = bottom_blob_bordered.h;
+
+    int outw = (w - kernel_extent_w) / stride_w + 1;
+    int outh = (h - kernel_extent_h) / stride_h + 1;
+
+    // int8 pack8 output when requantizing
+    size_t out_elemsize = use_int8_requantize ? 8u : 32u;
+
+    top_blob.create(outw, outh, num_output / 8, out_elemsize, 8, opt.blob_allocator);
+    if (top_blob.empty())
+        return -100;
+
+    std::vector<float> scale_dequant(num_output);
+    for (int p = 0; p < num_output; p++)
+    {
+        if (weight_data_int8_scales[p] == 0)
+            scale_dequant[p] = 0;
+        else
+            scale_dequant[p] = 1.f / (bottom_blob_int8_scale * weight_data_int8_scales[p]);
+    }
+
+    float scale_requant_out = use_int8_requantize ? top_blob_int8_scale : 0.f;
+
+    // the activation is fused before requantization
+    convolution_pack8_int8_avx2(bottom_blob_bordered, top_blob, weight_data_pack8_int8, bias_data, kernel_w, kernel_h, dilation_w, dilation_h, stride_w, stride_h, scale_dequant, scale_requant_out, activation_type, activation_params, opt);
+
+    return 0;
+}
+#endif // __AVX2__
+
 // TODO: FIX ME
 #if 0
 int Convolution_x86::forwardDilation_x86(const Mat& bottom_blob, Mat& top_blob, const Option& opt) const
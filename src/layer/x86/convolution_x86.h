@@ -26,12 +26,14 @@ public:
 
     virtual int create_pipeline(const Option& opt);
     virtual int destroy_pipeline(const Option& opt);
+    virtual int get_pipeline_weights(std::vector<Mat*>& weights);
 
     virtual int forward(const Mat& bottom_blob, Mat& top_blob, const Option& opt) const;
 
 protected:
     int create_pipeline_int8_x86(const Option& opt);
     int forward_int8_x86(const Mat& bottom_blob, Mat& top_blob, const Option& opt) const;
+    int forward_int8_pack8_x86(const Mat& bottom_blob, Mat& top_blob, const Option& opt) const;
     int forwardDilation_x86(const Mat& bottom_blob, Mat& top_blob, const Option& opt) const;
 
 public:
@@ -54,6 +56,13 @@ public:
     // int8
     bool use_winograd3x3_int8;
     Mat weight_3x3_winograd23_data_int8;
+
+    // int8 avx512 vnni
+    bool use_int8_vnni;
+    Mat weight_sgemm_data_int8_vnni;
+
+    // int8 pack8
+    Mat weight_data_pack8_int8;
 };
 
 } // namespace ncnn
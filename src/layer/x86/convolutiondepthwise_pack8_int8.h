@@ -0,0 +1,117 @@
+// Tencent is pleased to support the open source community by making ncnn available.
+//
+// Copyright (C) 2020 THL A29 Limited, a Tencent company. All rights reserved.
+//
+// Licensed under the BSD 3-Clause License (the "License"); you may not use this file except
+// in compliance with the License. You may obtain a copy of the License at
+//
+// https://opensource.org/licenses/BSD-3-Clause
+//
+// Unless required by applicable law or agreed to in writing, software distributed
+// under the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR
+// CONDITIONS OF ANY KIND, either express or implied. See the License for the
+// specific language governing permissions and limitations under the License.
+
+static void convdw_transform_kernel_pack8_int8_avx2(const Mat& weight_data, Mat& weight_data_pack8, int group, int maxk)
+{
+    // src = kw-kh-group
+    // dst = 8b-kw-kh-group/8b, widened to int16
+    const signed char* kernel = weight_data;
+
+    weight_data_pack8.create(maxk, group / 8, (size_t)2u * 8, 8);
+
+    for (int g = 0; g + 7 < group; g += 8)
+    {
+        short* g00 = weight_data_pack8.row<short>(g / 8);
+
+        for (int k = 0; k < maxk; k++)
+        {
+            for (int i = 0; i < 8; i++)
+            {
+                g00[i] = kernel[(g + i) * maxk + k];
+            }
+
+            g00 += 8;
+        }
+    }
+}
+
+static void convdw_pack8_int8_avx2(const Mat& bottom_blob, Mat& top_blob, const Mat& weight_data_pack8, const Mat& bias_data, int kernel_w, int kernel_h, int dilation_w, int dilation_h, int stride_w, int stride_h,
+                                   const std::vector<float>& scale_dequant, float scale_requant_out, int activation_type, const Mat& activation_params, const Option& opt)
+{
+    int w = bottom_blob.w;
+
+    int outw = top_blob.w;
+    int outh = top_blob.h;
+    int channels = top_blob.c;
+    size_t out_elemsize = top_blob.elemsize;
+
+    const int maxk = kernel_w * kernel_h;
+
+    // kernel offsets
+    std::vector<int> _space_ofs(maxk);
+    int* space_ofs = &_space_ofs[0];
+    {
+        int p1 = 0;
+        int p2 = 0;
+        int gap = w * dilation_h - kernel_w * dilation_w;
+        for (int i = 0; i < kernel_h; i++)
+        {
+            for (int j = 0; j < kernel_w; j++)
+            {
+                space_ofs[p1] = p2 * 8;
+                p1++;
+                p2 += dilation_w;
+            }
+            p2 += gap;
+        }
+    }
+
+    const float* bias_data_ptr = bias_data;
+
+    #pragma omp parallel for num_threads(opt.num_threads)
+    for (int g = 0; g < channels; g++)
+    {
+        unsigned char* outptr = top_blob.channel(g);
+        const Mat m = bottom_blob.channel(g);
+
+        const short* kptr = weight_data_pack8.row<const short>(g);
+
+        __m256 _scale_in = _mm256_loadu_ps(&scale_dequant[g * 8]);
+        __m256 _bias = bias_data_ptr ? _mm256_loadu_ps(bias_data_ptr + g * 8) : _mm256_setzero_ps();
+
+        for (int i = 0; i < outh; i++)
+        {
+            for (int j = 0; j < outw; j++)
+            {
+                const signed char* sptr = m.row<const signed char>(i * stride_h) + j * stride_w * 8;
+
+                __m256i _sum = _mm256_setzero_si256();
+
+                for (int k = 0; k < maxk; k++)
+                {
+                    __m128i _val = _mm_cvtepi8_epi16(_mm_loadl_epi64((const __m128i*)(sptr + space_ofs[k])));
+                    __m128i _w = _mm_loadu_si128((const __m128i*)(kptr + k * 8));
+
+                    // int8 products fit in int16
+                    _sum = _mm256_add_epi32(_sum, _mm256_cvtepi16_epi32(_mm_mullo_epi16(_val, _w)));
+                }
+
+                __m256 _v = _mm256_fmadd_ps(_mm256_cvtepi32_ps(_sum), _scale_in, _bias);
+                _v = activation_ps(_v, activation_type, activation_params);
+
+                if (scale_requant_out != 0.f)
+                {
+                    _v = _mm256_mul_ps(_v, _mm256_set1_ps(scale_requant_out));
+                    _mm_storel_epi64((__m128i*)outptr, float2int8_avx(_v));
+                }
+                else
+                {
+                    _mm256_storeu_ps((float*)outptr, _v);
+                }
+
+                outptr += out_elemsize;
+            }
+        }
+    }
+}
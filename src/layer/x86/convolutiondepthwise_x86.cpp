@@ -27,6 +27,9 @@ namespace ncnn {
 #endif
 #include "convolutiondepthwise_3x3.h"
 #include "convolutiondepthwise_3x3_int8.h"
+#if __AVX2__
+#include "convolutiondepthwise_pack8_int8.h"
+#endif
 
 DEFINE_LAYER_CREATOR(ConvolutionDepthWise_x86)
 
@@ -113,6 +116,21 @@ int ConvolutionDepthWise_x86::create_pipeline(const Option& opt)
     group_ops.clear();
     if (channels == group && group == num_output)
     {
+#if __AVX2__
+        if (opt.use_int8_inference && weight_data.elemsize == (size_t)1u && opt.use_packing_layout && channels % 8 == 0)
+        {
+            // int8 blobs stay pack8 between layers
+            support_packing = true;
+
+            if (weight_data_pack8_int8.empty())
+            {
+                convdw_transform_kernel_pack8_int8_avx2(weight_data, weight_data_pack8_int8, group, maxk);
+            }
+
+            return 0;
+        }
+#endif // __AVX2__
+
         int elempack = (support_packing && opt.use_packing_layout && channels % 8 == 0) ? 8 : 1;
 #if __AVX__
         // pack8
@@ -239,6 +257,8 @@ int ConvolutionDepthWise_x86::destroy_pipeline(const Option& opt)
     }
     group_ops.clear();
 
+    weight_data_pack8_int8.release();
+
     return 0;
 }
 
@@ -487,6 +507,13 @@ int ConvolutionDepthWise_x86::forward(const Mat& bottom_blob, Mat& top_blob, con
 
 int ConvolutionDepthWise_x86::forward_int8_x86(const Mat& bottom_blob, Mat& top_blob, const Option& opt) const
 {
+#if __AVX2__
+    if (bottom_blob.elempack == 8)
+    {
+        return forward_int8_pack8_x86(bottom_blob, top_blob, opt);
+    }
+#endif // __AVX2__
+
     int w = bottom_blob.w;
     int h = bottom_blob.h;
     int channels = bottom_blob.c;
@@ -637,4 +664,80 @@ int ConvolutionDepthWise_x86::forward_int8_x86(const Mat& bottom_blob, Mat& top_
     return 0;
 }
 
+#if __AVX2__
+int ConvolutionDepthWise_x86::forward_int8_pack8_x86(const Mat& bottom_blob, Mat& top_blob, const Option& opt) const
+{
+    int w = bottom_blob.w;
+    int h = bottom_blob.h;
+    int channels = bottom_blob.c;
+    size_t elemsize = bottom_blob.elemsize;
+
+    const int kernel_extent_w = dilation_w * (kernel_w - 1) + 1;
+    const int kernel_extent_h = dilation_h * (kernel_h - 1) + 1;
+
+    Mat bottom_blob_unbordered = bottom_blob;
+    if (elemsize != 8u)
+    {
+        // quantize fp32 pack8 to int8 pack8 with per channel scales
+        bottom_blob_unbordered.create(w, h, channels, (size_t)8u, 8, opt.workspace_allocator);
+        if (bottom_blob_unbordered.empty())
+            return -100;
+
+        const int size = w * h;
+
+        #pragma omp parallel for num_threads(opt.num_threads)
+        for (int q = 0; q < channels; q++)
+        {
+            const float* ptr = bottom_blob.channel(q);
+            signed char* outptr = bottom_blob_unbordered.channel(q);
+
+            __m256 _scale = _mm256_loadu_ps((const float*)bottom_blob_int8_scales + q * 8);
+
+            for (int i = 0; i < size; i++)
+            {
+                __m256 _p = _mm256_mul_ps(_mm256_loadu_ps(ptr), _scale);
+                _mm_storel_epi64((__m128i*)outptr, float2int8_avx(_p));
+
+                ptr += 8;
+                outptr += 8;
+            }
+        }
+    }
+
+    Mat bottom_blob_bordered;
+    make_padding(bottom_blob_unbordered, bottom_blob_bordered, opt);
+    if (bottom_blob_bordered.empty())
+        return -100;
+
+    w = bottom_blob_bordered.w;
+    h = bottom_blob_bordered.h;
+
+    int outw = (w - kernel_extent_w) / stride_w + 1;
+    int outh = (h - kernel_extent_h) / stride_h + 1;
+
+    // int8 pack8 output when requantizing
+    size_t out_elemsize = use_int8_requantize ? 8u : 32u;
+
+    top_blob.create(outw, outh, channels, out_elemsize, 8, opt.blob_allocator);
+    if (top_blob.empty())
+        return -100;
+
+    std::vector<float> scale_dequant(group);
+    for (int g = 0; g < group; g++)
+    {
+        if (weight_data_int8_scales[g] == 0)
+            scale_dequant[g] = 0;
+        else
+            scale_dequant[g] = 1.f / (bottom_blob_int8_scales[g] * weight_data_int8_scales[g]);
+    }
+
+    float scale_requant_out = use_int8_requantize ? top_blob_int8_scale : 0.f;
+
+    // the activation is fused before requantization
+    convdw_pack8_int8_avx2(bottom_blob_bordered, top_blob, weight_data_pack8_int8, bias_data, kernel_w, kernel_h, dilation_w, dilation_h, stride_w, stride_h, scale_dequant, scale_requant_out, activation_type, activation_params, opt);
+
+    return 0;
+}
+#endif // __AVX2__
+
 } // namespace ncnn
@@ -31,6 +31,7 @@ public:
 
 protected:
     int forward_int8_x86(const Mat& bottom_blob, Mat& top_blob, const Option& opt) const;
+    int forward_int8_pack8_x86(const Mat& bottom_blob, Mat& top_blob, const Option& opt) const;
 
 public:
     Layer* activation;
@@ -38,6 +39,9 @@ public:
 
     // packing
     Mat weight_data_pack8;
+
+    // int8 packing
+    Mat weight_data_pack8_int8;
 };
 
 } // namespace ncnn
@@ -16,6 +16,8 @@
 // the License.
 #include <algorithm>
 
+#include <emmintrin.h>
+
 #ifdef __AVX__
 #include "avx_activation.h"
 #include "avx_usability.h"
@@ -23,17 +25,224 @@
 
 #include "innerproduct_x86.h"
 
+#include "cpu.h"
 #include "layer_type.h"
 
 namespace ncnn {
 
 DEFINE_LAYER_CREATOR(InnerProduct_x86)
 
+// int8 products are summed pairwise in int16 lanes by pmaddwd
+static inline __m128i _mm_madd_epi8_sse(__m128i _m, __m128i _w)
+{
+    // sign extend to int16
+    __m128i _ml = _mm_srai_epi16(_mm_unpacklo_epi8(_m, _m), 8);
+    __m128i _mh = _mm_srai_epi16(_mm_unpackhi_epi8(_m, _m), 8);
+    __m128i _wl = _mm_srai_epi16(_mm_unpacklo_epi8(_w, _w), 8);
+    __m128i _wh = _mm_srai_epi16(_mm_unpackhi_epi8(_w, _w), 8);
+
+    return _mm_add_epi32(_mm_madd_epi16(_ml, _wl), _mm_madd_epi16(_mh, _wh));
+}
+
+static inline int _mm_reduce_add_epi32_sse(__m128i _sum)
+{
+    _sum = _mm_add_epi32(_sum, _mm_shuffle_epi32(_sum, _MM_SHUFFLE(1, 0, 3, 2)));
+    _sum = _mm_add_epi32(_sum, _mm_shuffle_epi32(_sum, _MM_SHUFFLE(2, 3, 0, 1)));
+    return _mm_cvtsi128_si32(_sum);
+}
+
+static inline signed char float2int8(float v)
+{
+    int int32 = static_cast<int>(round(v));
+    if (int32 > 127) return 127;
+    if (int32 < -127) return -127;
+    return (signed char)int32;
+}
+
+static void innerproduct_int8_sse(const signed char* bottom, const signed char* weight, int* sums, int size, int num_output, const Option& opt)
+{
+    const int nn = size >> 4;
+    const int remain_size_start = nn << 4;
+
+    int nn_num_output = num_output >> 2;
+    int remain_num_output_start = nn_num_output << 2;
+
+    #pragma omp parallel for num_threads(opt.num_threads)
+    for (int pp = 0; pp < nn_num_output; pp++)
+    {
+        int p = pp * 4;
+
+        const signed char* m = bottom;
+        const signed char* w0 = weight + size * p;
+        const signed char* w1 = weight + size * (p + 1);
+        const signed char* w2 = weight + size * (p + 2);
+        const signed char* w3 = weight + size * (p + 3);
+
+        __m128i _sum0 = _mm_setzero_si128();
+        __m128i _sum1 = _mm_setzero_si128();
+        __m128i _sum2 = _mm_setzero_si128();
+        __m128i _sum3 = _mm_setzero_si128();
+
+        for (int i = 0; i < nn; i++)
+        {
+            __m128i _m = _mm_loadu_si128((const __m128i*)m);
+
+            _sum0 = _mm_add_epi32(_sum0, _mm_madd_epi8_sse(_m, _mm_loadu_si128((const __m128i*)w0)));
+            _sum1 = _mm_add_epi32(_sum1, _mm_madd_epi8_sse(_m, _mm_loadu_si128((const __m128i*)w1)));
+            _sum2 = _mm_add_epi32(_sum2, _mm_madd_epi8_sse(_m, _mm_loadu_si128((const __m128i*)w2)));
+            _sum3 = _mm_add_epi32(_sum3, _mm_madd_epi8_sse(_m, _mm_loadu_si128((const __m128i*)w3)));
+
+            m += 16;
+            w0 += 16;
+            w1 += 16;
+            w2 += 16;
+            w3 += 16;
+        }
+
+        int sum0 = _mm_reduce_add_epi32_sse(_sum0);
+        int sum1 = _mm_reduce_add_epi32_sse(_sum1);
+        int sum2 = _mm_reduce_add_epi32_sse(_sum2);
+        int sum3 = _mm_reduce_add_epi32_sse(_sum3);
+
+        for (int i = remain_size_start; i < size; i++)
+        {
+            sum0 += *m * *w0++;
+            sum1 += *m * *w1++;
+            sum2 += *m * *w2++;
+            sum3 += *m * *w3++;
+            m++;
+        }
+
+        sums[p] = sum0;
+        sums[p + 1] = sum1;
+        sums[p + 2] = sum2;
+        sums[p + 3] = sum3;
+    }
+
+    #pragma omp parallel for num_threads(opt.num_threads)
+    for (int p = remain_num_output_start; p < num_output; p++)
+    {
+        const signed char* m = bottom;
+        const signed char* w = weight + size * p;
+
+        __m128i _sum = _mm_setzero_si128();
+
+        for (int i = 0; i < nn; i++)
+        {
+            __m128i _m = _mm_loadu_si128((const __m128i*)m);
+            _sum = _mm_add_epi32(_sum, _mm_madd_epi8_sse(_m, _mm_loadu_si128((const __m128i*)w)));
+
+            m += 16;
+            w += 16;
+        }
+
+        int sum = _mm_reduce_add_epi32_sse(_sum);
+
+        for (int i = remain_size_start; i < size; i++)
+        {
+            sum += *m++ * *w++;
+        }
+
+        sums[p] = sum;
+    }
+}
+
+#if __AVX512F__ && NCNN_RUNTIME_CPU_AVX512VNNI
+// vpdpbusd multiplies unsigned by signed bytes, the input is shifted by 128 into u8
+// and comp = 128 * sum(w) is subtracted back per output
+NCNN_AVX512VNNI_TARGET
+static void innerproduct_int8_avx512vnni(const signed char* bottom, const signed char* weight, const int* comp, int* sums, int size, int num_output, const Option& opt)
+{
+    const __m512i _shift = _mm512_set1_epi8((char)0x80);
+
+    const int nn = size >> 6;
+    const int remain = size & 63;
+    const __mmask64 _mask = remain ? (__mmask64)(~0ULL >> (64 - remain)) : 0;
+
+    int nn_num_output = num_output >> 2;
+    int remain_num_output_start = nn_num_output << 2;
+
+    #pragma omp parallel for num_threads(opt.num_threads)
+    for (int pp = 0; pp < nn_num_output; pp++)
+    {
+        int p = pp * 4;
+
+        const signed char* m = bottom;
+        const signed char* w0 = weight + size * p;
+        const signed char* w1 = weight + size * (p + 1);
+        const signed char* w2 = weight + size * (p + 2);
+        const signed char* w3 = weight + size * (p + 3);
+
+        __m512i _sum0 = _mm512_setzero_si512();
+        __m512i _sum1 = _mm512_setzero_si512();
+        __m512i _sum2 = _mm512_setzero_si512();
+        __m512i _sum3 = _mm512_setzero_si512();
+
+        for (int i = 0; i < nn; i++)
+        {
+            __m512i _m = _mm512_xor_si512(_mm512_loadu_si512((const __m512i*)m), _shift);
+
+            _sum0 = _mm512_dpbusd_epi32(_sum0, _m, _mm512_loadu_si512((const __m512i*)w0));
+            _sum1 = _mm512_dpbusd_epi32(_sum1, _m, _mm512_loadu_si512((const __m512i*)w1));
+            _sum2 = _mm512_dpbusd_epi32(_sum2, _m, _mm512_loadu_si512((const __m512i*)w2));
+            _sum3 = _mm512_dpbusd_epi32(_sum3, _m, _mm512_loadu_si512((const __m512i*)w3));
+
+            m += 64;
+            w0 += 64;
+            w1 += 64;
+            w2 += 64;
+            w3 += 64;
+        }
+        if (remain)
+        {
+            // masked out weights are zero
+            __m512i _m = _mm512_xor_si512(_mm512_maskz_loadu_epi8(_mask, m), _shift);
+
+            _sum0 = _mm512_dpbusd_epi32(_sum0, _m, _mm512_maskz_loadu_epi8(_mask, w0));
+            _sum1 = _mm512_dpbusd_epi32(_sum1, _m, _mm512_maskz_loadu_epi8(_mask, w1));
+            _sum2 = _mm512_dpbusd_epi32(_sum2, _m, _mm512_maskz_loadu_epi8(_mask, w2));
+            _sum3 = _mm512_dpbusd_epi32(_sum3, _m, _mm512_maskz_loadu_epi8(_mask, w3));
+        }
+
+        sums[p] = _mm512_reduce_add_epi32(_sum0) - comp[p];
+        sums[p + 1] = _mm512_reduce_add_epi32(_sum1) - comp[p + 1];
+        sums[p + 2] = _mm512_reduce_add_epi32(_sum2) - comp[p + 2];
+        sums[p + 3] = _mm512_reduce_add_epi32(_sum3) - comp[p + 3];
+    }
+
+    #pragma omp parallel for num_threads(opt.num_threads)
+    for (int p = remain_num_output_start; p < num_output; p++)
+    {
+        const signed char* m = bottom;
+        const signed char* w = weight + size * p;
+
+        __m512i _sum = _mm512_setzero_si512();
+
+        for (int i = 0; i < nn; i++)
+        {
+            __m512i _m = _mm512_xor_si512(_mm512_loadu_si512((const __m512i*)m), _shift);
+            _sum = _mm512_dpbusd_epi32(_sum, _m, _mm512_loadu_si512((const __m512i*)w));
+
+            m += 64;
+            w += 64;
+        }
+        if (remain)
+        {
+            __m512i _m = _mm512_xor_si512(_mm512_maskz_loadu_epi8(_mask, m), _shift);
+            _sum = _mm512_dpbusd_epi32(_sum, _m, _mm512_maskz_loadu_epi8(_mask, w));
+        }
+
+        sums[p] = _mm512_reduce_add_epi32(_sum) - comp[p];
+    }
+}
+#endif // __AVX512F__ && NCNN_RUNTIME_CPU_AVX512VNNI
+
 InnerProduct_x86::InnerProduct_x86()
 {
 #if __AVX__
     support_packing = true;
 #endif // __AVX__
+    support_batch = true;
 
     flatten = 0;
 }
@@ -51,12 +260,34 @@ int InnerProduct_x86::create_pipeline(const Option& opt)
 
         flatten->create_pipeline(opt);
     }
-    if (opt.use_fp16_storage && weight_data.elemsize == 4u)
+    if (opt.use_fp16_storage && weight_data.elemsize == 4u && weight_data_fp16.empty())
     {
         ncnn::cast_float32_to_float16(weight_data, weight_data_fp16, opt);
     }
 #endif // __AVX__
 
+#if __AVX512F__ && NCNN_RUNTIME_CPU_AVX512VNNI
+    if (opt.use_int8_inference && weight_data.elemsize == (size_t)1u && cpu_support_x86_avx512_vnni() && weight_data_int8_comp.empty())
+    {
+        const int size = weight_data_size / num_output;
+
+        weight_data_int8_comp.create(num_output, (size_t)4u);
+
+        for (int p = 0; p < num_output; p++)
+        {
+            const signed char* w = (const signed char*)weight_data + size * p;
+
+            int sum = 0;
+            for (int i = 0; i < size; i++)
+            {
+                sum += w[i];
+            }
+
+            ((int*)weight_data_int8_comp)[p] = sum * 128;
+        }
+    }
+#endif // __AVX512F__ && NCNN_RUNTIME_CPU_AVX512VNNI
+
     return 0;
 }
 
@@ -69,6 +300,18 @@ int InnerProduct_x86::destroy_pipeline(const Option& opt)
         flatten = 0;
     }
 
+    weight_data_fp16.release();
+    weight_data_int8_comp.release();
+
+    return 0;
+}
+
+int InnerProduct_x86::get_pipeline_weights(std::vector<Mat*>& weights)
+{
+    weights.clear();
+    weights.push_back(&weight_data_fp16);
+    weights.push_back(&weight_data_int8_comp);
+
     return 0;
 }
 
@@ -77,8 +320,7 @@ int InnerProduct_x86::forward(const Mat& bottom_blob, Mat& top_blob,
 {
     if (opt.use_int8_inference && weight_data.elemsize == (size_t)1u)
     {
-        // TODO
-        return InnerProduct::forward(bottom_blob, top_blob, opt);
+        return forward_int8_x86(bottom_blob, top_blob, opt);
     }
 
     int w = bottom_blob.w;
@@ -155,6 +397,16 @@ int InnerProduct_x86::forward(const Mat& bottom_blob, Mat& top_blob,
         __m256 _sum5 = _mm256_set1_ps(0.f);
         __m256 _sum6 = _mm256_set1_ps(0.f);
         __m256 _sum7 = _mm256_set1_ps(0.f);
+#if __AVX512F__
+        __m512 _sum0_avx512 = _mm512_setzero_ps();
+        __m512 _sum1_avx512 = _mm512_setzero_ps();
+        __m512 _sum2_avx512 = _mm512_setzero_ps();
+        __m512 _sum3_avx512 = _mm512_setzero_ps();
+        __m512 _sum4_avx512 = _mm512_setzero_ps();
+        __m512 _sum5_avx512 = _mm512_setzero_ps();
+        __m512 _sum6_avx512 = _mm512_setzero_ps();
+        __m512 _sum7_avx512 = _mm512_setzero_ps();
+#endif // __AVX512F__
 
         const float* w0 = weight_data_ptr + size * channels * p;
         const float* w1 = weight_data_ptr + size * channels * (p + 1);
@@ -169,7 +421,35 @@ int InnerProduct_x86::forward(const Mat& bottom_blob, Mat& top_blob,
         for (int q = 0; q < channels; q++)
         {
             const float* m = bottom_blob.channel(q);
+#if __AVX512F__
+            int nn16 = size >> 4;
+            for (; nn16 > 0; nn16--)
+            {
+                __m512 _m = _mm512_loadu_ps(m);
+
+                _sum0_avx512 = _mm512_fmadd_ps(_m, _mm512_loadu_ps(w0), _sum0_avx512);
+                _sum1_avx512 = _mm512_fmadd_ps(_m, _mm512_loadu_ps(w1), _sum1_avx512);
+                _sum2_avx512 = _mm512_fmadd_ps(_m, _mm512_loadu_ps(w2), _sum2_avx512);
+                _sum3_avx512 = _mm512_fmadd_ps(_m, _mm512_loadu_ps(w3), _sum3_avx512);
+                _sum4_avx512 = _mm512_fmadd_ps(_m, _mm512_loadu_ps(w4), _sum4_avx512);
+                _sum5_avx512 = _mm512_fmadd_ps(_m, _mm512_loadu_ps(w5), _sum5_avx512);
+                _sum6_avx512 = _mm512_fmadd_ps(_m, _mm512_loadu_ps(w6), _sum6_avx512);
+                _sum7_avx512 = _mm512_fmadd_ps(_m, _mm512_loadu_ps(w7), _sum7_avx512);
+
+                m += 16;
+                w0 += 16;
+                w1 += 16;
+                w2 += 16;
+                w3 += 16;
+                w4 += 16;
+                w5 += 16;
+                w6 += 16;
+                w7 += 16;
+            }
+            int nn = (size & 15) >> 3;
+#else
             int nn = size >> 3;
+#endif // __AVX512F__
             int remain = size & 7;
 
             for (; nn > 0; nn--)
@@ -233,13 +513,22 @@ int InnerProduct_x86::forward(const Mat& bottom_blob, Mat& top_blob,
                 w7++;
             }
         }
+#if __AVX512F__
+        _sum0 = _mm256_add_ps(_sum0, fold_avx512_ps(_sum0_avx512));
+        _sum1 = _mm256_add_ps(_sum1, fold_avx512_ps(_sum1_avx512));
+        _sum2 = _mm256_add_ps(_sum2, fold_avx512_ps(_sum2_avx512));
+        _sum3 = _mm256_add_ps(_sum3, fold_avx512_ps(_sum3_avx512));
+        _sum4 = _mm256_add_ps(_sum4, fold_avx512_ps(_sum4_avx512));
+        _sum5 = _mm256_add_ps(_sum5, fold_avx512_ps(_sum5_avx512));
+        _sum6 = _mm256_add_ps(_sum6, fold_avx512_ps(_sum6_avx512));
+        _sum7 = _mm256_add_ps(_sum7, fold_avx512_ps(_sum7_avx512));
+#endif // __AVX512F__
         __m256 _sums = HorizontalSums(_sum0, _sum1, _sum2, _sum3, _sum4, _sum5,
                                       _sum6, _sum7);
         __m256 _sums_f = _mm256_loadu_ps(sums);
         _sums = activation_ps(_mm256_add_ps(_sums_f, _sums), activation_type,
                               activation_params);
-        _mm256_storeu_ps(output_ptr, _sums);
-        output_ptr += 8;
+        _mm256_storeu_ps(output_ptr + p, _sums);
     }
 
     nn_num_output = (num_output - remain_num_output_start) >> 2;
@@ -316,8 +605,7 @@ int InnerProduct_x86::forward(const Mat& bottom_blob, Mat& top_blob,
         __m128 _sums = HorizontalSums(_sum0, _sum1, _sum2, _sum3);
         __m256 _sums_a = activation_ps(_mm256_castps128_ps256(_mm_add_ps(_mm_loadu_ps(sums), _sums)), activation_type,
                                        activation_params);
-        _mm_storeu_ps(output_ptr, _mm256_castps256_ps128(_sums_a));
-        output_ptr += 4;
+        _mm_storeu_ps(output_ptr + p, _mm256_castps256_ps128(_sums_a));
     }
 
 // num_output
@@ -337,7 +625,21 @@ int InnerProduct_x86::forward(const Mat& bottom_blob, Mat& top_blob,
         {
             const float* m = bottom_blob.channel(q);
 
+#if __AVX512F__
+            __m512 _sum_avx512 = _mm512_setzero_ps();
+            int nn16 = size >> 4;
+            for (; nn16 > 0; nn16--)
+            {
+                _sum_avx512 = _mm512_fmadd_ps(_mm512_loadu_ps(m), _mm512_loadu_ps(w), _sum_avx512);
+
+                m += 16;
+                w += 16;
+            }
+            _sum = _mm256_add_ps(_sum, fold_avx512_ps(_sum_avx512));
+            int nn = (size & 15) >> 3;
+#else
             int nn = size >> 3;
+#endif // __AVX512F__
             int remain = size & 7;
             for (; nn > 0; nn--)
             {
@@ -360,14 +662,308 @@ int InnerProduct_x86::forward(const Mat& bottom_blob, Mat& top_blob,
         sum += _mm256_reduce_add_ps(_sum);
         sum = activation_ss(sum, activation_type, activation_params);
 
-        *output_ptr = sum;
-        output_ptr++;
+        output_ptr[p] = sum;
     }
     return 0;
 #else
     return InnerProduct::forward(bottom_blob, top_blob, opt);
 #endif // __AVX__
 }
+
+int InnerProduct_x86::forward_int8_x86(const Mat& bottom_blob, Mat& top_blob, const Option& opt) const
+{
+    Option opt_g = opt;
+    opt_g.blob_allocator = opt.workspace_allocator;
+
+    Mat bottom_blob_unpacked = bottom_blob;
+    if (bottom_blob.elempack != 1)
+    {
+        convert_packing(bottom_blob, bottom_blob_unpacked, 1, opt_g);
+    }
+
+    const int size = bottom_blob_unpacked.w * bottom_blob_unpacked.h * bottom_blob_unpacked.c;
+
+    // flatten
+    Mat bottom_blob_flattened = bottom_blob_unpacked.reshape(size, opt.workspace_allocator);
+    if (bottom_blob_flattened.empty())
+        return -100;
+
+    Mat bottom_blob_int8 = bottom_blob_flattened;
+    if (bottom_blob_flattened.elemsize != 1)
+    {
+        quantize_float32_to_int8(bottom_blob_flattened, bottom_blob_int8, bottom_blob_int8_scale, opt_g);
+    }
+
+    Mat sums(num_output, (size_t)4u, opt.workspace_allocator);
+    if (sums.empty())
+        return -100;
+
+#if __AVX512F__ && NCNN_RUNTIME_CPU_AVX512VNNI
+    if (!weight_data_int8_comp.empty())
+    {
+        innerproduct_int8_avx512vnni(bottom_blob_int8, weight_data, weight_data_int8_comp, sums, size, num_output, opt);
+    }
+    else
+#endif // __AVX512F__ && NCNN_RUNTIME_CPU_AVX512VNNI
+    {
+        innerproduct_int8_sse(bottom_blob_int8, weight_data, sums, size, num_output, opt);
+    }
+
+    // int8 output when the next layer takes it
+    size_t out_elemsize = use_int8_requantize ? 1u : 4u;
+
+    top_blob.create(num_output, out_elemsize, opt.blob_allocator);
+    if (top_blob.empty())
+        return -100;
+
+    const int* sumptr = sums;
+
+    for (int p = 0; p < num_output; p++)
+    {
+        // dequantize and relu
+        float scale_in;
+        if (weight_data_int8_scales[p] == 0)
+            scale_in = 0;
+        else
+            scale_in = 1.f / (bottom_blob_int8_scale * weight_data_int8_scales[p]);
+
+        float sumfp32 = sumptr[p] * scale_in;
+
+        if (bias_term)
+            sumfp32 += bias_data[p];
+
+        if (activation_type == 1)
+        {
+            sumfp32 = std::max(sumfp32, 0.f);
+        }
+
+        if (use_int8_requantize)
+        {
+            signed char* outptr = top_blob;
+            outptr[p] = float2int8(sumfp32 * top_blob_int8_scale);
+        }
+        else
+        {
+            float* outptr = top_blob;
+            outptr[p] = sumfp32;
+        }
+    }
+
+    return 0;
+}
+
+int InnerProduct_x86::forward_batch(const std::vector<Mat>& bottom_blobs, std::vector<Mat>& top_blobs,
+                                    const Option& opt) const
+{
+#if __AVX__
+    const int batch = (int)bottom_blobs.size();
+    const int size = weight_data_size / num_output;
+
+    // int8 and fp16 storage go one by one
+    bool batchable = !(opt.use_int8_inference && weight_data.elemsize == (size_t)1u) && !opt.use_fp16_storage;
+    for (int n = 0; n < batch && batchable; n++)
+    {
+        const Mat& m = bottom_blobs[n];
+        batchable = m.elemsize == 4u * m.elempack && m.w * m.h * m.c * m.elempack == size;
+    }
+
+    if (!batchable)
+        return Layer::forward_batch(bottom_blobs, top_blobs, opt);
+
+    Option opt_flatten = opt;
+    opt_flatten.blob_allocator = opt.workspace_allocator;
+
+    // gather the samples as rows of a batch x size matrix
+    Mat bottom_rows(size, batch, 4u, opt.workspace_allocator);
+    if (bottom_rows.empty())
+        return -100;
+
+    for (int n = 0; n < batch; n++)
+    {
+        Mat m = bottom_blobs[n];
+        if (m.elempack == 8 && m.dims != 1)
+        {
+            flatten->forward(bottom_blobs[n], m, opt_flatten);
+            if (m.empty())
+                return -100;
+        }
+
+        const int channel_size = m.w * m.h * m.elempack;
+
+        float* outptr = bottom_rows.row(n);
+        for (int q = 0; q < m.c; q++)
+        {
+            memcpy(outptr + channel_size * q, m.channel(q), channel_size * sizeof(float));
+        }
+    }
+
+    top_blobs.resize(batch);
+    for (int n = 0; n < batch; n++)
+    {
+        top_blobs[n].create(num_output, 4u, opt.blob_allocator);
+        if (top_blobs[n].empty())
+            return -100;
+    }
+
+    const float* weight_data_ptr = weight_data;
+
+    // 4 outputs x 2 samples per block, every weight row is read once per sample pair
+    int nn_num_output = num_output >> 2;
+    int remain_num_output_start = nn_num_output << 2;
+
+    #pragma omp parallel for num_threads(opt.num_threads)
+    for (int pp = 0; pp < nn_num_output; pp++)
+    {
+        int p = pp * 4;
+
+        const float* w0 = weight_data_ptr + size * p;
+        const float* w1 = weight_data_ptr + size * (p + 1);
+        const float* w2 = weight_data_ptr + size * (p + 2);
+        const float* w3 = weight_data_ptr + size * (p + 3);
+
+        float bias[4] = {0.0f};
+        if (bias_term)
+        {
+            bias[0] = bias_data[p];
+            bias[1] = bias_data[p + 1];
+            bias[2] = bias_data[p + 2];
+            bias[3] = bias_data[p + 3];
+        }
+
+        int n = 0;
+        for (; n + 1 < batch; n += 2)
+        {
+            const float* m0 = bottom_rows.row(n);
+            const float* m1 = bottom_rows.row(n + 1);
+
+            __m256 _sum00 = _mm256_set1_ps(0.f);
+            __m256 _sum01 = _mm256_set1_ps(0.f);
+            __m256 _sum10 = _mm256_set1_ps(0.f);
+            __m256 _sum11 = _mm256_set1_ps(0.f);
+            __m256 _sum20 = _mm256_set1_ps(0.f);
+            __m256 _sum21 = _mm256_set1_ps(0.f);
+            __m256 _sum30 = _mm256_set1_ps(0.f);
+            __m256 _sum31 = _mm256_set1_ps(0.f);
+
+            int i = 0;
+            for (; i + 7 < size; i += 8)
+            {
+                __m256 _m0 = _mm256_loadu_ps(m0 + i);
+                __m256 _m1 = _mm256_loadu_ps(m1 + i);
+
+                __m256 _w0 = _mm256_loadu_ps(w0 + i);
+                _sum00 = _mm256_fmadd_ps(_m0, _w0, _sum00);
+                _sum01 = _mm256_fmadd_ps(_m1, _w0, _sum01);
+
+                __m256 _w1 = _mm256_loadu_ps(w1 + i);
+                _sum10 = _mm256_fmadd_ps(_m0, _w1, _sum10);
+                _sum11 = _mm256_fmadd_ps(_m1, _w1, _sum11);
+
+                __m256 _w2 = _mm256_loadu_ps(w2 + i);
+                _sum20 = _mm256_fmadd_ps(_m0, _w2, _sum20);
+                _sum21 = _mm256_fmadd_ps(_m1, _w2, _sum21);
+
+                __m256 _w3 = _mm256_loadu_ps(w3 + i);
+                _sum30 = _mm256_fmadd_ps(_m0, _w3, _sum30);
+                _sum31 = _mm256_fmadd_ps(_m1, _w3, _sum31);
+            }
+
+            float sums0[4];
+            float sums1[4];
+            _mm_storeu_ps(sums0, HorizontalSums(_sum00, _sum10, _sum20, _sum30));
+            _mm_storeu_ps(sums1, HorizontalSums(_sum01, _sum11, _sum21, _sum31));
+
+            for (; i < size; i++)
+            {
+                sums0[0] += m0[i] * w0[i];
+                sums0[1] += m0[i] * w1[i];
+                sums0[2] += m0[i] * w2[i];
+                sums0[3] += m0[i] * w3[i];
+                sums1[0] += m1[i] * w0[i];
+                sums1[1] += m1[i] * w1[i];
+                sums1[2] += m1[i] * w2[i];
+                sums1[3] += m1[i] * w3[i];
+            }
+
+            float* outptr0 = (float*)top_blobs[n] + p;
+            float* outptr1 = (float*)top_blobs[n + 1] + p;
+            for (int k = 0; k < 4; k++)
+            {
+                outptr0[k] = activation_ss(sums0[k] + bias[k], activation_type, activation_params);
+                outptr1[k] = activation_ss(sums1[k] + bias[k], activation_type, activation_params);
+            }
+        }
+        for (; n < batch; n++)
+        {
+            const float* m0 = bottom_rows.row(n);
+
+            __m256 _sum0 = _mm256_set1_ps(0.f);
+            __m256 _sum1 = _mm256_set1_ps(0.f);
+            __m256 _sum2 = _mm256_set1_ps(0.f);
+            __m256 _sum3 = _mm256_set1_ps(0.f);
+
+            int i = 0;
+            for (; i + 7 < size; i += 8)
+            {
+                __m256 _m0 = _mm256_loadu_ps(m0 + i);
+                _sum0 = _mm256_fmadd_ps(_m0, _mm256_loadu_ps(w0 + i), _sum0);
+                _sum1 = _mm256_fmadd_ps(_m0, _mm256_loadu_ps(w1 + i), _sum1);
+                _sum2 = _mm256_fmadd_ps(_m0, _mm256_loadu_ps(w2 + i), _sum2);
+                _sum3 = _mm256_fmadd_ps(_m0, _mm256_loadu_ps(w3 + i), _sum3);
+            }
+
+            float sums0[4];
+            _mm_storeu_ps(sums0, HorizontalSums(_sum0, _sum1, _sum2, _sum3));
+
+            for (; i < size; i++)
+            {
+                sums0[0] += m0[i] * w0[i];
+                sums0[1] += m0[i] * w1[i];
+                sums0[2] += m0[i] * w2[i];
+                sums0[3] += m0[i] * w3[i];
+            }
+
+            float* outptr0 = (float*)top_blobs[n] + p;
+            for (int k = 0; k < 4; k++)
+            {
+                outptr0[k] = activation_ss(sums0[k] + bias[k], activation_type, activation_params);
+            }
+        }
+    }
+
+    #pragma omp parallel for num_threads(opt.num_threads)
+    for (int p = remain_num_output_start; p < num_output; p++)
+    {
+        const float* w0 = weight_data_ptr + size * p;
+
+        for (int n = 0; n < batch; n++)
+        {
+            const float* m0 = bottom_rows.row(n);
+
+            __m256 _sum = _mm256_set1_ps(0.f);
+
+            int i = 0;
+            for (; i + 7 < size; i += 8)
+            {
+                _sum = _mm256_fmadd_ps(_mm256_loadu_ps(m0 + i), _mm256_loadu_ps(w0 + i), _sum);
+            }
+
+            float sum = bias_term ? bias_data[p] : 0.f;
+            for (; i < size; i++)
+            {
+                sum += m0[i] * w0[i];
+            }
+
+            sum += _mm256_reduce_add_ps(_sum);
+            top_blobs[n][p] = activation_ss(sum, activation_type, activation_params);
+        }
+    }
+
+    return 0;
+#else
+    return InnerProduct::forward_batch(bottom_blobs, top_blobs, opt);
+#endif // __AVX__
+}
 #if __AVX__
 
 int InnerProduct_x86::forward_fp16(const Mat& bottom_blob, Mat& top_blob,
@@ -413,6 +1009,16 @@ int InnerProduct_x86::forward_fp16(const Mat& bottom_blob, Mat& top_blob,
         __m256 _sum5 = _mm256_set1_ps(0.f);
         __m256 _sum6 = _mm256_set1_ps(0.f);
         __m256 _sum7 = _mm256_set1_ps(0.f);
+#if __AVX512F__
+        __m512 _sum0_avx512 = _mm512_setzero_ps();
+        __m512 _sum1_avx512 = _mm512_setzero_ps();
+        __m512 _sum2_avx512 = _mm512_setzero_ps();
+        __m512 _sum3_avx512 = _mm512_setzero_ps();
+        __m512 _sum4_avx512 = _mm512_setzero_ps();
+        __m512 _sum5_avx512 = _mm512_setzero_ps();
+        __m512 _sum6_avx512 = _mm512_setzero_ps();
+        __m512 _sum7_avx512 = _mm512_setzero_ps();
+#endif // __AVX512F__
 
         const unsigned short* w0 = (const unsigned short*)weight_data_ptr + size * channels * p;
         const unsigned short* w1 = (const unsigned short*)weight_data_ptr + size * channels * (p + 1);
@@ -427,7 +1033,35 @@ int InnerProduct_x86::forward_fp16(const Mat& bottom_blob, Mat& top_blob,
         for (int q = 0; q < channels; q++)
         {
             const float* m = bottom_blob.channel(q);
+#if __AVX512F__
+            int nn16 = size >> 4;
+            for (; nn16 > 0; nn16--)
+            {
+                __m512 _m = _mm512_loadu_ps(m);
+
+                _sum0_avx512 = _mm512_fmadd_ps(_m, loadfp16_avx512(w0), _sum0_avx512);
+                _sum1_avx512 = _mm512_fmadd_ps(_m, loadfp16_avx512(w1), _sum1_avx512);
+                _sum2_avx512 = _mm512_fmadd_ps(_m, loadfp16_avx512(w2), _sum2_avx512);
+                _sum3_avx512 = _mm512_fmadd_ps(_m, loadfp16_avx512(w3), _sum3_avx512);
+                _sum4_avx512 = _mm512_fmadd_ps(_m, loadfp16_avx512(w4), _sum4_avx512);
+                _sum5_avx512 = _mm512_fmadd_ps(_m, loadfp16_avx512(w5), _sum5_avx512);
+                _sum6_avx512 = _mm512_fmadd_ps(_m, loadfp16_avx512(w6), _sum6_avx512);
+                _sum7_avx512 = _mm512_fmadd_ps(_m, loadfp16_avx512(w7), _sum7_avx512);
+
+                m += 16;
+                w0 += 16;
+                w1 += 16;
+                w2 += 16;
+                w3 += 16;
+                w4 += 16;
+                w5 += 16;
+                w6 += 16;
+                w7 += 16;
+            }
+            int nn = (size & 15) >> 3;
+#else
             int nn = size >> 3;
+#endif // __AVX512F__
             int remain = size & 7;
 
             for (; nn > 0; nn--)
@@ -524,13 +1158,22 @@ int InnerProduct_x86::forward_fp16(const Mat& bottom_blob, Mat& top_blob,
                 _sum7 = _mm256_fmadd_ps(_m, _w7, _sum7);
             }
         }
+#if __AVX512F__
+        _sum0 = _mm256_add_ps(_sum0, fold_avx512_ps(_sum0_avx512));
+        _sum1 = _mm256_add_ps(_sum1, fold_avx512_ps(_sum1_avx512));
+        _sum2 = _mm256_add_ps(_sum2, fold_avx512_ps(_sum2_avx512));
+        _sum3 = _mm256_add_ps(_sum3, fold_avx512_ps(_sum3_avx512));
+        _sum4 = _mm256_add_ps(_sum4, fold_avx512_ps(_sum4_avx512));
+        _sum5 = _mm256_add_ps(_sum5, fold_avx512_ps(_sum5_avx512));
+        _sum6 = _mm256_add_ps(_sum6, fold_avx512_ps(_sum6_avx512));
+        _sum7 = _mm256_add_ps(_sum7, fold_avx512_ps(_sum7_avx512));
+#endif // __AVX512F__
         __m256 _sums = HorizontalSums(_sum0, _sum1, _sum2, _sum3, _sum4, _sum5,
                                       _sum6, _sum7);
         __m256 _sums_f = _mm256_loadu_ps(sums);
         _sums = activation_ps(_mm256_add_ps(_sums_f, _sums), activation_type,
                               activation_params);
-        _mm256_storeu_ps(output_ptr, _sums);
-        output_ptr += 8;
+        _mm256_storeu_ps(output_ptr + p, _sums);
     }
 
     nn_num_output = (num_output - remain_num_output_start) >> 2;
@@ -626,8 +1269,7 @@ int InnerProduct_x86::forward_fp16(const Mat& bottom_blob, Mat& top_blob,
         __m128 _sums = HorizontalSums(_sum0, _sum1, _sum2, _sum3);
         __m256 _sums_a = activation_ps(_mm256_castps128_ps256(_mm_add_ps(_mm_loadu_ps(sums), _sums)), activation_type,
                                        activation_params);
-        _mm_storeu_ps(output_ptr, _mm256_castps256_ps128(_sums_a));
-        output_ptr += 4;
+        _mm_storeu_ps(output_ptr + p, _mm256_castps256_ps128(_sums_a));
     }
 
 // num_output
@@ -647,7 +1289,21 @@ int InnerProduct_x86::forward_fp16(const Mat& bottom_blob, Mat& top_blob,
         {
             const float* m = bottom_blob.channel(q);
 
+#if __AVX512F__
+            __m512 _sum_avx512 = _mm512_setzero_ps();
+            int nn16 = size >> 4;
+            for (; nn16 > 0; nn16--)
+            {
+                _sum_avx512 = _mm512_fmadd_ps(_mm512_loadu_ps(m), loadfp16_avx512(w), _sum_avx512);
+
+                m += 16;
+                w += 16;
+            }
+            _sum = _mm256_add_ps(_sum, fold_avx512_ps(_sum_avx512));
+            int nn = (size & 15) >> 3;
+#else
             int nn = size >> 3;
+#endif // __AVX512F__
             int remain = size & 7;
             for (; nn > 0; nn--)
             {
@@ -682,8 +1338,7 @@ int InnerProduct_x86::forward_fp16(const Mat& bottom_blob, Mat& top_blob,
         sum += _mm256_reduce_add_ps(_sum);
         sum = activation_ss(sum, activation_type, activation_params);
 
-        *output_ptr = sum;
-        output_ptr++;
+        output_ptr[p] = sum;
     }
     return 0;
 }
@@ -29,18 +29,25 @@ public:
 
     virtual int create_pipeline(const Option& opt);
     virtual int destroy_pipeline(const Option& opt);
+    virtual int get_pipeline_weights(std::vector<Mat*>& weights);
 
     virtual int forward(const Mat& bottom_blob, Mat& top_blob,
                         const Option& opt) const;
+    virtual int forward_batch(const std::vector<Mat>& bottom_blobs, std::vector<Mat>& top_blobs,
+                              const Option& opt) const;
 
 protected:
     int forward_fp16(const Mat& bottom_blob, Mat& top_blob, const Option& opt) const;
+    int forward_int8_x86(const Mat& bottom_blob, Mat& top_blob, const Option& opt) const;
 
 public:
     ncnn::Layer* flatten;
 
     // fp16 weight data
     Mat weight_data_fp16;
+
+    // int8 avx512 vnni compensation
+    Mat weight_data_int8_comp;
 };
 
 } // namespace ncnn
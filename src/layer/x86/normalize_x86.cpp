@@ -0,0 +1,202 @@
+// Tencent is pleased to support the open source community by making ncnn available.
+//
+// Copyright (C) 2020 THL A29 Limited, a Tencent company. All rights reserved.
+//
+// Licensed under the BSD 3-Clause License (the "License"); you may not use this file except
+// in compliance with the License. You may obtain a copy of the License at
+//
+// https://opensource.org/licenses/BSD-3-Clause
+//
+// Unless required by applicable law or agreed to in writing, software distributed
+// under the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR
+// CONDITIONS OF ANY KIND, either express or implied. See the License for the
+// specific language governing permissions and limitations under the License.
+
+
+#include "normalize_x86.h"
+
+#include <algorithm>
+#include <math.h>
+
+#if __AVX__
+#include "avx_usability.h"
+
+#include <immintrin.h>
+#endif // __AVX__
+
+namespace ncnn {
+
+DEFINE_LAYER_CREATOR(Normalize_x86)
+
+Normalize_x86::Normalize_x86()
+{
+#if __AVX__
+    support_packing = true;
+#endif // __AVX__
+}
+
+#if __AVX__
+static inline float normalize_coeff(float ssum, float eps, int eps_mode)
+{
+    if (eps_mode == 0) // caffe/mxnet
+        return static_cast<float>(1.f / sqrt(ssum + eps));
+
+    if (eps_mode == 1) // pytorch
+        return 1.f / std::max((float)sqrt(ssum), eps);
+
+    // tensorflow
+    return static_cast<float>(1.f / sqrt(std::max(ssum, eps)));
+}
+
+static inline __m256 normalize_coeff(__m256 _ssum, float eps, int eps_mode)
+{
+    const __m256 _one = _mm256_set1_ps(1.f);
+    const __m256 _eps = _mm256_set1_ps(eps);
+
+    if (eps_mode == 0) // caffe/mxnet
+        return _mm256_div_ps(_one, _mm256_sqrt_ps(_mm256_add_ps(_ssum, _eps)));
+
+    if (eps_mode == 1) // pytorch
+        return _mm256_div_ps(_one, _mm256_max_ps(_mm256_sqrt_ps(_ssum), _eps));
+
+    // tensorflow
+    return _mm256_div_ps(_one, _mm256_sqrt_ps(_mm256_max_ps(_ssum, _eps)));
+}
+#endif // __AVX__
+
+int Normalize_x86::forward_inplace(Mat& bottom_top_blob, const Option& opt) const
+{
+#if __AVX__
+    int elempack = bottom_top_blob.elempack;
+
+    if (elempack == 8)
+    {
+        int w = bottom_top_blob.w;
+        int h = bottom_top_blob.h;
+        int channels = bottom_top_blob.c;
+        int size = w * h;
+
+        if (across_spatial && across_channel)
+        {
+            Mat square_sum_blob;
+            square_sum_blob.create(channels, (size_t)4u, opt.workspace_allocator);
+            if (square_sum_blob.empty())
+                return -100;
+
+            #pragma omp parallel for num_threads(opt.num_threads)
+            for (int q = 0; q < channels; q++)
+            {
+                const float* ptr = bottom_top_blob.channel(q);
+
+                __m256 _ssum = _mm256_setzero_ps();
+                for (int i = 0; i < size; i++)
+                {
+                    __m256 _p = _mm256_loadu_ps(ptr);
+                    _ssum = _mm256_fmadd_ps(_p, _p, _ssum);
+                    ptr += 8;
+                }
+
+                square_sum_blob[q] = _mm256_reduce_add_ps(_ssum);
+            }
+
+            float ssum = 0.f;
+            for (int q = 0; q < channels; q++)
+            {
+                ssum += square_sum_blob[q];
+            }
+
+            const float a = normalize_coeff(ssum, eps, eps_mode);
+
+            #pragma omp parallel for num_threads(opt.num_threads)
+            for (int q = 0; q < channels; q++)
+            {
+                float* ptr = bottom_top_blob.channel(q);
+
+                __m256 _scale = channel_shared ? _mm256_set1_ps(a * scale_data[0]) : _mm256_mul_ps(_mm256_set1_ps(a), _mm256_loadu_ps((const float*)scale_data + q * 8));
+
+                for (int i = 0; i < size; i++)
+                {
+                    _mm256_storeu_ps(ptr, _mm256_mul_ps(_mm256_loadu_ps(ptr), _scale));
+                    ptr += 8;
+                }
+            }
+
+            return 0;
+        }
+
+        if (across_spatial && !across_channel)
+        {
+            #pragma omp parallel for num_threads(opt.num_threads)
+            for (int q = 0; q < channels; q++)
+            {
+                float* ptr = bottom_top_blob.channel(q);
+
+                __m256 _ssum = _mm256_setzero_ps();
+                for (int i = 0; i < size; i++)
+                {
+                    __m256 _p = _mm256_loadu_ps(ptr + i * 8);
+                    _ssum = _mm256_fmadd_ps(_p, _p, _ssum);
+                }
+
+                __m256 _a = normalize_coeff(_ssum, eps, eps_mode);
+                __m256 _scale = _mm256_mul_ps(_a, channel_shared ? _mm256_set1_ps(scale_data[0]) : _mm256_loadu_ps((const float*)scale_data + q * 8));
+
+                for (int i = 0; i < size; i++)
+                {
+                    _mm256_storeu_ps(ptr, _mm256_mul_ps(_mm256_loadu_ps(ptr), _scale));
+                    ptr += 8;
+                }
+            }
+
+            return 0;
+        }
+
+        if (!across_spatial && across_channel)
+        {
+            // square sum over all packed channels, 1 / sqrt(ssum)
+            Mat square_sum_blob;
+            square_sum_blob.create(size, (size_t)4u, opt.workspace_allocator);
+            if (square_sum_blob.empty())
+                return -100;
+
+            const float scale0 = channel_shared ? scale_data[0] : 1.f;
+
+            #pragma omp parallel for num_threads(opt.num_threads)
+            for (int i = 0; i < size; i++)
+            {
+                __m256 _ssum = _mm256_setzero_ps();
+                for (int q = 0; q < channels; q++)
+                {
+                    __m256 _p = _mm256_loadu_ps((const float*)bottom_top_blob.channel(q) + i * 8);
+                    _ssum = _mm256_fmadd_ps(_p, _p, _ssum);
+                }
+
+                square_sum_blob[i] = normalize_coeff(_mm256_reduce_add_ps(_ssum), eps, eps_mode) * scale0;
+            }
+
+            #pragma omp parallel for num_threads(opt.num_threads)
+            for (int q = 0; q < channels; q++)
+            {
+                float* ptr = bottom_top_blob.channel(q);
+
+                __m256 _scale = channel_shared ? _mm256_set1_ps(1.f) : _mm256_loadu_ps((const float*)scale_data + q * 8);
+
+                for (int i = 0; i < size; i++)
+                {
+                    __m256 _p = _mm256_mul_ps(_mm256_loadu_ps(ptr), _mm256_set1_ps(square_sum_blob[i]));
+                    _mm256_storeu_ps(ptr, _mm256_mul_ps(_p, _scale));
+                    ptr += 8;
+                }
+            }
+
+            return 0;
+        }
+
+        return 0;
+    }
+#endif // __AVX__
+
+    return Normalize::forward_inplace(bottom_top_blob, opt);
+}
+
+} // namespace ncnn
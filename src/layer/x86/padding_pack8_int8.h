@@ -0,0 +1,49 @@
+// Tencent is pleased to support the open source community by making ncnn available.
+//
+// Copyright (C) 2020 THL A29 Limited, a Tencent company. All rights reserved.
+//
+// Licensed under the BSD 3-Clause License (the "License"); you may not use this file except
+// in compliance with the License. You may obtain a copy of the License at
+//
+// https://opensource.org/licenses/BSD-3-Clause
+//
+// Unless required by applicable law or agreed to in writing, software distributed
+// under the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR
+// CONDITIONS OF ANY KIND, either express or implied. See the License for the
+// specific language governing permissions and limitations under the License.
+
+// one int8 pack8 element is 8 bytes, moved around as int64_t
+static void padding_constant_pack8_int8_sse(const Mat& src, Mat& dst, int top, int bottom, int left, int right, int64_t v)
+{
+    const int64_t* ptr = src;
+    int64_t* outptr = dst;
+    int top_size = top * dst.w;
+    int bottom_size = bottom * dst.w;
+
+    // fill top
+    for (int y = 0; y < top_size; y++)
+    {
+        *outptr++ = v;
+    }
+    // fill center
+    for (int y = 0; y < src.h; y++)
+    {
+        for (int x = 0; x < left; x++)
+        {
+            *outptr++ = v;
+        }
+        for (int x = 0; x < src.w; x++)
+        {
+            *outptr++ = *ptr++;
+        }
+        for (int x = 0; x < right; x++)
+        {
+            *outptr++ = v;
+        }
+    }
+    // fill bottom
+    for (int y = 0; y < bottom_size; y++)
+    {
+        *outptr++ = v;
+    }
+}
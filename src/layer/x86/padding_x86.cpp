@@ -14,6 +14,9 @@
 
 #include "padding_x86.h"
 
+#include <stdint.h>
+#include <string.h>
+
 #if __AVX__
 #include <immintrin.h>
 #endif // __AVX__
@@ -22,6 +25,7 @@ namespace ncnn {
 
 #if __AVX__
 #include "padding_pack8.h"
+#include "padding_pack8_int8.h"
 #endif // __AVX__
 
 DEFINE_LAYER_CREATOR(Padding_x86)
@@ -60,6 +64,41 @@ int Padding_x86::forward(const Mat& bottom_blob, Mat& top_blob, const Option& op
     Mat bottom_blob_unpacked = bottom_blob;
 
 #if __AVX__
+    if (elempack == 8 && elemsize == 8u)
+    {
+        // int8 pack8 from int8 convolution
+        if (dims == 3 && type == 0 && front == 0 && behind == 0 && per_channel_pad_data_size == 0)
+        {
+            int outw = w + left + right;
+            int outh = h + top + bottom;
+
+            top_blob.create(outw, outh, channels, elemsize, elempack, opt.blob_allocator);
+            if (top_blob.empty())
+                return -100;
+
+            signed char v8 = static_cast<signed char>(value);
+            int64_t v;
+            memset(&v, v8, sizeof(v));
+
+            #pragma omp parallel for num_threads(opt.num_threads)
+            for (int q = 0; q < channels; q++)
+            {
+                const Mat m = bottom_blob.channel(q);
+                Mat borderm = top_blob.channel(q);
+
+                padding_constant_pack8_int8_sse(m, borderm, top, bottom, left, right, v);
+            }
+
+            return 0;
+        }
+
+        Option opt_pack = opt;
+        opt_pack.blob_allocator = opt.workspace_allocator;
+        convert_packing(bottom_blob, bottom_blob_unpacked, 1, opt_pack);
+
+        return Padding::forward(bottom_blob_unpacked, top_blob, opt);
+    }
+
     int out_elempack = elempack;
     int outc = channels;
     //Check if channel padding is being applied.
@@ -0,0 +1,170 @@
+// Tencent is pleased to support the open source community by making ncnn available.
+//
+// Copyright (C) 2020 THL A29 Limited, a Tencent company. All rights reserved.
+//
+// Licensed under the BSD 3-Clause License (the "License"); you may not use this file except
+// in compliance with the License. You may obtain a copy of the License at
+//
+// https://opensource.org/licenses/BSD-3-Clause
+//
+// Unless required by applicable law or agreed to in writing, software distributed
+// under the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR
+// CONDITIONS OF ANY KIND, either express or implied. See the License for the
+// specific language governing permissions and limitations under the License.
+
+
+#include "permute_x86.h"
+
+#if __AVX__
+#include <immintrin.h>
+#endif // __AVX__
+
+namespace ncnn {
+
+DEFINE_LAYER_CREATOR(Permute_x86)
+
+Permute_x86::Permute_x86()
+{
+#if __AVX__
+    support_packing = true;
+#endif // __AVX__
+}
+
+int Permute_x86::forward(const Mat& bottom_blob, Mat& top_blob, const Option& opt) const
+{
+#if __AVX__
+    int elempack = bottom_blob.elempack;
+
+    if (elempack == 8)
+    {
+        int dims = bottom_blob.dims;
+        int w = bottom_blob.w;
+        int h = bottom_blob.h;
+        int channels = bottom_blob.c;
+        size_t elemsize = bottom_blob.elemsize;
+
+        if (dims == 1 || order_type == 0)
+        {
+            top_blob = bottom_blob;
+            return 0;
+        }
+
+        if (dims == 2)
+        {
+            // order_type 1 = h w, the packed h becomes w
+            int outw = h * elempack;
+            int outh = w;
+            int out_elempack = opt.use_packing_layout && outh % 8 == 0 ? 8 : 1;
+            size_t out_elemsize = elemsize / elempack * out_elempack;
+
+            top_blob.create(outw, outh / out_elempack, out_elemsize, out_elempack, opt.blob_allocator);
+            if (top_blob.empty())
+                return -100;
+
+            #pragma omp parallel for num_threads(opt.num_threads)
+            for (int i = 0; i < top_blob.h; i++)
+            {
+                float* outptr = top_blob.row(i);
+
+                for (int j = 0; j < outw; j++)
+                {
+                    const float* ptr = (const float*)bottom_blob.row(j / 8) + j % 8;
+
+                    for (int k = 0; k < out_elempack; k++)
+                    {
+                        outptr[k] = ptr[(i * out_elempack + k) * 8];
+                    }
+
+                    outptr += out_elempack;
+                }
+            }
+
+            return 0;
+        }
+
+        if (order_type == 1)
+        {
+            // channels stay packed, transpose the pack8 pixels
+            top_blob.create(h, w, channels, elemsize, elempack, opt.blob_allocator);
+            if (top_blob.empty())
+                return -100;
+
+            #pragma omp parallel for num_threads(opt.num_threads)
+            for (int q = 0; q < channels; q++)
+            {
+                const float* ptr = bottom_blob.channel(q);
+                float* outptr = top_blob.channel(q);
+
+                for (int i = 0; i < w; i++)
+                {
+                    for (int j = 0; j < h; j++)
+                    {
+                        _mm256_storeu_ps(outptr, _mm256_loadu_ps(ptr + (j * w + i) * 8));
+                        outptr += 8;
+                    }
+                }
+            }
+
+            return 0;
+        }
+
+        // the channel axis moves, gather each output element from its input pack and lane
+        int channels_unpacked = channels * elempack;
+
+        // output axis feeding input w, h and c for order_type 2 to 5, 0 = w 1 = h 2 = c
+        static const int order_axes[6][3] = {
+            {0, 1, 2},
+            {1, 0, 2},
+            {0, 2, 1},
+            {1, 2, 0},
+            {2, 0, 1},
+            {2, 1, 0}
+        };
+
+        int outw = order_type == 2 ? w : order_type == 3 || order_type == 5 ? channels_unpacked : h;
+        int outh = order_type == 2 || order_type == 4 ? channels_unpacked : order_type == 3 ? w : h;
+        int outc = order_type == 2 || order_type == 3 ? h : w;
+
+        int out_elempack = opt.use_packing_layout && outc % 8 == 0 ? 8 : 1;
+        size_t out_elemsize = elemsize / elempack * out_elempack;
+
+        top_blob.create(outw, outh, outc / out_elempack, out_elemsize, out_elempack, opt.blob_allocator);
+        if (top_blob.empty())
+            return -100;
+
+        const int* axes = order_axes[order_type];
+        const float* bottom = bottom_blob;
+        const size_t cstep = bottom_blob.cstep * elempack;
+
+        #pragma omp parallel for num_threads(opt.num_threads)
+        for (int q = 0; q < top_blob.c; q++)
+        {
+            float* outptr = top_blob.channel(q);
+
+            for (int i = 0; i < outh; i++)
+            {
+                for (int j = 0; j < outw; j++)
+                {
+                    for (int k = 0; k < out_elempack; k++)
+                    {
+                        const int coords[3] = {j, i, q * out_elempack + k};
+                        const int x = coords[axes[0]];
+                        const int y = coords[axes[1]];
+                        const int c = coords[axes[2]];
+
+                        outptr[k] = bottom[(c / 8) * cstep + (y * w + x) * 8 + c % 8];
+                    }
+
+                    outptr += out_elempack;
+                }
+            }
+        }
+
+        return 0;
+    }
+#endif // __AVX__
+
+    return Permute::forward(bottom_blob, top_blob, opt);
+}
+
+} // namespace ncnn
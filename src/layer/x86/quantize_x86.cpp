@@ -0,0 +1,120 @@
+// Tencent is pleased to support the open source community by making ncnn available.
+//
+// Copyright (C) 2020 THL A29 Limited, a Tencent company. All rights reserved.
+//
+// Licensed under the BSD 3-Clause License (the "License"); you may not use this file except
+// in compliance with the License. You may obtain a copy of the License at
+//
+// https://opensource.org/licenses/BSD-3-Clause
+//
+// Unless required by applicable law or agreed to in writing, software distributed
+// under the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR
+// CONDITIONS OF ANY KIND, either express or implied. See the License for the
+// specific language governing permissions and limitations under the License.
+
+
+#include "quantize_x86.h"
+
+#if __AVX__
+#include "avx_usability.h"
+
+#include <immintrin.h>
+#endif // __AVX__
+
+namespace ncnn {
+
+DEFINE_LAYER_CREATOR(Quantize_x86)
+
+Quantize_x86::Quantize_x86()
+{
+#if __AVX__
+    support_packing = true;
+#endif // __AVX__
+}
+
+int Quantize_x86::forward(const Mat& bottom_blob, Mat& top_blob, const Option& opt) const
+{
+#if __AVX__
+    int elempack = bottom_blob.elempack;
+
+    if (elempack == 8)
+    {
+        // fp32 pack8 to int8 pack8
+        int dims = bottom_blob.dims;
+        int w = bottom_blob.w;
+        int h = bottom_blob.h;
+        int channels = bottom_blob.c;
+
+        const __m256 _scale = _mm256_set1_ps(scale);
+
+        if (dims == 1)
+        {
+            top_blob.create(w, (size_t)8u, 8, opt.blob_allocator);
+            if (top_blob.empty())
+                return -100;
+
+            const float* ptr = bottom_blob;
+            signed char* outptr = top_blob;
+
+            #pragma omp parallel for num_threads(opt.num_threads)
+            for (int i = 0; i < w; i++)
+            {
+                __m256 _v = _mm256_mul_ps(_mm256_loadu_ps(ptr + i * 8), _scale);
+                _mm_storel_epi64((__m128i*)(outptr + i * 8), float2int8_avx(_v));
+            }
+        }
+
+        if (dims == 2)
+        {
+            top_blob.create(w, h, (size_t)8u, 8, opt.blob_allocator);
+            if (top_blob.empty())
+                return -100;
+
+            #pragma omp parallel for num_threads(opt.num_threads)
+            for (int i = 0; i < h; i++)
+            {
+                const float* ptr = bottom_blob.row(i);
+                signed char* outptr = top_blob.row<signed char>(i);
+
+                for (int j = 0; j < w; j++)
+                {
+                    __m256 _v = _mm256_mul_ps(_mm256_loadu_ps(ptr), _scale);
+                    _mm_storel_epi64((__m128i*)outptr, float2int8_avx(_v));
+                    ptr += 8;
+                    outptr += 8;
+                }
+            }
+        }
+
+        if (dims == 3)
+        {
+            int size = w * h;
+
+            top_blob.create(w, h, channels, (size_t)8u, 8, opt.blob_allocator);
+            if (top_blob.empty())
+                return -100;
+
+            #pragma omp parallel for num_threads(opt.num_threads)
+            for (int q = 0; q < channels; q++)
+            {
+                const float* ptr = bottom_blob.channel(q);
+                signed char* outptr = top_blob.channel(q);
+
+                for (int i = 0; i < size; i++)
+                {
+                    __m256 _v = _mm256_mul_ps(_mm256_loadu_ps(ptr), _scale);
+                    _mm_storel_epi64((__m128i*)outptr, float2int8_avx(_v));
+                    ptr += 8;
+                    outptr += 8;
+                }
+            }
+        }
+
+        return 0;
+    }
+#endif // __AVX__
+
+    return Quantize::forward(bottom_blob, top_blob, opt);
+}
+
+} // namespace ncnn
@@ -13,6 +13,8 @@
 // specific language governing permissions and limitations under the License.
 #include <algorithm>
 
+#include <emmintrin.h>
+
 #if __AVX__
 #include "avx_activation.h"
 #endif // __AVX__
@@ -32,6 +34,9 @@ ReLU_x86::ReLU_x86()
 
 int ReLU_x86::forward_inplace(Mat& bottom_top_blob, const Option& opt) const
 {
+    if (bottom_top_blob.elemsize / bottom_top_blob.elempack == 1u)
+        return forward_inplace_int8_x86(bottom_top_blob, opt);
+
     int w = bottom_top_blob.w;
     int h = bottom_top_blob.h;
     int channels = bottom_top_blob.c;
@@ -111,4 +116,45 @@ int ReLU_x86::forward_inplace(Mat& bottom_top_blob, const Option& opt) const
 
     return 0;
 }
-} //namespace ncnn
\ No newline at end of file
+int ReLU_x86::forward_inplace_int8_x86(Mat& bottom_top_blob, const Option& opt) const
+{
+    int w = bottom_top_blob.w;
+    int h = bottom_top_blob.h;
+    int channels = bottom_top_blob.c;
+    int size = w * h * bottom_top_blob.elempack;
+
+    if (slope == 0.f)
+    {
+        #pragma omp parallel for num_threads(opt.num_threads)
+        for (int q = 0; q < channels; q++)
+        {
+            signed char* ptr = bottom_top_blob.channel(q);
+
+            int nn = size >> 4;
+            int remain = size - (nn << 4);
+
+            __m128i _zero = _mm_setzero_si128();
+            for (; nn > 0; nn--)
+            {
+                __m128i _p = _mm_loadu_si128((const __m128i*)ptr);
+                _p = _mm_and_si128(_p, _mm_cmpgt_epi8(_p, _zero));
+                _mm_storeu_si128((__m128i*)ptr, _p);
+
+                ptr += 16;
+            }
+            for (; remain > 0; remain--)
+            {
+                if (*ptr < 0)
+                    *ptr = 0;
+
+                ptr++;
+            }
+        }
+
+        return 0;
+    }
+
+    return ReLU::forward_inplace_int8(bottom_top_blob, opt);
+}
+
+} //namespace ncnn
@@ -0,0 +1,148 @@
+// Tencent is pleased to support the open source community by making ncnn available.
+//
+// Copyright (C) 2020 THL A29 Limited, a Tencent company. All rights reserved.
+//
+// Licensed under the BSD 3-Clause License (the "License"); you may not use this file except
+// in compliance with the License. You may obtain a copy of the License at
+//
+// https://opensource.org/licenses/BSD-3-Clause
+//
+// Unless required by applicable law or agreed to in writing, software distributed
+// under the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR
+// CONDITIONS OF ANY KIND, either express or implied. See the License for the
+// specific language governing permissions and limitations under the License.
+
+
+#include "requantize_x86.h"
+
+#if __AVX__
+#include "avx_usability.h"
+
+#include <immintrin.h>
+#endif // __AVX__
+
+namespace ncnn {
+
+DEFINE_LAYER_CREATOR(Requantize_x86)
+
+Requantize_x86::Requantize_x86()
+{
+#if __AVX__
+    support_packing = true;
+#endif // __AVX__
+}
+
+#if __AVX__
+static inline __m128i requantize_pack8(const int* intptr, __m256 _scale_in, __m256 _bias, __m256 _scale_out, bool fusion_relu)
+{
+    __m256 _v = _mm256_cvtepi32_ps(_mm256_loadu_si256((const __m256i*)intptr));
+    _v = _mm256_mul_ps(_mm256_add_ps(_mm256_mul_ps(_v, _scale_in), _bias), _scale_out);
+    if (fusion_relu)
+        _v = _mm256_max_ps(_v, _mm256_setzero_ps());
+
+    return float2int8_avx(_v);
+}
+#endif // __AVX__
+
+int Requantize_x86::forward(const Mat& bottom_blob, Mat& top_blob, const Option& opt) const
+{
+#if __AVX__
+    int elempack = bottom_blob.elempack;
+
+    if (elempack == 8)
+    {
+        // int32 pack8 to int8 pack8
+        int dims = bottom_blob.dims;
+        int w = bottom_blob.w;
+        int h = bottom_blob.h;
+        int channels = bottom_blob.c;
+
+        const __m256 _scale_in = _mm256_set1_ps(scale_in);
+        const __m256 _scale_out = _mm256_set1_ps(scale_out);
+
+        if (dims == 1)
+        {
+            top_blob.create(w, (size_t)8u, 8, opt.blob_allocator);
+            if (top_blob.empty())
+                return -100;
+
+            const int* intptr = bottom_blob;
+            signed char* ptr = top_blob;
+
+            #pragma omp parallel for num_threads(opt.num_threads)
+            for (int i = 0; i < w; i++)
+            {
+                __m256 _bias = _mm256_setzero_ps();
+                if (bias_term)
+                {
+                    _bias = bias_data_size > 1 ? _mm256_loadu_ps((const float*)bias_data + i * 8) : _mm256_set1_ps(bias_data[0]);
+                }
+
+                _mm_storel_epi64((__m128i*)(ptr + i * 8), requantize_pack8(intptr + i * 8, _scale_in, _bias, _scale_out, fusion_relu));
+            }
+        }
+
+        if (dims == 2)
+        {
+            top_blob.create(w, h, (size_t)8u, 8, opt.blob_allocator);
+            if (top_blob.empty())
+                return -100;
+
+            #pragma omp parallel for num_threads(opt.num_threads)
+            for (int i = 0; i < h; i++)
+            {
+                const int* intptr = bottom_blob.row<const int>(i);
+                signed char* ptr = top_blob.row<signed char>(i);
+
+                __m256 _bias = _mm256_setzero_ps();
+                if (bias_term)
+                {
+                    _bias = bias_data_size > 1 ? _mm256_loadu_ps((const float*)bias_data + i * 8) : _mm256_set1_ps(bias_data[0]);
+                }
+
+                for (int j = 0; j < w; j++)
+                {
+                    _mm_storel_epi64((__m128i*)ptr, requantize_pack8(intptr, _scale_in, _bias, _scale_out, fusion_relu));
+                    intptr += 8;
+                    ptr += 8;
+                }
+            }
+        }
+
+        if (dims == 3)
+        {
+            int size = w * h;
+
+            top_blob.create(w, h, channels, (size_t)8u, 8, opt.blob_allocator);
+            if (top_blob.empty())
+                return -100;
+
+            #pragma omp parallel for num_threads(opt.num_threads)
+            for (int q = 0; q < channels; q++)
+            {
+                const int* intptr = bottom_blob.channel(q);
+                signed char* ptr = top_blob.channel(q);
+
+                __m256 _bias = _mm256_setzero_ps();
+                if (bias_term)
+                {
+                    _bias = bias_data_size > 1 ? _mm256_loadu_ps((const float*)bias_data + q * 8) : _mm256_set1_ps(bias_data[0]);
+                }
+
+                for (int i = 0; i < size; i++)
+                {
+                    _mm_storel_epi64((__m128i*)ptr, requantize_pack8(intptr, _scale_in, _bias, _scale_out, fusion_relu));
+                    intptr += 8;
+                    ptr += 8;
+                }
+            }
+        }
+
+        return 0;
+    }
+#endif // __AVX__
+
+    return Requantize::forward(bottom_blob, top_blob, opt);
+}
+
+} // namespace ncnn
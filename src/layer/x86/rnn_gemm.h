@@ -0,0 +1,155 @@
+// Tencent is pleased to support the open source community by making ncnn available.
+//
+// Copyright (C) 2020 THL A29 Limited, a Tencent company. All rights reserved.
+//
+// Licensed under the BSD 3-Clause License (the "License"); you may not use this file except
+// in compliance with the License. You may obtain a copy of the License at
+//
+// https://opensource.org/licenses/BSD-3-Clause
+//
+// Unless required by applicable law or agreed to in writing, software distributed
+// under the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR
+// CONDITIONS OF ANY KIND, either express or implied. See the License for the
+// specific language governing permissions and limitations under the License.
+
+// shared by lstm gru and rnn, weight rows are fp32 or fp16
+
+static inline __m256 rnn_loadw(const float* ptr)
+{
+    return _mm256_loadu_ps(ptr);
+}
+
+static inline __m256 rnn_loadw(const unsigned short* ptr)
+{
+    return loadfp16(ptr);
+}
+
+static inline float rnn_w2f(float v)
+{
+    return v;
+}
+
+static inline float rnn_w2f(unsigned short v)
+{
+    return float16_to_float32(v);
+}
+
+// weight row times x
+template<typename WT>
+static float rnn_dot(const WT* w, const float* x, int size)
+{
+    __m256 _sum = _mm256_setzero_ps();
+
+    int i = 0;
+    for (; i + 7 < size; i += 8)
+    {
+        _sum = _mm256_fmadd_ps(rnn_loadw(w + i), _mm256_loadu_ps(x + i), _sum);
+    }
+
+    float sum = _mm256_reduce_add_ps(_sum);
+    for (; i < size; i++)
+    {
+        sum += rnn_w2f(w[i]) * x[i];
+    }
+
+    return sum;
+}
+
+// weight rows r to r+7 times x, one lane per row
+template<typename WT>
+static __m256 rnn_dot8(const Mat& weight, int r, const float* x, int size)
+{
+    const WT* w0 = weight.row<const WT>(r);
+    const WT* w1 = weight.row<const WT>(r + 1);
+    const WT* w2 = weight.row<const WT>(r + 2);
+    const WT* w3 = weight.row<const WT>(r + 3);
+    const WT* w4 = weight.row<const WT>(r + 4);
+    const WT* w5 = weight.row<const WT>(r + 5);
+    const WT* w6 = weight.row<const WT>(r + 6);
+    const WT* w7 = weight.row<const WT>(r + 7);
+
+    __m256 _sum0 = _mm256_setzero_ps();
+    __m256 _sum1 = _mm256_setzero_ps();
+    __m256 _sum2 = _mm256_setzero_ps();
+    __m256 _sum3 = _mm256_setzero_ps();
+    __m256 _sum4 = _mm256_setzero_ps();
+    __m256 _sum5 = _mm256_setzero_ps();
+    __m256 _sum6 = _mm256_setzero_ps();
+    __m256 _sum7 = _mm256_setzero_ps();
+
+    int i = 0;
+    for (; i + 7 < size; i += 8)
+    {
+        __m256 _x = _mm256_loadu_ps(x + i);
+        _sum0 = _mm256_fmadd_ps(rnn_loadw(w0 + i), _x, _sum0);
+        _sum1 = _mm256_fmadd_ps(rnn_loadw(w1 + i), _x, _sum1);
+        _sum2 = _mm256_fmadd_ps(rnn_loadw(w2 + i), _x, _sum2);
+        _sum3 = _mm256_fmadd_ps(rnn_loadw(w3 + i), _x, _sum3);
+        _sum4 = _mm256_fmadd_ps(rnn_loadw(w4 + i), _x, _sum4);
+        _sum5 = _mm256_fmadd_ps(rnn_loadw(w5 + i), _x, _sum5);
+        _sum6 = _mm256_fmadd_ps(rnn_loadw(w6 + i), _x, _sum6);
+        _sum7 = _mm256_fmadd_ps(rnn_loadw(w7 + i), _x, _sum7);
+    }
+
+    __m256 _sum = HorizontalSums(_sum0, _sum1, _sum2, _sum3, _sum4, _sum5, _sum6, _sum7);
+
+    if (i < size)
+    {
+        float sums[8] = {0.f};
+        for (; i < size; i++)
+        {
+            float xi = x[i];
+            sums[0] += rnn_w2f(w0[i]) * xi;
+            sums[1] += rnn_w2f(w1[i]) * xi;
+            sums[2] += rnn_w2f(w2[i]) * xi;
+            sums[3] += rnn_w2f(w3[i]) * xi;
+            sums[4] += rnn_w2f(w4[i]) * xi;
+            sums[5] += rnn_w2f(w5[i]) * xi;
+            sums[6] += rnn_w2f(w6[i]) * xi;
+            sums[7] += rnn_w2f(w7[i]) * xi;
+        }
+
+        _sum = _mm256_add_ps(_sum, _mm256_loadu_ps(sums));
+    }
+
+    return _sum;
+}
+
+// gates := W_xc * x_t + b_c for all timesteps in one pass over the weight
+// 8 weight rows stay in cache while the whole sequence streams through
+template<typename WT>
+static void rnn_input_gemm(const Mat& bottom_blob, Mat& gates, const Mat& weight_xc, const float* bias_c, const Option& opt)
+{
+    int size = bottom_blob.w;
+    int T = bottom_blob.h;
+
+    int rows = gates.w;
+
+    int nn_rows = rows >> 3;
+    int remain_rows_start = nn_rows << 3;
+
+    #pragma omp parallel for num_threads(opt.num_threads)
+    for (int pp = 0; pp < nn_rows; pp++)
+    {
+        int r = pp * 8;
+
+        __m256 _bias = _mm256_loadu_ps(bias_c + r);
+
+        for (int t = 0; t < T; t++)
+        {
+            __m256 _sum = rnn_dot8<WT>(weight_xc, r, bottom_blob.row(t), size);
+            _mm256_storeu_ps(gates.row(t) + r, _mm256_add_ps(_sum, _bias));
+        }
+    }
+
+    #pragma omp parallel for num_threads(opt.num_threads)
+    for (int r = remain_rows_start; r < rows; r++)
+    {
+        const WT* w = weight_xc.row<const WT>(r);
+
+        for (int t = 0; t < T; t++)
+        {
+            gates.row(t)[r] = bias_c[r] + rnn_dot(w, bottom_blob.row(t), size);
+        }
+    }
+}
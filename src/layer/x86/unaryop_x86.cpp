@@ -0,0 +1,293 @@
+// Tencent is pleased to support the open source community by making ncnn available.
+//
+// Copyright (C) 2020 THL A29 Limited, a Tencent company. All rights reserved.
+//
+// Licensed under the BSD 3-Clause License (the "License"); you may not use this file except
+// in compliance with the License. You may obtain a copy of the License at
+//
+// https://opensource.org/licenses/BSD-3-Clause
+//
+// Unless required by applicable law or agreed to in writing, software distributed
+// under the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR
+// CONDITIONS OF ANY KIND, either express or implied. See the License for the
+// specific language governing permissions and limitations under the License.
+
+#include "unaryop_x86.h"
+
+#include <math.h>
+
+#if __AVX__
+#include "avx_activation.h"
+#include "avx_mathfun.h"
+
+#include <immintrin.h>
+#endif // __AVX__
+
+namespace ncnn {
+
+DEFINE_LAYER_CREATOR(UnaryOp_x86)
+
+UnaryOp_x86::UnaryOp_x86()
+{
+#if __AVX__
+    support_packing = true;
+#endif // __AVX__
+}
+
+#if __AVX__
+template<typename Op>
+static int unary_op_inplace_pack8(Mat& a, const Option& opt)
+{
+    Op op;
+
+    int w = a.w;
+    int h = a.h;
+    int channels = a.c;
+    int size = w * h;
+
+    #pragma omp parallel for num_threads(opt.num_threads)
+    for (int q = 0; q < channels; q++)
+    {
+        float* ptr = a.channel(q);
+
+        for (int i = 0; i < size; i++)
+        {
+            __m256 _p = _mm256_loadu_ps(ptr);
+            _p = op(_p);
+            _mm256_storeu_ps(ptr, _p);
+            ptr += 8;
+        }
+    }
+
+    return 0;
+}
+
+struct unary_op_abs_pack8
+{
+    __m256 operator()(const __m256& x) const
+    {
+        return abs_avx(x);
+    }
+};
+
+struct unary_op_neg_pack8
+{
+    __m256 operator()(const __m256& x) const
+    {
+        return _mm256_sub_ps(_mm256_setzero_ps(), x);
+    }
+};
+
+struct unary_op_floor_pack8
+{
+    __m256 operator()(const __m256& x) const
+    {
+        return _mm256_floor_ps(x);
+    }
+};
+
+struct unary_op_ceil_pack8
+{
+    __m256 operator()(const __m256& x) const
+    {
+        return _mm256_ceil_ps(x);
+    }
+};
+
+struct unary_op_square_pack8
+{
+    __m256 operator()(const __m256& x) const
+    {
+        return _mm256_mul_ps(x, x);
+    }
+};
+
+struct unary_op_sqrt_pack8
+{
+    __m256 operator()(const __m256& x) const
+    {
+        return _mm256_sqrt_ps(x);
+    }
+};
+
+struct unary_op_rsqrt_pack8
+{
+    __m256 operator()(const __m256& x) const
+    {
+        return _mm256_div_ps(_mm256_set1_ps(1.f), _mm256_sqrt_ps(x));
+    }
+};
+
+struct unary_op_exp_pack8
+{
+    __m256 operator()(const __m256& x) const
+    {
+        return exp256_ps(x);
+    }
+};
+
+struct unary_op_log_pack8
+{
+    __m256 operator()(const __m256& x) const
+    {
+        return log256_ps(x);
+    }
+};
+
+struct unary_op_sin_pack8
+{
+    __m256 operator()(const __m256& x) const
+    {
+        return sin256_ps(x);
+    }
+};
+
+struct unary_op_cos_pack8
+{
+    __m256 operator()(const __m256& x) const
+    {
+        return cos256_ps(x);
+    }
+};
+
+struct unary_op_tan_pack8
+{
+    __m256 operator()(const __m256& x) const
+    {
+        // TODO avx optimize
+        float tmp[8];
+        _mm256_storeu_ps(tmp, x);
+        for (int i = 0; i < 8; i++)
+        {
+            tmp[i] = tan(tmp[i]);
+        }
+        return _mm256_loadu_ps(tmp);
+    }
+};
+
+struct unary_op_asin_pack8
+{
+    __m256 operator()(const __m256& x) const
+    {
+        // TODO avx optimize
+        float tmp[8];
+        _mm256_storeu_ps(tmp, x);
+        for (int i = 0; i < 8; i++)
+        {
+            tmp[i] = asin(tmp[i]);
+        }
+        return _mm256_loadu_ps(tmp);
+    }
+};
+
+struct unary_op_acos_pack8
+{
+    __m256 operator()(const __m256& x) const
+    {
+        // TODO avx optimize
+        float tmp[8];
+        _mm256_storeu_ps(tmp, x);
+        for (int i = 0; i < 8; i++)
+        {
+            tmp[i] = acos(tmp[i]);
+        }
+        return _mm256_loadu_ps(tmp);
+    }
+};
+
+struct unary_op_atan_pack8
+{
+    __m256 operator()(const __m256& x) const
+    {
+        // TODO avx optimize
+        float tmp[8];
+        _mm256_storeu_ps(tmp, x);
+        for (int i = 0; i < 8; i++)
+        {
+            tmp[i] = atan(tmp[i]);
+        }
+        return _mm256_loadu_ps(tmp);
+    }
+};
+
+struct unary_op_reciprocal_pack8
+{
+    __m256 operator()(const __m256& x) const
+    {
+        return _mm256_div_ps(_mm256_set1_ps(1.f), x);
+    }
+};
+
+struct unary_op_tanh_pack8
+{
+    __m256 operator()(const __m256& x) const
+    {
+        return tanh_avx(x);
+    }
+};
+#endif // __AVX__
+
+int UnaryOp_x86::forward_inplace(Mat& bottom_top_blob, const Option& opt) const
+{
+#if __AVX__
+    int elempack = bottom_top_blob.elempack;
+
+    if (elempack == 8)
+    {
+        if (op_type == Operation_ABS)
+            return unary_op_inplace_pack8<unary_op_abs_pack8>(bottom_top_blob, opt);
+
+        if (op_type == Operation_NEG)
+            return unary_op_inplace_pack8<unary_op_neg_pack8>(bottom_top_blob, opt);
+
+        if (op_type == Operation_FLOOR)
+            return unary_op_inplace_pack8<unary_op_floor_pack8>(bottom_top_blob, opt);
+
+        if (op_type == Operation_CEIL)
+            return unary_op_inplace_pack8<unary_op_ceil_pack8>(bottom_top_blob, opt);
+
+        if (op_type == Operation_SQUARE)
+            return unary_op_inplace_pack8<unary_op_square_pack8>(bottom_top_blob, opt);
+
+        if (op_type == Operation_SQRT)
+            return unary_op_inplace_pack8<unary_op_sqrt_pack8>(bottom_top_blob, opt);
+
+        if (op_type == Operation_RSQRT)
+            return unary_op_inplace_pack8<unary_op_rsqrt_pack8>(bottom_top_blob, opt);
+
+        if (op_type == Operation_EXP)
+            return unary_op_inplace_pack8<unary_op_exp_pack8>(bottom_top_blob, opt);
+
+        if (op_type == Operation_LOG)
+            return unary_op_inplace_pack8<unary_op_log_pack8>(bottom_top_blob, opt);
+
+        if (op_type == Operation_SIN)
+            return unary_op_inplace_pack8<unary_op_sin_pack8>(bottom_top_blob, opt);
+
+        if (op_type == Operation_COS)
+            return unary_op_inplace_pack8<unary_op_cos_pack8>(bottom_top_blob, opt);
+
+        if (op_type == Operation_TAN)
+            return unary_op_inplace_pack8<unary_op_tan_pack8>(bottom_top_blob, opt);
+
+        if (op_type == Operation_ASIN)
+            return unary_op_inplace_pack8<unary_op_asin_pack8>(bottom_top_blob, opt);
+
+        if (op_type == Operation_ACOS)
+            return unary_op_inplace_pack8<unary_op_acos_pack8>(bottom_top_blob, opt);
+
+        if (op_type == Operation_ATAN)
+            return unary_op_inplace_pack8<unary_op_atan_pack8>(bottom_top_blob, opt);
+
+        if (op_type == Operation_RECIPROCAL)
+            return unary_op_inplace_pack8<unary_op_reciprocal_pack8>(bottom_top_blob, opt);
+
+        if (op_type == Operation_TANH)
+            return unary_op_inplace_pack8<unary_op_tanh_pack8>(bottom_top_blob, opt);
+    }
+#endif // __AVX__
+
+    return UnaryOp::forward_inplace(bottom_top_blob, opt);
+}
+
+} // namespace ncnn
@@ -395,117 +395,174 @@ void resize_bicubic(const Mat& src, Mat& dst, int w, int h, const Option& opt)
     delete interp;
 }
 
-void convert_packing(const Mat& src, Mat& dst, int _elempack, const Option& opt)
+// packing and cast layers keep no state after create_pipeline
+// build them once and share them among all threads instead of per call
+class ConversionLayers
 {
-    Layer* packing = create_layer(LayerType::Packing);
+public:
+    ConversionLayers()
+    {
+        Option opt;
 
-    ParamDict pd;
-    pd.set(0, _elempack);
+        for (int i = 0; i < 5; i++)
+        {
+            ParamDict pd;
+            pd.set(0, 1 << i);
 
-    packing->load_param(pd);
+            packing[i] = create_layer(LayerType::Packing);
+            if (!packing[i])
+                continue;
 
-    packing->create_pipeline(opt);
+            packing[i]->load_param(pd);
+            packing[i]->create_pipeline(opt);
+        }
 
-    packing->forward(src, dst, opt);
+        for (int i = 0; i < 5; i++)
+        {
+            for (int j = 0; j < 5; j++)
+            {
+                cast[i][j] = 0;
+            }
+        }
 
-    packing->destroy_pipeline(opt);
+        // fp32 <-> fp16, int8 -> fp32, fp32 <-> bf16
+        static const int cast_pairs[5][2] = {{1, 2}, {2, 1}, {3, 1}, {1, 4}, {4, 1}};
+        for (int i = 0; i < 5; i++)
+        {
+            int type_from = cast_pairs[i][0];
+            int type_to = cast_pairs[i][1];
 
-    delete packing;
-}
+            ParamDict pd;
+            pd.set(0, type_from);
+            pd.set(1, type_to);
 
-void cast_float32_to_float16(const Mat& src, Mat& dst, const Option& opt)
-{
-    Layer* cast = create_layer(LayerType::Cast);
+            Layer* op = create_layer(LayerType::Cast);
+            if (!op)
+                continue;
 
-    ParamDict pd;
-    pd.set(0, 1);
-    pd.set(1, 2);
+            op->load_param(pd);
+            op->create_pipeline(opt);
 
-    cast->load_param(pd);
+            cast[type_from][type_to] = op;
+        }
+    }
 
-    cast->create_pipeline(opt);
+    ~ConversionLayers()
+    {
+        Option opt;
 
-    cast->forward(src, dst, opt);
+        for (int i = 0; i < 5; i++)
+        {
+            if (!packing[i])
+                continue;
 
-    cast->destroy_pipeline(opt);
+            packing[i]->destroy_pipeline(opt);
+            delete packing[i];
+        }
 
-    delete cast;
-}
+        for (int i = 0; i < 5; i++)
+        {
+            for (int j = 0; j < 5; j++)
+            {
+                if (!cast[i][j])
+                    continue;
 
-void cast_float16_to_float32(const Mat& src, Mat& dst, const Option& opt)
-{
-    Layer* cast = create_layer(LayerType::Cast);
+                cast[i][j]->destroy_pipeline(opt);
+                delete cast[i][j];
+            }
+        }
+    }
 
-    ParamDict pd;
-    pd.set(0, 2);
-    pd.set(1, 1);
+public:
+    // out_elempack 1 2 4 8 16
+    Layer* packing[5];
+    // type_from type_to
+    Layer* cast[5][5];
+};
 
-    cast->load_param(pd);
+// built on first use rather than during static initialization
+// creating the layers reads the cpu features and count, which may not be detected yet then
+static const ConversionLayers& conversion_layers()
+{
+    static ConversionLayers g_conversion_layers;
+    return g_conversion_layers;
+}
 
-    cast->create_pipeline(opt);
+static void cast_with(int type_from, int type_to, const Mat& src, Mat& dst, const Option& opt)
+{
+    const Layer* cast = conversion_layers().cast[type_from][type_to];
+    if (!cast)
+    {
+        NCNN_LOGE("cast layer not available");
+        return;
+    }
 
     cast->forward(src, dst, opt);
-
-    cast->destroy_pipeline(opt);
-
-    delete cast;
 }
 
-void cast_int8_to_float32(const Mat& src, Mat& dst, const Option& opt)
+void convert_packing(const Mat& src, Mat& dst, int _elempack, const Option& opt)
 {
-    Layer* cast = create_layer(LayerType::Cast);
-
-    ParamDict pd;
-    pd.set(0, 3);
-    pd.set(1, 1);
-
-    cast->load_param(pd);
-
-    cast->create_pipeline(opt);
+    if (src.elempack == _elempack)
+    {
+        dst = src;
+        return;
+    }
 
-    cast->forward(src, dst, opt);
+    int index = -1;
+    for (int i = 0; i < 5; i++)
+    {
+        if (_elempack == 1 << i)
+            index = i;
+    }
 
-    cast->destroy_pipeline(opt);
+    const ConversionLayers& layers = conversion_layers();
+    if (index != -1 && layers.packing[index])
+    {
+        const Layer* packing = layers.packing[index];
 
-    delete cast;
-}
+        packing->forward(src, dst, opt);
+        return;
+    }
 
-void cast_float32_to_bfloat16(const Mat& src, Mat& dst, const Option& opt)
-{
-    Layer* cast = create_layer(LayerType::Cast);
+    Layer* packing = create_layer(LayerType::Packing);
 
     ParamDict pd;
-    pd.set(0, 1);
-    pd.set(1, 4);
+    pd.set(0, _elempack);
 
-    cast->load_param(pd);
+    packing->load_param(pd);
 
-    cast->create_pipeline(opt);
+    packing->create_pipeline(opt);
 
-    cast->forward(src, dst, opt);
+    packing->forward(src, dst, opt);
 
-    cast->destroy_pipeline(opt);
+    packing->destroy_pipeline(opt);
 
-    delete cast;
+    delete packing;
 }
 
-void cast_bfloat16_to_float32(const Mat& src, Mat& dst, const Option& opt)
+void cast_float32_to_float16(const Mat& src, Mat& dst, const Option& opt)
 {
-    Layer* cast = create_layer(LayerType::Cast);
-
-    ParamDict pd;
-    pd.set(0, 4);
-    pd.set(1, 1);
-
-    cast->load_param(pd);
+    cast_with(1, 2, src, dst, opt);
+}
 
-    cast->create_pipeline(opt);
+void cast_float16_to_float32(const Mat& src, Mat& dst, const Option& opt)
+{
+    cast_with(2, 1, src, dst, opt);
+}
 
-    cast->forward(src, dst, opt);
+void cast_int8_to_float32(const Mat& src, Mat& dst, const Option& opt)
+{
+    cast_with(3, 1, src, dst, opt);
+}
 
-    cast->destroy_pipeline(opt);
+void cast_float32_to_bfloat16(const Mat& src, Mat& dst, const Option& opt)
+{
+    cast_with(1, 4, src, dst, opt);
+}
 
-    delete cast;
+void cast_bfloat16_to_float32(const Mat& src, Mat& dst, const Option& opt)
+{
+    cast_with(4, 1, src, dst, opt);
 }
 
 void quantize_float32_to_int8(const Mat& src, Mat& dst, float scale, const Option& opt)
@@ -42,6 +42,41 @@ Mat ModelBin::load(int w, int h, int c, int type) const
     return m.reshape(w, h, c);
 }
 
+// reference the data in place when the reader supports it, read a copy otherwise
+static Mat read_data(const DataReader& dr, int w, size_t elemsize, size_t size)
+{
+    const void* refbuf = 0;
+    size_t nread = dr.reference(size, &refbuf);
+    if (nread == size)
+    {
+        Mat m(w, (void*)refbuf, elemsize);
+
+        // misaligned data would break element access, copy it out
+        if ((size_t)refbuf % elemsize != 0)
+            return m.clone();
+
+        return m;
+    }
+    if (nread != 0)
+    {
+        NCNN_LOGE("ModelBin reference weight_data failed %zd", nread);
+        return Mat();
+    }
+
+    Mat m(w, elemsize);
+    if (m.empty())
+        return m;
+
+    nread = dr.read(m, size);
+    if (nread != size)
+    {
+        NCNN_LOGE("ModelBin read weight_data failed %zd", nread);
+        return Mat();
+    }
+
+    return m;
+}
+
 ModelBinFromDataReader::ModelBinFromDataReader(const DataReader& _dr)
     : dr(_dr)
 {
@@ -92,47 +127,20 @@ Mat ModelBinFromDataReader::load(int w, int type) const
         else if (flag_struct.tag == 0x000D4B38)
         {
             // int8 data
-            size_t align_data_size = alignSize(w, 4);
-            std::vector<signed char> int8_weights;
-            int8_weights.resize(align_data_size);
-            nread = dr.read(int8_weights.data(), align_data_size);
-            if (nread != align_data_size)
-            {
-                NCNN_LOGE("ModelBin read int8_weights failed %zd", nread);
-                return Mat();
-            }
-
-            Mat m(w, (size_t)1u);
-            if (m.empty())
-                return m;
-
-            memcpy(m.data, int8_weights.data(), w);
-
-            return m;
+            return read_data(dr, w, (size_t)1u, alignSize(w, 4));
         }
         else if (flag_struct.tag == 0x0002C056)
         {
-            Mat m(w);
-            if (m.empty())
-                return m;
-
             // raw data with extra scaling
-            nread = dr.read(m, w * sizeof(float));
-            if (nread != w * sizeof(float))
-            {
-                NCNN_LOGE("ModelBin read weight_data failed %zd", nread);
-                return Mat();
-            }
-
-            return m;
+            return read_data(dr, w, (size_t)4u, w * sizeof(float));
         }
 
-        Mat m(w);
-        if (m.empty())
-            return m;
-
         if (flag != 0)
         {
+            Mat m(w);
+            if (m.empty())
+                return m;
+
             // quantized data
             float quantization_value[256];
             nread = dr.read(quantization_value, 256 * sizeof(float));
@@ -157,35 +165,17 @@ Mat ModelBinFromDataReader::load(int w, int type) const
             {
                 ptr[i] = quantization_value[index_array[i]];
             }
-        }
-        else if (flag_struct.f0 == 0)
-        {
-            // raw data
-            nread = dr.read(m, w * sizeof(float));
-            if (nread != w * sizeof(float))
-            {
-                NCNN_LOGE("ModelBin read weight_data failed %zd", nread);
-                return Mat();
-            }
+
+            return m;
         }
 
-        return m;
+        // raw data
+        return read_data(dr, w, (size_t)4u, w * sizeof(float));
     }
     else if (type == 1)
     {
-        Mat m(w);
-        if (m.empty())
-            return m;
-
         // raw data
-        size_t nread = dr.read(m, w * sizeof(float));
-        if (nread != w * sizeof(float))
-        {
-            NCNN_LOGE("ModelBin read weight_data failed %zd", nread);
-            return Mat();
-        }
-
-        return m;
+        return read_data(dr, w, (size_t)4u, w * sizeof(float));
     }
     else
     {
@@ -14,30 +14,144 @@
 
 #include "net.h"
 
+#include "benchmark.h"
 #include "convolution.h"
 #include "convolutiondepthwise.h"
+#include "cpu.h"
 #include "datareader.h"
+#include "deconvolution.h"
+#include "deconvolutiondepthwise.h"
+#include "innerproduct.h"
 #include "layer_type.h"
 #include "modelbin.h"
 #include "paramdict.h"
+#include "profiler.h"
 #include "relu.h"
+#include "threadpool.h"
 
+#include <algorithm>
+#include <functional>
+#include <queue>
 #include <stdarg.h>
 #include <stdint.h>
 #include <string.h>
 
-#if NCNN_BENCHMARK
-#include "benchmark.h"
-#endif // NCNN_BENCHMARK
-
 #if NCNN_VULKAN
 #include "command.h"
 #endif // NCNN_VULKAN
 
 namespace ncnn {
 
+// arena offsets and reserved sizes of the blobs for one set of input shapes
+class MemoryPlan
+{
+public:
+    MemoryPlan()
+        : size(0)
+    {
+    }
+
+    // arena bytes
+    size_t size;
+    // offset and reserved size of each blob, size 0 for unplanned blob
+    std::vector<size_t> offsets;
+    std::vector<size_t> sizes;
+};
+
+// memory plans of recently seen input shapes, most recently used first
+class MemoryPlanCache
+{
+public:
+    struct Entry
+    {
+        std::vector<int> key;
+        MemoryPlan plan;
+    };
+
+    Mutex lock;
+    std::vector<Entry> entries;
+};
+
+// numa node the calling thread is bound to, plus one
+static ThreadLocalStorage g_numa_node_tls;
+
+// bind a thread the net owns and its parallel loops to numa node, once per thread
+static void bind_numa_node(int node)
+{
+    if (node < 0)
+        return;
+
+    if ((size_t)g_numa_node_tls.get() == (size_t)node + 1)
+        return;
+
+    if (set_numa_thread_affinity(node) == 0)
+    {
+        g_numa_node_tls.set((void*)((size_t)node + 1));
+    }
+}
+
+// bind the application thread running a forward and its parallel loops to numa node
+// and put back the affinity and openmp thread count it had when the forward is done
+class NumaNodeScope
+{
+public:
+    NumaNodeScope(int node)
+        : bound(false), saved_node_tls(0), saved_num_threads(0)
+    {
+        if (node < 0)
+            return;
+
+        saved_node_tls = g_numa_node_tls.get();
+        if ((size_t)saved_node_tls == (size_t)node + 1)
+            return;
+
+        if (get_cpu_thread_affinity(saved_cpuset) != 0)
+            return;
+
+        saved_num_threads = get_omp_max_threads();
+
+        if (set_numa_thread_affinity(node) == 0)
+        {
+            bound = true;
+            g_numa_node_tls.set((void*)((size_t)node + 1));
+        }
+    }
+
+    ~NumaNodeScope()
+    {
+        if (!bound)
+            return;
+
+        set_cpu_thread_affinity(saved_cpuset);
+        set_omp_num_threads(saved_num_threads);
+        g_numa_node_tls.set(saved_node_tls);
+    }
+
+private:
+    bool bound;
+    void* saved_node_tls;
+    CpuSet saved_cpuset;
+    int saved_num_threads;
+};
+
 Net::Net()
 {
+    static_runtime_conversions = 0;
+    static_conversion_layers = 0;
+
+    memory_plan = 0;
+    memory_plan_cache = 0;
+
+    thread_pool = 0;
+
+#if NCNN_STDIO
+    model_mmap = 0;
+    pipeline_cache_mmap = 0;
+    pipeline_cache_weight_checksum = 0;
+#endif // NCNN_STDIO
+
+    weight_checksum = 0;
+
 #if NCNN_VULKAN
     vkdev = 0;
     weight_vkallocator = 0;
@@ -481,7 +595,75 @@ int Net::load_param_bin(const DataReader& dr)
     return 0;
 }
 
+static unsigned int weight_checksum_bytes(unsigned int hash, const unsigned char* data, size_t size)
+{
+    // fnv-1a
+    for (size_t i = 0; i < size; i++)
+    {
+        hash ^= data[i];
+        hash *= 16777619u;
+    }
+
+    return hash;
+}
+
+static void weight_checksum_combine(unsigned int& hash, unsigned int layer_checksum)
+{
+    hash = weight_checksum_bytes(hash, (const unsigned char*)&layer_checksum, sizeof(layer_checksum));
+}
+
+// forward to a reader and checksum the bytes taken from it
+class DataReaderWithChecksum : public DataReader
+{
+public:
+    DataReaderWithChecksum(const DataReader& _dr)
+        : dr(_dr), checksum(2166136261u)
+    {
+    }
+
+#if NCNN_STRING
+    virtual int scan(const char* format, void* p) const
+    {
+        return dr.scan(format, p);
+    }
+#endif // NCNN_STRING
+
+    virtual size_t read(void* buf, size_t size) const
+    {
+        size_t nread = dr.read(buf, size);
+        checksum = weight_checksum_bytes(checksum, (const unsigned char*)buf, nread);
+        return nread;
+    }
+
+    virtual size_t reference(size_t size, const void** buf) const
+    {
+        size_t nref = dr.reference(size, buf);
+        if (nref)
+            checksum = weight_checksum_bytes(checksum, (const unsigned char*)*buf, nref);
+        return nref;
+    }
+
+    // the checksum of the bytes taken since the last call
+    unsigned int take() const
+    {
+        unsigned int ret = checksum;
+        checksum = 2166136261u;
+        return ret;
+    }
+
+protected:
+    const DataReader& dr;
+    mutable unsigned int checksum;
+};
+
 int Net::load_model(const DataReader& dr)
+{
+    DataReaderWithChecksum cdr(dr);
+    ModelBinFromDataReader mb(cdr);
+    return load_model(mb, &cdr);
+}
+
+int Net::load_model(const ModelBin& mb, const DataReaderWithChecksum* checksum_dr)
 {
     if (layers.empty())
     {
@@ -492,7 +674,18 @@ int Net::load_model(const DataReader& dr)
     // load file
     int ret = 0;
 
-    ModelBinFromDataReader mb(dr);
+    // place the weights while they are loaded and transformed
+    const int numa_policy = opt.numa_node >= 0 ? 1 : opt.use_numa_interleave ? 2 : 0;
+    NumaMemoryPolicy saved_mempolicy;
+    bool mempolicy_saved = false;
+    if (numa_policy != 0)
+    {
+        // the caller may have a policy of its own, put back afterwards
+        mempolicy_saved = get_numa_memory_policy(saved_mempolicy) == 0;
+        set_numa_memory_policy(numa_policy, opt.numa_node);
+    }
+
+    unsigned int layer_weight_checksum = 2166136261u;
     for (size_t i = 0; i < layers.size(); i++)
     {
         Layer* layer = layers[i];
@@ -512,7 +705,26 @@ int Net::load_model(const DataReader& dr)
             ret = -1;
             break;
         }
+
+        if (checksum_dr)
+        {
+            weight_checksum_combine(layer_weight_checksum, checksum_dr->take());
+        }
+    }
+
+    if (checksum_dr)
+    {
+        weight_checksum = layer_weight_checksum;
+    }
+
+#if NCNN_STDIO
+    if (!pipeline_cache_weights.empty() && pipeline_cache_weight_checksum != weight_checksum)
+    {
+        // the cache was made from other weights of the same graph
+        NCNN_LOGE("pipeline cache is stale for these weights, transform them again");
+        pipeline_cache_weights.clear();
     }
+#endif // NCNN_STDIO
 
     fuse_network();
 
@@ -529,6 +741,13 @@ int Net::load_model(const DataReader& dr)
         }
 
         Option opt1 = opt;
+        if (numa_policy != 0)
+        {
+            // the memory policy belongs to the thread that sets it and places the pages this thread touches first,
+            // openmp workers transforming weights in create_pipeline would place them by their own default policy,
+            // on whatever node they run on, so the transforms run on this thread alone
+            opt1.num_threads = 1;
+        }
 #if NCNN_VULKAN
         if (opt.use_vulkan_compute)
         {
@@ -540,6 +759,22 @@ int Net::load_model(const DataReader& dr)
         }
 #endif // NCNN_VULKAN
 
+#if NCNN_STDIO
+        if (i < pipeline_cache_weights.size() && !pipeline_cache_weights[i].empty())
+        {
+            // restored weights skip the transforms in create_pipeline
+            std::vector<Mat*> weights;
+            layer->get_pipeline_weights(weights);
+            if (weights.size() == pipeline_cache_weights[i].size())
+            {
+                for (size_t j = 0; j < weights.size(); j++)
+                {
+                    *weights[j] = pipeline_cache_weights[i][j];
+                }
+            }
+        }
+#endif // NCNN_STDIO
+
         int cret = layer->create_pipeline(opt1);
         if (cret != 0)
         {
@@ -558,6 +793,46 @@ int Net::load_model(const DataReader& dr)
     }
 #endif // NCNN_VULKAN
 
+#if NCNN_STDIO
+    // the layers hold what they need
+    pipeline_cache_weights.clear();
+#endif // NCNN_STDIO
+
+    if (mempolicy_saved)
+    {
+        set_numa_memory_policy(saved_mempolicy);
+    }
+
+    if (opt.use_static_layout)
+    {
+        propagate_layout();
+    }
+
+    if (build_schedule() != 0)
+    {
+        ret = -1;
+    }
+
+    // loading again without clear replaces the workers and plans of the previous load
+    delete thread_pool;
+    thread_pool = 0;
+
+    delete memory_plan_cache;
+    memory_plan_cache = 0;
+
+    if (opt.num_inter_threads > 1)
+    {
+        // the calling thread takes part as well
+        thread_pool = new ThreadPool(opt.num_inter_threads - 1);
+    }
+
+    if (opt.use_memory_plan)
+    {
+        plan_memory();
+
+        memory_plan_cache = new MemoryPlanCache;
+    }
+
     return ret;
 }
 
@@ -630,248 +905,1529 @@ int Net::load_model(const char* modelpath)
     fclose(fp);
     return ret;
 }
-#endif // NCNN_STDIO
 
-int Net::load_param(const unsigned char* _mem)
+int Net::load_model_mmap(const char* modelpath)
 {
-    const unsigned char* mem = _mem;
-    DataReaderFromMemory dr(mem);
-    load_param_bin(dr);
-    return static_cast<int>(mem - _mem);
+    DataReaderFromMmap* dr = new DataReaderFromMmap(modelpath);
+    if (!dr->mapped())
+    {
+        NCNN_LOGE("mmap %s failed", modelpath);
+        delete dr;
+        return -1;
+    }
+
+    // weight data points into the mapping, keep it alive with the layers
+    delete model_mmap;
+    model_mmap = dr;
+
+    return load_model(*dr);
 }
 
-int Net::load_model(const unsigned char* _mem)
+// pipeline cache file
+// header    magic version isa option_flags graph_hash weight_checksum layer_count
+// per layer weight_count, per weight dims w h c elemsize elempack and the data aligned to 64 bytes
+// only layers with pipeline weights are stored, in layer order
+static const unsigned int PIPELINE_CACHE_MAGIC = 0x4e435043;
+static const unsigned int PIPELINE_CACHE_VERSION = 3;
+
+static unsigned int pipeline_cache_isa()
 {
-    const unsigned char* mem = _mem;
-    DataReaderFromMemory dr(mem);
-    load_model(dr);
-    return static_cast<int>(mem - _mem);
+    unsigned int isa = 0;
+#if __SSE2__
+    isa |= 1 << 0;
+#endif
+#if __AVX__
+    isa |= 1 << 1;
+#endif
+#if __FMA__
+    isa |= 1 << 2;
+#endif
+#if __F16C__
+    isa |= 1 << 3;
+#endif
+#if __AVX2__
+    isa |= 1 << 4;
+#endif
+#if __AVX512F__
+    isa |= 1 << 5;
+#endif
+#if __ARM_NEON
+    isa |= 1 << 8;
+#endif
+#if __aarch64__
+    isa |= 1 << 9;
+#endif
+#if NCNN_RUNTIME_CPU
+    // layers run the avx2 build
+    if (cpu_support_x86_avx2())
+        isa |= (1 << 1) | (1 << 2) | (1 << 3) | (1 << 4);
+#endif
+#if NCNN_RUNTIME_CPU_AVX512
+    // layers with avx512 kernels run the avx512 build
+    if (cpu_support_x86_avx512())
+        isa |= 1 << 5;
+#endif
+#if NCNN_RUNTIME_CPU_AVX512VNNI
+    // int8 layers pack their weights for vnni
+    if (cpu_support_x86_avx512_vnni())
+        isa |= 1 << 6;
+#endif
+    return isa;
 }
 
-#if __ANDROID_API__ >= 9
-#if NCNN_STRING
-int Net::load_param(AAsset* asset)
+static unsigned int pipeline_cache_option_flags(const Option& opt)
 {
-    DataReaderFromAndroidAsset dr(asset);
-    return load_param(dr);
+    unsigned int flags = 0;
+    flags |= opt.use_winograd_convolution << 0;
+    flags |= opt.use_sgemm_convolution << 1;
+    flags |= opt.use_int8_inference << 2;
+    flags |= opt.use_fp16_packed << 3;
+    flags |= opt.use_fp16_storage << 4;
+    flags |= opt.use_fp16_arithmetic << 5;
+    flags |= opt.use_int8_storage << 6;
+    flags |= opt.use_int8_arithmetic << 7;
+    flags |= opt.use_packing_layout << 8;
+    flags |= opt.use_bf16_storage << 9;
+    return flags;
 }
 
-int Net::load_param(AAssetManager* mgr, const char* assetpath)
+static void pipeline_cache_hash(unsigned int& hash, unsigned int v)
 {
-    AAsset* asset = AAssetManager_open(mgr, assetpath, AASSET_MODE_BUFFER);
-    if (!asset)
+    // fnv-1a
+    for (int i = 0; i < 4; i++)
     {
-        NCNN_LOGE("AAssetManager_open %s failed", assetpath);
-        return -1;
+        hash ^= (v >> (i * 8)) & 0xff;
+        hash *= 16777619u;
     }
-
-    int ret = load_param(asset);
-    AAsset_close(asset);
-    return ret;
 }
-#endif // NCNN_STRING
 
-int Net::load_param_bin(AAsset* asset)
+// hash the params that decide the transformed weights and the sizes of the weights loaded for them
+// known right after load_param, so a cache of a model with another width or kernel is stale
+static void pipeline_cache_hash_layer(unsigned int& hash, const Layer* layer)
 {
-    DataReaderFromAndroidAsset dr(asset);
-    return load_param_bin(dr);
+    pipeline_cache_hash(hash, layer->typeindex);
+
+    if (layer->typeindex == LayerType::Convolution)
+    {
+        const Convolution* conv = (const Convolution*)layer;
+        const int params[10] = {conv->num_output, conv->kernel_w, conv->kernel_h, conv->dilation_w, conv->dilation_h, conv->stride_w, conv->stride_h, conv->bias_term, conv->weight_data_size, conv->int8_scale_term};
+        for (int i = 0; i < 10; i++)
+            pipeline_cache_hash(hash, params[i]);
+
+        // weight_data bias_data weight_data_int8_scales
+        pipeline_cache_hash(hash, conv->weight_data_size);
+        pipeline_cache_hash(hash, conv->bias_term ? conv->num_output : 0);
+        pipeline_cache_hash(hash, conv->int8_scale_term ? conv->num_output : 0);
+    }
+    if (layer->typeindex == LayerType::InnerProduct)
+    {
+        const InnerProduct* ip = (const InnerProduct*)layer;
+        const int params[4] = {ip->num_output, ip->bias_term, ip->weight_data_size, ip->int8_scale_term};
+        for (int i = 0; i < 4; i++)
+            pipeline_cache_hash(hash, params[i]);
+
+        pipeline_cache_hash(hash, ip->weight_data_size);
+        pipeline_cache_hash(hash, ip->bias_term ? ip->num_output : 0);
+        pipeline_cache_hash(hash, ip->int8_scale_term ? ip->num_output : 0);
+    }
+    if (layer->typeindex == LayerType::Deconvolution)
+    {
+        const Deconvolution* deconv = (const Deconvolution*)layer;
+        const int params[10] = {deconv->num_output, deconv->kernel_w, deconv->kernel_h, deconv->dilation_w, deconv->dilation_h, deconv->stride_w, deconv->stride_h, deconv->bias_term, deconv->weight_data_size, deconv->int8_scale_term};
+        for (int i = 0; i < 10; i++)
+            pipeline_cache_hash(hash, params[i]);
+
+        pipeline_cache_hash(hash, deconv->weight_data_size);
+        pipeline_cache_hash(hash, deconv->bias_term ? deconv->num_output : 0);
+        pipeline_cache_hash(hash, deconv->int8_scale_term ? deconv->num_output : 0);
+    }
+    if (layer->typeindex == LayerType::DeconvolutionDepthWise)
+    {
+        const DeconvolutionDepthWise* deconvdw = (const DeconvolutionDepthWise*)layer;
+        const int params[10] = {deconvdw->num_output, deconvdw->kernel_w, deconvdw->kernel_h, deconvdw->dilation_w, deconvdw->dilation_h, deconvdw->stride_w, deconvdw->stride_h, deconvdw->bias_term, deconvdw->weight_data_size, deconvdw->group};
+        for (int i = 0; i < 10; i++)
+            pipeline_cache_hash(hash, params[i]);
+
+        pipeline_cache_hash(hash, deconvdw->weight_data_size);
+        pipeline_cache_hash(hash, deconvdw->bias_term ? deconvdw->num_output : 0);
+    }
 }
 
-int Net::load_param_bin(AAssetManager* mgr, const char* assetpath)
+// collect the layers with pipeline weights and hash them as the graph part of the key
+// layers inserted after create_pipeline carry no pipeline weights and do not disturb the order
+static unsigned int pipeline_cache_layers(const std::vector<Layer*>& layers, std::vector<int>& cached_layers)
 {
-    AAsset* asset = AAssetManager_open(mgr, assetpath, AASSET_MODE_BUFFER);
-    if (!asset)
+    unsigned int hash = 2166136261u;
+    for (size_t i = 0; i < layers.size(); i++)
     {
-        NCNN_LOGE("AAssetManager_open %s failed", assetpath);
-        return -1;
+        std::vector<Mat*> weights;
+        layers[i]->get_pipeline_weights(weights);
+        if (weights.empty())
+            continue;
+
+        cached_layers.push_back((int)i);
+        pipeline_cache_hash_layer(hash, layers[i]);
+        pipeline_cache_hash(hash, (unsigned int)weights.size());
     }
 
-    int ret = load_param_bin(asset);
-    AAsset_close(asset);
-    return ret;
+    return hash;
 }
 
-int Net::load_model(AAsset* asset)
+// a cached weight shape dims w h c elemsize elempack that a Mat can hold
+static bool pipeline_cache_shape_valid(const int shape[6])
 {
-    DataReaderFromAndroidAsset dr(asset);
-    return load_model(dr);
+    const int dims = shape[0];
+    if (dims < 1 || dims > 3)
+        return false;
+
+    const int w = shape[1];
+    const int h = dims >= 2 ? shape[2] : 1;
+    const int c = dims == 3 ? shape[3] : 1;
+    const int elemsize = shape[4];
+    const int elempack = shape[5];
+    if (w <= 0 || h <= 0 || c <= 0 || elempack <= 0 || elemsize <= 0 || elemsize > 65536 || elemsize % elempack != 0)
+        return false;
+
+    // the mapped size is checked on reference, keep the element counts in range
+    return (uint64_t)w * h <= 0x7fffffff && (uint64_t)w * h * c <= ((uint64_t)1 << 40);
 }
 
-int Net::load_model(AAssetManager* mgr, const char* assetpath)
+// read an aligned cache field, the offset tracks the alignment padding
+static size_t pipeline_cache_read(const DataReader& dr, void* buf, size_t size, size_t& offset)
 {
-    AAsset* asset = AAssetManager_open(mgr, assetpath, AASSET_MODE_STREAMING);
-    if (!asset)
+    size_t nread = dr.read(buf, size);
+    offset += nread;
+    return nread;
+}
+
+// restore the cached weights of each layer from the cache at the reader position
+// the cache start must be 64-byte aligned in memory, weights are referenced in place
+// weight_checksum receives the checksum of the weights the cache was made from, for load_model to check
+// return 0 if success, -1 if the cache is stale, -2 if the cache is truncated
+static int pipeline_cache_load(const DataReader& dr, const std::vector<Layer*>& layers, const Option& opt, std::vector<std::vector<Mat> >& cache_weights, unsigned int& weight_checksum)
+{
+    std::vector<int> cached_layers;
+    unsigned int graph_hash = pipeline_cache_layers(layers, cached_layers);
+
+    size_t offset = 0;
+    unsigned int header[7];
+    if (pipeline_cache_read(dr, header, sizeof(header), offset) != sizeof(header)
+            || header[0] != PIPELINE_CACHE_MAGIC || header[1] != PIPELINE_CACHE_VERSION
+            || header[2] != pipeline_cache_isa() || header[3] != pipeline_cache_option_flags(opt)
+            || header[4] != graph_hash || header[6] != cached_layers.size())
     {
-        NCNN_LOGE("AAssetManager_open %s failed", assetpath);
         return -1;
     }
 
-    int ret = load_model(asset);
-    AAsset_close(asset);
-    return ret;
-}
-#endif // __ANDROID_API__ >= 9
+    weight_checksum = header[5];
 
-int Net::fuse_network()
-{
-    // set the int8 op fusion:requantize
-#if NCNN_STRING && NCNN_REQUANT
-    // NCNN_LOGE("Test op fusion to int8 implement:");
-    // parse the network whether is a quantization model
-    bool net_quantized = false;
-    for (size_t i = 0; i < layers.size(); i++)
+    cache_weights.clear();
+    cache_weights.resize(layers.size());
+    for (size_t i = 0; i < cached_layers.size(); i++)
     {
-        Layer* layer = layers[i];
-        if (layer->type == "Convolution" || layer->type == "ConvolutionDepthWise")
+        unsigned int weight_count = 0;
+        if (pipeline_cache_read(dr, &weight_count, sizeof(weight_count), offset) != sizeof(weight_count))
+            return -2;
+
+        std::vector<Mat*> layer_weights;
+        layers[cached_layers[i]]->get_pipeline_weights(layer_weights);
+        if (weight_count != layer_weights.size())
+            return -1;
+
+        std::vector<Mat>& weights = cache_weights[cached_layers[i]];
+        weights.resize(weight_count);
+        for (unsigned int j = 0; j < weight_count; j++)
         {
-            if (layer->type == "Convolution" && (((Convolution*)layer)->weight_data.elemsize != 1u))
-                continue;
-            if (layer->type == "ConvolutionDepthWise" && (((ConvolutionDepthWise*)layer)->weight_data.elemsize != 1u))
+            int shape[6];
+            if (pipeline_cache_read(dr, shape, sizeof(shape), offset) != sizeof(shape))
+                return -2;
+
+            const int dims = shape[0];
+            if (dims == 0)
                 continue;
-            net_quantized = true;
+
+            if (!pipeline_cache_shape_valid(shape))
+                return -1;
+
+            // skip the padding
+            size_t padding = alignSize(offset, 64) - offset;
+            const void* refbuf = 0;
+            offset += dr.reference(padding, &refbuf);
+
+            Mat& m = weights[j];
+            if (dims == 1)
+                m = Mat(shape[1], (void*)0, (size_t)shape[4], shape[5]);
+            if (dims == 2)
+                m = Mat(shape[1], shape[2], (void*)0, (size_t)shape[4], shape[5]);
+            if (dims == 3)
+                m = Mat(shape[1], shape[2], shape[3], (void*)0, (size_t)shape[4], shape[5]);
+
+            size_t size = m.total() * m.elemsize;
+            if (dr.reference(size, &refbuf) != size)
+                return -2;
+            offset += size;
+
+            m.data = (void*)refbuf;
         }
     }
 
-    if (net_quantized == false)
-        return 0;
+    return 0;
+}
 
-    for (size_t i = 0; i < layers.size(); i++)
+int Net::load_pipeline_cache(const char* cachepath)
+{
+    if (layers.empty())
     {
-        Layer* layer = layers[i];
+        NCNN_LOGE("network graph not ready");
+        return -1;
+    }
 
-        if (layer->type == "Convolution" || layer->type == "ConvolutionDepthWise")
-        {
-            if (layer->type == "Convolution" && (((Convolution*)layer)->weight_data.elemsize != 1u))
-                continue;
-            if (layer->type == "ConvolutionDepthWise" && (((ConvolutionDepthWise*)layer)->weight_data.elemsize != 1u))
-                continue;
+    DataReaderFromMmap* dr = new DataReaderFromMmap(cachepath);
+    if (!dr->mapped())
+    {
+        delete dr;
+        return -1;
+    }
 
-            for (size_t n = 0; n < blobs[layer->tops[0]].consumers.size(); n++)
-            {
-                int layer_next_index = blobs[layer->tops[0]].consumers[n];
-                Layer* layer_next = layers[layer_next_index];
+    std::vector<std::vector<Mat> > cache_weights;
+    unsigned int cache_weight_checksum = 0;
+    int ret = pipeline_cache_load(*dr, layers, opt, cache_weights, cache_weight_checksum);
+    if (ret != 0)
+    {
+        NCNN_LOGE("pipeline cache %s is %s", cachepath, ret == -1 ? "stale" : "truncated");
+        delete dr;
+        return -1;
+    }
 
-                if (layer_next->type == "Convolution" || layer_next->type == "ConvolutionDepthWise")
-                {
-                    if (layer_next->type == "Convolution" && ((Convolution*)layer_next)->weight_data.elemsize != 1u)
-                        continue;
-                    if (layer_next->type == "ConvolutionDepthWise" && ((ConvolutionDepthWise*)layer_next)->weight_data.elemsize != 1u)
-                        continue;
+    delete pipeline_cache_mmap;
+    pipeline_cache_mmap = dr;
+    pipeline_cache_weights = cache_weights;
+    pipeline_cache_weight_checksum = cache_weight_checksum;
 
-                    // NCNN_LOGE("%s, %s", layer->name.c_str(), layer_next->name.c_str());
-                    if (layer->type == "Convolution" && layer_next->type == "Convolution")
-                    {
-                        ((Convolution*)layer)->use_int8_requantize = true;
-                        ((Convolution*)layer)->top_blob_int8_scale = ((Convolution*)layer_next)->bottom_blob_int8_scale;
-                    }
-                    else if (layer->type == "ConvolutionDepthWise" && layer_next->type == "Convolution")
-                    {
-                        ((ConvolutionDepthWise*)layer)->use_int8_requantize = true;
-                        ((ConvolutionDepthWise*)layer)->top_blob_int8_scale = ((Convolution*)layer_next)->bottom_blob_int8_scale;
-                    }
-                    else if (layer->type == "Convolution" && layer_next->type == "ConvolutionDepthWise")
-                    {
-                        ((Convolution*)layer)->use_int8_requantize = true;
-                        ((Convolution*)layer)->top_blob_int8_scale = ((ConvolutionDepthWise*)layer_next)->bottom_blob_int8_scales[0];
-                    }
-                    else
-                    {
-                        ((ConvolutionDepthWise*)layer)->use_int8_requantize = true;
-                        ((ConvolutionDepthWise*)layer)->top_blob_int8_scale = ((ConvolutionDepthWise*)layer_next)->bottom_blob_int8_scales[0];
-                    }
-                }
-                else if (layer_next->type == "ReLU")
-                {
-                    int layer_next_2_index = blobs[layer_next->tops[0]].consumers[0];
-                    Layer* layer_next_2 = layers[layer_next_2_index];
+    return 0;
+}
 
-                    if (layer_next_2->type == "Convolution" || layer_next_2->type == "ConvolutionDepthWise")
-                    {
-                        if (layer_next_2->type == "Convolution" && ((Convolution*)layer_next_2)->weight_data.elemsize != 1u)
-                            continue;
-                        if (layer_next_2->type == "ConvolutionDepthWise" && ((ConvolutionDepthWise*)layer_next_2)->weight_data.elemsize != 1u)
-                            continue;
+int Net::save_pipeline_cache(const char* cachepath) const
+{
+    FILE* fp = fopen(cachepath, "wb");
+    if (!fp)
+    {
+        NCNN_LOGE("fopen %s failed", cachepath);
+        return -1;
+    }
+
+    int ret = save_pipeline_cache(fp);
+    fclose(fp);
+
+    if (ret != 0)
+    {
+        NCNN_LOGE("write pipeline cache %s failed", cachepath);
+    }
+
+    return ret;
+}
+
+int Net::save_pipeline_cache(FILE* fp) const
+{
+    std::vector<int> cached_layers;
+    unsigned int graph_hash = pipeline_cache_layers(layers, cached_layers);
+
+    const unsigned char zeros[64] = {0};
+
+    size_t offset = 0;
+    unsigned int header[7] = {PIPELINE_CACHE_MAGIC, PIPELINE_CACHE_VERSION, pipeline_cache_isa(), pipeline_cache_option_flags(opt), graph_hash, weight_checksum, (unsigned int)cached_layers.size()};
+    offset += fwrite(header, 1, sizeof(header), fp);
+
+    for (size_t i = 0; i < cached_layers.size(); i++)
+    {
+        std::vector<Mat*> weights;
+        layers[cached_layers[i]]->get_pipeline_weights(weights);
+
+        unsigned int weight_count = (unsigned int)weights.size();
+        offset += fwrite(&weight_count, 1, sizeof(weight_count), fp);
+
+        for (size_t j = 0; j < weights.size(); j++)
+        {
+            const Mat& m = *weights[j];
+
+            int shape[6] = {m.empty() ? 0 : m.dims, m.w, m.h, m.c, (int)m.elemsize, m.elempack};
+            offset += fwrite(shape, 1, sizeof(shape), fp);
+
+            if (shape[0] == 0)
+                continue;
+
+            offset += fwrite(zeros, 1, alignSize(offset, 64) - offset, fp);
+            offset += fwrite(m.data, 1, m.total() * m.elemsize, fp);
+        }
+    }
+
+    return ferror(fp) ? -1 : 0;
+}
+
+// model container file, written by tools/ncnn2container
+// header          16 uint64, magic version layer_count mat_count param_offset param_size names_offset names_size
+//                 layer_table_offset mat_table_offset pipeline_table_offset pipeline_count file_size index_checksum 0 0
+// param           binary param as load_param_bin reads it
+// names           nul-terminated type and name of each layer, then name of each blob
+// layer table     per layer uint32 first_mat mat_count weight_checksum 0
+// mat table       per weight uint64 offset size, the bytes ModelBinFromDataReader reads for it
+// pipeline table  per section uint64 offset size, each section is a pipeline cache file
+// sections start 64-byte aligned, weight payloads after the type 0 flag are 64-byte aligned too
+// index_checksum is fnv-1a over header with index_checksum zeroed, param, names and the tables
+static const uint64_t CONTAINER_MAGIC = 0x4e434d43;
+static const uint64_t CONTAINER_VERSION = 1;
+
+static bool container_section_valid(uint64_t offset, uint64_t size, uint64_t file_size)
+{
+    return offset <= file_size && size <= file_size - offset;
+}
+
+#if NCNN_STRING
+// next nul-terminated string in the names section, 0 if the section ends before
+static const char* container_string(const char*& p, const char* end)
+{
+    const char* s = p;
+    const char* nul = (const char*)memchr(p, 0, end - p);
+    if (!nul)
+        return 0;
+
+    p = nul + 1;
+    return s;
+}
+#endif // NCNN_STRING
+
+// one container section, reads never run past its end
+class DataReaderFromSection : public DataReader
+{
+public:
+    DataReaderFromSection(const unsigned char* _data, size_t _size)
+        : data(_data), size(_size), offset(0)
+    {
+    }
+
+    virtual size_t read(void* buf, size_t _size) const
+    {
+        _size = std::min(_size, size - offset);
+        memcpy(buf, data + offset, _size);
+        offset += _size;
+        return _size;
+    }
+
+    virtual size_t reference(size_t _size, const void** buf) const
+    {
+        _size = std::min(_size, size - offset);
+        *buf = data + offset;
+        offset += _size;
+        return _size;
+    }
+
+    size_t consumed() const
+    {
+        return offset;
+    }
+
+protected:
+    const unsigned char* data;
+    size_t size;
+    mutable size_t offset;
+};
+
+// weights in mat table order, each one read through ModelBinFromDataReader in place
+class ModelBinFromContainer : public ModelBin
+{
+public:
+    ModelBinFromContainer(const unsigned char* _base, const uint64_t* _mat_table, int _mat_count)
+        : base(_base), mat_table(_mat_table), mat_count(_mat_count), mat_index(0)
+    {
+    }
+
+    virtual Mat load(int w, int type) const
+    {
+        if (mat_index >= mat_count)
+        {
+            NCNN_LOGE("container holds %d weights only", mat_count);
+            return Mat();
+        }
+
+        const uint64_t offset = mat_table[mat_index * 2];
+        const uint64_t size = mat_table[mat_index * 2 + 1];
+        mat_index++;
+
+        DataReaderFromSection dr(base + offset, (size_t)size);
+        ModelBinFromDataReader mb(dr);
+        Mat m = mb.load(w, type);
+        if (!m.empty() && dr.consumed() != size)
+        {
+            NCNN_LOGE("container weight %d size mismatch", mat_index - 1);
+            return Mat();
+        }
+
+        return m;
+    }
+
+protected:
+    const unsigned char* base;
+    const uint64_t* mat_table;
+    int mat_count;
+    mutable int mat_index;
+};
+
+int Net::load_container(const char* containerpath)
+{
+    DataReaderFromMmap* dr = new DataReaderFromMmap(containerpath);
+    if (!dr->mapped())
+    {
+        NCNN_LOGE("mmap %s failed", containerpath);
+        delete dr;
+        return -1;
+    }
+
+    const unsigned char* base = dr->mapped_data();
+    const uint64_t file_size = dr->mapped_size();
+
+    uint64_t header[16];
+    if (file_size < sizeof(header))
+    {
+        NCNN_LOGE("container %s is truncated", containerpath);
+        delete dr;
+        return -1;
+    }
+    memcpy(header, base, sizeof(header));
+
+    const uint64_t layer_count = header[2];
+    const uint64_t mat_count = header[3];
+    const uint64_t pipeline_count = header[11];
+    if (header[0] != CONTAINER_MAGIC || header[1] != CONTAINER_VERSION || header[12] != file_size
+            || layer_count > file_size / 16 || mat_count > file_size / 16 || pipeline_count > file_size / 16
+            || !container_section_valid(header[4], header[5], file_size)
+            || !container_section_valid(header[6], header[7], file_size)
+            || !container_section_valid(header[8], layer_count * 16, file_size)
+            || !container_section_valid(header[9], mat_count * 16, file_size)
+            || !container_section_valid(header[10], pipeline_count * 16, file_size)
+            || header[8] % 8 != 0 || header[9] % 8 != 0 || header[10] % 8 != 0)
+    {
+        NCNN_LOGE("container %s is invalid", containerpath);
+        delete dr;
+        return -1;
+    }
+
+    // the index must be intact, weights are only touched when used
+    const unsigned int index_checksum = (unsigned int)header[13];
+    header[13] = 0;
+    unsigned int checksum = 2166136261u;
+    checksum = weight_checksum_bytes(checksum, (const unsigned char*)header, sizeof(header));
+    checksum = weight_checksum_bytes(checksum, base + header[4], (size_t)header[5]);
+    checksum = weight_checksum_bytes(checksum, base + header[6], (size_t)header[7]);
+    checksum = weight_checksum_bytes(checksum, base + header[8], (size_t)layer_count * 16);
+    checksum = weight_checksum_bytes(checksum, base + header[9], (size_t)mat_count * 16);
+    checksum = weight_checksum_bytes(checksum, base + header[10], (size_t)pipeline_count * 16);
+    if (checksum != index_checksum)
+    {
+        NCNN_LOGE("container %s checksum mismatch", containerpath);
+        delete dr;
+        return -1;
+    }
+
+    const uint64_t* mat_table = (const uint64_t*)(base + header[9]);
+    for (uint64_t i = 0; i < mat_count; i++)
+    {
+        if (!container_section_valid(mat_table[i * 2], mat_table[i * 2 + 1], file_size))
+        {
+            NCNN_LOGE("container %s weight %d is out of range", containerpath, (int)i);
+            delete dr;
+            return -1;
+        }
+    }
+
+    DataReaderFromSection pdr(base + header[4], (size_t)header[5]);
+    if (load_param_bin(pdr) != 0 || layers.size() != layer_count)
+    {
+        NCNN_LOGE("container %s param mismatch", containerpath);
+        delete dr;
+        return -1;
+    }
+
+#if NCNN_STRING
+    const char* names = (const char*)base + header[6];
+    const char* names_end = names + header[7];
+    for (size_t i = 0; i < layers.size(); i++)
+    {
+        const char* type = container_string(names, names_end);
+        const char* name = type ? container_string(names, names_end) : 0;
+        if (!name)
+            break;
+
+        if (layers[i])
+        {
+            layers[i]->type = std::string(type);
+            layers[i]->name = std::string(name);
+        }
+    }
+    for (size_t i = 0; i < blobs.size(); i++)
+    {
+        const char* name = container_string(names, names_end);
+        if (!name)
+            break;
+
+        blobs[i].name = std::string(name);
+    }
+#endif // NCNN_STRING
+
+    // restore the pre-packed weights made for this cpu and option, if any
+    const uint64_t* pipeline_table = (const uint64_t*)(base + header[10]);
+    for (uint64_t i = 0; i < pipeline_count; i++)
+    {
+        const uint64_t offset = pipeline_table[i * 2];
+        const uint64_t size = pipeline_table[i * 2 + 1];
+        if (!container_section_valid(offset, size, file_size) || offset % 64 != 0)
+            continue;
+
+        std::vector<std::vector<Mat> > cache_weights;
+        unsigned int cache_weight_checksum = 0;
+        DataReaderFromSection cdr(base + offset, (size_t)size);
+        if (pipeline_cache_load(cdr, layers, opt, cache_weights, cache_weight_checksum) == 0)
+        {
+            pipeline_cache_weights = cache_weights;
+            pipeline_cache_weight_checksum = cache_weight_checksum;
+            break;
+        }
+    }
+
+    // the weights are checksummed per layer already, leave their pages alone
+    const unsigned int* layer_table = (const unsigned int*)(base + header[8]);
+    unsigned int layer_weight_checksum = 2166136261u;
+    for (uint64_t i = 0; i < layer_count; i++)
+    {
+        weight_checksum_combine(layer_weight_checksum, layer_table[i * 4 + 2]);
+    }
+    weight_checksum = layer_weight_checksum;
+
+    // weight data points into the mapping, keep it alive with the layers
+    delete model_mmap;
+    model_mmap = dr;
+
+    ModelBinFromContainer mb(base, mat_table, (int)mat_count);
+    return load_model(mb);
+}
+#endif // NCNN_STDIO
+
+int Net::load_param(const unsigned char* _mem)
+{
+    const unsigned char* mem = _mem;
+    DataReaderFromMemory dr(mem);
+    load_param_bin(dr);
+    return static_cast<int>(mem - _mem);
+}
+
+int Net::load_model(const unsigned char* _mem)
+{
+    const unsigned char* mem = _mem;
+    DataReaderFromMemory dr(mem);
+    load_model(dr);
+    return static_cast<int>(mem - _mem);
+}
+
+#if __ANDROID_API__ >= 9
+#if NCNN_STRING
+int Net::load_param(AAsset* asset)
+{
+    DataReaderFromAndroidAsset dr(asset);
+    return load_param(dr);
+}
+
+int Net::load_param(AAssetManager* mgr, const char* assetpath)
+{
+    AAsset* asset = AAssetManager_open(mgr, assetpath, AASSET_MODE_BUFFER);
+    if (!asset)
+    {
+        NCNN_LOGE("AAssetManager_open %s failed", assetpath);
+        return -1;
+    }
+
+    int ret = load_param(asset);
+    AAsset_close(asset);
+    return ret;
+}
+#endif // NCNN_STRING
+
+int Net::load_param_bin(AAsset* asset)
+{
+    DataReaderFromAndroidAsset dr(asset);
+    return load_param_bin(dr);
+}
+
+int Net::load_param_bin(AAssetManager* mgr, const char* assetpath)
+{
+    AAsset* asset = AAssetManager_open(mgr, assetpath, AASSET_MODE_BUFFER);
+    if (!asset)
+    {
+        NCNN_LOGE("AAssetManager_open %s failed", assetpath);
+        return -1;
+    }
+
+    int ret = load_param_bin(asset);
+    AAsset_close(asset);
+    return ret;
+}
+
+int Net::load_model(AAsset* asset)
+{
+    DataReaderFromAndroidAsset dr(asset);
+    return load_model(dr);
+}
+
+int Net::load_model(AAssetManager* mgr, const char* assetpath)
+{
+    AAsset* asset = AAssetManager_open(mgr, assetpath, AASSET_MODE_STREAMING);
+    if (!asset)
+    {
+        NCNN_LOGE("AAssetManager_open %s failed", assetpath);
+        return -1;
+    }
+
+    int ret = load_model(asset);
+    AAsset_close(asset);
+    return ret;
+}
+#endif // __ANDROID_API__ >= 9
+
+#if NCNN_STRING && NCNN_REQUANT
+// the int8 input scale of a quantized layer, 0 if it cannot take an int8 blob
+static float get_int8_bottom_blob_scale(const Layer* layer)
+{
+    if (layer->type == "Convolution")
+    {
+        const Convolution* op = (const Convolution*)layer;
+        return op->weight_data.elemsize == 1u ? op->bottom_blob_int8_scale : 0.f;
+    }
+
+    if (layer->type == "ConvolutionDepthWise")
+    {
+        const ConvolutionDepthWise* op = (const ConvolutionDepthWise*)layer;
+
+        // a single requantize scale cannot feed per group input scales
+        if (op->weight_data.elemsize != 1u || op->int8_scale_term == 3)
+            return 0.f;
+
+        return op->bottom_blob_int8_scales[0];
+    }
+
+    if (layer->type == "InnerProduct")
+    {
+        const InnerProduct* op = (const InnerProduct*)layer;
+        return op->weight_data.elemsize == 1u ? op->bottom_blob_int8_scale : 0.f;
+    }
+
+    if (layer->type == "Deconvolution")
+    {
+        const Deconvolution* op = (const Deconvolution*)layer;
+        return op->weight_data.elemsize == 1u ? op->bottom_blob_int8_scale : 0.f;
+    }
+
+    return 0.f;
+}
+
+// gather the int8 input scales of all layers reading the blob, looking through relu and split
+static bool get_int8_consumer_scales(const std::vector<Blob>& blobs, const std::vector<Layer*>& layers, int blob_index, std::vector<float>& scales)
+{
+    const Blob& blob = blobs[blob_index];
+
+    // the network output stays fp32
+    if (blob.consumers.empty())
+        return false;
+
+    for (size_t i = 0; i < blob.consumers.size(); i++)
+    {
+        const Layer* consumer = layers[blob.consumers[i]];
+
+        // priorbox only reads the shape
+        if (consumer->type == "PriorBox")
+            continue;
+
+        if (consumer->type == "ReLU" && ((const ReLU*)consumer)->slope == 0.f)
+        {
+            if (!get_int8_consumer_scales(blobs, layers, consumer->tops[0], scales))
+                return false;
+
+            continue;
+        }
+
+        if (consumer->type == "Split")
+        {
+            for (size_t j = 0; j < consumer->tops.size(); j++)
+            {
+                if (!get_int8_consumer_scales(blobs, layers, consumer->tops[j], scales))
+                    return false;
+            }
+
+            continue;
+        }
+
+        float scale = get_int8_bottom_blob_scale(consumer);
+        if (scale == 0.f)
+            return false;
+
+        scales.push_back(scale);
+    }
+
+    return !scales.empty();
+}
+
+// let a quantized layer write int8 output directly
+static bool set_int8_requantize(Layer* layer, float top_blob_int8_scale)
+{
+    if (layer->type == "Convolution")
+    {
+        Convolution* op = (Convolution*)layer;
+        if (op->weight_data.elemsize != 1u)
+            return false;
+
+        op->use_int8_requantize = true;
+        op->top_blob_int8_scale = top_blob_int8_scale;
+        return true;
+    }
+
+    if (layer->type == "ConvolutionDepthWise")
+    {
+        ConvolutionDepthWise* op = (ConvolutionDepthWise*)layer;
+        if (op->weight_data.elemsize != 1u)
+            return false;
+
+        // the grouped path has no requantize output yet
+        const int maxk = op->kernel_w * op->kernel_h;
+        if (op->group != op->num_output || op->weight_data_size != maxk * op->num_output)
+            return false;
+
+        op->use_int8_requantize = true;
+        op->top_blob_int8_scale = top_blob_int8_scale;
+        return true;
+    }
+
+    if (layer->type == "InnerProduct")
+    {
+        InnerProduct* op = (InnerProduct*)layer;
+        if (op->weight_data.elemsize != 1u)
+            return false;
+
+        op->use_int8_requantize = true;
+        op->top_blob_int8_scale = top_blob_int8_scale;
+        return true;
+    }
+
+    if (layer->type == "Deconvolution")
+    {
+        Deconvolution* op = (Deconvolution*)layer;
+        if (op->weight_data.elemsize != 1u)
+            return false;
+
+        op->use_int8_requantize = true;
+        op->top_blob_int8_scale = top_blob_int8_scale;
+        return true;
+    }
+
+    return false;
+}
+#endif // NCNN_STRING && NCNN_REQUANT
+
+int Net::fuse_network()
+{
+    // set the int8 op fusion:requantize
+#if NCNN_STRING && NCNN_REQUANT
+    // an int8 layer whose every consumer is int8 with the same input scale
+    // requantizes its output, so no fp32 blob is made between them
+    for (size_t i = 0; i < layers.size(); i++)
+    {
+        Layer* layer = layers[i];
+
+        if (layer->tops.size() != 1)
+            continue;
+
+        if (layer->type != "Convolution" && layer->type != "ConvolutionDepthWise" && layer->type != "InnerProduct" && layer->type != "Deconvolution")
+            continue;
+
+        std::vector<float> scales;
+        if (!get_int8_consumer_scales(blobs, layers, layer->tops[0], scales))
+            continue;
+
+        bool same_scale = true;
+        for (size_t j = 1; j < scales.size(); j++)
+        {
+            if (scales[j] != scales[0])
+                same_scale = false;
+        }
+
+        if (!same_scale)
+            continue;
+
+        set_int8_requantize(layer, scales[0]);
+    }
+#endif
+    return 0;
+}
+
+static size_t planned_blob_size(const Mat& shape)
+{
+    // fp32 elempack=1 storage is the upper bound of all packed layouts
+    size_t cstep = shape.dims == 3 ? alignSize((size_t)shape.w * shape.h * 4u, 16) / 4u : (size_t)shape.w * shape.h;
+    size_t totalsize = alignSize(cstep * shape.c * 4u, 4) + sizeof(int);
+    return alignSize(totalsize, MALLOC_ALIGN);
+}
+
+// shape of a blob as the hints describe it, without elempack
+static Mat unpacked_shape(const Mat& m)
+{
+    if (m.dims == 1)
+        return Mat(m.w * m.elempack, (void*)0);
+    if (m.dims == 2)
+        return Mat(m.w, m.h * m.elempack, (void*)0);
+    if (m.dims == 3)
+        return Mat(m.w, m.h, m.c * m.elempack, (void*)0);
+
+    return Mat();
+}
+
+int Net::plan_memory()
+{
+    std::vector<Mat> shapes(blobs.size());
+    for (size_t i = 0; i < blobs.size(); i++)
+    {
+        shapes[i] = blobs[i].shape;
+    }
+
+    delete memory_plan;
+    memory_plan = new MemoryPlan;
+
+    return plan_memory(shapes, *memory_plan);
+}
+
+int Net::plan_memory(const std::vector<Mat>& shapes, MemoryPlan& plan) const
+{
+    const int blob_count = (int)blobs.size();
+    const int layer_count = (int)layers.size();
+
+    plan.size = 0;
+    plan.offsets.assign(blob_count, 0);
+    plan.sizes.assign(blob_count, 0);
+
+    // blobs sharing the same memory are planned as one storage
+    // inplace layer writes into its bottom, split tops reference the bottom
+    std::vector<int> storage(blob_count);
+    for (int i = 0; i < blob_count; i++)
+    {
+        storage[i] = i;
+    }
+
+    for (int i = 0; i < layer_count; i++)
+    {
+        const Layer* layer = layers[i];
+        if (layer->bottoms.empty())
+            continue;
+
+        if (layer->typeindex == LayerType::Split)
+        {
+            for (size_t j = 0; j < layer->tops.size(); j++)
+            {
+                storage[layer->tops[j]] = storage[layer->bottoms[0]];
+            }
+        }
+        else if (opt.lightmode && layer->support_inplace)
+        {
+            for (size_t j = 0; j < layer->tops.size() && j < layer->bottoms.size(); j++)
+            {
+                storage[layer->tops[j]] = storage[layer->bottoms[j]];
+            }
+        }
+    }
+
+    if ((int)schedule_positions.size() != layer_count)
+        return -1;
+
+    // lifetime in schedule order, [first, last] inclusive
+    std::vector<int> first(blob_count, layer_count);
+    std::vector<int> last(blob_count, -1);
+    std::vector<size_t> sizes(blob_count, 0);
+    std::vector<bool> plannable(blob_count, true);
+    for (int i = 0; i < blob_count; i++)
+    {
+        const Blob& blob = blobs[i];
+        int s = storage[i];
+
+        // input blobs are fed by the user
+        if (blob.producer == -1 || layers[blob.producer]->typeindex == LayerType::Input || shapes[i].dims == 0)
+        {
+            plannable[s] = false;
+            continue;
+        }
+
+        first[s] = std::min(first[s], schedule_positions[blob.producer]);
+        last[s] = std::max(last[s], blob.consumers.empty() ? layer_count : schedule_positions[blob.producer]);
+        for (size_t j = 0; j < blob.consumers.size(); j++)
+        {
+            last[s] = std::max(last[s], schedule_positions[blob.consumers[j]]);
+        }
+
+        sizes[s] = std::max(sizes[s], planned_blob_size(shapes[i]));
+    }
+
+    std::vector<std::pair<size_t, int> > order;
+    for (int i = 0; i < blob_count; i++)
+    {
+        if (storage[i] == i && plannable[i] && sizes[i] != 0)
+            order.push_back(std::make_pair(sizes[i], i));
+    }
+
+    if (order.empty())
+        return 0;
+
+    // greedy by size, place each storage at the lowest offset free during its lifetime
+    std::sort(order.begin(), order.end());
+    std::reverse(order.begin(), order.end());
+
+    std::vector<int> placed;
+    for (size_t i = 0; i < order.size(); i++)
+    {
+        int s = order[i].second;
+        size_t size = sizes[s];
+
+        std::vector<std::pair<size_t, size_t> > conflicts;
+        for (size_t j = 0; j < placed.size(); j++)
+        {
+            int p = placed[j];
+            if (first[p] <= last[s] && first[s] <= last[p])
+                conflicts.push_back(std::make_pair(plan.offsets[p], sizes[p]));
+        }
+
+        std::sort(conflicts.begin(), conflicts.end());
+
+        size_t offset = 0;
+        for (size_t j = 0; j < conflicts.size(); j++)
+        {
+            if (conflicts[j].first >= offset + size)
+                break;
+
+            offset = std::max(offset, conflicts[j].first + conflicts[j].second);
+        }
+
+        plan.offsets[s] = offset;
+        plan.sizes[s] = size;
+        placed.push_back(s);
+
+        plan.size = std::max(plan.size, offset + size);
+    }
+
+    for (int i = 0; i < blob_count; i++)
+    {
+        int s = storage[i];
+        if (!plannable[s])
+            continue;
+
+        plan.offsets[i] = plan.offsets[s];
+        plan.sizes[i] = plan.sizes[s];
+    }
+
+    return 0;
+}
+
+bool Net::find_memory_plan(const std::vector<int>& key, MemoryPlan& plan) const
+{
+    if (!memory_plan_cache)
+        return false;
+
+    MutexLockGuard guard(memory_plan_cache->lock);
+
+    std::vector<MemoryPlanCache::Entry>& entries = memory_plan_cache->entries;
+    for (size_t i = 0; i < entries.size(); i++)
+    {
+        if (entries[i].key != key)
+            continue;
+
+        plan = entries[i].plan;
+
+        // move to front
+        std::rotate(entries.begin(), entries.begin() + i, entries.begin() + i + 1);
+
+        return true;
+    }
+
+    return false;
+}
+
+void Net::add_memory_plan(const std::vector<int>& key, const std::vector<Mat>& shapes, int capacity) const
+{
+    if (!memory_plan_cache || capacity <= 0)
+        return;
+
+    MemoryPlanCache::Entry entry;
+    entry.key = key;
+    plan_memory(shapes, entry.plan);
+
+    MutexLockGuard guard(memory_plan_cache->lock);
+
+    std::vector<MemoryPlanCache::Entry>& entries = memory_plan_cache->entries;
+    for (size_t i = 0; i < entries.size(); i++)
+    {
+        // planned by another extractor meanwhile
+        if (entries[i].key == key)
+            return;
+    }
+
+    entries.insert(entries.begin(), entry);
+
+    // evict the least recently used
+    if ((int)entries.size() > capacity)
+        entries.resize(capacity);
+}
+
+int Net::build_schedule()
+{
+    const int layer_count = (int)layers.size();
+
+    layer_schedule.clear();
+    layer_schedule.reserve(layer_count);
+    schedule_positions.clear();
+
+    // kahn's algorithm, lowest layer index first so that a well ordered param keeps its order
+    std::vector<int> pending(layer_count, 0);
+    for (int i = 0; i < layer_count; i++)
+    {
+        const Layer* layer = layers[i];
+        for (size_t j = 0; j < layer->bottoms.size(); j++)
+        {
+            if (blobs[layer->bottoms[j]].producer != -1)
+                pending[i]++;
+        }
+    }
+
+    std::priority_queue<int, std::vector<int>, std::greater<int> > ready;
+    for (int i = 0; i < layer_count; i++)
+    {
+        if (pending[i] == 0)
+            ready.push(i);
+    }
+
+    while (!ready.empty())
+    {
+        int i = ready.top();
+        ready.pop();
+
+        layer_schedule.push_back(i);
+
+        const Layer* layer = layers[i];
+        for (size_t j = 0; j < layer->tops.size(); j++)
+        {
+            const Blob& blob = blobs[layer->tops[j]];
+            for (size_t k = 0; k < blob.consumers.size(); k++)
+            {
+                int consumer = blob.consumers[k];
+                if (--pending[consumer] == 0)
+                    ready.push(consumer);
+            }
+        }
+    }
+
+    if ((int)layer_schedule.size() != layer_count)
+    {
+        NCNN_LOGE("network graph has cycle");
+        layer_schedule.clear();
+        return -1;
+    }
+
+    schedule_positions.resize(layer_count);
+    for (int i = 0; i < layer_count; i++)
+    {
+        schedule_positions[layer_schedule[i]] = i;
+    }
+
+    return 0;
+}
+
+// the elempack of layers supporting packing
+static int packing_elempack()
+{
+#if __AVX__
+    return 8;
+#elif NCNN_RUNTIME_CPU
+    // layers run the avx2 build
+    return cpu_support_x86_avx2() ? 8 : 4;
+#else
+    return 4;
+#endif
+}
+
+static int static_elempack(const Mat& shape, bool support_packing)
+{
+    if (!support_packing)
+        return 1;
+
+    const int elempack = packing_elempack();
+
+    int size = shape.dims == 1 ? shape.w : shape.dims == 2 ? shape.h : shape.c;
+    return size % elempack == 0 ? elempack : 1;
+}
+
+// the layout forward_layer converts a bottom blob to before this layer
+static void required_layout(const Layer* layer, const Mat& shape, int elempack, int elembits, const Option& opt, int& out_elempack, int& out_elembits)
+{
+    out_elempack = opt.use_packing_layout ? static_elempack(shape, layer->support_packing) : elempack;
+    out_elembits = elembits;
+
+    if (opt.use_bf16_storage)
+    {
+        if (elembits == 32 && layer->support_bf16_storage)
+            out_elembits = 16;
+        if (elembits == 16 && !layer->support_bf16_storage)
+            out_elembits = 32;
+    }
+}
+
+// the layout this layer produces, 0 if only known at runtime
+static void produced_layout(const Layer* layer, const Mat& shape, int bottom_elempack, int bottom_elembits, const Option& opt, int& elempack, int& elembits)
+{
+    elempack = 0;
+    elembits = 0;
+
+    if (layer->typeindex == LayerType::Input)
+    {
+        // user feeds plain fp32 data
+        elempack = 1;
+        elembits = 32;
+        return;
+    }
+
+    if (layer->typeindex == LayerType::Split)
+    {
+        elempack = bottom_elempack;
+        elembits = bottom_elembits;
+        return;
+    }
+
+    // element type decided by layer param or int8 fusion
+    if (layer->typeindex == LayerType::Cast || layer->typeindex == LayerType::Packing || layer->typeindex == LayerType::Quantize || layer->typeindex == LayerType::Requantize)
+        return;
+    if (layer->typeindex == LayerType::Convolution && ((const Convolution*)layer)->use_int8_requantize)
+        return;
+    if (layer->typeindex == LayerType::ConvolutionDepthWise && ((const ConvolutionDepthWise*)layer)->use_int8_requantize)
+        return;
+    if (layer->typeindex == LayerType::InnerProduct && ((const InnerProduct*)layer)->use_int8_requantize)
+        return;
+    if (layer->typeindex == LayerType::Deconvolution && ((const Deconvolution*)layer)->use_int8_requantize)
+        return;
+
+    // relu keeps requantized int8 blobs int8
+    if (layer->typeindex == LayerType::ReLU && bottom_elempack == 0)
+        return;
+
+    if (shape.dims == 0)
+        return;
+
+    elempack = static_elempack(shape, opt.use_packing_layout && layer->support_packing);
+    elembits = opt.use_bf16_storage && layer->support_bf16_storage ? 16 : 32;
+}
+
+static Layer* create_layout_layer(int typeindex, int param0, int param1, const Mat& shape, const Option& opt)
+{
+    Layer* layer = create_layer(typeindex);
+    if (!layer)
+        return 0;
+
+    ParamDict pd;
+    pd.set(0, param0);
+    pd.set(1, param1);
+    layer->load_param(pd);
+
+    layer->bottom_shapes.resize(1, shape);
+    layer->top_shapes.resize(1, shape);
+
+    if (layer->create_pipeline(opt) != 0)
+    {
+        delete layer;
+        return 0;
+    }
+
+    return layer;
+}
+
+int Net::propagate_layout()
+{
+    blob_elempacks.clear();
+    blob_elembits.clear();
+    static_runtime_conversions = 0;
+    static_conversion_layers = 0;
+
+    if (!opt.use_packing_layout && !opt.use_bf16_storage)
+        return 0;
+
+    // blobs are modelled as fp32 or bf16 only, fp16 storage keeps x86 weights in fp16
+    // but may keep arm blobs in fp16 where asimdhp is present, leave those to runtime
+    if (opt.use_fp16_storage && cpu_support_arm_asimdhp())
+        return 0;
+
+#if NCNN_VULKAN
+    if (opt.use_vulkan_compute)
+        return 0;
+#endif // NCNN_VULKAN
+
+    const int layer_count = (int)layers.size();
+
+    // conversions forward_layer would do per inference on the original graph
+    int runtime_conversions = 0;
+    {
+        std::vector<int> elempacks(blobs.size(), 0);
+        std::vector<int> elembits(blobs.size(), 0);
+        for (int i = 0; i < layer_count; i++)
+        {
+            const Layer* layer = layers[i];
+
+            int bottom_elempack = 0;
+            int bottom_elembits = 0;
+            for (size_t j = 0; j < layer->bottoms.size(); j++)
+            {
+                int b = layer->bottoms[j];
+                if (elempacks[b] == 0 || blobs[b].shape.dims == 0)
+                    continue;
+
+                int rp;
+                int rb;
+                required_layout(layer, blobs[b].shape, elempacks[b], elembits[b], opt, rp, rb);
+                if (rp != elempacks[b] || rb != elembits[b])
+                    runtime_conversions++;
+
+                if (j == 0)
+                {
+                    bottom_elempack = rp;
+                    bottom_elembits = rb;
+                }
+            }
+
+            for (size_t j = 0; j < layer->tops.size(); j++)
+            {
+                int t = layer->tops[j];
+                produced_layout(layer, blobs[t].shape, bottom_elempack, bottom_elembits, opt, elempacks[t], elembits[t]);
+            }
+        }
+    }
+
+    blob_elempacks.resize(blobs.size(), 0);
+    blob_elembits.resize(blobs.size(), 0);
+
+    // conversion layers to run right before each layer
+    std::vector<std::vector<Layer*> > conversion_layers(layer_count);
+    int conversion_count = 0;
+
+    int ret = 0;
+    for (int i = 0; i < layer_count && ret == 0; i++)
+    {
+        Layer* layer = layers[i];
 
-                        //                         NCNN_LOGE("%s, %s, %s", layer->name.c_str(), layer_next->name.c_str(), layer_next_2->name.c_str());
-                        if (layer->type == "Convolution" && layer_next_2->type == "Convolution")
-                        {
-                            ((Convolution*)layer)->use_int8_requantize = true;
-                            ((Convolution*)layer)->top_blob_int8_scale = ((Convolution*)layer_next_2)->bottom_blob_int8_scale;
-                        }
-                        else if (layer->type == "ConvolutionDepthWise" && layer_next_2->type == "Convolution")
+        int bottom_elempack = 0;
+        int bottom_elembits = 0;
+        for (size_t j = 0; j < layer->bottoms.size(); j++)
+        {
+            int b = layer->bottoms[j];
+            int p = blob_elempacks[b];
+            int e = blob_elembits[b];
+            if (p == 0 || blobs[b].shape.dims == 0)
+                continue;
+
+            int rp = p;
+            int rb = e;
+            if (layer->typeindex == LayerType::Split)
+            {
+                // convert once before split if all consumers agree on the layout
+                bool unanimous = true;
+                int sp = 0;
+                int sb = 0;
+                for (size_t k = 0; k < layer->tops.size() && unanimous; k++)
+                {
+                    const Blob& top = blobs[layer->tops[k]];
+                    if (top.consumers.empty())
+                        unanimous = false;
+
+                    for (size_t n = 0; n < top.consumers.size() && unanimous; n++)
+                    {
+                        const Layer* consumer = layers[top.consumers[n]];
+                        if (consumer->typeindex == LayerType::Split)
                         {
-                            ((ConvolutionDepthWise*)layer)->use_int8_requantize = true;
-                            ((ConvolutionDepthWise*)layer)->top_blob_int8_scale = ((Convolution*)layer_next_2)->bottom_blob_int8_scale;
+                            unanimous = false;
+                            break;
                         }
-                        else if (layer->type == "Convolution" && layer_next_2->type == "ConvolutionDepthWise")
+
+                        int cp;
+                        int cb;
+                        required_layout(consumer, top.shape, p, e, opt, cp, cb);
+                        if (sp == 0)
                         {
-                            ((Convolution*)layer)->use_int8_requantize = true;
-                            ((Convolution*)layer)->top_blob_int8_scale = ((ConvolutionDepthWise*)layer_next_2)->bottom_blob_int8_scales[0];
+                            sp = cp;
+                            sb = cb;
                         }
-                        else
+                        else if (cp != sp || cb != sb)
                         {
-                            ((ConvolutionDepthWise*)layer)->use_int8_requantize = true;
-                            ((ConvolutionDepthWise*)layer)->top_blob_int8_scale = ((ConvolutionDepthWise*)layer_next_2)->bottom_blob_int8_scales[0];
+                            unanimous = false;
                         }
                     }
-                    else if (layer_next_2->type == "Split")
-                    {
-                        bool all_conv = true;
-                        for (size_t i = 0; i < layer_next_2->tops.size(); i++)
-                        {
-                            int layer_next_3_index = blobs[layer_next_2->tops[i]].consumers[0];
-                            if (layers[layer_next_3_index]->type != "Convolution" && layers[layer_next_3_index]->type != "ConvolutionDepthWise" && layers[layer_next_3_index]->type != "PriorBox")
-                            {
-                                // NCNN_LOGE("%s, %s, %s, %s", layer->name.c_str(), layer_next->name.c_str(), layer_next_2->name.c_str(), layers[layer_next_3_index]->name.c_str());
-                                all_conv = false;
-                            }
-                        }
-
-                        if (all_conv == true && layer_next_2->tops.size() >= size_t(2))
-                        {
-                            // NCNN_LOGE("%s, %s, %s, ", layer->name.c_str(), layer_next->name.c_str(), layer_next_2->name.c_str());
-                            for (size_t i = 0; i < layer_next_2->tops.size(); i++)
-                            {
-                                int layer_next_3_index = blobs[layer_next_2->tops[i]].consumers[0];
-                                Layer* layer_next_3 = layers[layer_next_3_index];
-
-                                // NCNN_LOGE("%s, ", layer_next_3->name.c_str());
-                                if (layer_next_3->type == "Convolution")
-                                {
-                                    ((Convolution*)layer)->top_blob_int8_scale = ((Convolution*)layer_next_3)->bottom_blob_int8_scale;
-                                }
-                            }
+                }
 
-                            ((Convolution*)layer)->use_int8_requantize = true;
-                            // NCNN_LOGE("");
-                        }
-                    }
-                    else
-                    {
-                        // NCNN_LOGE("%s, %s", layer->name.c_str(), layer_next->name.c_str());
-                    }
+                if (unanimous)
+                {
+                    rp = sp;
+                    rb = sb;
                 }
-                else if (layer_next->type == "Pooling")
+            }
+            else
+            {
+                required_layout(layer, blobs[b].shape, p, e, opt, rp, rb);
+            }
+
+            if (rb != e)
+            {
+                Layer* cast = create_layout_layer(LayerType::Cast, e == 32 ? 1 : 4, rb == 32 ? 1 : 4, blobs[b].shape, opt);
+                if (!cast)
                 {
-                    // ToDo
+                    ret = -1;
+                    break;
                 }
-                else
+
+                int c = (int)blobs.size();
+                blobs.push_back(Blob());
+                blobs[c].shape = blobs[b].shape;
+#if NCNN_STRING
+                blobs[c].name = blobs[b].name + (rb == 32 ? "_fp32" : "_bf16");
+                cast->type = "Cast";
+                cast->name = blobs[c].name;
+#endif // NCNN_STRING
+                cast->bottoms.push_back(b);
+                cast->tops.push_back(c);
+
+                blob_elempacks.push_back(p);
+                blob_elembits.push_back(rb);
+
+                conversion_layers[i].push_back(cast);
+                conversion_count++;
+                b = c;
+            }
+
+            if (rp != p)
+            {
+                Layer* packing = create_layout_layer(LayerType::Packing, rp, 0, blobs[b].shape, opt);
+                if (!packing)
                 {
-                    // NCNN_LOGE("%s", layer->name.c_str());
+                    ret = -1;
+                    break;
                 }
+
+                int c = (int)blobs.size();
+                blobs.push_back(Blob());
+                blobs[c].shape = blobs[b].shape;
+#if NCNN_STRING
+                char suffix[16];
+                sprintf(suffix, "_pack%d", rp);
+                blobs[c].name = blobs[b].name + suffix;
+                packing->type = "Packing";
+                packing->name = blobs[c].name;
+#endif // NCNN_STRING
+                packing->bottoms.push_back(b);
+                packing->tops.push_back(c);
+
+                blob_elempacks.push_back(rp);
+                blob_elembits.push_back(rb);
+
+                conversion_layers[i].push_back(packing);
+                conversion_count++;
+                b = c;
+            }
+
+            layer->bottoms[j] = b;
+
+            if (j == 0)
+            {
+                bottom_elempack = rp;
+                bottom_elembits = rb;
             }
         }
+
+        for (size_t j = 0; j < layer->tops.size(); j++)
+        {
+            int t = layer->tops[j];
+            produced_layout(layer, blobs[t].shape, bottom_elempack, bottom_elembits, opt, blob_elempacks[t], blob_elembits[t]);
+        }
     }
-#endif
+
+    // conversion layers go right before their consumer, keeping layers in topological order
+    std::vector<Layer*> sorted_layers;
+    for (int i = 0; i < layer_count; i++)
+    {
+        sorted_layers.insert(sorted_layers.end(), conversion_layers[i].begin(), conversion_layers[i].end());
+        sorted_layers.push_back(layers[i]);
+    }
+    layers = sorted_layers;
+
+    for (size_t i = 0; i < blobs.size(); i++)
+    {
+        blobs[i].producer = -1;
+        blobs[i].consumers.clear();
+    }
+
+    for (size_t i = 0; i < layers.size(); i++)
+    {
+        const Layer* layer = layers[i];
+        for (size_t j = 0; j < layer->bottoms.size(); j++)
+        {
+            blobs[layer->bottoms[j]].consumers.push_back((int)i);
+        }
+        for (size_t j = 0; j < layer->tops.size(); j++)
+        {
+            blobs[layer->tops[j]].producer = (int)i;
+        }
+    }
+
+    if (ret != 0)
+    {
+        // inserted layers stay valid, conversions fall back to runtime checks
+        NCNN_LOGE("propagate_layout failed to create conversion layer");
+        blob_elempacks.clear();
+        blob_elembits.clear();
+        return ret;
+    }
+
+    static_runtime_conversions = runtime_conversions;
+    static_conversion_layers = conversion_count;
+
     return 0;
 }
 
+int Net::runtime_conversion_count() const
+{
+    return static_runtime_conversions;
+}
+
+int Net::conversion_layer_count() const
+{
+    return static_conversion_layers;
+}
+
 void Net::clear()
 {
 #if NCNN_VULKAN
     destroy_pipeline();
 #endif // NCNN_VULKAN
 
+    delete thread_pool;
+    thread_pool = 0;
+
+    layer_schedule.clear();
+    schedule_positions.clear();
+
+    blob_elempacks.clear();
+    blob_elembits.clear();
+    static_runtime_conversions = 0;
+    static_conversion_layers = 0;
+
+    delete memory_plan;
+    memory_plan = 0;
+
+    delete memory_plan_cache;
+    memory_plan_cache = 0;
+
     blobs.clear();
     for (size_t i = 0; i < layers.size(); i++)
     {
@@ -894,6 +2450,19 @@ void Net::clear()
     }
     layers.clear();
 
+#if NCNN_STDIO
+    // unmap after the layers referencing it are gone
+    delete model_mmap;
+    model_mmap = 0;
+
+    pipeline_cache_weights.clear();
+    delete pipeline_cache_mmap;
+    pipeline_cache_mmap = 0;
+    pipeline_cache_weight_checksum = 0;
+#endif // NCNN_STDIO
+
+    weight_checksum = 0;
+
 #if NCNN_VULKAN
     if (weight_vkallocator)
     {
@@ -955,113 +2524,427 @@ int Net::upload_model()
             int uret = layers[i]->upload_model(cmd, opt_upload);
             if (uret != 0)
             {
-                NCNN_LOGE("layer upload_model %d failed", (int)i);
-                return -1;
+                NCNN_LOGE("layer upload_model %d failed", (int)i);
+                return -1;
+            }
+        }
+    }
+
+    cmd.submit_and_wait();
+
+    return 0;
+}
+
+int Net::create_pipeline()
+{
+    return 0;
+}
+
+int Net::destroy_pipeline()
+{
+    return 0;
+}
+#endif // NCNN_VULKAN
+
+#if NCNN_STRING
+int Net::find_blob_index_by_name(const char* name) const
+{
+    for (size_t i = 0; i < blobs.size(); i++)
+    {
+        const Blob& blob = blobs[i];
+        if (blob.name == name)
+        {
+            return static_cast<int>(i);
+        }
+    }
+
+    NCNN_LOGE("find_blob_index_by_name %s failed", name);
+    return -1;
+}
+
+int Net::find_layer_index_by_name(const char* name) const
+{
+    for (size_t i = 0; i < layers.size(); i++)
+    {
+        const Layer* layer = layers[i];
+        if (layer->name == name)
+        {
+            return static_cast<int>(i);
+        }
+    }
+
+    NCNN_LOGE("find_layer_index_by_name %s failed", name);
+    return -1;
+}
+
+int Net::custom_layer_to_index(const char* type)
+{
+    const size_t custom_layer_registry_entry_count = custom_layer_registry.size();
+    for (size_t i = 0; i < custom_layer_registry_entry_count; i++)
+    {
+        if (strcmp(type, custom_layer_registry[i].name) == 0)
+            return static_cast<int>(i);
+    }
+
+    return -1;
+}
+
+Layer* Net::create_custom_layer(const char* type)
+{
+    int index = custom_layer_to_index(type);
+    if (index == -1)
+        return 0;
+
+    return create_custom_layer(index);
+}
+#endif // NCNN_STRING
+
+Layer* Net::create_custom_layer(int index)
+{
+    const size_t custom_layer_registry_entry_count = custom_layer_registry.size();
+    if (index < 0 || static_cast<unsigned int>(index) >= custom_layer_registry_entry_count)
+        return 0;
+
+    layer_creator_func layer_creator = custom_layer_registry[index].creator;
+    if (!layer_creator)
+        return 0;
+
+    return layer_creator();
+}
+
+int Net::mark_needed_layers(int blob_index, const std::vector<Mat>& blob_mats, std::vector<unsigned char>& layer_needed, int& first, int& last) const
+{
+    if (layer_schedule.empty())
+    {
+        NCNN_LOGE("network graph not ready");
+        return -1;
+    }
+
+    const int producer = blobs[blob_index].producer;
+    if (producer == -1)
+    {
+        NCNN_LOGE("blob %d has no producer", blob_index);
+        return -1;
+    }
+
+    // walk the schedule backward from the producer
+    // a layer is needed if it produces a missing blob that is requested or taken by a needed layer
+    layer_needed.assign(layers.size(), 0);
+
+    last = schedule_positions[producer];
+    first = last + 1;
+    for (int i = last; i >= 0; i--)
+    {
+        const int layer_index = layer_schedule[i];
+        const Layer* layer = layers[layer_index];
+
+        bool needed = false;
+        for (size_t j = 0; j < layer->tops.size() && !needed; j++)
+        {
+            int top_blob_index = layer->tops[j];
+            if (blob_mats[top_blob_index].dims != 0)
+                continue;
+
+            if (top_blob_index == blob_index)
+            {
+                needed = true;
+                break;
+            }
+
+            const Blob& blob = blobs[top_blob_index];
+            for (size_t k = 0; k < blob.consumers.size(); k++)
+            {
+                if (layer_needed[blob.consumers[k]])
+                {
+                    needed = true;
+                    break;
+                }
+            }
+        }
+
+        if (!needed)
+            continue;
+
+        if (layer->typeindex == LayerType::Input)
+        {
+            NCNN_LOGE("input blob %d not set", layer->tops[0]);
+            return -100;
+        }
+
+        layer_needed[layer_index] = 1;
+        first = i;
+    }
+
+    return 0;
+}
+
+int Net::forward_schedule(int blob_index, std::vector<Mat>& blob_mats, std::vector<unsigned char>& layer_needed, ArenaAllocator* arena, const MemoryPlan* plan, std::vector<Mat>* shapes, const Option& opt) const
+{
+    int first = 0;
+    int last = -1;
+    int ret = mark_needed_layers(blob_index, blob_mats, layer_needed, first, last);
+    if (ret != 0)
+        return ret;
+
+    if (thread_pool && opt.num_inter_threads > 1)
+    {
+        return forward_parallel(first, last, blob_mats, layer_needed, opt);
+    }
+
+    for (int i = first; i <= last; i++)
+    {
+        const int layer_index = layer_schedule[i];
+        if (!layer_needed[layer_index])
+            continue;
+
+        int ret = forward_layer(layer_index, blob_mats, arena, plan, opt);
+        if (ret != 0)
+            return ret;
+
+        if (shapes)
+        {
+            const Layer* layer = layers[layer_index];
+            for (size_t j = 0; j < layer->tops.size(); j++)
+            {
+                int top_blob_index = layer->tops[j];
+                (*shapes)[top_blob_index] = unpacked_shape(blob_mats[top_blob_index]);
+            }
+        }
+    }
+
+    return 0;
+}
+
+int Net::forward_schedule_batch(int blob_index, std::vector<std::vector<Mat> >& batch_blob_mats, std::vector<unsigned char>& layer_needed, const Option& opt) const
+{
+    // samples of a batch move in lockstep, the first one tells what is missing
+    int first = 0;
+    int last = -1;
+    int ret = mark_needed_layers(blob_index, batch_blob_mats[0], layer_needed, first, last);
+    if (ret != 0)
+        return ret;
+
+    for (int i = first; i <= last; i++)
+    {
+        const int layer_index = layer_schedule[i];
+        if (!layer_needed[layer_index])
+            continue;
+
+        ret = forward_layer_batch(layer_index, batch_blob_mats, opt);
+        if (ret != 0)
+            return ret;
+    }
+
+    return 0;
+}
+
+struct ParallelForwardContext
+{
+    const Net* net;
+    std::vector<Mat>* blob_mats;
+    const std::vector<unsigned char>* layer_needed;
+    const Option* opt;
+    ThreadPool* thread_pool;
+
+    Mutex lock;
+    ConditionVariable condition;
+
+    // unfinished needed producers of each layer
+    std::vector<int> pending;
+    // submitted layers not done yet
+    int running;
+    // bumped whenever a layer is done
+    int generation;
+    int ret;
+};
+
+void Net::forward_parallel_task(void* _ctx, int layer_index)
+{
+    ParallelForwardContext* ctx = (ParallelForwardContext*)_ctx;
+    const Net* net = ctx->net;
+    ThreadPool* thread_pool = ctx->thread_pool;
+
+    bind_numa_node(ctx->opt->numa_node);
+
+    std::vector<int> ready;
+    while (layer_index != -1)
+    {
+        ctx->lock.lock();
+        bool failed = ctx->ret != 0;
+        ctx->lock.unlock();
+
+        int ret = failed ? 0 : net->forward_layer(layer_index, *ctx->blob_mats, 0, 0, *ctx->opt);
+
+        ready.clear();
+
+        ctx->lock.lock();
+
+        if (ret != 0 && ctx->ret == 0)
+            ctx->ret = ret;
+
+        if (ctx->ret == 0)
+        {
+            const Layer* layer = net->layers[layer_index];
+            for (size_t i = 0; i < layer->tops.size(); i++)
+            {
+                const Blob& blob = net->blobs[layer->tops[i]];
+                for (size_t j = 0; j < blob.consumers.size(); j++)
+                {
+                    int consumer = blob.consumers[j];
+                    if ((*ctx->layer_needed)[consumer] && --ctx->pending[consumer] == 0)
+                        ready.push_back(consumer);
+                }
             }
         }
-    }
 
-    cmd.submit_and_wait();
+        // keep the first ready consumer on this thread, it likely reads what we just wrote
+        layer_index = ready.empty() ? -1 : ready[0];
+        ctx->running += ready.empty() ? -1 : (int)ready.size() - 1;
 
-    return 0;
-}
+        ctx->generation++;
+        ctx->condition.broadcast();
 
-int Net::create_pipeline()
-{
-    return 0;
-}
+        // ctx may be gone once running drops to zero and the lock is released
+        ctx->lock.unlock();
 
-int Net::destroy_pipeline()
-{
-    return 0;
+        for (size_t i = 1; i < ready.size(); i++)
+        {
+            thread_pool->submit(forward_parallel_task, ctx, ready[i]);
+        }
+    }
 }
-#endif // NCNN_VULKAN
 
-#if NCNN_STRING
-int Net::find_blob_index_by_name(const char* name) const
+int Net::forward_parallel(int first, int last, std::vector<Mat>& blob_mats, const std::vector<unsigned char>& layer_needed, const Option& opt) const
 {
-    for (size_t i = 0; i < blobs.size(); i++)
+    ParallelForwardContext ctx;
+    ctx.net = this;
+    ctx.blob_mats = &blob_mats;
+    ctx.layer_needed = &layer_needed;
+    ctx.opt = &opt;
+    ctx.thread_pool = thread_pool;
+    ctx.pending.resize(layers.size(), 0);
+    ctx.running = 0;
+    ctx.generation = 0;
+    ctx.ret = 0;
+
+    std::vector<int> roots;
+    for (int i = first; i <= last; i++)
     {
-        const Blob& blob = blobs[i];
-        if (blob.name == name)
+        const int layer_index = layer_schedule[i];
+        if (!layer_needed[layer_index])
+            continue;
+
+        const Layer* layer = layers[layer_index];
+        for (size_t j = 0; j < layer->bottoms.size(); j++)
         {
-            return static_cast<int>(i);
+            int producer = blobs[layer->bottoms[j]].producer;
+            if (producer != -1 && layer_needed[producer])
+                ctx.pending[layer_index]++;
         }
+
+        if (ctx.pending[layer_index] == 0)
+            roots.push_back(layer_index);
     }
 
-    NCNN_LOGE("find_blob_index_by_name %s failed", name);
-    return -1;
-}
+    ctx.running = (int)roots.size();
+    for (size_t i = 0; i < roots.size(); i++)
+    {
+        thread_pool->submit(forward_parallel_task, &ctx, roots[i]);
+    }
 
-int Net::find_layer_index_by_name(const char* name) const
-{
-    for (size_t i = 0; i < layers.size(); i++)
+    // help with queued layers until every branch is done
+    ctx.lock.lock();
+    while (ctx.running > 0)
     {
-        const Layer* layer = layers[i];
-        if (layer->name == name)
+        int generation = ctx.generation;
+        ctx.lock.unlock();
+
+        bool ran = thread_pool->run_one();
+
+        ctx.lock.lock();
+        if (!ran && ctx.running > 0 && ctx.generation == generation)
         {
-            return static_cast<int>(i);
+            ctx.condition.wait(ctx.lock);
         }
     }
+    ctx.lock.unlock();
 
-    NCNN_LOGE("find_layer_index_by_name %s failed", name);
-    return -1;
+    return ctx.ret;
 }
 
-int Net::custom_layer_to_index(const char* type)
+bool Net::static_layout_matched(int blob_index, const Mat& m) const
 {
-    const size_t custom_layer_registry_entry_count = custom_layer_registry.size();
-    for (size_t i = 0; i < custom_layer_registry_entry_count; i++)
-    {
-        if (strcmp(type, custom_layer_registry[i].name) == 0)
-            return static_cast<int>(i);
-    }
+    if (blob_elempacks.empty() || blob_elempacks[blob_index] == 0)
+        return false;
 
-    return -1;
+    return m.elempack == blob_elempacks[blob_index] && (int)(m.elemsize * 8 / m.elempack) == blob_elembits[blob_index];
 }
 
-Layer* Net::create_custom_layer(const char* type)
+void Net::convert_bottom_layout(const Layer* layer, int bottom_blob_index, Mat& bottom_blob, const Option& opt) const
 {
-    int index = custom_layer_to_index(type);
-    if (index == -1)
-        return 0;
+    // the layout fixed at load time comes from shape hints, convert as usual unless the blob really has it
+    if (static_layout_matched(bottom_blob_index, bottom_blob))
+        return;
 
-    return create_custom_layer(index);
+    if (opt.use_bf16_storage)
+    {
+        if (bottom_blob.elemsize / bottom_blob.elempack == 4u && layer->support_bf16_storage)
+        {
+            Mat bottom_blob_bf16;
+            cast_float32_to_bfloat16(bottom_blob, bottom_blob_bf16, opt);
+            bottom_blob = bottom_blob_bf16;
+        }
+        if (bottom_blob.elemsize / bottom_blob.elempack == 2u && !layer->support_bf16_storage)
+        {
+            Mat bottom_blob_fp32;
+            cast_bfloat16_to_float32(bottom_blob, bottom_blob_fp32, opt);
+            bottom_blob = bottom_blob_fp32;
+        }
+    }
+
+    if (opt.use_packing_layout)
+    {
+        int elempack = layer->support_packing ? packing_elempack() : 1;
+
+        Mat bottom_blob_packed;
+        convert_packing(bottom_blob, bottom_blob_packed, elempack, opt);
+        bottom_blob = bottom_blob_packed;
+    }
 }
-#endif // NCNN_STRING
 
-Layer* Net::create_custom_layer(int index)
+int Net::forward_layer(int layer_index, std::vector<Mat>& blob_mats, ArenaAllocator* arena, const MemoryPlan* plan, const Option& opt) const
 {
-    const size_t custom_layer_registry_entry_count = custom_layer_registry.size();
-    if (index < 0 || static_cast<unsigned int>(index) >= custom_layer_registry_entry_count)
-        return 0;
+    if (!opt.profiler)
+        return run_layer(layer_index, blob_mats, arena, plan, opt, 0);
 
-    layer_creator_func layer_creator = custom_layer_registry[index].creator;
-    if (!layer_creator)
-        return 0;
+    // the workspace of a profiled run goes through a counter of its own
+    // so layers running at once on inter-op threads are counted apart
+    Profiler::CountingAllocator workspace_counter(opt.workspace_allocator);
 
-    return layer_creator();
+    Option opt_counted = opt;
+    opt_counted.workspace_allocator = &workspace_counter;
+
+    return run_layer(layer_index, blob_mats, arena, plan, opt_counted, &workspace_counter);
 }
 
-int Net::forward_layer(int layer_index, std::vector<Mat>& blob_mats, const Option& opt) const
+int Net::run_layer(int layer_index, std::vector<Mat>& blob_mats, ArenaAllocator* arena, const MemoryPlan* plan, const Option& opt, const Profiler::CountingAllocator* workspace_counter) const
 {
     const Layer* layer = layers[layer_index];
 
     //     NCNN_LOGE("forward_layer %d %s", layer_index, layer->name.c_str());
 
+    LayerProfile lp;
+    if (opt.profiler)
+    {
+        opt.profiler->begin(lp, layer, layer_index);
+    }
+
     if (layer->one_blob_only)
     {
         // load bottom blob
         int bottom_blob_index = layer->bottoms[0];
         int top_blob_index = layer->tops[0];
 
-        if (blob_mats[bottom_blob_index].dims == 0)
-        {
-            int ret = forward_layer(blobs[bottom_blob_index].producer, blob_mats, opt);
-            if (ret != 0)
-                return ret;
-        }
-
         Mat bottom_blob = blob_mats[bottom_blob_index];
 
         if (opt.lightmode)
@@ -1075,33 +2958,11 @@ int Net::forward_layer(int layer_index, std::vector<Mat>& blob_mats, const Optio
             }
         }
 
-        if (opt.use_bf16_storage)
-        {
-            if (bottom_blob.elemsize / bottom_blob.elempack == 4u && layer->support_bf16_storage)
-            {
-                Mat bottom_blob_bf16;
-                cast_float32_to_bfloat16(bottom_blob, bottom_blob_bf16, opt);
-                bottom_blob = bottom_blob_bf16;
-            }
-            if (bottom_blob.elemsize / bottom_blob.elempack == 2u && !layer->support_bf16_storage)
-            {
-                Mat bottom_blob_fp32;
-                cast_bfloat16_to_float32(bottom_blob, bottom_blob_fp32, opt);
-                bottom_blob = bottom_blob_fp32;
-            }
-        }
+        convert_bottom_layout(layer, bottom_blob_index, bottom_blob, opt);
 
-        if (opt.use_packing_layout)
+        if (opt.profiler)
         {
-#if __AVX__
-            int elempack = layer->support_packing ? 8 : 1;
-#else
-            int elempack = layer->support_packing ? 4 : 1;
-#endif
-
-            Mat bottom_blob_packed;
-            convert_packing(bottom_blob, bottom_blob_packed, elempack, opt);
-            bottom_blob = bottom_blob_packed;
+            opt.profiler->converted(lp);
         }
 
         // forward
@@ -1119,11 +2980,21 @@ int Net::forward_layer(int layer_index, std::vector<Mat>& blob_mats, const Optio
             if (ret != 0)
                 return ret;
 
+            if (opt.profiler)
+            {
+                opt.profiler->end(lp, workspace_counter, std::vector<Mat>(1, bottom_top_blob), std::vector<Mat>(1, bottom_top_blob));
+            }
+
             // store top blob
             blob_mats[top_blob_index] = bottom_top_blob;
         }
         else
         {
+            if (arena && plan->sizes[top_blob_index])
+            {
+                arena->push_planned(plan->offsets[top_blob_index], plan->sizes[top_blob_index]);
+            }
+
             Mat top_blob;
 #if NCNN_BENCHMARK
             double start = get_current_time();
@@ -1133,9 +3004,18 @@ int Net::forward_layer(int layer_index, std::vector<Mat>& blob_mats, const Optio
 #else
             int ret = layer->forward(bottom_blob, top_blob, opt);
 #endif // NCNN_BENCHMARK
+            if (arena)
+            {
+                arena->clear_planned();
+            }
             if (ret != 0)
                 return ret;
 
+            if (opt.profiler)
+            {
+                opt.profiler->end(lp, workspace_counter, std::vector<Mat>(1, bottom_blob), std::vector<Mat>(1, top_blob));
+            }
+
             // store top blob
             blob_mats[top_blob_index] = top_blob;
         }
@@ -1148,13 +3028,6 @@ int Net::forward_layer(int layer_index, std::vector<Mat>& blob_mats, const Optio
         {
             int bottom_blob_index = layer->bottoms[i];
 
-            if (blob_mats[bottom_blob_index].dims == 0)
-            {
-                int ret = forward_layer(blobs[bottom_blob_index].producer, blob_mats, opt);
-                if (ret != 0)
-                    return ret;
-            }
-
             bottom_blobs[i] = blob_mats[bottom_blob_index];
 
             if (opt.lightmode)
@@ -1168,34 +3041,12 @@ int Net::forward_layer(int layer_index, std::vector<Mat>& blob_mats, const Optio
                 }
             }
 
-            if (opt.use_bf16_storage)
-            {
-                if (bottom_blobs[i].elemsize / bottom_blobs[i].elempack == 4u && layer->support_bf16_storage)
-                {
-                    Mat bottom_blob_bf16;
-                    cast_float32_to_bfloat16(bottom_blobs[i], bottom_blob_bf16, opt);
-                    bottom_blobs[i] = bottom_blob_bf16;
-                }
-                if (bottom_blobs[i].elemsize / bottom_blobs[i].elempack == 2u && !layer->support_bf16_storage)
-                {
-                    Mat bottom_blob_fp32;
-                    cast_bfloat16_to_float32(bottom_blobs[i], bottom_blob_fp32, opt);
-                    bottom_blobs[i] = bottom_blob_fp32;
-                }
-            }
-
-            if (opt.use_packing_layout)
-            {
-#if __AVX__
-                int elempack = layer->support_packing ? 8 : 1;
-#else
-                int elempack = layer->support_packing ? 4 : 1;
-#endif
+            convert_bottom_layout(layer, bottom_blob_index, bottom_blobs[i], opt);
+        }
 
-                Mat bottom_blob_packed;
-                convert_packing(bottom_blobs[i], bottom_blob_packed, elempack, opt);
-                bottom_blobs[i] = bottom_blob_packed;
-            }
+        if (opt.profiler)
+        {
+            opt.profiler->converted(lp);
         }
 
         // forward
@@ -1213,6 +3064,11 @@ int Net::forward_layer(int layer_index, std::vector<Mat>& blob_mats, const Optio
             if (ret != 0)
                 return ret;
 
+            if (opt.profiler)
+            {
+                opt.profiler->end(lp, workspace_counter, bottom_top_blobs, bottom_top_blobs);
+            }
+
             // store top blobs
             for (size_t i = 0; i < layer->tops.size(); i++)
             {
@@ -1223,6 +3079,18 @@ int Net::forward_layer(int layer_index, std::vector<Mat>& blob_mats, const Optio
         }
         else
         {
+            if (arena)
+            {
+                for (size_t i = 0; i < layer->tops.size(); i++)
+                {
+                    int top_blob_index = layer->tops[i];
+                    if (plan->sizes[top_blob_index])
+                    {
+                        arena->push_planned(plan->offsets[top_blob_index], plan->sizes[top_blob_index]);
+                    }
+                }
+            }
+
             std::vector<Mat> top_blobs(layer->tops.size());
 #if NCNN_BENCHMARK
             double start = get_current_time();
@@ -1232,9 +3100,18 @@ int Net::forward_layer(int layer_index, std::vector<Mat>& blob_mats, const Optio
 #else
             int ret = layer->forward(bottom_blobs, top_blobs, opt);
 #endif // NCNN_BENCHMARK
+            if (arena)
+            {
+                arena->clear_planned();
+            }
             if (ret != 0)
                 return ret;
 
+            if (opt.profiler)
+            {
+                opt.profiler->end(lp, workspace_counter, bottom_blobs, top_blobs);
+            }
+
             // store top blobs
             for (size_t i = 0; i < layer->tops.size(); i++)
             {
@@ -1252,6 +3129,95 @@ int Net::forward_layer(int layer_index, std::vector<Mat>& blob_mats, const Optio
     return 0;
 }
 
+int Net::forward_layer_batch(int layer_index, std::vector<std::vector<Mat> >& batch_blob_mats, const Option& opt) const
+{
+    const Layer* layer = layers[layer_index];
+    const int batch = (int)batch_blob_mats.size();
+
+    const bool one_blob = layer->one_blob_only || (layer->bottoms.size() == 1 && layer->tops.size() == 1);
+    if (!layer->support_batch || !one_blob || (opt.lightmode && layer->support_inplace))
+    {
+        // run the samples one by one
+        for (int n = 0; n < batch; n++)
+        {
+            int ret = forward_layer(layer_index, batch_blob_mats[n], 0, 0, opt);
+            if (ret != 0)
+                return ret;
+        }
+
+        return 0;
+    }
+
+    if (!opt.profiler)
+        return run_layer_batch(layer_index, batch_blob_mats, opt, 0);
+
+    Profiler::CountingAllocator workspace_counter(opt.workspace_allocator);
+
+    Option opt_counted = opt;
+    opt_counted.workspace_allocator = &workspace_counter;
+
+    return run_layer_batch(layer_index, batch_blob_mats, opt_counted, &workspace_counter);
+}
+
+int Net::run_layer_batch(int layer_index, std::vector<std::vector<Mat> >& batch_blob_mats, const Option& opt, const Profiler::CountingAllocator* workspace_counter) const
+{
+    const Layer* layer = layers[layer_index];
+    const int batch = (int)batch_blob_mats.size();
+
+    LayerProfile lp;
+    if (opt.profiler)
+    {
+        opt.profiler->begin(lp, layer, layer_index);
+    }
+
+    int bottom_blob_index = layer->bottoms[0];
+    int top_blob_index = layer->tops[0];
+
+    std::vector<Mat> bottom_blobs(batch);
+    for (int n = 0; n < batch; n++)
+    {
+        bottom_blobs[n] = batch_blob_mats[n][bottom_blob_index];
+
+        if (opt.lightmode)
+        {
+            // delete after taken in light mode
+            batch_blob_mats[n][bottom_blob_index].release();
+        }
+
+        convert_bottom_layout(layer, bottom_blob_index, bottom_blobs[n], opt);
+    }
+
+    if (opt.profiler)
+    {
+        opt.profiler->converted(lp);
+    }
+
+    std::vector<Mat> top_blobs(batch);
+#if NCNN_BENCHMARK
+    double start = get_current_time();
+    int ret = layer->forward_batch(bottom_blobs, top_blobs, opt);
+    double end = get_current_time();
+    benchmark(layer, bottom_blobs[0], top_blobs[0], start, end);
+#else
+    int ret = layer->forward_batch(bottom_blobs, top_blobs, opt);
+#endif // NCNN_BENCHMARK
+    if (ret != 0)
+        return ret;
+
+    if (opt.profiler)
+    {
+        opt.profiler->end(lp, workspace_counter, bottom_blobs, top_blobs);
+    }
+
+    // store top blobs
+    for (int n = 0; n < batch; n++)
+    {
+        batch_blob_mats[n][top_blob_index] = top_blobs[n];
+    }
+
+    return 0;
+}
+
 #if NCNN_VULKAN
 int Net::forward_layer(int layer_index, std::vector<Mat>& blob_mats, std::vector<VkMat>& blob_mats_gpu, VkCompute& cmd, const Option& opt) const
 {
@@ -2399,6 +4365,11 @@ Extractor::Extractor(const Net* _net, size_t blob_count)
     blob_mats.resize(blob_count);
     opt = net->opt;
 
+    arena_allocator = 0;
+    arena_size = 0;
+    memory_plan_matched = true;
+    shape_plan = 0;
+
 #if NCNN_VULKAN
     if (net->opt.use_vulkan_compute)
     {
@@ -2415,6 +4386,55 @@ Extractor::~Extractor()
 {
     blob_mats.clear();
 
+    delete arena_allocator;
+    delete shape_plan;
+
+#if NCNN_VULKAN
+    if (net->opt.use_vulkan_compute)
+    {
+        blob_mats_gpu.clear();
+        blob_mats_gpu_image.clear();
+
+        if (local_blob_vkallocator)
+        {
+            net->vkdev->reclaim_blob_allocator(local_blob_vkallocator);
+        }
+        if (local_staging_vkallocator)
+        {
+            net->vkdev->reclaim_staging_allocator(local_staging_vkallocator);
+        }
+    }
+#endif // NCNN_VULKAN
+}
+
+Extractor::Extractor(const Extractor& other)
+    : net(other.net)
+{
+    arena_allocator = 0;
+    shape_plan = 0;
+
+#if NCNN_VULKAN
+    local_blob_vkallocator = 0;
+    local_staging_vkallocator = 0;
+#endif // NCNN_VULKAN
+
+    copy_from(other);
+}
+
+Extractor& Extractor::operator=(const Extractor& other)
+{
+    if (this == &other)
+        return *this;
+
+    // blobs of our arena must go before the arena does
+    blob_mats.clear();
+    batch_blob_mats.clear();
+
+    delete arena_allocator;
+    arena_allocator = 0;
+    delete shape_plan;
+    shape_plan = 0;
+
 #if NCNN_VULKAN
     if (net->opt.use_vulkan_compute)
     {
@@ -2430,6 +4450,51 @@ Extractor::~Extractor()
             net->vkdev->reclaim_staging_allocator(local_staging_vkallocator);
         }
     }
+
+    local_blob_vkallocator = 0;
+    local_staging_vkallocator = 0;
+#endif // NCNN_VULKAN
+
+    net = other.net;
+    copy_from(other);
+
+    return *this;
+}
+
+void Extractor::copy_from(const Extractor& other)
+{
+    blob_mats = other.blob_mats;
+    opt = other.opt;
+
+    for (size_t i = 0; i < blob_mats.size(); i++)
+    {
+        // the arena of other is recycled by its next forward and dies with it
+        if (other.arena_allocator && blob_mats[i].allocator == other.arena_allocator)
+        {
+            blob_mats[i] = blob_mats[i].clone(opt.blob_allocator);
+        }
+    }
+
+    arena_size = 0;
+    memory_plan_matched = other.memory_plan_matched;
+    input_shapes = other.input_shapes;
+    shape_plan_key.clear();
+    layer_needed = other.layer_needed;
+    batch_blob_mats = other.batch_blob_mats;
+
+#if NCNN_VULKAN
+    // the local allocators of other are handed back when it dies
+    if (other.local_blob_vkallocator && opt.blob_vkallocator == other.local_blob_vkallocator)
+    {
+        opt.blob_vkallocator = net->opt.blob_vkallocator;
+    }
+    if (other.local_staging_vkallocator && opt.staging_vkallocator == other.local_staging_vkallocator)
+    {
+        opt.staging_vkallocator = net->opt.staging_vkallocator;
+    }
+
+    blob_mats_gpu = other.blob_mats_gpu;
+    blob_mats_gpu_image = other.blob_mats_gpu_image;
 #endif // NCNN_VULKAN
 }
 
@@ -2443,14 +4508,50 @@ void Extractor::set_num_threads(int num_threads)
     opt.num_threads = num_threads;
 }
 
-void Extractor::set_blob_allocator(Allocator* allocator)
+void Extractor::set_blob_allocator(Allocator* allocator)
+{
+    opt.blob_allocator = allocator;
+}
+
+void Extractor::set_workspace_allocator(Allocator* allocator)
+{
+    opt.workspace_allocator = allocator;
+}
+
+void Extractor::set_profiler(Profiler* profiler)
 {
-    opt.blob_allocator = allocator;
+    opt.profiler = profiler;
 }
 
-void Extractor::set_workspace_allocator(Allocator* allocator)
+void Extractor::clear()
 {
-    opt.workspace_allocator = allocator;
+    for (size_t i = 0; i < blob_mats.size(); i++)
+    {
+        blob_mats[i].release();
+    }
+
+    // the next request may come with another batch size
+    batch_blob_mats.clear();
+
+    memory_plan_matched = true;
+    input_shapes.clear();
+
+    if (arena_allocator)
+    {
+        arena_allocator->clear_planned();
+    }
+
+#if NCNN_VULKAN
+    for (size_t i = 0; i < blob_mats_gpu.size(); i++)
+    {
+        blob_mats_gpu[i].release();
+    }
+
+    for (size_t i = 0; i < blob_mats_gpu_image.size(); i++)
+    {
+        blob_mats_gpu_image[i].release();
+    }
+#endif // NCNN_VULKAN
 }
 
 #if NCNN_VULKAN
@@ -2500,13 +4601,65 @@ int Extractor::extract(const char* blob_name, Mat& feat)
 
     return extract(blob_index, feat);
 }
+
+int Extractor::input_batch(const char* blob_name, const std::vector<Mat>& ins)
+{
+    int blob_index = net->find_blob_index_by_name(blob_name);
+    if (blob_index == -1)
+        return -1;
+
+    return input_batch(blob_index, ins);
+}
+
+int Extractor::extract_batch(const char* blob_name, std::vector<Mat>& feats)
+{
+    int blob_index = net->find_blob_index_by_name(blob_name);
+    if (blob_index == -1)
+        return -1;
+
+    return extract_batch(blob_index, feats);
+}
 #endif // NCNN_STRING
 
-int Extractor::input(int blob_index, const Mat& in)
+int Extractor::input(int blob_index, const Mat& _in)
 {
     if (blob_index < 0 || blob_index >= (int)blob_mats.size())
         return -1;
 
+    Mat in = _in;
+    if (opt.shape_bucket_size > 1 && in.dims == 3)
+    {
+        // pad right and bottom up to the bucket so that nearby sizes share one memory plan
+        const int bucket = opt.shape_bucket_size;
+        int wpad = (in.w + bucket - 1) / bucket * bucket - in.w;
+        int hpad = (in.h + bucket - 1) / bucket * bucket - in.h;
+        if (wpad > 0 || hpad > 0)
+        {
+            copy_make_border(_in, in, 0, hpad, 0, wpad, BORDER_CONSTANT, 0.f, opt);
+            if (in.empty())
+                return -100;
+        }
+    }
+
+    // the memory plan only holds for the hinted input shape
+    const Mat& shape = net->blobs[blob_index].shape;
+    if (shape.dims != 0 && (shape.dims != in.dims || shape.w != in.w || shape.h != in.h || shape.c != in.c * in.elempack))
+    {
+        memory_plan_matched = false;
+    }
+
+    // memory plan cache key, one group per input blob
+    const int key[7] = {blob_index, in.dims, in.w, in.h, in.c, in.elempack, (int)in.elemsize};
+    size_t i = 0;
+    for (; i < input_shapes.size(); i += 7)
+    {
+        if (input_shapes[i] == blob_index)
+            break;
+    }
+    if (i == input_shapes.size())
+        input_shapes.resize(i + 7);
+    std::copy(key, key + 7, input_shapes.begin() + i);
+
     blob_mats[blob_index] = in;
 
     return 0;
@@ -2521,8 +4674,6 @@ int Extractor::extract(int blob_index, Mat& feat)
 
     if (blob_mats[blob_index].dims == 0)
     {
-        int layer_index = net->blobs[blob_index].producer;
-
 #if NCNN_VULKAN
         if (opt.use_vulkan_compute)
         {
@@ -2605,10 +4756,10 @@ int Extractor::extract(int blob_index, Mat& feat)
         }
         else
         {
-            ret = net->forward_layer(layer_index, blob_mats, opt);
+            ret = forward_cpu(blob_index);
         }
 #else
-        ret = net->forward_layer(layer_index, blob_mats, opt);
+        ret = forward_cpu(blob_index);
 #endif // NCNN_VULKAN
     }
 
@@ -2621,9 +4772,415 @@ int Extractor::extract(int blob_index, Mat& feat)
         feat = bottom_blob_unpacked;
     }
 
+    if (arena_allocator && feat.allocator == arena_allocator)
+    {
+        // arena memory is recycled by the following forward and dies with this extractor
+        feat = feat.clone(opt.blob_allocator);
+    }
+
+    return ret;
+}
+
+int Extractor::input_batch(int blob_index, const std::vector<Mat>& ins)
+{
+    if (blob_index < 0 || blob_index >= (int)blob_mats.size())
+        return -1;
+
+    if (ins.empty())
+        return -1;
+
+    if (batch_blob_mats.empty())
+    {
+        batch_blob_mats.resize(ins.size(), std::vector<Mat>(blob_mats.size()));
+    }
+
+    if (batch_blob_mats.size() != ins.size())
+    {
+        NCNN_LOGE("batch size %d mismatch, expect %d", (int)ins.size(), (int)batch_blob_mats.size());
+        return -1;
+    }
+
+    for (size_t n = 0; n < ins.size(); n++)
+    {
+        batch_blob_mats[n][blob_index] = ins[n];
+    }
+
+    return 0;
+}
+
+int Extractor::extract_batch(int blob_index, std::vector<Mat>& feats)
+{
+    if (blob_index < 0 || blob_index >= (int)blob_mats.size())
+        return -1;
+
+    if (batch_blob_mats.empty())
+    {
+        NCNN_LOGE("batch input not set");
+        return -1;
+    }
+
+    int ret = 0;
+
+    if (batch_blob_mats[0][blob_index].dims == 0)
+    {
+        NumaNodeScope numa_scope(opt.numa_node);
+
+        ret = net->forward_schedule_batch(blob_index, batch_blob_mats, layer_needed, opt);
+    }
+
+    const int batch = (int)batch_blob_mats.size();
+    feats.resize(batch);
+    for (int n = 0; n < batch; n++)
+    {
+        feats[n] = batch_blob_mats[n][blob_index];
+
+        if (opt.use_packing_layout)
+        {
+            Mat bottom_blob_unpacked;
+            convert_packing(feats[n], bottom_blob_unpacked, 1, opt);
+            feats[n] = bottom_blob_unpacked;
+        }
+    }
+
+    return ret;
+}
+
+int Extractor::forward_cpu(int blob_index)
+{
+    NumaNodeScope numa_scope(opt.numa_node);
+
+    // the plan assumes layers run one after another
+    if (!opt.use_memory_plan || opt.num_inter_threads > 1)
+    {
+        return net->forward_schedule(blob_index, blob_mats, layer_needed, 0, 0, 0, opt);
+    }
+
+    const MemoryPlan* plan = 0;
+    if (memory_plan_matched && net->memory_plan && net->memory_plan->size != 0)
+    {
+        plan = net->memory_plan;
+    }
+    else if (opt.memory_plan_cache_size > 0)
+    {
+        if (!shape_plan || shape_plan_key != input_shapes)
+        {
+            if (!shape_plan)
+                shape_plan = new MemoryPlan;
+
+            if (!net->find_memory_plan(input_shapes, *shape_plan))
+            {
+                // first run of these input shapes, record the blob shapes to plan the next runs
+                shape_plan_key.clear();
+
+                std::vector<Mat> shapes(blob_mats.size());
+                int ret = net->forward_schedule(blob_index, blob_mats, layer_needed, 0, 0, &shapes, opt);
+                if (ret == 0)
+                {
+                    net->add_memory_plan(input_shapes, shapes, opt.memory_plan_cache_size);
+                }
+
+                return ret;
+            }
+
+            shape_plan_key = input_shapes;
+        }
+
+        plan = shape_plan;
+    }
+
+    if (!plan || plan->size == 0)
+    {
+        return net->forward_schedule(blob_index, blob_mats, layer_needed, 0, 0, 0, opt);
+    }
+
+    if (!arena_allocator)
+    {
+        arena_allocator = new ArenaAllocator;
+    }
+
+    if (arena_size < plan->size)
+    {
+        // the arena cannot grow under blobs still living in it
+        for (size_t i = 0; i < blob_mats.size(); i++)
+        {
+            if (blob_mats[i].allocator == arena_allocator)
+                return net->forward_schedule(blob_index, blob_mats, layer_needed, 0, 0, 0, opt);
+        }
+
+        arena_allocator->reserve(plan->size, opt.blob_allocator);
+        arena_size = plan->size;
+    }
+
+    Option opt_arena = opt;
+    opt_arena.blob_allocator = arena_allocator;
+
+    return net->forward_schedule(blob_index, blob_mats, layer_needed, arena_allocator, plan, 0, opt_arena);
+}
+
+StreamExtractor::StreamExtractor(const Net* _net, int _input_blob_index, int _output_blob_index, int stage_count, int num_threads, int max_inflight)
+    : net(_net), input_blob_index(_input_blob_index), output_blob_index(_output_blob_index)
+{
+    init(stage_count, num_threads, max_inflight);
+}
+
+#if NCNN_STRING
+StreamExtractor::StreamExtractor(const Net* _net, const char* input_blob_name, const char* output_blob_name, int stage_count, int num_threads, int max_inflight)
+    : net(_net)
+{
+    input_blob_index = net->find_blob_index_by_name(input_blob_name);
+    output_blob_index = net->find_blob_index_by_name(output_blob_name);
+
+    init(stage_count, num_threads, max_inflight);
+}
+#endif // NCNN_STRING
+
+void StreamExtractor::init(int stage_count, int num_threads, int _max_inflight)
+{
+    max_stage_count = std::max(stage_count, 1);
+    max_inflight = _max_inflight > 0 ? _max_inflight : max_stage_count * 2;
+
+    opt = net->opt;
+    opt.num_threads = num_threads;
+    // the stages are the concurrency
+    opt.num_inter_threads = 1;
+
+    first = 0;
+    last = -1;
+
+    inflight = 0;
+    stopping = false;
+}
+
+StreamExtractor::~StreamExtractor()
+{
+    lock.lock();
+    stopping = true;
+    condition.broadcast();
+    lock.unlock();
+
+    for (size_t i = 0; i < stages.size(); i++)
+    {
+        stages[i].thread->join();
+        delete stages[i].thread;
+
+        for (size_t j = 0; j < stages[i].queue.size(); j++)
+        {
+            delete stages[i].queue[j];
+        }
+    }
+
+    for (size_t i = 0; i < results.size(); i++)
+    {
+        delete results[i];
+    }
+}
+
+int StreamExtractor::push(const Mat& in)
+{
+    const int blob_count = (int)net->blobs.size();
+    if (input_blob_index < 0 || input_blob_index >= blob_count || output_blob_index < 0 || output_blob_index >= blob_count)
+        return -1;
+
+    Frame* frame = new Frame;
+    frame->blob_mats.resize(blob_count);
+    frame->blob_mats[input_blob_index] = in;
+    frame->ret = 0;
+
+    if (stages.empty())
+    {
+        int ret = partition(frame);
+        if (ret != 0)
+        {
+            delete frame;
+            return ret;
+        }
+
+        lock.lock();
+        inflight++;
+        results.push_back(frame);
+        lock.unlock();
+
+        return 0;
+    }
+
+    lock.lock();
+    while (inflight >= max_inflight)
+    {
+        condition.wait(lock);
+    }
+
+    inflight++;
+    stages[0].queue.push_back(frame);
+    condition.broadcast();
+    lock.unlock();
+
+    return 0;
+}
+
+int StreamExtractor::pull(Mat& out)
+{
+    lock.lock();
+    if (inflight == 0)
+    {
+        lock.unlock();
+        NCNN_LOGE("pull without pushed frame");
+        return -1;
+    }
+
+    while (results.empty())
+    {
+        condition.wait(lock);
+    }
+
+    Frame* frame = results.front();
+    results.erase(results.begin());
+
+    inflight--;
+    condition.broadcast();
+    lock.unlock();
+
+    int ret = frame->ret;
+    if (ret == 0)
+    {
+        out = frame->blob_mats[output_blob_index];
+
+        if (opt.use_packing_layout)
+        {
+            Mat out_unpacked;
+            convert_packing(out, out_unpacked, 1, opt);
+            out = out_unpacked;
+        }
+    }
+
+    delete frame;
+
     return ret;
 }
 
+int StreamExtractor::stage_count() const
+{
+    return (int)stages.size();
+}
+
+int StreamExtractor::partition(Frame* frame)
+{
+    int ret = net->mark_needed_layers(output_blob_index, frame->blob_mats, layer_needed, first, last);
+    if (ret != 0)
+        return ret;
+
+    std::vector<int> positions;
+    std::vector<double> times;
+    double total = 0;
+    for (int i = first; i <= last; i++)
+    {
+        const int layer_index = net->layer_schedule[i];
+        if (!layer_needed[layer_index])
+            continue;
+
+        double start = get_current_time();
+        ret = net->forward_layer(layer_index, frame->blob_mats, 0, 0, opt);
+        double end = get_current_time();
+        if (ret != 0)
+            return ret;
+
+        positions.push_back(i);
+        times.push_back(end - start);
+        total += end - start;
+    }
+
+    const int count = std::max(std::min(max_stage_count, (int)positions.size()), 1);
+    stages.resize(count);
+
+    // cut where the running cost passes the next share of the total
+    // while leaving at least one layer for every following stage
+    int s = 0;
+    double cost = 0;
+    stages[0].first = first;
+    for (int j = 0; j < (int)positions.size() && s + 1 < count; j++)
+    {
+        cost += times[j];
+
+        const int remaining_layers = (int)positions.size() - j - 1;
+        const int remaining_stages = count - s - 1;
+        if (cost >= total * (s + 1) / count || remaining_layers == remaining_stages)
+        {
+            stages[s].last = positions[j];
+            s++;
+            stages[s].first = positions[j] + 1;
+        }
+    }
+    stages[count - 1].last = last;
+
+    for (int i = 0; i < count; i++)
+    {
+        stages[i].stream = this;
+        stages[i].index = i;
+        stages[i].thread = new Thread(stage_main, &stages[i]);
+    }
+
+    return 0;
+}
+
+int StreamExtractor::forward_stage(const Stage& stage, Frame* frame) const
+{
+    for (int i = stage.first; i <= stage.last; i++)
+    {
+        const int layer_index = net->layer_schedule[i];
+        if (!layer_needed[layer_index])
+            continue;
+
+        int ret = net->forward_layer(layer_index, frame->blob_mats, 0, 0, opt);
+        if (ret != 0)
+            return ret;
+    }
+
+    return 0;
+}
+
+void* StreamExtractor::stage_main(void* args)
+{
+    Stage* stage = (Stage*)args;
+    StreamExtractor* stream = stage->stream;
+
+    bind_numa_node(stream->opt.numa_node);
+
+    stream->lock.lock();
+    for (;;)
+    {
+        while (stage->queue.empty() && !stream->stopping)
+        {
+            stream->condition.wait(stream->lock);
+        }
+
+        if (stream->stopping)
+            break;
+
+        Frame* frame = stage->queue.front();
+        stage->queue.erase(stage->queue.begin());
+        stream->lock.unlock();
+
+        // a failed frame passes through to pull
+        if (frame->ret == 0)
+        {
+            frame->ret = stream->forward_stage(*stage, frame);
+        }
+
+        stream->lock.lock();
+        if (stage->index + 1 < (int)stream->stages.size())
+        {
+            stream->stages[stage->index + 1].queue.push_back(frame);
+        }
+        else
+        {
+            stream->results.push_back(frame);
+        }
+        stream->condition.broadcast();
+    }
+    stream->lock.unlock();
+
+    return 0;
+}
+
 #if NCNN_VULKAN
 #if NCNN_STRING
 int Extractor::input(const char* blob_name, const VkMat& in)
@@ -20,6 +20,7 @@
 #include "mat.h"
 #include "option.h"
 #include "platform.h"
+#include "profiler.h"
 
 #if __ANDROID_API__ >= 9
 #include <android/asset_manager.h>
@@ -31,7 +32,13 @@ namespace ncnn {
 class VkCompute;
 #endif // NCNN_VULKAN
 class DataReader;
+class DataReaderFromMmap;
+class DataReaderWithChecksum;
 class Extractor;
+class StreamExtractor;
+class MemoryPlan;
+class MemoryPlanCache;
+class ThreadPool;
 class Net
 {
 public:
@@ -88,6 +95,36 @@ public:
     // return 0 if success
     int load_model(FILE* fp);
     int load_model(const char* modelpath);
+
+    // map network weight data from model file
+    // weight data is referenced in the mapping instead of copied
+    // so processes loading the same model share the page cache
+    // the mapping is kept until clear
+    // return 0 if success
+    int load_model_mmap(const char* modelpath);
+
+    // restore the weights transformed by create_pipeline from pipeline cache file
+    // so that load_model skips the transforms, the cache file is mapped until clear
+    // call after load_param and option setup, before load_model
+    // the cache is keyed by layer graph, instruction set, option flags and a checksum of the raw weights
+    // load_model checks the weight checksum and transforms the weights again if they changed
+    // return 0 if success, -1 if the cache is missing or stale
+    int load_pipeline_cache(const char* cachepath);
+
+    // save the weights transformed by create_pipeline into pipeline cache file
+    // call after load_model
+    // return 0 if success
+    int save_pipeline_cache(const char* cachepath) const;
+    // the same written at the current file position, which must be 64-byte aligned
+    int save_pipeline_cache(FILE* fp) const;
+
+    // load network structure and weight data from model container file made by ncnn2container
+    // the file is mapped and weight data referenced in place, pages are read on first touch
+    // the pipeline section matching this cpu and option replaces the create_pipeline transforms
+    // the index is verified by checksum, weight checksums are left to ncnn2container
+    // the mapping is kept until clear
+    // return 0 if success
+    int load_container(const char* containerpath);
 #endif // NCNN_STDIO
 
     // load network structure from external memory
@@ -121,17 +158,50 @@ public:
     void clear();
 
     // construct an Extractor from network
+    // a loaded network is never modified by extraction
+    // so many threads can share one network, each with its own extractor
+    // allocators in the option shared by these extractors must be thread-safe
     Extractor create_extractor() const;
 
+    // layout conversions forward would do per inference without use_static_layout
+    // and the explicit conversion layers inserted in their place at load time
+    int runtime_conversion_count() const;
+    int conversion_layer_count() const;
+
 public:
     std::vector<Blob> blobs;
     std::vector<Layer*> layers;
 
 protected:
+    // load weight data of every layer from mb and create the layer pipelines
+    // checksum_dr is the reader under mb, its checksum after each layer makes weight_checksum
+    // without it weight_checksum is left as the caller set it
+    int load_model(const ModelBin& mb, const DataReaderWithChecksum* checksum_dr = 0);
+
     // parse the structure of network
     // fuse int8 op dequantize and quantize by requantize
     int fuse_network();
 
+    // compute the topological layer order used by every forward
+    int build_schedule();
+
+    // assign elempack and storage type to every blob from shape hints
+    // insert explicit packing and cast layers where a consumer needs another layout
+    int propagate_layout();
+
+    // assign arena offsets to intermediate blobs from shape hints
+    // blobs with overlapping lifetime never share memory
+    int plan_memory();
+    // the same for the given blob shapes, dims 0 for unplanned blob
+    int plan_memory(const std::vector<Mat>& shapes, MemoryPlan& plan) const;
+
+    // look up the memory plan cached for input shapes key
+    // return true if found
+    bool find_memory_plan(const std::vector<int>& key, MemoryPlan& plan) const;
+    // plan the recorded blob shapes and cache the plan for input shapes key
+    // the least recently used plan is evicted beyond capacity
+    void add_memory_plan(const std::vector<int>& key, const std::vector<Mat>& shapes, int capacity) const;
+
 #if NCNN_VULKAN
 
     int upload_model();
@@ -143,6 +213,7 @@ protected:
 #endif // NCNN_VULKAN
 
     friend class Extractor;
+    friend class StreamExtractor;
 #if NCNN_STRING
     int find_blob_index_by_name(const char* name) const;
     int find_layer_index_by_name(const char* name) const;
@@ -150,7 +221,26 @@ protected:
     Layer* create_custom_layer(const char* type);
 #endif // NCNN_STRING
     Layer* create_custom_layer(int index);
-    int forward_layer(int layer_index, std::vector<Mat>& blob_mats, const Option& opt) const;
+    bool static_layout_matched(int blob_index, const Mat& m) const;
+    // run the scheduled layers needed for blob_index, skipping blobs already present
+    // place top blobs in arena following plan when set, record top blob shapes into shapes when set
+    int forward_schedule(int blob_index, std::vector<Mat>& blob_mats, std::vector<unsigned char>& layer_needed, ArenaAllocator* arena, const MemoryPlan* plan, std::vector<Mat>* shapes, const Option& opt) const;
+    // mark the layers needed for blob_index in layer_needed and return their schedule range
+    int mark_needed_layers(int blob_index, const std::vector<Mat>& blob_mats, std::vector<unsigned char>& layer_needed, int& first, int& last) const;
+    // forward_schedule for a batch, batch_blob_mats holds the blob mats of each sample
+    int forward_schedule_batch(int blob_index, std::vector<std::vector<Mat> >& batch_blob_mats, std::vector<unsigned char>& layer_needed, const Option& opt) const;
+    // run the needed layers between schedule position first and last, independent branches concurrently
+    int forward_parallel(int first, int last, std::vector<Mat>& blob_mats, const std::vector<unsigned char>& layer_needed, const Option& opt) const;
+    static void forward_parallel_task(void* ctx, int layer_index);
+    // run one layer whose bottom blobs are ready
+    int forward_layer(int layer_index, std::vector<Mat>& blob_mats, ArenaAllocator* arena, const MemoryPlan* plan, const Option& opt) const;
+    // run one layer for every sample, in one forward_batch call if the layer supports it
+    int forward_layer_batch(int layer_index, std::vector<std::vector<Mat> >& batch_blob_mats, const Option& opt) const;
+    // the layer runs themselves, workspace_counter is the workspace allocator of a profiled run
+    int run_layer(int layer_index, std::vector<Mat>& blob_mats, ArenaAllocator* arena, const MemoryPlan* plan, const Option& opt, const Profiler::CountingAllocator* workspace_counter) const;
+    int run_layer_batch(int layer_index, std::vector<std::vector<Mat> >& batch_blob_mats, const Option& opt, const Profiler::CountingAllocator* workspace_counter) const;
+    // cast and pack a bottom blob into the storage the layer takes
+    void convert_bottom_layout(const Layer* layer, int bottom_blob_index, Mat& bottom_blob, const Option& opt) const;
 
 #if NCNN_VULKAN
     int forward_layer(int layer_index, std::vector<Mat>& blob_mats, std::vector<VkMat>& blob_mats_gpu, VkCompute& cmd, const Option& opt) const;
@@ -160,6 +250,39 @@ protected:
 protected:
     std::vector<layer_registry_entry> custom_layer_registry;
 
+    // layer indices in execution order and the position of each layer in it
+    std::vector<int> layer_schedule;
+    std::vector<int> schedule_positions;
+
+    // inter-op workers
+    ThreadPool* thread_pool;
+
+#if NCNN_STDIO
+    // mapped model file referenced by weight data
+    DataReaderFromMmap* model_mmap;
+    // mapped pipeline cache referenced by transformed weights
+    DataReaderFromMmap* pipeline_cache_mmap;
+    // restored transformed weights of each layer, handed over in load_model
+    std::vector<std::vector<Mat> > pipeline_cache_weights;
+    // weight_checksum of the model the cache was saved from
+    unsigned int pipeline_cache_weight_checksum;
+#endif // NCNN_STDIO
+
+    // checksum of the raw weight bytes of every layer, as ncnn2container keeps them per layer
+    unsigned int weight_checksum;
+
+    // static blob layout
+    // elempack and element bits of each blob, 0 for layout decided at runtime
+    std::vector<int> blob_elempacks;
+    std::vector<int> blob_elembits;
+    int static_runtime_conversions;
+    int static_conversion_layers;
+
+    // static memory plan from shape hints
+    MemoryPlan* memory_plan;
+    // memory plans recorded for other input shapes
+    MemoryPlanCache* memory_plan_cache;
+
 #if NCNN_VULKAN
     const VulkanDevice* vkdev;
 
@@ -173,6 +296,11 @@ class Extractor
 public:
     ~Extractor();
 
+    // the copy shares the net, option and blobs set so far
+    // it plans its own arena and memory plan, blobs living in the arena of other are cloned
+    Extractor(const Extractor& other);
+    Extractor& operator=(const Extractor& other);
+
     // enable light mode
     // intermediate blob will be recycled when enabled
     // enabled by default
@@ -189,6 +317,16 @@ public:
     // set workspace memory allocator
     void set_workspace_allocator(Allocator* allocator);
 
+    // set per layer profiler, null to disable
+    // records the layer runs of the following cpu extracts
+    void set_profiler(Profiler* profiler);
+
+    // drop the inputs and blobs of the previous request
+    // the blob slots, allocators and planned arena are kept for the next request
+    // so a long-lived extractor serves request after request without setup
+    // one extractor must not be used by several threads at once
+    void clear();
+
 #if NCNN_VULKAN
     void set_vulkan_compute(bool enable);
 
@@ -207,6 +345,14 @@ public:
     // get result by blob name
     // return 0 if success
     int extract(const char* blob_name, Mat& feat);
+
+    // set batch input by blob name, one mat per sample
+    // return 0 if success
+    int input_batch(const char* blob_name, const std::vector<Mat>& ins);
+
+    // get batch result by blob name, one mat per sample
+    // return 0 if success
+    int extract_batch(const char* blob_name, std::vector<Mat>& feats);
 #endif // NCNN_STRING
 
     // set input by blob index
@@ -217,6 +363,17 @@ public:
     // return 0 if success
     int extract(int blob_index, Mat& feat);
 
+    // set batch input by blob index, one mat per sample
+    // every batch input must hold the same sample count
+    // batch blobs are kept apart from the ones set by input()
+    // return 0 if success
+    int input_batch(int blob_index, const std::vector<Mat>& ins);
+
+    // get batch result by blob index, one mat per sample
+    // layers supporting batch run all samples in one call
+    // return 0 if success
+    int extract_batch(int blob_index, std::vector<Mat>& feats);
+
 #if NCNN_VULKAN
 #if NCNN_STRING
     // set input by blob name
@@ -257,11 +414,35 @@ protected:
     friend Extractor Net::create_extractor() const;
     Extractor(const Net* net, size_t blob_count);
 
+    // forward on cpu, through the planned arena when possible
+    int forward_cpu(int blob_index);
+
+    // take the state of other, the arena, memory plan and local allocators stay unset
+    void copy_from(const Extractor& other);
+
 private:
     const Net* net;
     std::vector<Mat> blob_mats;
     Option opt;
 
+    // planned arena for intermediate blobs
+    ArenaAllocator* arena_allocator;
+    size_t arena_size;
+    // input shapes agree with the planned shapes
+    bool memory_plan_matched;
+
+    // blob index and shape of every input, the memory plan cache key
+    std::vector<int> input_shapes;
+    // memory plan cached for shape_plan_key
+    MemoryPlan* shape_plan;
+    std::vector<int> shape_plan_key;
+
+    // layers needed by the current extract
+    std::vector<unsigned char> layer_needed;
+
+    // blob mats of each sample for batch extract
+    std::vector<std::vector<Mat> > batch_blob_mats;
+
 #if NCNN_VULKAN
     VkAllocator* local_blob_vkallocator;
     VkAllocator* local_staging_vkallocator;
@@ -271,6 +452,86 @@ private:
 #endif // NCNN_VULKAN
 };
 
+// pipelined cpu inference over a stream of inputs
+// the layers are split into stages of about equal cost, each stage runs on its own thread
+// so the early layers of a frame overlap with the later layers of the frames before it
+// results come out in push order
+// allocators in the network option must be thread-safe
+class StreamExtractor
+{
+public:
+    // stage_count stages, each layer run with num_threads threads
+    // at most max_inflight frames are pushed but not pulled, 0 for stage_count * 2
+    StreamExtractor(const Net* net, int input_blob_index, int output_blob_index, int stage_count, int num_threads, int max_inflight = 0);
+#if NCNN_STRING
+    StreamExtractor(const Net* net, const char* input_blob_name, const char* output_blob_name, int stage_count, int num_threads, int max_inflight = 0);
+#endif // NCNN_STRING
+    // stop the stages, frames not pulled yet are dropped
+    ~StreamExtractor();
+
+    // queue one input frame, blocks while max_inflight frames are in flight
+    // a single caller thread must pull before pushing beyond max_inflight
+    // the first frame runs on the calling thread to time the layers and place the stage boundaries
+    // return 0 if success
+    int push(const Mat& in);
+
+    // wait for the result of the oldest pushed frame
+    // return 0 if success
+    int pull(Mat& out);
+
+    // number of stages in use, known after the first push
+    int stage_count() const;
+
+protected:
+    struct Frame
+    {
+        std::vector<Mat> blob_mats;
+        int ret;
+    };
+
+    struct Stage
+    {
+        StreamExtractor* stream;
+        int index;
+        // schedule positions [first, last]
+        int first;
+        int last;
+        std::vector<Frame*> queue;
+        Thread* thread;
+    };
+
+    void init(int stage_count, int num_threads, int max_inflight);
+    // time the layers on the first frame and split them into stages
+    int partition(Frame* frame);
+    int forward_stage(const Stage& stage, Frame* frame) const;
+    static void* stage_main(void* args);
+
+private:
+    // not copyable
+    StreamExtractor(const StreamExtractor&);
+    StreamExtractor& operator=(const StreamExtractor&);
+
+    const Net* net;
+    int input_blob_index;
+    int output_blob_index;
+    int max_stage_count;
+    int max_inflight;
+    Option opt;
+
+    // layers needed for the output blob
+    std::vector<unsigned char> layer_needed;
+    int first;
+    int last;
+
+    std::vector<Stage> stages;
+    std::vector<Frame*> results;
+    int inflight;
+    bool stopping;
+
+    Mutex lock;
+    ConditionVariable condition;
+};
+
 } // namespace ncnn
 
 #endif // NCNN_NET_H
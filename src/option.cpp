@@ -49,6 +49,16 @@ Option::Option()
     use_image_storage = false;
 
     use_bf16_storage = false;
+
+    use_memory_plan = false;
+    memory_plan_cache_size = 8;
+    shape_bucket_size = 0;
+    use_static_layout = false;
+
+    num_inter_threads = 1;
+    numa_node = -1;
+    use_numa_interleave = false;
+    profiler = 0;
 }
 
 } // namespace ncnn
@@ -24,6 +24,7 @@ class VkAllocator;
 #endif // NCNN_VULKAN
 
 class Allocator;
+class Profiler;
 class Option
 {
 public:
@@ -99,6 +100,60 @@ public:
     // enable bf16 data type for storage
     // improve most operator performace on all arm devices, may consume more memory
     bool use_bf16_storage;
+
+    // enable static memory plan
+    // place intermediate blobs in one preplanned arena per extractor using the blob shape hints
+    // changes should be applied before loading network structure and weight
+    // disabled by default
+    bool use_memory_plan;
+
+    // memory plans kept for input shapes other than the shape hints
+    // the first extract of new input shapes records the blob shapes, the following ones run planned
+    // the least recently used plan is evicted, 0 to disable
+    // effective with use_memory_plan
+    // default value is 8
+    int memory_plan_cache_size;
+
+    // pad width and height of 3d inputs up to a multiple of this on the right and bottom
+    // so that inputs of nearby sizes share one cached memory plan
+    // the padding is not cropped or reported, outputs are those of the padded input
+    // callers crop them, the input gains (w + n - 1) / n * n - w columns and likewise rows
+    // 0 to disable
+    // default value is 0
+    int shape_bucket_size;
+
+    // enable static blob layout
+    // fix elempack and storage type of every blob at load time and insert explicit packing and cast layers
+    // blobs that arrive in another layout at runtime are still converted before use
+    // has no effect with fp16 storage on arm cpus with asimdhp
+    // changes should be applied before loading network structure and weight
+    // disabled by default
+    bool use_static_layout;
+
+    // inter-op thread count
+    // independent branches run concurrently when greater than 1, each layer still uses num_threads
+    // blob and workspace allocator must be thread-safe when enabled
+    // changes should be applied before loading network structure and weight
+    // default value is 1
+    int num_inter_threads;
+
+    // numa node the weights are placed on and the extracting threads run on
+    // load one net per node with its own numa_node to replicate the weights on every node
+    // a thread running an extractor is bound to the node during each extract and gets its own affinity back afterwards
+    // changes should be applied before loading network structure and weight
+    // default value is -1, no placement
+    int numa_node;
+
+    // interleave the weights page by page over all numa nodes
+    // for one net shared by threads on every node, ignored when numa_node is set
+    // changes should be applied before loading network structure and weight
+    // disabled by default
+    bool use_numa_interleave;
+
+    // per layer profiler
+    // records every cpu layer run when set, see Extractor::set_profiler
+    // null by default
+    Profiler* profiler;
 };
 
 } // namespace ncnn
@@ -0,0 +1,351 @@
+// Tencent is pleased to support the open source community by making ncnn available.
+//
+// Copyright (C) 2020 THL A29 Limited, a Tencent company. All rights reserved.
+//
+// Licensed under the BSD 3-Clause License (the "License"); you may not use this file except
+// in compliance with the License. You may obtain a copy of the License at
+//
+// https://opensource.org/licenses/BSD-3-Clause
+//
+// Unless required by applicable law or agreed to in writing, software distributed
+// under the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR
+// CONDITIONS OF ANY KIND, either express or implied. See the License for the
+// specific language governing permissions and limitations under the License.
+
+#include "profiler.h"
+
+#include "benchmark.h"
+#include "layer.h"
+
+#if NCNN_STDIO
+#include <stdio.h>
+#endif // NCNN_STDIO
+
+namespace ncnn {
+
+Profiler::CountingAllocator::CountingAllocator(Allocator* _allocator)
+    : allocator(_allocator)
+{
+    allocated_bytes = 0;
+}
+
+void* Profiler::CountingAllocator::fastMalloc(size_t size)
+{
+    lock.lock();
+    allocated_bytes += size;
+    lock.unlock();
+
+    return allocator ? allocator->fastMalloc(size) : ncnn::fastMalloc(size);
+}
+
+void Profiler::CountingAllocator::fastFree(void* ptr)
+{
+    if (allocator)
+        allocator->fastFree(ptr);
+    else
+        ncnn::fastFree(ptr);
+}
+
+size_t Profiler::CountingAllocator::bytes() const
+{
+    lock.lock();
+    size_t b = allocated_bytes;
+    lock.unlock();
+
+    return b;
+}
+
+Profiler::Profiler()
+{
+    origin = get_current_time();
+    thread_count = 0;
+}
+
+Profiler::~Profiler()
+{
+}
+
+void Profiler::clear()
+{
+    lock.lock();
+    origin = get_current_time();
+    layer_profiles.clear();
+    lock.unlock();
+}
+
+std::vector<LayerProfile> Profiler::records() const
+{
+    lock.lock();
+    std::vector<LayerProfile> copy = layer_profiles;
+    lock.unlock();
+
+    return copy;
+}
+
+int Profiler::current_thread_index()
+{
+    // index + 1 kept per thread, 0 for a thread not seen yet
+    size_t index = (size_t)thread_index_tls.get();
+    if (index == 0)
+    {
+        lock.lock();
+        index = ++thread_count;
+        lock.unlock();
+
+        thread_index_tls.set((void*)index);
+    }
+
+    return (int)index - 1;
+}
+
+static size_t blob_bytes(const Mat& m)
+{
+    return m.total() * m.elemsize;
+}
+
+static Mat blob_shape(const Mat& m)
+{
+    if (m.dims == 1)
+        return Mat(m.w, (void*)0, m.elemsize, m.elempack);
+    if (m.dims == 2)
+        return Mat(m.w, m.h, (void*)0, m.elemsize, m.elempack);
+    if (m.dims == 3)
+        return Mat(m.w, m.h, m.c, (void*)0, m.elemsize, m.elempack);
+
+    return Mat();
+}
+
+void Profiler::begin(LayerProfile& lp, const Layer* layer, int layer_index)
+{
+    lp.layer_index = layer_index;
+    lp.typeindex = layer->typeindex;
+#if NCNN_STRING
+    lp.type = layer->type;
+    lp.name = layer->name;
+#endif // NCNN_STRING
+    lp.thread_index = current_thread_index();
+
+    // store the start points, end turns them into durations
+    lp.thread_cpu_time = get_thread_cpu_time();
+    lp.process_cpu_time = get_process_cpu_time();
+    lp.start = get_current_time();
+    lp.convert_time = lp.start;
+}
+
+void Profiler::converted(LayerProfile& lp)
+{
+    lp.convert_time = get_current_time();
+}
+
+void Profiler::end(LayerProfile& lp, const CountingAllocator* workspace_counter, const std::vector<Mat>& bottom_blobs, const std::vector<Mat>& top_blobs)
+{
+    lp.end = get_current_time();
+    lp.process_cpu_time = get_process_cpu_time() - lp.process_cpu_time;
+    lp.thread_cpu_time = get_thread_cpu_time() - lp.thread_cpu_time;
+    lp.convert_time -= lp.start;
+
+    lp.workspace_bytes = workspace_counter ? workspace_counter->bytes() : 0;
+
+    lp.top_bytes = 0;
+    lp.bottom_shapes.resize(bottom_blobs.size());
+    for (size_t i = 0; i < bottom_blobs.size(); i++)
+    {
+        lp.bottom_shapes[i] = blob_shape(bottom_blobs[i]);
+    }
+    lp.top_shapes.resize(top_blobs.size());
+    for (size_t i = 0; i < top_blobs.size(); i++)
+    {
+        lp.top_shapes[i] = blob_shape(top_blobs[i]);
+        lp.top_bytes += blob_bytes(top_blobs[i]);
+    }
+
+    lock.lock();
+    lp.start -= origin;
+    lp.end -= origin;
+    layer_profiles.push_back(lp);
+    lock.unlock();
+}
+
+#if NCNN_STDIO
+static void write_shapes(FILE* fp, const std::vector<Mat>& shapes)
+{
+    for (size_t i = 0; i < shapes.size(); i++)
+    {
+        const Mat& m = shapes[i];
+        if (i != 0)
+            fprintf(fp, " ");
+
+        if (m.dims == 1)
+            fprintf(fp, "%d", m.w * m.elempack);
+        if (m.dims == 2)
+            fprintf(fp, "%dx%d", m.w, m.h * m.elempack);
+        if (m.dims == 3)
+            fprintf(fp, "%dx%dx%d", m.w, m.h, m.c * m.elempack);
+        if (m.elempack != 1)
+            fprintf(fp, "/%d", m.elempack);
+    }
+}
+
+#if NCNN_STRING
+static void write_json_string(FILE* fp, const std::string& s)
+{
+    fprintf(fp, "\"");
+    for (size_t i = 0; i < s.size(); i++)
+    {
+        unsigned char c = s[i];
+        if (c == '"' || c == '\\')
+            fprintf(fp, "\\%c", c);
+        else if (c < 0x20)
+            fprintf(fp, "\\u%04x", c);
+        else
+            fputc(c, fp);
+    }
+    fprintf(fp, "\"");
+}
+
+static void write_csv_string(FILE* fp, const std::string& s)
+{
+    fprintf(fp, "\"");
+    for (size_t i = 0; i < s.size(); i++)
+    {
+        if (s[i] == '"')
+            fputc('"', fp);
+        fputc(s[i], fp);
+    }
+    fprintf(fp, "\"");
+}
+#endif // NCNN_STRING
+
+int Profiler::save_chrome_trace(const char* path) const
+{
+    FILE* fp = fopen(path, "wb");
+    if (!fp)
+    {
+        NCNN_LOGE("fopen %s failed", path);
+        return -1;
+    }
+
+    std::vector<LayerProfile> lps = records();
+
+    fprintf(fp, "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n");
+
+    int max_thread_index = -1;
+    for (size_t i = 0; i < lps.size(); i++)
+    {
+        const LayerProfile& lp = lps[i];
+
+        // complete event, timestamps in us
+        fprintf(fp, "{\"ph\":\"X\",\"pid\":0,\"tid\":%d,\"ts\":%.3f,\"dur\":%.3f,", lp.thread_index, lp.start * 1000, (lp.end - lp.start) * 1000);
+#if NCNN_STRING
+        fprintf(fp, "\"name\":");
+        write_json_string(fp, lp.name);
+        fprintf(fp, ",\"cat\":");
+        write_json_string(fp, lp.type);
+#else
+        fprintf(fp, "\"name\":\"%d\",\"cat\":\"%d\"", lp.layer_index, lp.typeindex);
+#endif // NCNN_STRING
+        fprintf(fp, ",\"args\":{\"layer_index\":%d,\"convert_ms\":%.3f,\"thread_cpu_ms\":%.3f,\"process_cpu_ms\":%.3f,\"top_bytes\":%lu,\"workspace_bytes\":%lu,\"bottom\":\"",
+                lp.layer_index, lp.convert_time, lp.thread_cpu_time, lp.process_cpu_time, (unsigned long)lp.top_bytes, (unsigned long)lp.workspace_bytes);
+        write_shapes(fp, lp.bottom_shapes);
+        fprintf(fp, "\",\"top\":\"");
+        write_shapes(fp, lp.top_shapes);
+        fprintf(fp, "\"}},\n");
+
+        if (lp.thread_index > max_thread_index)
+            max_thread_index = lp.thread_index;
+    }
+
+    for (int i = 0; i <= max_thread_index; i++)
+    {
+        fprintf(fp, "{\"ph\":\"M\",\"pid\":0,\"tid\":%d,\"name\":\"thread_name\",\"args\":{\"name\":\"thread %d\"}}%s\n", i, i, i == max_thread_index ? "" : ",");
+    }
+
+    fprintf(fp, "]}\n");
+
+    int ret = ferror(fp) ? -1 : 0;
+    fclose(fp);
+
+    return ret;
+}
+
+int Profiler::save_csv(const char* path) const
+{
+    FILE* fp = fopen(path, "wb");
+    if (!fp)
+    {
+        NCNN_LOGE("fopen %s failed", path);
+        return -1;
+    }
+
+    std::vector<LayerProfile> lps = records();
+
+    // sum up the runs of each layer, the shapes of the last run are kept
+    int layer_count = 0;
+    for (size_t i = 0; i < lps.size(); i++)
+    {
+        if (lps[i].layer_index + 1 > layer_count)
+            layer_count = lps[i].layer_index + 1;
+    }
+
+    std::vector<int> runs(layer_count, 0);
+    std::vector<LayerProfile> sums(layer_count);
+    double total_time = 0;
+    for (size_t i = 0; i < lps.size(); i++)
+    {
+        const LayerProfile& lp = lps[i];
+        LayerProfile& sum = sums[lp.layer_index];
+
+        if (runs[lp.layer_index] == 0)
+        {
+            sum = lp;
+            sum.end = lp.end - lp.start;
+        }
+        else
+        {
+            sum.end += lp.end - lp.start;
+            sum.convert_time += lp.convert_time;
+            sum.thread_cpu_time += lp.thread_cpu_time;
+            sum.process_cpu_time += lp.process_cpu_time;
+            sum.top_bytes += lp.top_bytes;
+            sum.workspace_bytes += lp.workspace_bytes;
+            sum.bottom_shapes = lp.bottom_shapes;
+            sum.top_shapes = lp.top_shapes;
+        }
+
+        runs[lp.layer_index]++;
+        total_time += lp.end - lp.start;
+    }
+
+    fprintf(fp, "layer_index,type,name,runs,wall_ms,wall_percent,convert_ms,thread_cpu_ms,process_cpu_ms,top_bytes,workspace_bytes,bottom_shapes,top_shapes\n");
+
+    for (int i = 0; i < layer_count; i++)
+    {
+        if (runs[i] == 0)
+            continue;
+
+        const LayerProfile& sum = sums[i];
+
+        fprintf(fp, "%d,", i);
+#if NCNN_STRING
+        write_csv_string(fp, sum.type);
+        fprintf(fp, ",");
+        write_csv_string(fp, sum.name);
+#else
+        fprintf(fp, "%d,", sum.typeindex);
+#endif // NCNN_STRING
+        fprintf(fp, ",%d,%.3f,%.2f,%.3f,%.3f,%.3f,%lu,%lu,", runs[i], sum.end, total_time > 0 ? sum.end * 100 / total_time : 0.0,
+                sum.convert_time, sum.thread_cpu_time, sum.process_cpu_time, (unsigned long)sum.top_bytes, (unsigned long)sum.workspace_bytes);
+        write_shapes(fp, sum.bottom_shapes);
+        fprintf(fp, ",");
+        write_shapes(fp, sum.top_shapes);
+        fprintf(fp, "\n");
+    }
+
+    int ret = ferror(fp) ? -1 : 0;
+    fclose(fp);
+
+    return ret;
+}
+#endif // NCNN_STDIO
+
+} // namespace ncnn
@@ -0,0 +1,137 @@
+// Tencent is pleased to support the open source community by making ncnn available.
+//
+// Copyright (C) 2020 THL A29 Limited, a Tencent company. All rights reserved.
+//
+// Licensed under the BSD 3-Clause License (the "License"); you may not use this file except
+// in compliance with the License. You may obtain a copy of the License at
+//
+// https://opensource.org/licenses/BSD-3-Clause
+//
+// Unless required by applicable law or agreed to in writing, software distributed
+// under the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR
+// CONDITIONS OF ANY KIND, either express or implied. See the License for the
+// specific language governing permissions and limitations under the License.
+
+#ifndef NCNN_PROFILER_H
+#define NCNN_PROFILER_H
+
+#include "allocator.h"
+#include "mat.h"
+#include "platform.h"
+
+#include <vector>
+#if NCNN_STRING
+#include <string>
+#endif // NCNN_STRING
+
+namespace ncnn {
+
+class Layer;
+
+// one profiled layer run
+class LayerProfile
+{
+public:
+    int layer_index;
+    int typeindex;
+#if NCNN_STRING
+    std::string type;
+    std::string name;
+#endif // NCNN_STRING
+
+    // profiler thread index of the thread running the layer
+    int thread_index;
+
+    // wall time in ms since the profiler was created or cleared
+    double start;
+    double end;
+
+    // wall time in ms spent casting and repacking the bottom blobs
+    double convert_time;
+
+    // cpu time in ms of the thread running the layer
+    double thread_cpu_time;
+    // cpu time in ms of the whole process, covering the worker threads of the layer
+    // also covers layers running concurrently when inter-op threads are enabled
+    double process_cpu_time;
+
+    // bytes of the top blobs produced by the layer
+    size_t top_bytes;
+    // bytes allocated through the workspace allocator by this run
+    size_t workspace_bytes;
+
+    // blob shapes without data
+    std::vector<Mat> bottom_shapes;
+    std::vector<Mat> top_shapes;
+};
+
+// runtime per layer profiler
+// set it on an extractor to record every layer run of the following extracts
+// several extractors may share one profiler, keep it alive while they work
+class Profiler
+{
+public:
+    Profiler();
+    ~Profiler();
+
+    // drop the records and restart the clock
+    void clear();
+
+    // layer runs in completion order
+    std::vector<LayerProfile> records() const;
+
+#if NCNN_STDIO
+    // write the records as chrome trace event json
+    // open it with chrome://tracing or perfetto
+    // return 0 if success
+    int save_chrome_trace(const char* path) const;
+
+    // write one csv row per layer with run count, time, convert overhead and bytes summed up
+    // return 0 if success
+    int save_csv(const char* path) const;
+#endif // NCNN_STDIO
+
+public:
+    // workspace allocator of one profiled layer run, living as long as the run
+    // counts bytes and forwards to the wrapped allocator, fastMalloc if null
+    class CountingAllocator : public Allocator
+    {
+    public:
+        CountingAllocator(Allocator* allocator);
+        virtual void* fastMalloc(size_t size);
+        virtual void fastFree(void* ptr);
+
+        // bytes allocated so far, by any thread of the run
+        size_t bytes() const;
+
+    private:
+        Allocator* allocator;
+        mutable Mutex lock;
+        size_t allocated_bytes;
+    };
+
+    // hooks called around every layer run
+    void begin(LayerProfile& lp, const Layer* layer, int layer_index);
+    void converted(LayerProfile& lp);
+    void end(LayerProfile& lp, const CountingAllocator* workspace_counter, const std::vector<Mat>& bottom_blobs, const std::vector<Mat>& top_blobs);
+
+protected:
+    int current_thread_index();
+
+private:
+    // not copyable
+    Profiler(const Profiler&);
+    Profiler& operator=(const Profiler&);
+
+    double origin;
+
+    mutable Mutex lock;
+    std::vector<LayerProfile> layer_profiles;
+
+    int thread_count;
+    ThreadLocalStorage thread_index_tls;
+};
+
+} // namespace ncnn
+
+#endif // NCNN_PROFILER_H
@@ -0,0 +1,341 @@
+// Tencent is pleased to support the open source community by making ncnn available.
+//
+// Copyright (C) 2020 THL A29 Limited, a Tencent company. All rights reserved.
+//
+// Licensed under the BSD 3-Clause License (the "License"); you may not use this file except
+// in compliance with the License. You may obtain a copy of the License at
+//
+// https://opensource.org/licenses/BSD-3-Clause
+//
+// Unless required by applicable law or agreed to in writing, software distributed
+// under the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR
+// CONDITIONS OF ANY KIND, either express or implied. See the License for the
+// specific language governing permissions and limitations under the License.
+
+#include "threadpool.h"
+
+#include "option.h"
+
+#include <algorithm>
+
+#if NCNN_THREADPOOL
+#if !(defined _WIN32 && !(defined __MINGW32__))
+#include <unistd.h> // sysconf()
+#endif
+#endif // NCNN_THREADPOOL
+
+namespace ncnn {
+
+ThreadPool::ThreadPool(int worker_count)
+{
+    nworkers = worker_count > 0 ? worker_count : 0;
+
+    queues.resize(nworkers + 1);
+    queue_locks = new Mutex[nworkers + 1];
+
+    queued = 0;
+    stop = false;
+
+    affinity_func = 0;
+    affinity_mask = 0;
+    affinity_generation = 0;
+
+    worker_args.resize(nworkers);
+    workers.resize(nworkers);
+    for (int i = 0; i < nworkers; i++)
+    {
+        worker_args[i].pool = this;
+        worker_args[i].slot = i;
+        worker_args[i].affinity_generation = 0;
+        workers[i] = new Thread(worker_main, &worker_args[i]);
+    }
+}
+
+ThreadPool::~ThreadPool()
+{
+    lock.lock();
+    stop = true;
+    condition.broadcast();
+    lock.unlock();
+
+    for (int i = 0; i < nworkers; i++)
+    {
+        workers[i]->join();
+        delete workers[i];
+    }
+
+    // no worker left, drain on this thread
+    while (run_one())
+    {
+    }
+
+    delete[] queue_locks;
+}
+
+int ThreadPool::worker_count() const
+{
+    return nworkers;
+}
+
+void ThreadPool::submit(task_func func, void* ctx, int arg)
+{
+    Task task;
+    task.func = func;
+    task.ctx = ctx;
+    task.arg = arg;
+
+    int slot = current_slot();
+
+    queue_locks[slot].lock();
+    queues[slot].push_back(task);
+    queue_locks[slot].unlock();
+
+    lock.lock();
+    queued++;
+    condition.signal();
+    lock.unlock();
+}
+
+bool ThreadPool::run_one()
+{
+    int slot = current_slot();
+
+    Task task;
+    if (!take(slot, task))
+        return false;
+
+    task.func(task.ctx, task.arg);
+
+    return true;
+}
+
+void ThreadPool::set_worker_affinity(int (*func)(size_t mask), size_t mask)
+{
+    lock.lock();
+    affinity_func = func;
+    affinity_mask = mask;
+    affinity_generation++;
+    condition.broadcast();
+    lock.unlock();
+}
+
+int ThreadPool::current_slot() const
+{
+    // worker threads store slot + 1, others read null
+    size_t slot = (size_t)slot_tls.get();
+    return slot == 0 ? nworkers : (int)slot - 1;
+}
+
+bool ThreadPool::take(int slot, Task& task)
+{
+    bool taken = false;
+
+    // newest task of our own deque
+    queue_locks[slot].lock();
+    if (!queues[slot].empty())
+    {
+        task = queues[slot].back();
+        queues[slot].pop_back();
+        taken = true;
+    }
+    queue_locks[slot].unlock();
+
+    // oldest task of the others, starting from the next slot
+    for (int i = 1; i <= nworkers && !taken; i++)
+    {
+        int victim = (slot + i) % (nworkers + 1);
+
+        queue_locks[victim].lock();
+        if (!queues[victim].empty())
+        {
+            task = queues[victim].front();
+            queues[victim].pop_front();
+            taken = true;
+        }
+        queue_locks[victim].unlock();
+    }
+
+    if (taken)
+    {
+        lock.lock();
+        queued--;
+        lock.unlock();
+    }
+
+    return taken;
+}
+
+void* ThreadPool::worker_main(void* args)
+{
+    WorkerArgs* worker = (WorkerArgs*)args;
+    ThreadPool* pool = worker->pool;
+
+    pool->slot_tls.set((void*)(size_t)(worker->slot + 1));
+
+    for (;;)
+    {
+        if (pool->run_one())
+            continue;
+
+        pool->lock.lock();
+        while (!pool->stop && pool->queued == 0 && worker->affinity_generation == pool->affinity_generation)
+        {
+            pool->condition.wait(pool->lock);
+        }
+        bool quit = pool->stop && pool->queued == 0;
+        int (*affinity_func)(size_t) = 0;
+        size_t affinity_mask = pool->affinity_mask;
+        if (worker->affinity_generation != pool->affinity_generation)
+        {
+            affinity_func = pool->affinity_func;
+            worker->affinity_generation = pool->affinity_generation;
+        }
+        pool->lock.unlock();
+
+        if (affinity_func)
+            affinity_func(affinity_mask);
+
+        if (quit)
+            break;
+    }
+
+    return 0;
+}
+
+#if NCNN_THREADPOOL
+static int get_hardware_thread_count()
+{
+#if (defined _WIN32 && !(defined __MINGW32__))
+    SYSTEM_INFO info;
+    GetSystemInfo(&info);
+    int count = (int)info.dwNumberOfProcessors;
+#else
+    int count = (int)sysconf(_SC_NPROCESSORS_ONLN);
+#endif
+    return count > 0 ? count : 1;
+}
+
+static Mutex g_shared_thread_pool_lock;
+static ThreadPool* g_shared_thread_pool = 0;
+
+class SharedThreadPoolHolder
+{
+public:
+    ~SharedThreadPoolHolder()
+    {
+        delete g_shared_thread_pool;
+        g_shared_thread_pool = 0;
+    }
+};
+
+static SharedThreadPoolHolder g_shared_thread_pool_holder;
+
+ThreadPool* get_shared_thread_pool()
+{
+    MutexLockGuard guard(g_shared_thread_pool_lock);
+
+    if (!g_shared_thread_pool)
+    {
+        g_shared_thread_pool = new ThreadPool(get_hardware_thread_count() - 1);
+    }
+
+    return g_shared_thread_pool;
+}
+
+// one parallel_for call, each share of the range is a pool task
+struct ParallelForTeam
+{
+    parallel_for_func func;
+    const void* ctx;
+    int n;
+    int shares;
+
+    Mutex lock;
+    ConditionVariable condition;
+    // shares not done yet, the calling thread excluded
+    int running;
+};
+
+static void parallel_for_share(const ParallelForTeam* team, int share)
+{
+    // contiguous ranges, the same split as a static schedule
+    const int begin = (int)((long long)team->n * share / team->shares);
+    const int end = (int)((long long)team->n * (share + 1) / team->shares);
+    for (int i = begin; i < end; i++)
+    {
+        team->func(team->ctx, i);
+    }
+}
+
+static void parallel_for_task(void* ctx, int share)
+{
+    ParallelForTeam* team = (ParallelForTeam*)ctx;
+
+    parallel_for_share(team, share);
+
+    // team may be gone once running drops to zero and the lock is released
+    team->lock.lock();
+    if (--team->running == 0)
+    {
+        team->condition.signal();
+    }
+    team->lock.unlock();
+}
+#endif // NCNN_THREADPOOL
+
+void parallel_for(const Option& opt, int n, parallel_for_func func, const void* ctx)
+{
+#if NCNN_THREADPOOL
+    ParallelForTeam team;
+    team.func = func;
+    team.ctx = ctx;
+    team.n = n;
+    team.shares = std::min(std::max(opt.num_threads, 1), n);
+    team.running = team.shares - 1;
+
+    if (team.shares <= 1)
+    {
+        for (int i = 0; i < n; i++)
+        {
+            func(ctx, i);
+        }
+        return;
+    }
+
+    ThreadPool* pool = get_shared_thread_pool();
+    for (int i = 1; i < team.shares; i++)
+    {
+        pool->submit(parallel_for_task, &team, i);
+    }
+
+    parallel_for_share(&team, 0);
+
+    // help with queued shares of any parallel_for until ours are done
+    team.lock.lock();
+    while (team.running > 0)
+    {
+        team.lock.unlock();
+
+        bool ran = pool->run_one();
+
+        team.lock.lock();
+        if (!ran)
+        {
+            // nothing queued, the rest of our shares are running elsewhere
+            while (team.running > 0)
+            {
+                team.condition.wait(team.lock);
+            }
+        }
+    }
+    team.lock.unlock();
+#else
+    #pragma omp parallel for num_threads(opt.num_threads)
+    for (int i = 0; i < n; i++)
+    {
+        func(ctx, i);
+    }
+#endif // NCNN_THREADPOOL
+}
+
+} // namespace ncnn
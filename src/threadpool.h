@@ -0,0 +1,131 @@
+// Tencent is pleased to support the open source community by making ncnn available.
+//
+// Copyright (C) 2020 THL A29 Limited, a Tencent company. All rights reserved.
+//
+// Licensed under the BSD 3-Clause License (the "License"); you may not use this file except
+// in compliance with the License. You may obtain a copy of the License at
+//
+// https://opensource.org/licenses/BSD-3-Clause
+//
+// Unless required by applicable law or agreed to in writing, software distributed
+// under the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR
+// CONDITIONS OF ANY KIND, either express or implied. See the License for the
+// specific language governing permissions and limitations under the License.
+
+#ifndef NCNN_THREADPOOL_H
+#define NCNN_THREADPOOL_H
+
+#include "platform.h"
+
+#include <deque>
+
+namespace ncnn {
+
+class Option;
+
+// work-stealing thread pool
+// every worker owns a task deque, pops its newest task first
+// and steals the oldest task of another deque when its own runs dry
+class ThreadPool
+{
+public:
+    typedef void (*task_func)(void* ctx, int arg);
+
+    // start worker_count threads
+    ThreadPool(int worker_count);
+    // run the remaining tasks and join the workers
+    ~ThreadPool();
+
+    int worker_count() const;
+
+    // queue a task
+    // a task submitted from a worker goes to that worker deque, others go to the shared deque
+    void submit(task_func func, void* ctx, int arg);
+
+    // run one queued task on the calling thread
+    // return false if there is no queued task
+    bool run_one();
+
+    // have every worker call func(mask) on itself before it next waits for tasks
+    void set_worker_affinity(int (*func)(size_t mask), size_t mask);
+
+protected:
+    struct Task
+    {
+        task_func func;
+        void* ctx;
+        int arg;
+    };
+
+    struct WorkerArgs
+    {
+        ThreadPool* pool;
+        int slot;
+        // affinity_generation applied by this worker
+        int affinity_generation;
+    };
+
+    // the deque slot of the calling thread
+    int current_slot() const;
+    bool take(int slot, Task& task);
+
+    static void* worker_main(void* args);
+
+private:
+    // not copyable
+    ThreadPool(const ThreadPool&);
+    ThreadPool& operator=(const ThreadPool&);
+
+    int nworkers;
+    std::vector<Thread*> workers;
+    std::vector<WorkerArgs> worker_args;
+
+    // one deque per worker and a shared one at the end
+    std::vector<std::deque<Task> > queues;
+    Mutex* queue_locks;
+
+    // queued task count and shutdown flag
+    Mutex lock;
+    ConditionVariable condition;
+    int queued;
+    bool stop;
+
+    // pending worker affinity, guarded by lock
+    int (*affinity_func)(size_t mask);
+    size_t affinity_mask;
+    int affinity_generation;
+
+    mutable ThreadLocalStorage slot_tls;
+};
+
+#if NCNN_THREADPOOL
+// the pool that runs parallel_for loops
+// one worker less than the cpu count, the thread entering a loop takes a share itself
+// created on first use and shared by every caller in the process
+ThreadPool* get_shared_thread_pool();
+#endif // NCNN_THREADPOOL
+
+typedef void (*parallel_for_func)(const void* ctx, int i);
+
+// run func(ctx, i) for every i in [0, n), split into opt.num_threads contiguous shares
+// with NCNN_THREADPOOL the shares are tasks of the shared pool, otherwise they run on an openmp team
+// layers keep their own openmp loops, only code calling parallel_for uses the shared pool
+// the calling thread takes a share itself, nested calls are fine
+void parallel_for(const Option& opt, int n, parallel_for_func func, const void* ctx);
+
+template<typename Op>
+static void parallel_for_op(const void* ctx, int i)
+{
+    (*(const Op*)ctx)(i);
+}
+
+// the same calling op(i), op is shared by all threads
+template<typename Op>
+void parallel_for(const Option& opt, int n, const Op& op)
+{
+    parallel_for(opt, n, parallel_for_op<Op>, (const void*)&op);
+}
+
+} // namespace ncnn
+
+#endif // NCNN_THREADPOOL_H
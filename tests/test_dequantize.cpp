@@ -0,0 +1,105 @@
+// Tencent is pleased to support the open source community by making ncnn available.
+//
+// Copyright (C) 2020 THL A29 Limited, a Tencent company. All rights reserved.
+//
+// Licensed under the BSD 3-Clause License (the "License"); you may not use this file except
+// in compliance with the License. You may obtain a copy of the License at
+//
+// https://opensource.org/licenses/BSD-3-Clause
+//
+// Unless required by applicable law or agreed to in writing, software distributed
+// under the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR
+// CONDITIONS OF ANY KIND, either express or implied. See the License for the
+// specific language governing permissions and limitations under the License.
+
+
+#include "layer/dequantize.h"
+#include "testutil.h"
+
+static ncnn::Mat RandomIntMat(const ncnn::Mat& shape)
+{
+    ncnn::Mat m;
+    m.create_like(shape);
+    for (size_t i = 0; i < m.total(); i++)
+    {
+        ((int*)m)[i] = (int)RandomFloat(-10000.f, 10000.f);
+    }
+    return m;
+}
+
+static int test_dequantize(const ncnn::Mat& a, int bias_data_size)
+{
+    ncnn::ParamDict pd;
+    pd.set(0, 1.f / 128);
+    pd.set(1, bias_data_size ? 1 : 0);
+    pd.set(2, bias_data_size);
+
+    std::vector<ncnn::Mat> weights(bias_data_size ? 1 : 0);
+    if (bias_data_size)
+        weights[0] = RandomMat(bias_data_size);
+
+    ncnn::Option opt;
+    opt.num_threads = 1;
+    opt.use_vulkan_compute = false;
+    opt.use_int8_inference = false;
+
+    int ret = test_layer<ncnn::Dequantize>("Dequantize", pd, weights, opt, a);
+    if (ret != 0)
+    {
+        fprintf(stderr, "test_dequantize failed a.dims=%d a=(%d %d %d) bias_data_size=%d\n", a.dims, a.w, a.h, a.c, bias_data_size);
+    }
+
+    return ret;
+}
+
+static int test_dequantize_0()
+{
+    ncnn::Mat a = RandomIntMat(ncnn::Mat(5, 7, 16));
+    ncnn::Mat b = RandomIntMat(ncnn::Mat(3, 5, 13));
+
+    return 0
+           || test_dequantize(a, 0)
+           || test_dequantize(a, 1)
+           || test_dequantize(a, 16)
+           || test_dequantize(b, 0)
+           || test_dequantize(b, 1)
+           || test_dequantize(b, 13);
+}
+
+static int test_dequantize_1()
+{
+    ncnn::Mat a = RandomIntMat(ncnn::Mat(15, 16));
+    ncnn::Mat b = RandomIntMat(ncnn::Mat(9, 5));
+
+    return 0
+           || test_dequantize(a, 0)
+           || test_dequantize(a, 1)
+           || test_dequantize(a, 16)
+           || test_dequantize(b, 0)
+           || test_dequantize(b, 1)
+           || test_dequantize(b, 5);
+}
+
+static int test_dequantize_2()
+{
+    ncnn::Mat a = RandomIntMat(ncnn::Mat(128));
+    ncnn::Mat b = RandomIntMat(ncnn::Mat(17));
+
+    return 0
+           || test_dequantize(a, 0)
+           || test_dequantize(a, 1)
+           || test_dequantize(a, 128)
+           || test_dequantize(b, 0)
+           || test_dequantize(b, 1)
+           || test_dequantize(b, 17);
+}
+
+int main()
+{
+    SRAND(7767517);
+
+    return 0
+           || test_dequantize_0()
+           || test_dequantize_1()
+           || test_dequantize_2();
+}
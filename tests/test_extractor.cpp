@@ -0,0 +1,128 @@
+// Tencent is pleased to support the open source community by making ncnn available.
+//
+// Copyright (C) 2020 THL A29 Limited, a Tencent company. All rights reserved.
+//
+// Licensed under the BSD 3-Clause License (the "License"); you may not use this file except
+// in compliance with the License. You may obtain a copy of the License at
+//
+// https://opensource.org/licenses/BSD-3-Clause
+//
+// Unless required by applicable law or agreed to in writing, software distributed
+// under the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR
+// CONDITIONS OF ANY KIND, either express or implied. See the License for the
+// specific language governing permissions and limitations under the License.
+
+#include "testutil.h"
+
+#include <vector>
+
+static int extract_fresh(const ncnn::Net& net, const ncnn::Mat& in, ncnn::Mat& out)
+{
+    ncnn::Extractor ex = net.create_extractor();
+
+    ex.input("data", in);
+
+    ncnn::Mat out0;
+    int ret = ex.extract("output", out0);
+    if (ret != 0)
+        return ret;
+
+    out = out0.clone();
+
+    return 0;
+}
+
+// one extractor serves every input after clear, as fresh extractors do
+static int test_extractor_clear(bool use_memory_plan, bool lightmode)
+{
+    std::vector<ncnn::Mat> ins;
+    ins.push_back(RandomMat(16, 16, 3));
+    ins.push_back(RandomMat(24, 20, 3));
+    ins.push_back(RandomMat(16, 16, 3));
+    ins.push_back(RandomMat(7, 9, 3));
+    ins.push_back(RandomMat(24, 20, 3));
+    ins.push_back(RandomMat(16, 16, 3));
+
+    ncnn::Net net;
+    net.opt.use_memory_plan = use_memory_plan;
+    LoadTestNet(net);
+
+    ncnn::Extractor ex = net.create_extractor();
+    ex.set_light_mode(lightmode);
+
+    for (size_t i = 0; i < ins.size(); i++)
+    {
+        ncnn::Mat out;
+        if (extract_fresh(net, ins[i], out) != 0)
+            return -1;
+
+        ex.clear();
+        ex.input("data", ins[i]);
+
+        // without light mode the intermediate blobs of the previous input would be picked up again
+        ncnn::Mat c1;
+        ncnn::Mat out_reused;
+        if (!lightmode && ex.extract("c1", c1) != 0)
+            return -1;
+        if (ex.extract("output", out_reused) != 0)
+            return -1;
+
+        if (CompareMat(out, out_reused, 0.001) != 0)
+        {
+            fprintf(stderr, "test_extractor_clear failed use_memory_plan=%d lightmode=%d input=%d\n", use_memory_plan, lightmode, (int)i);
+            return -1;
+        }
+    }
+
+    return 0;
+}
+
+// the planned arena stays with the extractor across clear
+static int test_extractor_clear_arena()
+{
+    ncnn::Mat in = RandomMat(16, 16, 3);
+
+    ncnn::Net net;
+    net.opt.use_memory_plan = true;
+    LoadTestNet(net);
+
+    CountingAllocator blob_allocator;
+
+    ncnn::Extractor ex = net.create_extractor();
+    ex.set_blob_allocator(&blob_allocator);
+
+    for (int i = 0; i < 3; i++)
+    {
+        blob_allocator.count = 0;
+
+        ex.clear();
+        ex.input("data", in);
+
+        ncnn::Mat out;
+        if (ex.extract("output", out) != 0)
+            return -1;
+
+        // the returned output only
+        if (blob_allocator.count != 1)
+        {
+            fprintf(stderr, "test_extractor_clear_arena failed request=%d mallocs=%d\n", i, blob_allocator.count);
+            return -1;
+        }
+    }
+
+    ex.clear();
+
+    return 0;
+}
+
+int main()
+{
+    SRAND(7767517);
+
+    return 0
+           || test_extractor_clear(false, true)
+           || test_extractor_clear(false, false)
+           || test_extractor_clear(true, true)
+           || test_extractor_clear(true, false)
+           || test_extractor_clear_arena();
+}
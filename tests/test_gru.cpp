@@ -0,0 +1,325 @@
+// Tencent is pleased to support the open source community by making ncnn available.
+//
+// Copyright (C) 2020 THL A29 Limited, a Tencent company. All rights reserved.
+//
+// Licensed under the BSD 3-Clause License (the "License"); you may not use this file except
+// in compliance with the License. You may obtain a copy of the License at
+//
+// https://opensource.org/licenses/BSD-3-Clause
+//
+// Unless required by applicable law or agreed to in writing, software distributed
+// under the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR
+// CONDITIONS OF ANY KIND, either express or implied. See the License for the
+// specific language governing permissions and limitations under the License.
+
+#include "layer/gru.h"
+#include "testutil.h"
+
+static int test_gru(const ncnn::Mat& a, int outch, int direction)
+{
+    int input_size = a.w * a.h * a.c;
+    int num_directions = direction == 2 ? 2 : 1;
+
+    ncnn::ParamDict pd;
+    pd.set(0, outch); // num_output
+    pd.set(1, outch * input_size * 3 * num_directions);
+    pd.set(2, direction);
+
+    std::vector<ncnn::Mat> weights(3);
+    weights[0] = RandomMat(outch * input_size * 3 * num_directions);
+    weights[1] = RandomMat(outch * 4 * num_directions);
+    weights[2] = RandomMat(outch * outch * 3 * num_directions);
+
+    ncnn::Option opt;
+    opt.num_threads = 1;
+    opt.use_int8_inference = false;
+
+    int ret = test_layer<ncnn::GRU>("GRU", pd, weights, opt, a);
+    if (ret != 0)
+    {
+        fprintf(stderr, "test_gru failed a.dims=%d a=(%d %d %d) outch=%d, direction = %d \n", a.dims, a.w, a.h, a.c, outch, direction);
+    }
+
+    return ret;
+}
+
+static int test_gru_layer(const ncnn::Mat& a, int outch, int direction, float epsilon = 0.01)
+{
+    int input_size = a.w * a.h * a.c;
+
+    ncnn::ParamDict pd;
+    pd.set(0, outch); // num_output
+    pd.set(1, outch * input_size * 3);
+    pd.set(2, direction);
+
+    std::vector<ncnn::Mat> weights(3);
+    weights[0] = RandomMat(outch * input_size * 3);
+    weights[1] = RandomMat(outch * 4);
+    weights[2] = RandomMat(outch * outch * 3);
+
+    ncnn::Option opt;
+    opt.num_threads = 1;
+    opt.use_int8_inference = false;
+
+    ncnn::GRU* op = (ncnn::GRU*)ncnn::create_layer(ncnn::layer_to_index("GRU"));
+
+    if (!op->support_vulkan) opt.use_vulkan_compute = false;
+    if (!op->support_packing) opt.use_packing_layout = false;
+    if (!op->support_bf16_storage) opt.use_bf16_storage = false;
+    if (!op->support_image_storage) opt.use_image_storage = false;
+
+    op->load_param(pd);
+
+    ncnn::ModelBinFromMatArray mb(weights.data());
+
+    op->load_model(mb);
+
+    op->create_pipeline(opt);
+
+    ncnn::Mat b;
+    op->GRU::forward(a, b, opt);
+
+    // run the sequence in two halves, passing the hidden state along
+    std::vector<ncnn::Mat> _c1(2);
+    std::vector<ncnn::Mat> _c2(2);
+    std::vector<ncnn::Mat> a1(2);
+    std::vector<ncnn::Mat> a2(2);
+    if (direction == 0)
+    {
+        a1[0] = a.row_range(0, a.h / 2).clone();
+        a2[0] = a.row_range(a.h / 2, a.h - a.h / 2).clone();
+    }
+    else
+    {
+        a2[0] = a.row_range(0, a.h / 2).clone();
+        a1[0] = a.row_range(a.h / 2, a.h - a.h / 2).clone();
+    }
+
+    // initial hidden state
+    ncnn::Mat hidden(outch);
+    if (hidden.empty())
+        return -100;
+    hidden.fill(0.f);
+
+    a1[1] = hidden;
+    op->forward(a1, _c1, opt);
+    a2[1] = _c1[1];
+    op->forward(a2, _c2, opt);
+
+    ncnn::Mat c1 = _c1[0];
+    ncnn::Mat c2 = _c2[0];
+
+    if (direction == 1)
+    {
+        c2 = _c1[0];
+        c1 = _c2[0];
+    }
+
+    // total height
+    ncnn::Mat c;
+    c.create(b.w, b.h, b.elemsize, opt.blob_allocator);
+    if (c.empty())
+        return -100;
+
+    unsigned char* outptr = c;
+    int c1_size = c1.w * c1.h;
+    const unsigned char* c1ptr = c1;
+    memcpy(outptr, c1ptr, c1_size * c1.elemsize);
+    outptr += c1_size * c1.elemsize;
+    int c2_size = c2.w * c2.h;
+    const unsigned char* c2ptr = c2;
+    memcpy(outptr, c2ptr, c2_size * c2.elemsize);
+
+    op->destroy_pipeline(opt);
+
+    delete op;
+
+    if (CompareMat(b, c, epsilon) != 0)
+    {
+        fprintf(stderr, "test_gru two step failed a.dims=%d a=(%d %d %d) outch=%d, direction = %d \n", a.dims, a.w, a.h, a.c, outch, direction);
+        return -1;
+    }
+
+    return 0;
+}
+
+static int test_gru_linear_before_reset(const ncnn::Mat& a, int outch)
+{
+    const int input_size = a.w;
+    const int T = a.h;
+
+    ncnn::ParamDict pd;
+    pd.set(0, outch); // num_output
+    pd.set(1, outch * input_size * 3);
+    pd.set(2, 0);
+
+    std::vector<ncnn::Mat> weights(3);
+    weights[0] = RandomMat(outch * input_size * 3);
+    weights[1] = RandomMat(outch * 4);
+    weights[2] = RandomMat(outch * outch * 3);
+
+    // reference with gate order R U N and bias rows R U WN BN
+    // n_t = tanh(W_n x_t + b_wn + r_t .* (R_n h_{t-1} + b_bn))
+    const float* weight_xc = weights[0];
+    const float* bias_c = weights[1];
+    const float* weight_hc = weights[2];
+
+    ncnn::Mat b(outch, T);
+    std::vector<float> hidden(outch, 0.f);
+    for (int t = 0; t < T; t++)
+    {
+        const float* x = a.row(t);
+        float* outptr = b.row(t);
+
+        for (int q = 0; q < outch; q++)
+        {
+            float gx[3];
+            float gh[3];
+            for (int g = 0; g < 3; g++)
+            {
+                gx[g] = 0.f;
+                for (int i = 0; i < input_size; i++)
+                {
+                    gx[g] += weight_xc[(g * outch + q) * input_size + i] * x[i];
+                }
+
+                gh[g] = 0.f;
+                for (int i = 0; i < outch; i++)
+                {
+                    gh[g] += weight_hc[(g * outch + q) * outch + i] * hidden[i];
+                }
+            }
+
+            float R = 1.f / (1.f + exp(-(gx[0] + bias_c[q] + gh[0])));
+            float U = 1.f / (1.f + exp(-(gx[1] + bias_c[outch + q] + gh[1])));
+            float N = tanh(gx[2] + bias_c[outch * 2 + q] + R * (gh[2] + bias_c[outch * 3 + q]));
+
+            outptr[q] = (1.f - U) * N + U * hidden[q];
+        }
+
+        for (int q = 0; q < outch; q++)
+        {
+            hidden[q] = outptr[q];
+        }
+    }
+
+    ncnn::Option opt;
+    opt.num_threads = 1;
+    opt.use_vulkan_compute = false;
+    opt.use_int8_inference = false;
+    opt.use_fp16_storage = false;
+
+    ncnn::Layer* op = ncnn::create_layer("GRU");
+
+    op->load_param(pd);
+
+    ncnn::ModelBinFromMatArray mb(weights.data());
+
+    op->load_model(mb);
+
+    op->create_pipeline(opt);
+
+    ncnn::Mat c;
+    op->forward(a, c, opt);
+
+    // the same sequence twice in a batch, forward_batch sizes the output vector itself
+    std::vector<ncnn::Mat> bottom_blobs(2, a);
+    std::vector<ncnn::Mat> d;
+    op->forward_batch(bottom_blobs, d, opt);
+
+    op->destroy_pipeline(opt);
+
+    delete op;
+
+    int ret = CompareMat(b, c, 0.001);
+    if (ret == 0)
+        ret = d.size() == 2 ? 0 : -1;
+    for (size_t n = 0; n < d.size() && ret == 0; n++)
+    {
+        ret = CompareMat(b, d[n], 0.001);
+    }
+    if (ret != 0)
+    {
+        fprintf(stderr, "test_gru_linear_before_reset failed a.dims=%d a=(%d %d %d) outch=%d\n", a.dims, a.w, a.h, a.c, outch);
+    }
+
+    return ret;
+}
+
+static int test_gru_0()
+{
+    return 0
+           || test_gru(RandomMat(4, 1), 2, 2)
+           || test_gru(RandomMat(8, 2), 2, 2)
+           || test_gru(RandomMat(16, 8), 7, 2)
+           || test_gru(RandomMat(17, 8), 8, 2)
+           || test_gru(RandomMat(19, 15), 8, 2)
+           || test_gru(RandomMat(5, 16), 16, 2)
+           || test_gru(RandomMat(3, 16), 8, 2)
+           || test_gru(RandomMat(8, 16), 16, 2)
+           || test_gru(RandomMat(2, 5), 17, 2);
+}
+
+static int test_gru_1()
+{
+    return 0
+           || test_gru_layer(RandomMat(4, 4), 1, 1)
+           || test_gru_layer(RandomMat(8, 2), 2, 1)
+           || test_gru_layer(RandomMat(16, 8), 7, 1)
+           || test_gru_layer(RandomMat(17, 8), 8, 1)
+           || test_gru_layer(RandomMat(19, 15), 8, 1)
+           || test_gru_layer(RandomMat(5, 16), 16, 1)
+           || test_gru_layer(RandomMat(3, 16), 8, 1)
+           || test_gru_layer(RandomMat(2, 5), 99, 1)
+           || test_gru_layer(RandomMat(4, 2), 1, 0)
+           || test_gru_layer(RandomMat(8, 2), 2, 0)
+           || test_gru_layer(RandomMat(16, 8), 7, 0)
+           || test_gru_layer(RandomMat(17, 8), 8, 0)
+           || test_gru_layer(RandomMat(19, 15), 8, 0)
+           || test_gru_layer(RandomMat(5, 16), 16, 0)
+           || test_gru_layer(RandomMat(3, 16), 8, 0)
+           || test_gru_layer(RandomMat(2, 5), 17, 0);
+}
+
+static int test_gru_2()
+{
+    return 0
+           || test_gru(RandomMat(4, 1), 1, 0)
+           || test_gru(RandomMat(8, 2), 2, 0)
+           || test_gru(RandomMat(16, 8), 7, 0)
+           || test_gru(RandomMat(17, 8), 8, 0)
+           || test_gru(RandomMat(19, 15), 8, 0)
+           || test_gru(RandomMat(5, 16), 16, 0)
+           || test_gru(RandomMat(3, 16), 8, 0)
+           || test_gru(RandomMat(8, 16), 16, 0)
+           || test_gru(RandomMat(2, 5), 17, 0);
+}
+
+static int test_gru_3()
+{
+    return 0
+           || test_gru(RandomMat(4, 1), 1, 1)
+           || test_gru(RandomMat(8, 2), 2, 1)
+           || test_gru(RandomMat(16, 8), 7, 1)
+           || test_gru(RandomMat(17, 8), 8, 1)
+           || test_gru(RandomMat(19, 15), 8, 1)
+           || test_gru(RandomMat(5, 16), 16, 1)
+           || test_gru(RandomMat(3, 16), 8, 1)
+           || test_gru(RandomMat(8, 16), 16, 1)
+           || test_gru(RandomMat(2, 5), 17, 1);
+}
+
+static int test_gru_4()
+{
+    return 0
+           || test_gru_linear_before_reset(RandomMat(4, 3), 2)
+           || test_gru_linear_before_reset(RandomMat(16, 8), 7)
+           || test_gru_linear_before_reset(RandomMat(17, 8), 8)
+           || test_gru_linear_before_reset(RandomMat(5, 16), 16);
+}
+
+int main()
+{
+    SRAND(7767517);
+    return 0 || test_gru_0() || test_gru_1() || test_gru_2() || test_gru_3() || test_gru_4();
+}
@@ -143,6 +143,100 @@ static int test_innerproduct_3()
            || test_innerproduct_int8(RandomMat(6, 3, 16), 16, 1);
 }
 
+static int test_innerproduct_batch(const ncnn::Mat& a, int outch, int batch)
+{
+    ncnn::ParamDict pd;
+    pd.set(0, outch); // num_output
+    pd.set(1, 1);     // bias_term
+    pd.set(2, outch * a.w * a.h * a.c);
+    pd.set(9, 1); // relu
+
+    std::vector<ncnn::Mat> weights(2);
+    weights[0] = RandomMat(outch * a.w * a.h * a.c);
+    weights[1] = RandomMat(outch);
+
+    ncnn::Option opt;
+    opt.num_threads = 1;
+    opt.use_vulkan_compute = false;
+    opt.use_int8_inference = false;
+    opt.use_fp16_storage = false;
+    opt.use_bf16_storage = false;
+
+    ncnn::Layer* op = ncnn::create_layer("InnerProduct");
+    if (!op->support_packing) opt.use_packing_layout = false;
+
+    op->load_param(pd);
+
+    ncnn::ModelBinFromMatArray mb(weights.data());
+
+    op->load_model(mb);
+
+    op->create_pipeline(opt);
+
+    std::vector<ncnn::Mat> bottom_blobs(batch);
+    std::vector<ncnn::Mat> bottom_blobs_packed(batch);
+    for (int n = 0; n < batch; n++)
+    {
+        bottom_blobs[n] = a.clone();
+        Randomize(bottom_blobs[n]);
+
+        if (opt.use_packing_layout)
+        {
+#if (defined(__x86_64__) || (defined _WIN32 && !(defined __MINGW32__)))
+            ncnn::convert_packing(bottom_blobs[n], bottom_blobs_packed[n], 8, opt);
+#else
+            ncnn::convert_packing(bottom_blobs[n], bottom_blobs_packed[n], 4, opt);
+#endif
+        }
+        else
+        {
+            bottom_blobs_packed[n] = bottom_blobs[n];
+        }
+    }
+
+    // every sample on its own as reference
+    std::vector<ncnn::Mat> b(batch);
+    for (int n = 0; n < batch; n++)
+    {
+        ((ncnn::InnerProduct*)op)->ncnn::InnerProduct::forward(bottom_blobs[n], b[n], opt);
+    }
+
+    std::vector<ncnn::Mat> c;
+    op->forward_batch(bottom_blobs_packed, c, opt);
+
+    op->destroy_pipeline(opt);
+
+    delete op;
+
+    int ret = (int)c.size() != batch;
+    for (int n = 0; n < batch && ret == 0; n++)
+    {
+        ncnn::Mat c_unpacked;
+        ncnn::convert_packing(c[n], c_unpacked, 1, opt);
+
+        ret = CompareMat(b[n], c_unpacked, 0.001);
+    }
+
+    if (ret != 0)
+    {
+        fprintf(stderr, "test_innerproduct_batch failed a.dims=%d a=(%d %d %d) outch=%d batch=%d\n", a.dims, a.w, a.h, a.c, outch, batch);
+    }
+
+    return ret;
+}
+
+static int test_innerproduct_4()
+{
+    return 0
+           || test_innerproduct_batch(RandomMat(1, 3, 1), 1, 1)
+           || test_innerproduct_batch(RandomMat(3, 2, 2), 2, 3)
+           || test_innerproduct_batch(RandomMat(4, 3, 16), 7, 4)
+           || test_innerproduct_batch(RandomMat(6, 2, 16), 16, 5)
+           || test_innerproduct_batch(RandomMat(6, 16), 9, 2)
+           || test_innerproduct_batch(RandomMat(15), 8, 7)
+           || test_innerproduct_batch(RandomMat(32), 13, 8);
+}
+
 int main()
 {
     SRAND(7767517);
@@ -151,5 +245,6 @@ int main()
            || test_innerproduct_0()
            || test_innerproduct_1()
            || test_innerproduct_2()
-           || test_innerproduct_3();
+           || test_innerproduct_3()
+           || test_innerproduct_4();
 }
@@ -148,6 +148,168 @@ int test_lstm_layer(const ncnn::Mat& a, int outch, int direction, float epsilon
     return 0;
 }
 
+static int test_lstm_batch(int size, int outch, int direction, int batch)
+{
+    int num_directions = direction == 2 ? 2 : 1;
+
+    ncnn::ParamDict pd;
+    pd.set(0, outch); // num_output
+    pd.set(1, outch * size * 4 * num_directions);
+    pd.set(2, direction);
+
+    std::vector<ncnn::Mat> weights(3);
+    weights[0] = RandomMat(outch * size * 4 * num_directions);
+    weights[1] = RandomMat(outch * 4 * num_directions);
+    weights[2] = RandomMat(outch * outch * 4 * num_directions);
+
+    ncnn::Option opt;
+    opt.num_threads = 4;
+    opt.use_vulkan_compute = false;
+    opt.use_int8_inference = false;
+    opt.use_fp16_storage = false;
+    opt.use_packing_layout = false;
+
+    ncnn::Layer* op = ncnn::create_layer("LSTM");
+
+    op->load_param(pd);
+
+    ncnn::ModelBinFromMatArray mb(weights.data());
+
+    op->load_model(mb);
+
+    op->create_pipeline(opt);
+
+    // sequences of different length
+    std::vector<ncnn::Mat> bottom_blobs(batch);
+    for (int n = 0; n < batch; n++)
+    {
+        bottom_blobs[n] = RandomMat(size, 1 + n * 3 % 7);
+    }
+
+    // every sequence on its own as reference
+    ncnn::Option opt1 = opt;
+    opt1.num_threads = 1;
+
+    std::vector<ncnn::Mat> b(batch);
+    for (int n = 0; n < batch; n++)
+    {
+        ((ncnn::LSTM*)op)->ncnn::LSTM::forward(bottom_blobs[n], b[n], opt1);
+    }
+
+    // forward_batch sizes the output vector itself
+    std::vector<ncnn::Mat> c;
+    op->forward_batch(bottom_blobs, c, opt);
+
+    op->destroy_pipeline(opt);
+
+    delete op;
+
+    int ret = (int)c.size() == batch ? 0 : -1;
+    for (int n = 0; n < batch && ret == 0; n++)
+    {
+        ret = CompareMat(b[n], c[n], 0.001);
+    }
+
+    if (ret != 0)
+    {
+        fprintf(stderr, "test_lstm_batch failed size=%d outch=%d direction=%d batch=%d\n", size, outch, direction, batch);
+    }
+
+    return ret;
+}
+
+static int test_lstm_int8(const ncnn::Mat& a, int outch, int direction)
+{
+    int input_size = a.w;
+    int num_directions = direction == 2 ? 2 : 1;
+
+    ncnn::ParamDict pd;
+    pd.set(0, outch); // num_output
+    pd.set(1, outch * input_size * 4 * num_directions);
+    pd.set(2, direction);
+
+    std::vector<ncnn::Mat> weights(3);
+    weights[0] = RandomMat(outch * input_size * 4 * num_directions);
+    weights[1] = RandomMat(outch * 4 * num_directions);
+    weights[2] = RandomMat(outch * outch * 4 * num_directions);
+
+    // quantize every weight row and keep the dequantized weight as reference
+    std::vector<ncnn::Mat> weights_int8(5);
+    weights_int8[1] = weights[1];
+    for (int k = 0; k < 2; k++)
+    {
+        ncnn::Mat& weight = weights[k * 2];
+        const int rows = outch * 4 * num_directions;
+        const int row_size = weight.w / rows;
+
+        ncnn::Mat weight_int8(weight.w, (size_t)1u);
+        ncnn::Mat scales(rows);
+        for (int r = 0; r < rows; r++)
+        {
+            float* ptr = (float*)weight + r * row_size;
+            signed char* ptr_int8 = (signed char*)weight_int8 + r * row_size;
+
+            float absmax = 0.f;
+            for (int i = 0; i < row_size; i++)
+            {
+                absmax = std::max(absmax, (float)fabs(ptr[i]));
+            }
+
+            scales[r] = absmax == 0.f ? 1.f : 127 / absmax;
+            for (int i = 0; i < row_size; i++)
+            {
+                ptr_int8[i] = (signed char)round(ptr[i] * scales[r]);
+                ptr[i] = ptr_int8[i] / scales[r];
+            }
+        }
+
+        weights_int8[k * 2] = weight_int8;
+        weights_int8[3 + k] = scales;
+    }
+
+    ncnn::Option opt;
+    opt.num_threads = 1;
+    opt.use_vulkan_compute = false;
+    opt.use_int8_inference = false;
+    opt.use_fp16_storage = false;
+
+    ncnn::Layer* op = ncnn::create_layer("LSTM");
+    ncnn::Layer* op_int8 = ncnn::create_layer("LSTM");
+
+    op->load_param(pd);
+    pd.set(8, 1); // int8_scale_term
+    op_int8->load_param(pd);
+
+    ncnn::ModelBinFromMatArray mb(weights.data());
+    ncnn::ModelBinFromMatArray mb_int8(weights_int8.data());
+
+    op->load_model(mb);
+    op_int8->load_model(mb_int8);
+
+    op->create_pipeline(opt);
+    op_int8->create_pipeline(opt);
+
+    ncnn::Mat b;
+    op->forward(a, b, opt);
+
+    ncnn::Mat c;
+    op_int8->forward(a, c, opt);
+
+    op->destroy_pipeline(opt);
+    op_int8->destroy_pipeline(opt);
+
+    delete op;
+    delete op_int8;
+
+    int ret = CompareMat(b, c, 0.001);
+    if (ret != 0)
+    {
+        fprintf(stderr, "test_lstm_int8 failed a.dims=%d a=(%d %d %d) outch=%d direction=%d\n", a.dims, a.w, a.h, a.c, outch, direction);
+    }
+
+    return ret;
+}
+
 static int test_lstm_0()
 {
     return 0
@@ -210,8 +372,28 @@ static int test_lstm_3()
            || test_lstm(RandomMat(2, 5), 17, 1);
 }
 
+static int test_lstm_4()
+{
+    return 0
+           || test_lstm_batch(4, 1, 0, 1)
+           || test_lstm_batch(8, 2, 1, 3)
+           || test_lstm_batch(16, 7, 2, 4)
+           || test_lstm_batch(17, 8, 0, 5)
+           || test_lstm_batch(19, 16, 2, 2)
+           || test_lstm_batch(5, 17, 1, 6);
+}
+
+static int test_lstm_5()
+{
+    return 0
+           || test_lstm_int8(RandomMat(4, 3), 2, 0)
+           || test_lstm_int8(RandomMat(16, 8), 7, 1)
+           || test_lstm_int8(RandomMat(17, 8), 8, 2)
+           || test_lstm_int8(RandomMat(5, 16), 16, 2);
+}
+
 int main()
 {
     SRAND(7767517);
-    return 0 || test_lstm_0() || test_lstm_1() || test_lstm_2() || test_lstm_3();
+    return 0 || test_lstm_0() || test_lstm_1() || test_lstm_2() || test_lstm_3() || test_lstm_4() || test_lstm_5();
 }
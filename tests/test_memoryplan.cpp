@@ -0,0 +1,226 @@
+// Tencent is pleased to support the open source community by making ncnn available.
+//
+// Copyright (C) 2020 THL A29 Limited, a Tencent company. All rights reserved.
+//
+// Licensed under the BSD 3-Clause License (the "License"); you may not use this file except
+// in compliance with the License. You may obtain a copy of the License at
+//
+// https://opensource.org/licenses/BSD-3-Clause
+//
+// Unless required by applicable law or agreed to in writing, software distributed
+// under the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR
+// CONDITIONS OF ANY KIND, either express or implied. See the License for the
+// specific language governing permissions and limitations under the License.
+
+#include "testutil.h"
+
+static int test_arena_allocator_0()
+{
+    ncnn::ArenaAllocator arena;
+    arena.reserve(1024, 0);
+
+    // planned offsets are served first
+    arena.push_planned(512, 256);
+    unsigned char* p0 = (unsigned char*)arena.fastMalloc(200);
+
+    // first fit takes the hole in front
+    unsigned char* p1 = (unsigned char*)arena.fastMalloc(300);
+
+    // the rest does not fit anywhere
+    unsigned char* p2 = (unsigned char*)arena.fastMalloc(600);
+
+    int ret = 0;
+    if (p1 + 512 != p0 || !arena.owns(p0) || !arena.owns(p1) || arena.owns(p2) || arena.fallback_count() != 1)
+    {
+        fprintf(stderr, "test_arena_allocator_0 placement failed fallback_count=%d\n", arena.fallback_count());
+        ret = -1;
+    }
+
+    arena.fastFree(p2);
+    arena.fastFree(p1);
+
+    // a planned slot overlapping a live payout is skipped for first fit
+    arena.push_planned(448, 128);
+    unsigned char* p3 = (unsigned char*)arena.fastMalloc(100);
+    if (p3 != p1)
+    {
+        fprintf(stderr, "test_arena_allocator_0 overlapping plan failed\n");
+        ret = -1;
+    }
+
+    arena.fastFree(p3);
+    arena.fastFree(p0);
+
+    return ret;
+}
+
+// extract output with a fresh extractor, mallocs counts the blob allocations
+static int extract_counted(const ncnn::Net& net, const ncnn::Mat& in, ncnn::Mat& out, int& mallocs)
+{
+    CountingAllocator blob_allocator;
+
+    {
+        ncnn::Extractor ex = net.create_extractor();
+        ex.set_blob_allocator(&blob_allocator);
+
+        ex.input("data", in);
+
+        ncnn::Mat out0;
+        int ret = ex.extract("output", out0);
+        if (ret != 0)
+            return ret;
+
+        out = out0.clone();
+    }
+
+    mallocs = blob_allocator.count;
+
+    return 0;
+}
+
+// the arena falls back to the blob allocator when a blob does not fit the plan
+// so a planned extract allocates the returned output blob only
+static int test_memoryplan(int w, int h, bool hinted)
+{
+    ncnn::Mat in = RandomMat(w, h, 3);
+
+    ncnn::Net net;
+    LoadTestNet(net);
+
+    ncnn::Net net_planned;
+    net_planned.opt.use_memory_plan = true;
+    LoadTestNet(net_planned);
+
+    ncnn::Mat out;
+    int mallocs = 0;
+    extract_counted(net, in, out, mallocs);
+
+    // the hinted shape is planned from the start, other shapes from the second extract on
+    ncnn::Mat out_planned0;
+    ncnn::Mat out_planned1;
+    int mallocs_planned0 = 0;
+    int mallocs_planned1 = 0;
+    extract_counted(net_planned, in, out_planned0, mallocs_planned0);
+    extract_counted(net_planned, in, out_planned1, mallocs_planned1);
+
+    if (CompareMat(out, out_planned0, 0.001) != 0 || CompareMat(out, out_planned1, 0.001) != 0)
+    {
+        fprintf(stderr, "test_memoryplan output mismatch w=%d h=%d\n", w, h);
+        return -1;
+    }
+
+    if ((hinted && mallocs_planned0 != 1) || mallocs_planned1 != 1)
+    {
+        fprintf(stderr, "test_memoryplan fallback w=%d h=%d mallocs=%d %d %d\n", w, h, mallocs, mallocs_planned0, mallocs_planned1);
+        return -1;
+    }
+
+    return 0;
+}
+
+static int test_memoryplan_0()
+{
+    return 0
+           || test_memoryplan(16, 16, true)
+           || test_memoryplan(24, 20, false)
+           || test_memoryplan(7, 9, false);
+}
+
+static int test_memoryplan_1()
+{
+    // shapes other than the hinted one, the cache holds two plans
+    ncnn::Net net;
+    net.opt.use_memory_plan = true;
+    net.opt.memory_plan_cache_size = 2;
+    LoadTestNet(net);
+
+    const int sizes[] = {20, 20, 24, 28, 20, 28, 24, 28};
+    // a planned extract allocates the returned output only, a recording one every blob
+    const bool planned[] = {false, true, false, false, false, true, false, true};
+
+    for (int i = 0; i < 8; i++)
+    {
+        ncnn::Mat in = RandomMat(sizes[i], sizes[i], 3);
+
+        ncnn::Mat out;
+        int mallocs = 0;
+        extract_counted(net, in, out, mallocs);
+
+        if ((mallocs == 1) != planned[i])
+        {
+            fprintf(stderr, "test_memoryplan_1 lru failed i=%d size=%d mallocs=%d\n", i, sizes[i], mallocs);
+            return -1;
+        }
+    }
+
+    return 0;
+}
+
+static int test_memoryplan_bucket(int w, int h, int bucket)
+{
+    ncnn::Mat in = RandomMat(w, h, 3);
+
+    const int wpad = (w + bucket - 1) / bucket * bucket - w;
+    const int hpad = (h + bucket - 1) / bucket * bucket - h;
+
+    ncnn::Mat in_padded;
+    ncnn::copy_make_border(in, in_padded, 0, hpad, 0, wpad, ncnn::BORDER_CONSTANT, 0.f);
+
+    ncnn::Net net;
+    LoadTestNet(net);
+
+    ncnn::Mat out;
+    int mallocs = 0;
+    extract_counted(net, in_padded, out, mallocs);
+
+    ncnn::Net net_bucket;
+    net_bucket.opt.use_memory_plan = true;
+    net_bucket.opt.shape_bucket_size = bucket;
+    LoadTestNet(net_bucket);
+
+    // the output describes the padded input
+    ncnn::Mat out_bucket;
+    int mallocs_bucket = 0;
+    extract_counted(net_bucket, in, out_bucket, mallocs_bucket);
+
+    if (CompareMat(out, out_bucket, 0.001) != 0)
+    {
+        fprintf(stderr, "test_memoryplan_bucket output mismatch w=%d h=%d bucket=%d\n", w, h, bucket);
+        return -1;
+    }
+
+    // another size of the same bucket reuses the plan
+    // allocating the padded input and the returned output only
+    ncnn::Mat in3 = RandomMat(in_padded.w - bucket + 1, in_padded.h - bucket + 1, 3);
+
+    ncnn::Mat out3;
+    int mallocs3 = 0;
+    extract_counted(net_bucket, in3, out3, mallocs3);
+
+    if (out3.w != out.w || out3.h != out.h || mallocs3 != 2)
+    {
+        fprintf(stderr, "test_memoryplan_bucket plan not shared w=%d h=%d bucket=%d mallocs=%d\n", w, h, bucket, mallocs3);
+        return -1;
+    }
+
+    return 0;
+}
+
+static int test_memoryplan_2()
+{
+    return 0
+           || test_memoryplan_bucket(21, 19, 8)
+           || test_memoryplan_bucket(30, 17, 16)
+           || test_memoryplan_bucket(34, 35, 4);
+}
+
+int main()
+{
+    SRAND(7767517);
+
+    return 0
+           || test_arena_allocator_0()
+           || test_memoryplan_0()
+           || test_memoryplan_1()
+           || test_memoryplan_2();
+}
@@ -0,0 +1,222 @@
+// Tencent is pleased to support the open source community by making ncnn available.
+//
+// Copyright (C) 2020 THL A29 Limited, a Tencent company. All rights reserved.
+//
+// Licensed under the BSD 3-Clause License (the "License"); you may not use this file except
+// in compliance with the License. You may obtain a copy of the License at
+//
+// https://opensource.org/licenses/BSD-3-Clause
+//
+// Unless required by applicable law or agreed to in writing, software distributed
+// under the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR
+// CONDITIONS OF ANY KIND, either express or implied. See the License for the
+// specific language governing permissions and limitations under the License.
+
+#include "testutil.h"
+
+#include "platform.h"
+
+#include <vector>
+
+static const size_t test_sizes[] = {1, 64, 65, 100, 1000, 4096, 5000, 65536, 100000, 1048577};
+static const int test_size_count = sizeof(test_sizes) / sizeof(test_sizes[0]);
+
+// statistics of an idle allocator
+// every block obtained is either cached or in use, and never more than the peak
+static int check_statistics(const ncnn::AllocatorStatistics& s, size_t mallocs, size_t bytes_in_use, const char* tag)
+{
+    if (s.hits + s.misses != mallocs || s.bytes_in_use != bytes_in_use || s.bytes_cached + s.bytes_in_use > s.high_water_mark)
+    {
+        fprintf(stderr, "%s statistics failed mallocs=%d hits=%d misses=%d bytes_cached=%d bytes_in_use=%d high_water_mark=%d\n", tag, (int)mallocs, (int)s.hits, (int)s.misses, (int)s.bytes_cached, (int)s.bytes_in_use, (int)s.high_water_mark);
+        return -1;
+    }
+
+    return 0;
+}
+
+// allocate every test size, fill it all and check alignment, the blocks stay in use
+static int malloc_blocks(ncnn::SizeClassPoolAllocator& allocator, std::vector<void*>& ptrs)
+{
+    for (int i = 0; i < test_size_count; i++)
+    {
+        unsigned char* ptr = (unsigned char*)allocator.fastMalloc(test_sizes[i]);
+        if (!ptr || (size_t)ptr % MALLOC_ALIGN != 0)
+        {
+            fprintf(stderr, "malloc_blocks failed size=%d ptr=%p\n", (int)test_sizes[i], ptr);
+            return -1;
+        }
+
+        memset(ptr, i, test_sizes[i]);
+        ptrs.push_back(ptr);
+    }
+
+    return 0;
+}
+
+static void free_blocks(ncnn::SizeClassPoolAllocator& allocator, std::vector<void*>& ptrs)
+{
+    for (size_t i = 0; i < ptrs.size(); i++)
+    {
+        allocator.fastFree(ptrs[i]);
+    }
+    ptrs.clear();
+}
+
+static int test_sizeclasspoolallocator_0()
+{
+    ncnn::SizeClassPoolAllocator allocator;
+
+    std::vector<void*> ptrs;
+    if (malloc_blocks(allocator, ptrs) != 0)
+        return -1;
+
+    ncnn::AllocatorStatistics s0 = allocator.statistics();
+    if (s0.misses != (size_t)test_size_count || s0.bytes_cached != 0 || s0.bytes_in_use != s0.high_water_mark
+            || check_statistics(s0, test_size_count, s0.high_water_mark, "test_sizeclasspoolallocator_0 in use") != 0)
+        return -1;
+
+    const size_t bytes = s0.bytes_in_use;
+
+    // the freed blocks come back from the thread cache
+    free_blocks(allocator, ptrs);
+
+    ncnn::AllocatorStatistics s1 = allocator.statistics();
+    if (s1.bytes_cached != bytes || check_statistics(s1, test_size_count, 0, "test_sizeclasspoolallocator_0 freed") != 0)
+        return -1;
+
+    if (malloc_blocks(allocator, ptrs) != 0)
+        return -1;
+
+    ncnn::AllocatorStatistics s2 = allocator.statistics();
+    if (s2.hits != (size_t)test_size_count || s2.misses != (size_t)test_size_count || s2.high_water_mark != bytes
+            || check_statistics(s2, test_size_count * 2, bytes, "test_sizeclasspoolallocator_0 reused") != 0)
+        return -1;
+
+    free_blocks(allocator, ptrs);
+
+    // nothing is cached after clear, the peak is kept
+    allocator.clear();
+
+    ncnn::AllocatorStatistics s3 = allocator.statistics();
+    if (s3.bytes_cached != 0 || s3.high_water_mark != bytes || check_statistics(s3, test_size_count * 2, 0, "test_sizeclasspoolallocator_0 cleared") != 0)
+        return -1;
+
+    return 0;
+}
+
+static int test_sizeclasspoolallocator_1()
+{
+    // no thread cache, the freed blocks go through the shared free lists
+    ncnn::SizeClassPoolAllocator allocator;
+    allocator.set_thread_cache_size(0);
+
+    std::vector<void*> ptrs;
+    for (int i = 0; i < 3; i++)
+    {
+        if (malloc_blocks(allocator, ptrs) != 0)
+            return -1;
+
+        free_blocks(allocator, ptrs);
+    }
+
+    ncnn::AllocatorStatistics s = allocator.statistics();
+    if (s.misses != (size_t)test_size_count || check_statistics(s, test_size_count * 3, 0, "test_sizeclasspoolallocator_1") != 0)
+        return -1;
+
+    return 0;
+}
+
+struct test_thread_args
+{
+    ncnn::SizeClassPoolAllocator* allocator;
+    std::vector<void*> ptrs;
+    int rounds;
+    int ret;
+};
+
+static void* test_thread_main(void* args)
+{
+    test_thread_args* ta = (test_thread_args*)args;
+
+    // free the blocks handed over by the main thread
+    free_blocks(*ta->allocator, ta->ptrs);
+
+    ta->ret = 0;
+    for (int i = 0; i < ta->rounds; i++)
+    {
+        if (malloc_blocks(*ta->allocator, ta->ptrs) != 0)
+        {
+            ta->ret = -1;
+            break;
+        }
+
+        free_blocks(*ta->allocator, ta->ptrs);
+    }
+
+    return 0;
+}
+
+static int test_sizeclasspoolallocator_2()
+{
+    const int thread_count = 4;
+    const int rounds = 50;
+
+    ncnn::SizeClassPoolAllocator allocator;
+
+    // blocks allocated here are freed on the threads
+    std::vector<test_thread_args> args(thread_count);
+    for (int i = 0; i < thread_count; i++)
+    {
+        args[i].allocator = &allocator;
+        args[i].rounds = rounds;
+        if (malloc_blocks(allocator, args[i].ptrs) != 0)
+            return -1;
+    }
+
+    std::vector<ncnn::Thread*> threads(thread_count);
+    for (int i = 0; i < thread_count; i++)
+    {
+        threads[i] = new ncnn::Thread(test_thread_main, &args[i]);
+    }
+    for (int i = 0; i < thread_count; i++)
+    {
+        threads[i]->join();
+        delete threads[i];
+    }
+
+    for (int i = 0; i < thread_count; i++)
+    {
+        if (args[i].ret != 0)
+            return -1;
+    }
+
+    // the caches of the exited threads went to the shared free lists with their hits
+    const size_t mallocs = (size_t)test_size_count * thread_count * (rounds + 1);
+
+    ncnn::AllocatorStatistics s0 = allocator.statistics();
+    if (check_statistics(s0, mallocs, 0, "test_sizeclasspoolallocator_2 threads") != 0)
+        return -1;
+
+    // and serve this thread without new blocks
+    std::vector<void*> ptrs;
+    if (malloc_blocks(allocator, ptrs) != 0)
+        return -1;
+
+    ncnn::AllocatorStatistics s1 = allocator.statistics();
+    if (s1.misses != s0.misses || s1.high_water_mark != s0.high_water_mark || check_statistics(s1, mallocs + test_size_count, s1.bytes_in_use, "test_sizeclasspoolallocator_2 reused") != 0)
+        return -1;
+
+    free_blocks(allocator, ptrs);
+
+    return 0;
+}
+
+int main()
+{
+    SRAND(7767517);
+
+    return 0
+           || test_sizeclasspoolallocator_0()
+           || test_sizeclasspoolallocator_1()
+           || test_sizeclasspoolallocator_2();
+}
@@ -0,0 +1,154 @@
+// Tencent is pleased to support the open source community by making ncnn available.
+//
+// Copyright (C) 2020 THL A29 Limited, a Tencent company. All rights reserved.
+//
+// Licensed under the BSD 3-Clause License (the "License"); you may not use this file except
+// in compliance with the License. You may obtain a copy of the License at
+//
+// https://opensource.org/licenses/BSD-3-Clause
+//
+// Unless required by applicable law or agreed to in writing, software distributed
+// under the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR
+// CONDITIONS OF ANY KIND, either express or implied. See the License for the
+// specific language governing permissions and limitations under the License.
+
+#include "testutil.h"
+
+#include <vector>
+
+// frames of two sizes, so that a frame pulled out of order is caught by its shape as well
+static void make_frames(int frame_count, std::vector<ncnn::Mat>& ins, std::vector<ncnn::Mat>& outs, const ncnn::Net& net)
+{
+    ins.resize(frame_count);
+    outs.resize(frame_count);
+
+    for (int i = 0; i < frame_count; i++)
+    {
+        ins[i] = i % 2 == 0 ? RandomMat(16, 16, 3) : RandomMat(20, 20, 3);
+
+        ncnn::Extractor ex = net.create_extractor();
+        ex.input("data", ins[i]);
+        ex.extract("output", outs[i]);
+    }
+}
+
+// pull returns the frames in push order, with the results of a plain extractor
+static int test_streamextractor(int stage_count, int max_inflight, int frame_count)
+{
+    ncnn::Net net;
+    LoadTestNet(net);
+
+    std::vector<ncnn::Mat> ins;
+    std::vector<ncnn::Mat> outs;
+    make_frames(frame_count, ins, outs, net);
+
+    ncnn::StreamExtractor stream(&net, "data", "output", stage_count, 1, max_inflight);
+
+    const int inflight = max_inflight > 0 ? max_inflight : stage_count * 2;
+
+    int pulled = 0;
+    for (int i = 0; i < frame_count; i++)
+    {
+        // pull before pushing beyond max_inflight
+        if (i - pulled == inflight)
+        {
+            ncnn::Mat out;
+            if (stream.pull(out) != 0 || CompareMat(outs[pulled], out, 0.001) != 0)
+            {
+                fprintf(stderr, "test_streamextractor failed stage_count=%d max_inflight=%d frame=%d\n", stage_count, max_inflight, pulled);
+                return -1;
+            }
+            pulled++;
+        }
+
+        if (stream.push(ins[i]) != 0)
+            return -1;
+
+        if (i == 0 && stream.stage_count() != stage_count)
+        {
+            fprintf(stderr, "test_streamextractor stage_count %d expected %d\n", stream.stage_count(), stage_count);
+            return -1;
+        }
+    }
+
+    for (; pulled < frame_count; pulled++)
+    {
+        ncnn::Mat out;
+        if (stream.pull(out) != 0 || CompareMat(outs[pulled], out, 0.001) != 0)
+        {
+            fprintf(stderr, "test_streamextractor failed stage_count=%d max_inflight=%d frame=%d\n", stage_count, max_inflight, pulled);
+            return -1;
+        }
+    }
+
+    // nothing left to pull
+    ncnn::Mat out;
+    if (stream.pull(out) == 0)
+    {
+        fprintf(stderr, "test_streamextractor pulled a frame never pushed\n");
+        return -1;
+    }
+
+    return 0;
+}
+
+static int test_streamextractor_0()
+{
+    return 0
+           || test_streamextractor(1, 0, 5)
+           || test_streamextractor(3, 0, 20)
+           || test_streamextractor(3, 1, 7)
+           || test_streamextractor(4, 3, 16);
+}
+
+// destroyed with frames in flight in every stage, the frames are dropped and the stages stop
+static int test_streamextractor_shutdown(int stage_count, int pushes, int pulls)
+{
+    ncnn::Net net;
+    LoadTestNet(net);
+
+    ncnn::Mat in = RandomMat(16, 16, 3);
+
+    ncnn::StreamExtractor stream(&net, "data", "output", stage_count, 1, pushes);
+
+    for (int i = 0; i < pushes; i++)
+    {
+        if (stream.push(in) != 0)
+            return -1;
+    }
+
+    for (int i = 0; i < pulls; i++)
+    {
+        ncnn::Mat out;
+        if (stream.pull(out) != 0)
+            return -1;
+    }
+
+    return 0;
+}
+
+static int test_streamextractor_1()
+{
+    // never started
+    {
+        ncnn::Net net;
+        LoadTestNet(net);
+
+        ncnn::StreamExtractor stream(&net, "data", "output", 3, 1);
+    }
+
+    return 0
+           || test_streamextractor_shutdown(3, 1, 0)
+           || test_streamextractor_shutdown(3, 6, 0)
+           || test_streamextractor_shutdown(3, 6, 2)
+           || test_streamextractor_shutdown(2, 8, 8);
+}
+
+int main()
+{
+    SRAND(7767517);
+
+    return 0
+           || test_streamextractor_0()
+           || test_streamextractor_1();
+}
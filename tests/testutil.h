@@ -15,13 +15,17 @@
 #ifndef TESTUTIL_H
 #define TESTUTIL_H
 
+#include "allocator.h"
+#include "datareader.h"
 #include "layer.h"
 #include "mat.h"
+#include "net.h"
 #include "prng.h"
 
 #include <algorithm>
 #include <math.h>
 #include <stdio.h>
+#include <string.h>
 
 #if NCNN_VULKAN
 #include "command.h"
@@ -840,4 +844,83 @@ int test_layer(const char* layer_type, const ncnn::ParamDict& pd, const std::vec
     return 0;
 }
 
+// random weights for a whole network
+// the 4 byte weight type tags read as zero, plain fp32 weights follow
+class RandomDataReader : public ncnn::DataReader
+{
+public:
+    virtual size_t read(void* buf, size_t size) const
+    {
+        if (size == 4)
+        {
+            memset(buf, 0, size);
+            return size;
+        }
+
+        float* ptr = (float*)buf;
+        for (size_t i = 0; i < size / sizeof(float); i++)
+        {
+            ptr[i] = RandomFloat();
+        }
+
+        return size;
+    }
+};
+
+// counts the allocations it serves
+class CountingAllocator : public ncnn::Allocator
+{
+public:
+    CountingAllocator()
+        : count(0)
+    {
+    }
+
+    virtual void* fastMalloc(size_t size)
+    {
+        count++;
+        return ncnn::fastMalloc(size);
+    }
+
+    virtual void fastFree(void* ptr)
+    {
+        ncnn::fastFree(ptr);
+    }
+
+public:
+    int count;
+};
+
+// a small branchy network on a 3d input blob named data with output blob named output
+// conv 3x3, relu, split into conv 3x3 and conv 1x1, sum, pool 2x2
+// shape hints for a 16x16x3 input
+static const char* test_net_param = "7767517\n"
+                                    "8 9\n"
+                                    "Input data 0 1 data 0=16 1=16 2=3 -23330=4,3,16,16,3\n"
+                                    "Convolution conv1 1 1 data c1 0=16 1=3 4=1 5=1 6=432 -23330=4,3,16,16,16\n"
+                                    "ReLU relu1 1 1 c1 r1 -23330=4,3,16,16,16\n"
+                                    "Split split 1 2 r1 s0 s1 -23330=8,3,16,16,16,3,16,16,16\n"
+                                    "Convolution conv2 1 1 s0 c2 0=16 1=3 4=1 5=1 6=2304 -23330=4,3,16,16,16\n"
+                                    "Convolution conv3 1 1 s1 c3 0=16 1=1 5=1 6=256 -23330=4,3,16,16,16\n"
+                                    "Eltwise sum 2 1 c2 c3 e 0=1 -23330=4,3,16,16,16\n"
+                                    "Pooling pool 1 1 e output 0=0 1=2 2=2 -23330=4,3,8,8,16\n";
+
+// load test_net_param with the same random weights on every call
+static int LoadTestNet(ncnn::Net& net)
+{
+    int ret = net.load_param_mem(test_net_param);
+    if (ret != 0)
+        return ret;
+
+    struct prng_rand_t saved_state = g_prng_rand_state;
+    prng_srand(7767517, &g_prng_rand_state);
+
+    RandomDataReader dr;
+    ret = net.load_model(dr);
+
+    g_prng_rand_state = saved_state;
+
+    return ret;
+}
+
 #endif // TESTUTIL_H
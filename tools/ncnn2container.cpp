@@ -0,0 +1,580 @@
+// Tencent is pleased to support the open source community by making ncnn available.
+//
+// Copyright (C) 2020 THL A29 Limited, a Tencent company. All rights reserved.
+//
+// Licensed under the BSD 3-Clause License (the "License"); you may not use this file except
+// in compliance with the License. You may obtain a copy of the License at
+//
+// https://opensource.org/licenses/BSD-3-Clause
+//
+// Unless required by applicable law or agreed to in writing, software distributed
+// under the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR
+// CONDITIONS OF ANY KIND, either express or implied. See the License for the
+// specific language governing permissions and limitations under the License.
+
+#include "datareader.h"
+#include "layer.h"
+#include "modelbin.h"
+#include "net.h"
+
+#include <algorithm>
+#include <ctype.h>
+#include <map>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+#include <vector>
+
+// model container layout, see Net::load_container
+static const uint64_t CONTAINER_MAGIC = 0x4e434d43;
+static const uint64_t CONTAINER_VERSION = 1;
+
+static uint64_t align64(uint64_t offset)
+{
+    return (offset + 63) & ~(uint64_t)63;
+}
+
+static unsigned int checksum(unsigned int hash, const unsigned char* data, size_t size)
+{
+    // fnv-1a
+    for (size_t i = 0; i < size; i++)
+    {
+        hash ^= data[i];
+        hash *= 16777619u;
+    }
+
+    return hash;
+}
+
+static bool vstr_is_float(const char vstr[16])
+{
+    // look ahead for determine isfloat
+    for (int j = 0; j < 16; j++)
+    {
+        if (vstr[j] == '\0')
+            break;
+
+        if (vstr[j] == '.' || tolower(vstr[j]) == 'e')
+            return true;
+    }
+
+    return false;
+}
+
+static void append_int(std::vector<unsigned char>& buf, int v)
+{
+    const unsigned char* p = (const unsigned char*)&v;
+    buf.insert(buf.end(), p, p + sizeof(int));
+}
+
+static void append_value(std::vector<unsigned char>& buf, const char vstr[16])
+{
+    if (vstr_is_float(vstr))
+    {
+        float vf = 0.f;
+        sscanf(vstr, "%f", &vf);
+        const unsigned char* p = (const unsigned char*)&vf;
+        buf.insert(buf.end(), p, p + sizeof(float));
+    }
+    else
+    {
+        int v = 0;
+        sscanf(vstr, "%d", &v);
+        append_int(buf, v);
+    }
+}
+
+static void append_string(std::vector<unsigned char>& buf, const std::string& s)
+{
+    buf.insert(buf.end(), s.begin(), s.end());
+    buf.push_back(0);
+}
+
+// convert plain param into binary param and the names table
+// blobs are numbered the way Net::load_param does
+static int convert_param(const char* parampath, std::vector<unsigned char>& parambin, std::vector<unsigned char>& names)
+{
+    FILE* fp = fopen(parampath, "rb");
+    if (!fp)
+    {
+        fprintf(stderr, "fopen %s failed\n", parampath);
+        return -1;
+    }
+
+    int magic = 0;
+    int layer_count = 0;
+    int blob_count = 0;
+    if (fscanf(fp, "%d", &magic) != 1 || magic != 7767517)
+    {
+        fprintf(stderr, "read magic failed\n");
+        fclose(fp);
+        return -1;
+    }
+    if (fscanf(fp, "%d %d", &layer_count, &blob_count) != 2)
+    {
+        fprintf(stderr, "read layer_count and blob_count failed\n");
+        fclose(fp);
+        return -1;
+    }
+    append_int(parambin, magic);
+    append_int(parambin, layer_count);
+    append_int(parambin, blob_count);
+
+    std::vector<std::string> blob_names(blob_count);
+    std::map<std::string, int> blob_indexes;
+    int blob_index = 0;
+
+    for (int i = 0; i < layer_count; i++)
+    {
+        char layer_type[256];
+        char layer_name[256];
+        int bottom_count = 0;
+        int top_count = 0;
+        if (fscanf(fp, "%255s %255s %d %d", layer_type, layer_name, &bottom_count, &top_count) != 4)
+        {
+            fprintf(stderr, "read layer %d failed\n", i);
+            fclose(fp);
+            return -1;
+        }
+
+        int typeindex = ncnn::layer_to_index(layer_type);
+        if (typeindex == -1)
+        {
+            fprintf(stderr, "custom layer %s is not supported\n", layer_type);
+            fclose(fp);
+            return -1;
+        }
+
+        append_int(parambin, typeindex);
+        append_int(parambin, bottom_count);
+        append_int(parambin, top_count);
+
+        append_string(names, layer_type);
+        append_string(names, layer_name);
+
+        for (int j = 0; j < bottom_count; j++)
+        {
+            char bottom_name[256];
+            if (fscanf(fp, "%255s", bottom_name) != 1)
+            {
+                fprintf(stderr, "read bottom_name failed\n");
+                fclose(fp);
+                return -1;
+            }
+
+            std::map<std::string, int>::const_iterator it = blob_indexes.find(bottom_name);
+            int bottom_blob_index = it == blob_indexes.end() ? -1 : it->second;
+            if (bottom_blob_index == -1)
+            {
+                // a blob nobody produces, numbered on first use
+                if (blob_index >= blob_count)
+                {
+                    fprintf(stderr, "blob_count %d too small\n", blob_count);
+                    fclose(fp);
+                    return -1;
+                }
+
+                bottom_blob_index = blob_index;
+                blob_names[blob_index] = bottom_name;
+                blob_indexes[bottom_name] = blob_index;
+                blob_index++;
+            }
+
+            append_int(parambin, bottom_blob_index);
+        }
+
+        for (int j = 0; j < top_count; j++)
+        {
+            char blob_name[256];
+            if (fscanf(fp, "%255s", blob_name) != 1)
+            {
+                fprintf(stderr, "read blob_name failed\n");
+                fclose(fp);
+                return -1;
+            }
+
+            if (blob_index >= blob_count)
+            {
+                fprintf(stderr, "blob_count %d too small\n", blob_count);
+                fclose(fp);
+                return -1;
+            }
+
+            // bottoms refer to the first blob of a name, as find_blob_index_by_name does
+            blob_names[blob_index] = blob_name;
+            blob_indexes.insert(std::make_pair(std::string(blob_name), blob_index));
+
+            append_int(parambin, blob_index);
+
+            blob_index++;
+        }
+
+        // layer specific params
+        int id = 0;
+        while (fscanf(fp, "%d=", &id) == 1)
+        {
+            append_int(parambin, id);
+
+            if (id <= -23300)
+            {
+                int len = 0;
+                if (fscanf(fp, "%d", &len) != 1)
+                {
+                    fprintf(stderr, "read array length failed\n");
+                    fclose(fp);
+                    return -1;
+                }
+                append_int(parambin, len);
+
+                for (int j = 0; j < len; j++)
+                {
+                    char vstr[16];
+                    if (fscanf(fp, ",%15[^,\n ]", vstr) != 1)
+                    {
+                        fprintf(stderr, "read array element failed\n");
+                        fclose(fp);
+                        return -1;
+                    }
+
+                    append_value(parambin, vstr);
+                }
+            }
+            else
+            {
+                char vstr[16];
+                if (fscanf(fp, "%15s", vstr) != 1)
+                {
+                    fprintf(stderr, "read value failed\n");
+                    fclose(fp);
+                    return -1;
+                }
+
+                append_value(parambin, vstr);
+            }
+        }
+
+        append_int(parambin, -233);
+    }
+
+    fclose(fp);
+
+    for (int i = 0; i < blob_count; i++)
+    {
+        append_string(names, blob_names[i]);
+    }
+
+    return 0;
+}
+
+static int read_file(const char* path, std::vector<unsigned char>& buf)
+{
+    FILE* fp = fopen(path, "rb");
+    if (!fp)
+    {
+        fprintf(stderr, "fopen %s failed\n", path);
+        return -1;
+    }
+
+    fseek(fp, 0, SEEK_END);
+    long size = ftell(fp);
+    fseek(fp, 0, SEEK_SET);
+
+    buf.resize(size);
+    size_t nread = size > 0 ? fread(buf.data(), 1, size, fp) : 0;
+    fclose(fp);
+
+    if (nread != (size_t)size)
+    {
+        fprintf(stderr, "read %s failed\n", path);
+        return -1;
+    }
+
+    return 0;
+}
+
+// one weight as stored in the model file
+struct WeightRange
+{
+    size_t offset;
+    size_t size;
+    int type;
+};
+
+// forward to ModelBinFromDataReader and note where each weight lies in the model file
+class ModelBinRecorder : public ncnn::ModelBin
+{
+public:
+    ModelBinRecorder(const unsigned char* _base, const unsigned char*& _mem, std::vector<WeightRange>& _ranges)
+        : base(_base), mem(_mem), dr(_mem), mb(dr), ranges(_ranges)
+    {
+    }
+
+    virtual ncnn::Mat load(int w, int type) const
+    {
+        WeightRange range;
+        range.offset = mem - base;
+        range.type = type;
+
+        ncnn::Mat m = mb.load(w, type);
+
+        range.size = (mem - base) - range.offset;
+        if (!m.empty())
+            ranges.push_back(range);
+
+        return m;
+    }
+
+protected:
+    const unsigned char* base;
+    const unsigned char*& mem;
+    ncnn::DataReaderFromMemory dr;
+    ncnn::ModelBinFromDataReader mb;
+    std::vector<WeightRange>& ranges;
+};
+
+static size_t write_padding(FILE* fp, uint64_t offset, uint64_t aligned)
+{
+    static const unsigned char zeros[64] = {0};
+
+    size_t nwrite = 0;
+    while (offset + nwrite < aligned)
+    {
+        size_t n = (size_t)std::min<uint64_t>(aligned - offset - nwrite, 64);
+        nwrite += fwrite(zeros, 1, n, fp);
+    }
+
+    return nwrite;
+}
+
+static int make_container(const char* parampath, const char* modelpath, const char* containerpath, int prepack)
+{
+    std::vector<unsigned char> parambin;
+    std::vector<unsigned char> names;
+    if (convert_param(parampath, parambin, names) != 0)
+        return -1;
+
+    std::vector<unsigned char> modelbin;
+    if (read_file(modelpath, modelbin) != 0)
+        return -1;
+
+    // walk the weights of every layer in load order
+    ncnn::Net net;
+    {
+        const unsigned char* mem = parambin.data();
+        ncnn::DataReaderFromMemory dr(mem);
+        if (net.load_param_bin(dr) != 0)
+        {
+            fprintf(stderr, "load converted param failed\n");
+            return -1;
+        }
+    }
+
+    const int layer_count = (int)net.layers.size();
+
+    std::vector<WeightRange> ranges;
+    std::vector<unsigned int> layer_table(layer_count * 4, 0);
+    const unsigned char* mem = modelbin.data();
+    ModelBinRecorder mbr(modelbin.data(), mem, ranges);
+    for (int i = 0; i < layer_count; i++)
+    {
+        ncnn::Layer* layer = net.layers[i];
+        if (!layer)
+        {
+            fprintf(stderr, "layer %d load_param failed\n", i);
+            return -1;
+        }
+
+        layer_table[i * 4] = (unsigned int)ranges.size();
+        if (layer->load_model(mbr) != 0)
+        {
+            fprintf(stderr, "layer %d load_model failed\n", i);
+            return -1;
+        }
+        layer_table[i * 4 + 1] = (unsigned int)ranges.size() - layer_table[i * 4];
+
+        unsigned int layer_checksum = 2166136261u;
+        for (size_t j = layer_table[i * 4]; j < ranges.size(); j++)
+        {
+            layer_checksum = checksum(layer_checksum, modelbin.data() + ranges[j].offset, ranges[j].size);
+        }
+        layer_table[i * 4 + 2] = layer_checksum;
+    }
+
+    if ((size_t)(mem - modelbin.data()) != modelbin.size())
+    {
+        fprintf(stderr, "%d trailing bytes in %s are dropped\n", (int)(modelbin.size() - (mem - modelbin.data())), modelpath);
+    }
+
+    // place the sections
+    const int mat_count = (int)ranges.size();
+    const int pipeline_count = prepack ? 1 : 0;
+
+    uint64_t header[16] = {0};
+    header[0] = CONTAINER_MAGIC;
+    header[1] = CONTAINER_VERSION;
+    header[2] = layer_count;
+    header[3] = mat_count;
+    header[4] = align64(sizeof(header));
+    header[5] = parambin.size();
+    header[6] = align64(header[4] + header[5]);
+    header[7] = names.size();
+    header[8] = align64(header[6] + header[7]);
+    header[9] = align64(header[8] + layer_count * 16);
+    header[10] = align64(header[9] + mat_count * 16);
+    header[11] = pipeline_count;
+
+    // the payload after the type 0 flag lands on 64 bytes
+    std::vector<uint64_t> mat_table(mat_count * 2);
+    uint64_t offset = header[10] + pipeline_count * 16;
+    for (int i = 0; i < mat_count; i++)
+    {
+        const uint64_t flag_size = ranges[i].type == 0 ? 4 : 0;
+        offset = align64(offset + flag_size) - flag_size;
+        mat_table[i * 2] = offset;
+        mat_table[i * 2 + 1] = ranges[i].size;
+        offset += ranges[i].size;
+    }
+
+    FILE* fp = fopen(containerpath, "wb");
+    if (!fp)
+    {
+        fprintf(stderr, "fopen %s failed\n", containerpath);
+        return -1;
+    }
+
+    // weights first, the index follows once the pipeline sections are placed
+    fseek(fp, (long)(header[10] + pipeline_count * 16), SEEK_SET);
+    offset = header[10] + pipeline_count * 16;
+    for (int i = 0; i < mat_count; i++)
+    {
+        offset += write_padding(fp, offset, mat_table[i * 2]);
+        offset += fwrite(modelbin.data() + ranges[i].offset, 1, ranges[i].size, fp);
+    }
+
+    std::vector<uint64_t> pipeline_table(pipeline_count * 2);
+    if (prepack)
+    {
+        // the transformed weights of this cpu with the default option
+        ncnn::Net pnet;
+        if (pnet.load_param(parampath) != 0 || pnet.load_model(modelpath) != 0)
+        {
+            fprintf(stderr, "load %s %s failed\n", parampath, modelpath);
+            fclose(fp);
+            return -1;
+        }
+
+        offset += write_padding(fp, offset, align64(offset));
+        pipeline_table[0] = offset;
+        if (pnet.save_pipeline_cache(fp) != 0)
+        {
+            fprintf(stderr, "write pipeline section failed\n");
+            fclose(fp);
+            return -1;
+        }
+        pipeline_table[1] = (uint64_t)ftell(fp) - offset;
+        offset += pipeline_table[1];
+    }
+
+    header[12] = offset;
+
+    unsigned int index_checksum = 2166136261u;
+    index_checksum = checksum(index_checksum, (const unsigned char*)header, sizeof(header));
+    index_checksum = checksum(index_checksum, parambin.data(), parambin.size());
+    index_checksum = checksum(index_checksum, names.data(), names.size());
+    index_checksum = checksum(index_checksum, (const unsigned char*)layer_table.data(), layer_count * 16);
+    index_checksum = checksum(index_checksum, (const unsigned char*)mat_table.data(), mat_count * 16);
+    index_checksum = checksum(index_checksum, (const unsigned char*)pipeline_table.data(), pipeline_count * 16);
+    header[13] = index_checksum;
+
+    fseek(fp, 0, SEEK_SET);
+    offset = fwrite(header, 1, sizeof(header), fp);
+    offset += write_padding(fp, offset, header[4]);
+    offset += fwrite(parambin.data(), 1, parambin.size(), fp);
+    offset += write_padding(fp, offset, header[6]);
+    offset += fwrite(names.data(), 1, names.size(), fp);
+    offset += write_padding(fp, offset, header[8]);
+    offset += fwrite(layer_table.data(), 1, layer_count * 16, fp);
+    offset += write_padding(fp, offset, header[9]);
+    offset += fwrite(mat_table.data(), 1, mat_count * 16, fp);
+    offset += write_padding(fp, offset, header[10]);
+    offset += fwrite(pipeline_table.data(), 1, pipeline_count * 16, fp);
+
+    int ret = ferror(fp) ? -1 : 0;
+    fclose(fp);
+
+    if (ret != 0)
+    {
+        fprintf(stderr, "write %s failed\n", containerpath);
+        return -1;
+    }
+
+    fprintf(stderr, "%d layers %d weights %d pipeline sections %lu bytes\n", layer_count, mat_count, pipeline_count, (unsigned long)header[12]);
+
+    return 0;
+}
+
+// verify the weight checksum of every layer, which load_container leaves alone
+static int check_container(const char* containerpath)
+{
+    ncnn::Net net;
+    if (net.load_container(containerpath) != 0)
+        return -1;
+
+    std::vector<unsigned char> buf;
+    if (read_file(containerpath, buf) != 0)
+        return -1;
+
+    uint64_t header[16];
+    memcpy(header, buf.data(), sizeof(header));
+
+    const unsigned int* layer_table = (const unsigned int*)(buf.data() + header[8]);
+    const uint64_t* mat_table = (const uint64_t*)(buf.data() + header[9]);
+
+    int ret = 0;
+    for (uint64_t i = 0; i < header[2]; i++)
+    {
+        unsigned int layer_checksum = 2166136261u;
+        for (unsigned int j = 0; j < layer_table[i * 4 + 1]; j++)
+        {
+            const uint64_t* mat = mat_table + (layer_table[i * 4] + j) * 2;
+            layer_checksum = checksum(layer_checksum, buf.data() + mat[0], (size_t)mat[1]);
+        }
+
+        if (layer_checksum != layer_table[i * 4 + 2])
+        {
+            fprintf(stderr, "layer %d %s weight checksum mismatch\n", (int)i, net.layers[i]->name.c_str());
+            ret = -1;
+        }
+    }
+
+    if (ret == 0)
+    {
+        fprintf(stderr, "%s ok\n", containerpath);
+    }
+
+    return ret;
+}
+
+int main(int argc, char** argv)
+{
+    if (argc == 2)
+    {
+        return check_container(argv[1]);
+    }
+
+    if (argc != 4 && argc != 5)
+    {
+        fprintf(stderr, "Usage: %s [ncnnparam] [ncnnbin] [container] [prepack=0]\n", argv[0]);
+        fprintf(stderr, "       %s [container]\n", argv[0]);
+        return -1;
+    }
+
+    const char* parampath = argv[1];
+    const char* modelpath = argv[2];
+    const char* containerpath = argv[3];
+    int prepack = argc == 5 ? atoi(argv[4]) : 0;
+
+    return make_container(parampath, modelpath, containerpath, prepack);
+}
@@ -1408,7 +1408,7 @@ int main(int argc, char** argv)
                 node_reference[input_name] = node_reference[input_name] + 1;
             }
 
-            if (op == "LSTM")
+            if (op == "GRU" || op == "LSTM")
             {
                 // ignore all optional input blobs
                 break;
@@ -1422,7 +1422,7 @@ int main(int argc, char** argv)
             continue;
         }
 
-        if (op == "LSTM")
+        if (op == "GRU" || op == "LSTM")
         {
             const std::string& output_name = node.output(0);
             blob_names.insert(output_name);
@@ -1778,6 +1778,13 @@ int main(int argc, char** argv)
         {
             fprintf(pp, "%-16s", "Pooling");
         }
+        else if (op == "GRU")
+        {
+            fprintf(pp, "%-16s", "GRU");
+            // force no output hidden blob
+            input_size = 1;
+            output_size = 1;
+        }
         else if (op == "HardSigmoid")
         {
             fprintf(pp, "%-16s", "HardSigmoid");
@@ -2509,6 +2516,146 @@ int main(int argc, char** argv)
             fprintf(pp, " 0=%d", pool);
             fprintf(pp, " 4=%d", global_pool);
         }
+        else if (op == "GRU")
+        {
+            const onnx::TensorProto& W = weights[node.input(1)];
+            const onnx::TensorProto& R = weights[node.input(2)];
+            const onnx::TensorProto& B = weights[node.input(3)];
+
+            int hidden_size = get_node_attr_i(node, "hidden_size", 0);
+            std::string direction = get_node_attr_s(node, "direction");
+            int linear_before_reset = get_node_attr_i(node, "linear_before_reset", 0);
+
+            if (linear_before_reset == 0)
+            {
+                fprintf(stderr, "Unsupported GRU linear_before_reset 0!\n");
+            }
+
+            int direction_type = 0;
+            if (direction == "forward")
+            {
+                direction_type = 0;
+            }
+            else if (direction == "reverse")
+            {
+                direction_type = 1;
+            }
+            else if (direction == "bidirectional")
+            {
+                direction_type = 2;
+            }
+
+            int weight_data_size = get_tensor_proto_data_size(W);
+
+            fprintf(pp, " 0=%d", hidden_size);
+            fprintf(pp, " 1=%d", weight_data_size);
+            fprintf(pp, " 2=%d", direction_type);
+
+            int num_directions = direction_type == 2 ? 2 : 1;
+
+            int quantize_tag = 0;
+
+            // reorder num_directions-URN-hidden-size to num_directions-RUN-hidden-size
+            {
+                fwrite(&quantize_tag, sizeof(int), 1, bp);
+
+                int weight_data_size_g = get_tensor_proto_data_size(W) / 3 / num_directions;
+                const float* wptr = W.has_raw_data() ? (const float*)W.raw_data().data() : W.float_data().data();
+
+                const float* uptr = wptr;
+                const float* rptr = wptr + weight_data_size_g;
+                const float* nptr = wptr + weight_data_size_g * 2;
+                fwrite(rptr, sizeof(float), weight_data_size_g, bp);
+                fwrite(uptr, sizeof(float), weight_data_size_g, bp);
+                fwrite(nptr, sizeof(float), weight_data_size_g, bp);
+
+                if (direction_type == 2)
+                {
+                    uptr += weight_data_size_g * 3;
+                    rptr += weight_data_size_g * 3;
+                    nptr += weight_data_size_g * 3;
+                    fwrite(rptr, sizeof(float), weight_data_size_g, bp);
+                    fwrite(uptr, sizeof(float), weight_data_size_g, bp);
+                    fwrite(nptr, sizeof(float), weight_data_size_g, bp);
+                }
+            }
+
+            // reduce U and R bias except N
+            // reorder num_directions-URN-hidden to num_directions-RUN-hidden
+            {
+                fwrite(&quantize_tag, sizeof(int), 1, bp);
+
+                int bias_data_size_g = get_tensor_proto_data_size(B) / 2 / 3 / num_directions;
+                const float* bptr = B.has_raw_data() ? (const float*)B.raw_data().data() : B.float_data().data();
+                const float* wuptr = bptr;
+                const float* wrptr = bptr + bias_data_size_g;
+                const float* wnptr = bptr + bias_data_size_g * 2;
+                const float* buptr = bptr + bias_data_size_g * 3;
+                const float* brptr = bptr + bias_data_size_g * 4;
+                const float* bnptr = bptr + bias_data_size_g * 5;
+
+                for (int j = 0; j < bias_data_size_g; j++)
+                {
+                    float vb = wrptr[j] + brptr[j];
+                    fwrite(&vb, sizeof(float), 1, bp);
+                }
+                for (int j = 0; j < bias_data_size_g; j++)
+                {
+                    float vb = wuptr[j] + buptr[j];
+                    fwrite(&vb, sizeof(float), 1, bp);
+                }
+                fwrite(wnptr, sizeof(float), bias_data_size_g, bp);
+                fwrite(bnptr, sizeof(float), bias_data_size_g, bp);
+
+                if (direction_type == 2)
+                {
+                    wuptr += bias_data_size_g * 6;
+                    wrptr += bias_data_size_g * 6;
+                    wnptr += bias_data_size_g * 6;
+                    buptr += bias_data_size_g * 6;
+                    brptr += bias_data_size_g * 6;
+                    bnptr += bias_data_size_g * 6;
+
+                    for (int j = 0; j < bias_data_size_g; j++)
+                    {
+                        float vb = wrptr[j] + brptr[j];
+                        fwrite(&vb, sizeof(float), 1, bp);
+                    }
+                    for (int j = 0; j < bias_data_size_g; j++)
+                    {
+                        float vb = wuptr[j] + buptr[j];
+                        fwrite(&vb, sizeof(float), 1, bp);
+                    }
+                    fwrite(wnptr, sizeof(float), bias_data_size_g, bp);
+                    fwrite(bnptr, sizeof(float), bias_data_size_g, bp);
+                }
+            }
+
+            // reorder num_directions-URN-hidden-hidden to num_directions-RUN-hidden-hidden
+            {
+                fwrite(&quantize_tag, sizeof(int), 1, bp);
+
+                int weight_data_size_g = get_tensor_proto_data_size(R) / 3 / num_directions;
+                const float* Rptr = R.has_raw_data() ? (const float*)R.raw_data().data() : R.float_data().data();
+
+                const float* uptr = Rptr;
+                const float* rptr = Rptr + weight_data_size_g;
+                const float* nptr = Rptr + weight_data_size_g * 2;
+                fwrite(rptr, sizeof(float), weight_data_size_g, bp);
+                fwrite(uptr, sizeof(float), weight_data_size_g, bp);
+                fwrite(nptr, sizeof(float), weight_data_size_g, bp);
+
+                if (direction_type == 2)
+                {
+                    uptr += weight_data_size_g * 3;
+                    rptr += weight_data_size_g * 3;
+                    nptr += weight_data_size_g * 3;
+                    fwrite(rptr, sizeof(float), weight_data_size_g, bp);
+                    fwrite(uptr, sizeof(float), weight_data_size_g, bp);
+                    fwrite(nptr, sizeof(float), weight_data_size_g, bp);
+                }
+            }
+        }
         else if (op == "HardSigmoid")
         {
             float alpha = get_node_attr_f(node, "alpha", 0.2f);
@@ -16,6 +16,8 @@
 #define _CRT_SECURE_NO_DEPRECATE
 #endif
 
+#include <algorithm>
+#include <cmath>
 #include <cstdio>
 #include <cstring>
 #include <map>
@@ -44,6 +46,7 @@
 #include "layer/elu.h"
 #include "layer/exp.h"
 #include "layer/flatten.h"
+#include "layer/gru.h"
 #include "layer/innerproduct.h"
 #include "layer/input.h"
 #include "layer/instancenorm.h"
@@ -159,6 +162,8 @@ public:
     int quantize_convolution();
     int quantize_convolutiondepthwise();
     int quantize_innerproduct();
+    int quantize_deconvolution();
+    int quantize_rnn();
 
 public:
     int fprintf_param_int_array(int id, const ncnn::Mat& m, FILE* pp);
@@ -298,7 +303,15 @@ int NetQuantize::quantize_convolutiondepthwise()
             convdw->weight_data = int8_weight_data;
         }
 
-        convdw->int8_scale_term = 1;
+        // one input scale per channel when the table holds a scale for every group
+        if ((int)iter_data->second.size() == convdw->group && convdw->group > 1)
+        {
+            convdw->int8_scale_term = 3;
+        }
+        else
+        {
+            convdw->int8_scale_term = 1;
+        }
     }
 
     return 0;
@@ -371,6 +384,181 @@ int NetQuantize::quantize_innerproduct()
     return 0;
 }
 
+int NetQuantize::quantize_deconvolution()
+{
+    const int layer_count = static_cast<int>(layers.size());
+    for (int i = 0; i < layer_count; i++)
+    {
+        // find deconvolution layer
+        if (layers[i]->type != "Deconvolution")
+            continue;
+
+        std::map<std::string, std::vector<float> >::iterator iter_data = blob_int8scale_table.find(layers[i]->name);
+        if (iter_data == blob_int8scale_table.end())
+            continue;
+
+        char key[256];
+        sprintf(key, "%s_param_0", layers[i]->name.c_str());
+
+        std::map<std::string, std::vector<float> >::iterator iter = weight_int8scale_table.find(key);
+        if (iter == weight_int8scale_table.end())
+        {
+            fprintf(stderr, "this layer need to be quantized, but no scale param!\n");
+            return -1;
+        }
+
+        // Deconvolution - quantize weight from fp32 to int8
+        ncnn::Deconvolution* deconvolution = (ncnn::Deconvolution*)layers[i];
+
+        std::vector<float> weight_data_int8_scales = iter->second;
+
+        fprintf(stderr, "quantize_deconvolution %s\n", deconvolution->name.c_str());
+
+        {
+            ncnn::Mat int8_weight_data(deconvolution->weight_data_size, (size_t)1u);
+            if (int8_weight_data.empty())
+                return -100;
+
+            const int weight_data_size_output = deconvolution->weight_data_size / deconvolution->num_output;
+
+            // quantize weight to int8
+            for (int n = 0; n < deconvolution->num_output; n++)
+            {
+                ncnn::Layer* op = ncnn::create_layer(ncnn::LayerType::Quantize);
+
+                ncnn::ParamDict pd;
+                pd.set(0, weight_data_int8_scales[n]); // scale
+
+                op->load_param(pd);
+
+                ncnn::Option opt;
+                opt.blob_allocator = int8_weight_data.allocator;
+
+                const ncnn::Mat weight_data_n = deconvolution->weight_data.range(weight_data_size_output * n, weight_data_size_output);
+                ncnn::Mat int8_weight_data_n = int8_weight_data.range(weight_data_size_output * n, weight_data_size_output);
+                op->forward(weight_data_n, int8_weight_data_n, opt);
+
+                delete op;
+            }
+
+            deconvolution->weight_data = int8_weight_data;
+        }
+
+        deconvolution->int8_scale_term = 2;
+    }
+
+    return 0;
+}
+
+// quantize every weight row of a recurrent layer on its own absmax
+// weight is size x rows x num_directions, scales is rows x num_directions
+static int quantize_rnn_weight(const ncnn::Mat& weight, ncnn::Mat& int8_weight, ncnn::Mat& int8_scales)
+{
+    const int size = weight.w;
+    const int rows = weight.h;
+    const int num_directions = weight.c;
+
+    int8_weight.create(size, rows, num_directions, (size_t)1u);
+    if (int8_weight.empty())
+        return -100;
+
+    int8_scales.create(rows, num_directions);
+    if (int8_scales.empty())
+        return -100;
+
+    for (int d = 0; d < num_directions; d++)
+    {
+        for (int r = 0; r < rows; r++)
+        {
+            const float* ptr = weight.channel(d).row(r);
+
+            float absmax = 0.f;
+            for (int k = 0; k < size; k++)
+            {
+                absmax = std::max(absmax, (float)fabs(ptr[k]));
+            }
+
+            const float scale = absmax == 0.f ? 1.f : 127 / absmax;
+            int8_scales.row(d)[r] = scale;
+
+            ncnn::Layer* op = ncnn::create_layer(ncnn::LayerType::Quantize);
+
+            ncnn::ParamDict pd;
+            pd.set(0, scale); // scale
+
+            op->load_param(pd);
+
+            ncnn::Option opt;
+            opt.blob_allocator = int8_weight.allocator;
+
+            const ncnn::Mat weight_r = weight.channel(d).row_range(r, 1).reshape(size);
+            ncnn::Mat int8_weight_r = int8_weight.channel(d).row_range(r, 1).reshape(size);
+            op->forward(weight_r, int8_weight_r, opt);
+
+            delete op;
+        }
+    }
+
+    return 0;
+}
+
+int NetQuantize::quantize_rnn()
+{
+    const int layer_count = static_cast<int>(layers.size());
+    for (int i = 0; i < layer_count; i++)
+    {
+        // LSTM and GRU keep fp32 activations, only the weight is stored as int8
+        // so the scales come from the weight itself and need no calibration
+        if (layers[i]->type == "LSTM")
+        {
+            ncnn::LSTM* lstm = (ncnn::LSTM*)layers[i];
+
+            fprintf(stderr, "quantize_rnn %s\n", lstm->name.c_str());
+
+            ncnn::Mat int8_weight_xc_data;
+            int ret = quantize_rnn_weight(lstm->weight_xc_data, int8_weight_xc_data, lstm->weight_xc_data_int8_scales);
+            if (ret != 0)
+                return ret;
+
+            lstm->weight_xc_data = int8_weight_xc_data;
+
+            ncnn::Mat int8_weight_hc_data;
+            ret = quantize_rnn_weight(lstm->weight_hc_data, int8_weight_hc_data, lstm->weight_hc_data_int8_scales);
+            if (ret != 0)
+                return ret;
+
+            lstm->weight_hc_data = int8_weight_hc_data;
+
+            lstm->int8_scale_term = 2;
+        }
+
+        if (layers[i]->type == "GRU")
+        {
+            ncnn::GRU* gru = (ncnn::GRU*)layers[i];
+
+            fprintf(stderr, "quantize_rnn %s\n", gru->name.c_str());
+
+            ncnn::Mat int8_weight_xc_data;
+            int ret = quantize_rnn_weight(gru->weight_xc_data, int8_weight_xc_data, gru->weight_xc_data_int8_scales);
+            if (ret != 0)
+                return ret;
+
+            gru->weight_xc_data = int8_weight_xc_data;
+
+            ncnn::Mat int8_weight_hc_data;
+            ret = quantize_rnn_weight(gru->weight_hc_data, int8_weight_hc_data, gru->weight_hc_data_int8_scales);
+            if (ret != 0)
+                return ret;
+
+            gru->weight_hc_data = int8_weight_hc_data;
+
+            gru->int8_scale_term = 2;
+        }
+    }
+
+    return 0;
+}
+
 int NetQuantize::fprintf_param_int_array(int id, const ncnn::Mat& m, FILE* pp)
 {
     const int count = m.w;
@@ -736,8 +924,17 @@ int NetQuantize::save(const char* parampath, const char* binpath)
             {
                 if (op->pad_bottom != op->pad_top) fprintf(pp, " 16=%d", op->pad_bottom);
             }
+            fprintf_param_value(" 18=%d", output_pad_right)
+            {
+                if (op->output_pad_bottom != op->output_pad_right) fprintf(pp, " 19=%d", op->output_pad_bottom);
+            }
+            fprintf_param_value(" 20=%d", output_w)
+            {
+                if (op->output_h != op->output_w) fprintf(pp, " 21=%d", op->output_h);
+            }
             fprintf_param_value(" 5=%d", bias_term)
             fprintf_param_value(" 6=%d", weight_data_size)
+            fprintf_param_value(" 8=%d", int8_scale_term)
             fprintf_param_value(" 9=%d", activation_type)
             {
                 if (!op->activation_params.empty()) fprintf_param_float_array(10, op->activation_params, pp);
@@ -745,6 +942,30 @@ int NetQuantize::save(const char* parampath, const char* binpath)
 
             fwrite_weight_tag_data(0, op->weight_data, bp);
             fwrite_weight_data(op->bias_data, bp);
+
+            // write int8_scale data
+            if (op->int8_scale_term)
+            {
+                std::vector<float> weight_int8scale;
+                std::vector<float> blob_int8scale;
+
+                char key[256];
+                sprintf(key, "%s_param_0", layers[i]->name.c_str());
+
+                if (weight_int8scale_table.find(std::string(key)) != weight_int8scale_table.end())
+                {
+                    weight_int8scale = weight_int8scale_table[std::string(key)];
+                }
+
+                if (blob_int8scale_table.find(layer->name) != blob_int8scale_table.end())
+                {
+                    blob_int8scale = blob_int8scale_table[layer->name];
+                }
+
+                // write int8_scale data
+                fwrite(weight_int8scale.data(), sizeof(float), weight_int8scale.size(), bp);
+                fwrite(blob_int8scale.data(), sizeof(float), blob_int8scale.size(), bp);
+            }
         }
         else if (layer->type == "DeconvolutionDepthWise")
         {
@@ -833,6 +1054,27 @@ int NetQuantize::save(const char* parampath, const char* binpath)
             fprintf_param_value(" 1=%f", scale)
             fprintf_param_value(" 2=%f", shift)
         }
+        else if (layer->type == "GRU")
+        {
+            ncnn::GRU* op = (ncnn::GRU*)layer;
+            ncnn::GRU* op_default = (ncnn::GRU*)layer_default;
+
+            fprintf_param_value(" 0=%d", num_output)
+            fprintf_param_value(" 1=%d", weight_data_size)
+            fprintf_param_value(" 2=%d", direction)
+            fprintf_param_value(" 8=%d", int8_scale_term)
+
+            fwrite_weight_tag_data(0, op->weight_xc_data, bp);
+            fwrite_weight_tag_data(0, op->bias_c_data, bp);
+            fwrite_weight_tag_data(0, op->weight_hc_data, bp);
+
+            // write int8_scale data
+            if (op->int8_scale_term)
+            {
+                fwrite_weight_data(op->weight_xc_data_int8_scales, bp);
+                fwrite_weight_data(op->weight_hc_data_int8_scales, bp);
+            }
+        }
         else if (layer->type == "InnerProduct")
         {
             ncnn::InnerProduct* op = (ncnn::InnerProduct*)layer;
@@ -930,10 +1172,18 @@ int NetQuantize::save(const char* parampath, const char* binpath)
             fprintf_param_value(" 0=%d", num_output)
             fprintf_param_value(" 1=%d", weight_data_size)
             fprintf_param_value(" 2=%d", direction)
+            fprintf_param_value(" 8=%d", int8_scale_term)
 
             fwrite_weight_tag_data(0, op->weight_xc_data, bp);
             fwrite_weight_tag_data(0, op->bias_c_data, bp);
             fwrite_weight_tag_data(0, op->weight_hc_data, bp);
+
+            // write int8_scale data
+            if (op->int8_scale_term)
+            {
+                fwrite_weight_data(op->weight_xc_data_int8_scales, bp);
+                fwrite_weight_data(op->weight_hc_data_int8_scales, bp);
+            }
         }
         else if (layer->type == "MemoryData")
         {
@@ -1297,6 +1547,8 @@ int main(int argc, char** argv)
     quantizer.quantize_convolution();
     quantizer.quantize_convolutiondepthwise();
     quantizer.quantize_innerproduct();
+    quantizer.quantize_deconvolution();
+    quantizer.quantize_rnn();
 
     quantizer.save(outparam, outbin);
 
@@ -36,6 +36,7 @@
 // ncnn private header
 #include "layer/convolution.h"
 #include "layer/convolutiondepthwise.h"
+#include "layer/deconvolution.h"
 #include "layer/innerproduct.h"
 
 static ncnn::Option g_default_option;
@@ -67,10 +68,14 @@ public:
     int get_conv_names();
     int get_conv_bottom_blob_names();
     int get_conv_weight_blob_scales();
+    int get_conv_channel_counts();
     int get_input_names();
 
 public:
     std::vector<std::string> conv_names;
+    std::vector<const ncnn::Layer*> conv_layers;
+    // depthwise layers whose groups see one input channel each, the input may take one scale per channel
+    std::map<std::string, int> conv_channel_counts;
     std::map<std::string, std::string> conv_bottom_blob_names;
     std::map<std::string, std::vector<float> > weight_scales;
     std::vector<std::string> input_names;
@@ -102,10 +107,11 @@ int QuantNet::get_conv_names()
     {
         const ncnn::Layer* layer = layers[i];
 
-        if (layer->type == "Convolution" || layer->type == "ConvolutionDepthWise" || layer->type == "InnerProduct")
+        if (layer->type == "Convolution" || layer->type == "ConvolutionDepthWise" || layer->type == "InnerProduct" || layer->type == "Deconvolution")
         {
             std::string name = layer->name;
             conv_names.push_back(name);
+            conv_layers.push_back(layer);
         }
     }
 
@@ -119,7 +125,7 @@ int QuantNet::get_conv_bottom_blob_names()
     {
         const ncnn::Layer* layer = layers[i];
 
-        if (layer->type == "Convolution" || layer->type == "ConvolutionDepthWise" || layer->type == "InnerProduct")
+        if (layer->type == "Convolution" || layer->type == "ConvolutionDepthWise" || layer->type == "InnerProduct" || layer->type == "Deconvolution")
         {
             const std::string& name = layer->name;
             const std::string& bottom_blob_name = blobs[layer->bottoms[0]].name;
@@ -227,32 +233,96 @@ int QuantNet::get_conv_weight_blob_scales()
 
             weight_scales[name] = scales;
         }
+
+        if (layer->type == "Deconvolution")
+        {
+            const ncnn::Deconvolution* deconvolution = static_cast<const ncnn::Deconvolution*>(layer);
+
+            std::string name = layer->name;
+            const int weight_data_size_output = deconvolution->weight_data_size / deconvolution->num_output;
+            std::vector<float> scales;
+
+            for (int n = 0; n < deconvolution->num_output; n++)
+            {
+                const ncnn::Mat weight_data_n = deconvolution->weight_data.range(weight_data_size_output * n, weight_data_size_output);
+                const float* data_n = weight_data_n;
+                float max_value = std::numeric_limits<float>::min();
+
+                for (int k = 0; k < weight_data_size_output; k++)
+                    max_value = std::max(max_value, std::fabs(data_n[k]));
+
+                scales.push_back(127 / max_value);
+            }
+
+            weight_scales[name] = scales;
+        }
     }
 
     return 0;
 }
 
+int QuantNet::get_conv_channel_counts()
+{
+    for (size_t i = 0; i < layers.size(); i++)
+    {
+        const ncnn::Layer* layer = layers[i];
+
+        if (layer->type == "ConvolutionDepthWise")
+        {
+            const ncnn::ConvolutionDepthWise* convolutiondepthwise = static_cast<const ncnn::ConvolutionDepthWise*>(layer);
+
+            const int maxk = convolutiondepthwise->kernel_w * convolutiondepthwise->kernel_h;
+            if (convolutiondepthwise->group == convolutiondepthwise->num_output && convolutiondepthwise->weight_data_size == maxk * convolutiondepthwise->group)
+            {
+                conv_channel_counts[layer->name] = convolutiondepthwise->group;
+            }
+        }
+    }
+
+    return 0;
+}
+
+// how the clipping threshold is searched in the histogram
+enum CalibrationMethod
+{
+    CALIBRATION_KL = 0,
+    CALIBRATION_ACIQ = 1,
+    CALIBRATION_PERCENTILE = 2,
+    CALIBRATION_MSE = 3
+};
+
 class QuantizeData
 {
 public:
     QuantizeData(const std::string& layer_name, const int& num);
 
-    int initial_blob_max(ncnn::Mat data);
-    int initial_histogram_interval();
-    int initial_histogram_value();
-
-    int normalize_histogram();
+    // widen the range to cover data, then count data into the histogram
     int update_histogram(ncnn::Mat data);
+    // add the histogram another worker counted for the same layer
+    int merge_histogram(const QuantizeData& other);
 
     float compute_kl_divergence(const std::vector<float>& dist_a, const std::vector<float>& dist_b) const;
     int threshold_distribution(const std::vector<float>& distribution, const int target_bin = 128) const;
-    float get_data_blob_scale();
+    int threshold_aciq(const std::vector<float>& distribution) const;
+    int threshold_percentile(const std::vector<float>& distribution, float percentile) const;
+    int threshold_mse(const std::vector<float>& distribution, const int target_bin = 128) const;
+    float get_data_blob_scale(int method, float percentile);
+
+protected:
+    // range becomes 2^exponent, adjacent bins fold together
+    void grow_range(int exponent);
 
 public:
     std::string name;
 
     float max_value;
     int num_bins;
+    // the histogram spans [0, 2^range_exponent), so histograms of any worker line up bin by bin
+    // the range doubles whenever a larger value arrives and one pass over the images is enough
+    bool range_valid;
+    int range_exponent;
+    std::vector<double> histogram_count;
+
     float histogram_interval;
     std::vector<float> histogram;
 
@@ -266,67 +336,68 @@ QuantizeData::QuantizeData(const std::string& layer_name, const int& num)
     name = layer_name;
     max_value = 0.f;
     num_bins = num;
+    range_valid = false;
+    range_exponent = 0;
+    histogram_count.resize(num_bins, 0.0);
+
     histogram_interval = 0.f;
-    histogram.resize(num_bins);
-    initial_histogram_value();
 
     threshold = 0.f;
     threshold_bin = 0;
     scale = 1.0f;
 }
 
-int QuantizeData::initial_blob_max(ncnn::Mat data)
+void QuantizeData::grow_range(int exponent)
 {
-    const int channel_num = data.c;
-    const int size = data.w * data.h;
-
-    for (int q = 0; q < channel_num; q++)
+    if (!range_valid)
     {
-        const float* data_n = data.channel(q);
-        for (int i = 0; i < size; i++)
-        {
-            max_value = std::max(max_value, std::fabs(data_n[i]));
-        }
+        range_valid = true;
+        range_exponent = exponent;
+        return;
     }
 
-    return 0;
-}
+    if (exponent <= range_exponent)
+        return;
 
-int QuantizeData::initial_histogram_interval()
-{
-    histogram_interval = max_value / static_cast<float>(num_bins);
-
-    return 0;
-}
+    const int shift = exponent - range_exponent;
+    const int factor = shift < 31 ? 1 << shift : num_bins;
 
-int QuantizeData::initial_histogram_value()
-{
-    for (size_t i = 0; i < histogram.size(); i++)
+    std::vector<double> folded(num_bins, 0.0);
+    for (int i = 0; i < num_bins; i++)
     {
-        histogram[i] = 0.00001f;
+        folded[std::min(i / factor, num_bins - 1)] += histogram_count[i];
     }
 
-    return 0;
+    histogram_count.swap(folded);
+    range_exponent = exponent;
 }
 
-int QuantizeData::normalize_histogram()
+int QuantizeData::update_histogram(ncnn::Mat data)
 {
-    const size_t length = histogram.size();
-    float sum = 0;
+    const int channel_num = data.c;
+    const int size = data.w * data.h;
 
-    for (size_t i = 0; i < length; i++)
-        sum += histogram[i];
+    float data_max = 0.f;
+    for (int q = 0; q < channel_num; q++)
+    {
+        const float* data_n = data.channel(q);
+        for (int i = 0; i < size; i++)
+        {
+            data_max = std::max(data_max, std::fabs(data_n[i]));
+        }
+    }
 
-    for (size_t i = 0; i < length; i++)
-        histogram[i] /= sum;
+    if (data_max == 0.f)
+        return 0;
 
-    return 0;
-}
+    max_value = std::max(max_value, data_max);
 
-int QuantizeData::update_histogram(ncnn::Mat data)
-{
-    const int channel_num = data.c;
-    const int size = data.w * data.h;
+    // the power of two above data_max
+    int exponent = 0;
+    frexp(data_max, &exponent);
+    grow_range(exponent);
+
+    const float inv_interval = num_bins / ldexp(1.f, range_exponent);
 
     for (int q = 0; q < channel_num; q++)
     {
@@ -336,15 +407,35 @@ int QuantizeData::update_histogram(ncnn::Mat data)
             if (data_n[i] == 0)
                 continue;
 
-            const int index = std::min(static_cast<int>(std::abs(data_n[i]) / histogram_interval), 2047);
+            const int index = std::min(static_cast<int>(std::fabs(data_n[i]) * inv_interval), num_bins - 1);
 
-            histogram[index]++;
+            histogram_count[index]++;
         }
     }
 
     return 0;
 }
 
+int QuantizeData::merge_histogram(const QuantizeData& other)
+{
+    if (!other.range_valid)
+        return 0;
+
+    max_value = std::max(max_value, other.max_value);
+
+    grow_range(other.range_exponent);
+
+    const int shift = range_exponent - other.range_exponent;
+    const int factor = shift < 31 ? 1 << shift : num_bins;
+
+    for (int i = 0; i < num_bins; i++)
+    {
+        histogram_count[std::min(i / factor, num_bins - 1)] += other.histogram_count[i];
+    }
+
+    return 0;
+}
+
 float QuantizeData::compute_kl_divergence(const std::vector<float>& dist_a, const std::vector<float>& dist_b) const
 {
     const size_t length = dist_a.size();
@@ -500,10 +591,113 @@ int QuantizeData::threshold_distribution(const std::vector<float>& distribution,
     return target_threshold;
 }
 
-float QuantizeData::get_data_blob_scale()
+int QuantizeData::threshold_aciq(const std::vector<float>& distribution) const
+{
+    const int length = static_cast<int>(distribution.size());
+
+    // fit laplace(0, b) to the absolute values, b being their mean
+    float b = 0.f;
+    for (int i = 0; i < length; i++)
+    {
+        b += distribution[i] * (static_cast<float>(i) + 0.5f);
+    }
+
+    // the clipping value with the least expected 8bit quantization noise on laplace(0, b)
+    const int target_threshold = static_cast<int>(9.89f * b);
+
+    return std::max(1, std::min(target_threshold, length - 1));
+}
+
+int QuantizeData::threshold_percentile(const std::vector<float>& distribution, float percentile) const
+{
+    const int length = static_cast<int>(distribution.size());
+
+    const float target_sum = percentile / 100.f;
+
+    float sum = 0.f;
+    for (int i = 0; i < length; i++)
+    {
+        sum += distribution[i];
+        if (sum >= target_sum)
+            return i;
+    }
+
+    return length - 1;
+}
+
+int QuantizeData::threshold_mse(const std::vector<float>& distribution, const int target_bin) const
+{
+    const int length = static_cast<int>(distribution.size());
+
+    double total = 0.0;
+    for (int i = 0; i < length; i++)
+    {
+        total += distribution[i];
+    }
+
+    // values above the threshold clip to it, the ones below round to target_bin - 1 levels
+    // walking down from the top keeps the moments of the clipped tail at hand
+    int target_threshold = length - 1;
+    double min_error = std::numeric_limits<double>::max();
+
+    double tail_count = 0.0;
+    double tail_sum = 0.0;
+    double tail_sum2 = 0.0;
+
+    for (int threshold = length - 1; threshold > 0; threshold--)
+    {
+        const double t = threshold + 0.5;
+        const double step = t / (target_bin - 1);
+
+        const double round_error = (total - tail_count) * step * step / 12;
+        const double clip_error = tail_sum2 - 2 * t * tail_sum + t * t * tail_count;
+
+        if (round_error + clip_error < min_error)
+        {
+            min_error = round_error + clip_error;
+            target_threshold = threshold;
+        }
+
+        tail_count += distribution[threshold];
+        tail_sum += distribution[threshold] * t;
+        tail_sum2 += distribution[threshold] * t * t;
+    }
+
+    return target_threshold;
+}
+
+float QuantizeData::get_data_blob_scale(int method, float percentile)
 {
-    normalize_histogram();
-    threshold_bin = threshold_distribution(histogram);
+    // the range is at most twice the max value, leave out the empty bins above it
+    int length = num_bins;
+    while (length > 1 && histogram_count[length - 1] == 0)
+        length--;
+
+    histogram.resize(length);
+    for (int i = 0; i < length; i++)
+    {
+        histogram[i] = static_cast<float>(histogram_count[i]) + 0.00001f;
+    }
+
+    const size_t histogram_length = histogram.size();
+    float sum = 0;
+
+    for (size_t i = 0; i < histogram_length; i++)
+        sum += histogram[i];
+
+    for (size_t i = 0; i < histogram_length; i++)
+        histogram[i] /= sum;
+
+    histogram_interval = ldexp(1.f, range_exponent) / static_cast<float>(num_bins);
+    if (method == CALIBRATION_ACIQ)
+        threshold_bin = threshold_aciq(histogram);
+    else if (method == CALIBRATION_PERCENTILE)
+        threshold_bin = threshold_percentile(histogram, percentile);
+    else if (method == CALIBRATION_MSE)
+        threshold_bin = threshold_mse(histogram);
+    else
+        threshold_bin = threshold_distribution(histogram);
+
     threshold = (static_cast<float>(threshold_bin) + 0.5f) * histogram_interval;
     scale = 127 / threshold;
     return scale;
@@ -518,209 +712,586 @@ struct PreParam
     bool swapRB;
 };
 
-static int post_training_quantize(const std::vector<std::string>& image_list, const std::string& param_path, const std::string& bin_path, const std::string& table_path, struct PreParam& per_param)
+struct CalibrationParam
 {
-    size_t size = image_list.size();
+    int num_workers;
+    int method;
+    float percentile;
+    // one activation scale per channel for depthwise convolution
+    bool per_channel;
+    // layers whose simulated int8 relative error is above this stay fp32, 0 quantizes all
+    float mixed_error;
+};
 
-    QuantNet net;
-    net.opt = g_default_option;
+// what the calibration workers share
+struct CalibrationContext
+{
+    const QuantNet* net;
+    const std::vector<std::string>* image_list;
+    const PreParam* pre_param;
+    int num_threads;
+
+    // the merged histograms to search the thresholds of
+    std::vector<QuantizeData*>* threshold_tasks;
+    int method;
+    float percentile;
+
+    // the layers to measure the int8 error of, in fp32 and with fake quantized weights
+    std::vector<ncnn::Layer*>* reference_layers;
+    std::vector<ncnn::Layer*>* quantized_layers;
+    std::vector<std::vector<float> >* bottom_blob_scales;
+    size_t sensitivity_image_count;
+
+    ncnn::Mutex lock;
+    // next image to calibrate, or next layer to search the threshold of
+    size_t next;
+    int ret;
+};
 
-    net.load_param(param_path.c_str());
-    net.load_model(bin_path.c_str());
+struct CalibrationWorker
+{
+    CalibrationContext* ctx;
 
-    float mean_vals[3];
-    float norm_vals[3];
+    // histograms of the images this worker took, in conv_names order
+    std::vector<QuantizeData> quantize_datas;
+    // per channel histograms, empty for layers with one scale
+    std::vector<std::vector<QuantizeData> > channel_quantize_datas;
 
-    int width = per_param.width;
-    int height = per_param.height;
-    bool swapRB = per_param.swapRB;
+    // squared output error and squared output of every layer
+    std::vector<double> error_sums;
+    std::vector<double> energy_sums;
+};
 
-    mean_vals[0] = per_param.mean[0];
-    mean_vals[1] = per_param.mean[1];
-    mean_vals[2] = per_param.mean[2];
+static int load_calibration_image(const std::string& img_name, const PreParam& pre_param, ncnn::Mat& in)
+{
+#if OpenCV_VERSION_MAJOR > 2
+    cv::Mat bgr = cv::imread(img_name, cv::IMREAD_COLOR);
+#else
+    cv::Mat bgr = cv::imread(img_name, CV_LOAD_IMAGE_COLOR);
+#endif
+    if (bgr.empty())
+    {
+        fprintf(stderr, "cv::imread %s failed\n", img_name.c_str());
+        return -1;
+    }
 
-    norm_vals[0] = per_param.norm[0];
-    norm_vals[1] = per_param.norm[1];
-    norm_vals[2] = per_param.norm[2];
+    in = ncnn::Mat::from_pixels_resize(bgr.data, pre_param.swapRB ? ncnn::Mat::PIXEL_BGR2RGB : ncnn::Mat::PIXEL_BGR, bgr.cols, bgr.rows, pre_param.width, pre_param.height);
+    in.substract_mean_normalize(pre_param.mean, pre_param.norm);
 
-    g_blob_pool_allocator.clear();
-    g_workspace_pool_allocator.clear();
+    return 0;
+}
 
-    net.get_input_names();
-    net.get_conv_names();
-    net.get_conv_bottom_blob_names();
-    net.get_conv_weight_blob_scales();
+static void* calibration_worker_func(void* args)
+{
+    CalibrationWorker* worker = (CalibrationWorker*)args;
+    CalibrationContext* ctx = worker->ctx;
+    const QuantNet& net = *ctx->net;
+    const std::vector<std::string>& image_list = *ctx->image_list;
 
-    if (net.input_names.empty())
-    {
-        fprintf(stderr, "not found [Input] Layer, Check your ncnn.param \n");
-        return -1;
-    }
+    const size_t size = image_list.size();
 
-    FILE* fp = fopen(table_path.c_str(), "w");
+    // blob memory is not shared between workers
+    ncnn::UnlockedPoolAllocator blob_pool_allocator;
+    ncnn::UnlockedPoolAllocator workspace_pool_allocator;
+    blob_pool_allocator.set_size_compare_ratio(0.0f);
+    workspace_pool_allocator.set_size_compare_ratio(0.5f);
 
-    // save quantization scale of weight
-    printf("====> Quantize the parameters.\n");
-    for (size_t i = 0; i < net.conv_names.size(); i++)
+    for (;;)
     {
-        std::string layer_name = net.conv_names[i];
-        std::string blob_name = net.conv_bottom_blob_names[layer_name];
-        std::vector<float> weight_scale_n = net.weight_scales[layer_name];
+        ctx->lock.lock();
+        const size_t i = ctx->next++;
+        const bool failed = ctx->ret != 0;
+        ctx->lock.unlock();
 
-        fprintf(fp, "%s_param_0 ", layer_name.c_str());
-        for (size_t j = 0; j < weight_scale_n.size(); j++)
+        if (i >= size || failed)
+            break;
+
+        if ((i + 1) % 100 == 0)
         {
-            fprintf(fp, "%f ", weight_scale_n[j]);
+            fprintf(stderr, "          %d/%d\n", static_cast<int>(i + 1), static_cast<int>(size));
+        }
+
+        ncnn::Mat in;
+        if (load_calibration_image(image_list[i], *ctx->pre_param, in) != 0)
+        {
+            ctx->lock.lock();
+            ctx->ret = -1;
+            ctx->lock.unlock();
+            break;
+        }
+
+        ncnn::Extractor ex = net.create_extractor();
+        ex.set_num_threads(ctx->num_threads);
+        ex.set_blob_allocator(&blob_pool_allocator);
+        ex.set_workspace_allocator(&workspace_pool_allocator);
+        ex.input(net.input_names[0].c_str(), in);
+
+        for (size_t j = 0; j < net.conv_names.size(); j++)
+        {
+            const std::string& layer_name = net.conv_names[j];
+            const std::string& blob_name = net.conv_bottom_blob_names.find(layer_name)->second;
+
+            ncnn::Mat out;
+            ex.extract(blob_name.c_str(), out);
+
+            worker->quantize_datas[j].update_histogram(out);
+
+            std::vector<QuantizeData>& channel_quantize_datas = worker->channel_quantize_datas[j];
+            for (size_t q = 0; q < channel_quantize_datas.size(); q++)
+            {
+                channel_quantize_datas[q].update_histogram(out.channel(q));
+            }
         }
-        fprintf(fp, "\n");
     }
 
-    // initial quantization data
-    std::vector<QuantizeData> quantize_datas;
+    return 0;
+}
+
+static void* threshold_worker_func(void* args)
+{
+    CalibrationWorker* worker = (CalibrationWorker*)args;
+    CalibrationContext* ctx = worker->ctx;
 
-    for (size_t i = 0; i < net.conv_names.size(); i++)
+    // histograms are independent from here on
+    std::vector<QuantizeData*>& threshold_tasks = *ctx->threshold_tasks;
+
+    for (;;)
     {
-        std::string layer_name = net.conv_names[i];
+        ctx->lock.lock();
+        const size_t i = ctx->next++;
+        ctx->lock.unlock();
 
-        QuantizeData quantize_data(layer_name, 2048);
-        quantize_datas.push_back(quantize_data);
+        if (i >= threshold_tasks.size())
+            break;
+
+        threshold_tasks[i]->get_data_blob_scale(ctx->method, ctx->percentile);
     }
 
-    // step 1 count the max value
-    printf("====> Quantize the activation.\n");
-    printf("    ====> step 1 : find the max value.\n");
+    return 0;
+}
 
-    for (size_t i = 0; i < image_list.size(); i++)
+static float fake_quantize(float v, float scale)
+{
+    float q = static_cast<float>(round(v * scale));
+    q = std::min(std::max(q, -127.f), 127.f);
+    return q / scale;
+}
+
+// the blob as int8 inference sees it, one scale for all channels or one for each
+static ncnn::Mat fake_quantize_blob(const ncnn::Mat& blob, const std::vector<float>& scales)
+{
+    ncnn::Mat blob_fq = blob.clone();
+
+    const int size = blob_fq.w * blob_fq.h;
+    for (int q = 0; q < blob_fq.c; q++)
     {
-        std::string img_name = image_list[i];
+        const float scale = scales.size() == 1 ? scales[0] : scales[q];
 
-        if ((i + 1) % 100 == 0)
+        float* ptr = blob_fq.channel(q);
+        for (int i = 0; i < size; i++)
         {
-            fprintf(stderr, "          %d/%d\n", static_cast<int>(i + 1), static_cast<int>(size));
+            ptr[i] = fake_quantize(ptr[i], scale);
         }
+    }
 
-#if OpenCV_VERSION_MAJOR > 2
-        cv::Mat bgr = cv::imread(img_name, cv::IMREAD_COLOR);
-#else
-        cv::Mat bgr = cv::imread(img_name, CV_LOAD_IMAGE_COLOR);
-#endif
-        if (bgr.empty())
+    return blob_fq;
+}
+
+// the weight as int8 inference sees it, split evenly between the scales
+static ncnn::Mat fake_quantize_weight(const ncnn::Mat& weight_data, const std::vector<float>& scales)
+{
+    ncnn::Mat weight_data_fq = weight_data.clone();
+
+    const int size = static_cast<int>(weight_data_fq.total() / scales.size());
+    for (size_t n = 0; n < scales.size(); n++)
+    {
+        float* ptr = (float*)weight_data_fq + size * n;
+        for (int i = 0; i < size; i++)
         {
-            fprintf(stderr, "cv::imread %s failed\n", img_name.c_str());
-            return -1;
+            ptr[i] = fake_quantize(ptr[i], scales[n]);
         }
+    }
+
+    return weight_data_fq;
+}
+
+// the generic fp32 implementation of a conv layer, with fake quantized weights if scales are given
+static ncnn::Layer* create_reference_layer(const ncnn::Layer* layer, const std::vector<float>* weight_scales)
+{
+    if (layer->type == "Convolution")
+    {
+        ncnn::Convolution* op = new ncnn::Convolution(*static_cast<const ncnn::Convolution*>(layer));
+        if (weight_scales)
+            op->weight_data = fake_quantize_weight(op->weight_data, *weight_scales);
+        return op;
+    }
+
+    if (layer->type == "ConvolutionDepthWise")
+    {
+        ncnn::ConvolutionDepthWise* op = new ncnn::ConvolutionDepthWise(*static_cast<const ncnn::ConvolutionDepthWise*>(layer));
+        if (weight_scales)
+            op->weight_data = fake_quantize_weight(op->weight_data, *weight_scales);
+        return op;
+    }
+
+    if (layer->type == "Deconvolution")
+    {
+        ncnn::Deconvolution* op = new ncnn::Deconvolution(*static_cast<const ncnn::Deconvolution*>(layer));
+        if (weight_scales)
+            op->weight_data = fake_quantize_weight(op->weight_data, *weight_scales);
+        return op;
+    }
 
-        ncnn::Mat in = ncnn::Mat::from_pixels_resize(bgr.data, swapRB ? ncnn::Mat::PIXEL_BGR2RGB : ncnn::Mat::PIXEL_BGR, bgr.cols, bgr.rows, width, height);
-        in.substract_mean_normalize(mean_vals, norm_vals);
+    ncnn::InnerProduct* op = new ncnn::InnerProduct(*static_cast<const ncnn::InnerProduct*>(layer));
+    if (weight_scales)
+        op->weight_data = fake_quantize_weight(op->weight_data, *weight_scales);
+    return op;
+}
+
+static void* sensitivity_worker_func(void* args)
+{
+    CalibrationWorker* worker = (CalibrationWorker*)args;
+    CalibrationContext* ctx = worker->ctx;
+    const QuantNet& net = *ctx->net;
+    const std::vector<std::string>& image_list = *ctx->image_list;
+
+    ncnn::UnlockedPoolAllocator blob_pool_allocator;
+    ncnn::UnlockedPoolAllocator workspace_pool_allocator;
+    blob_pool_allocator.set_size_compare_ratio(0.0f);
+    workspace_pool_allocator.set_size_compare_ratio(0.5f);
+
+    ncnn::Option opt = net.opt;
+    opt.num_threads = ctx->num_threads;
+    opt.blob_allocator = &blob_pool_allocator;
+    opt.workspace_allocator = &workspace_pool_allocator;
+
+    for (;;)
+    {
+        ctx->lock.lock();
+        const size_t i = ctx->next++;
+        const bool failed = ctx->ret != 0;
+        ctx->lock.unlock();
+
+        if (i >= ctx->sensitivity_image_count || failed)
+            break;
+
+        ncnn::Mat in;
+        if (load_calibration_image(image_list[i], *ctx->pre_param, in) != 0)
+        {
+            ctx->lock.lock();
+            ctx->ret = -1;
+            ctx->lock.unlock();
+            break;
+        }
 
         ncnn::Extractor ex = net.create_extractor();
+        ex.set_num_threads(ctx->num_threads);
+        ex.set_blob_allocator(&blob_pool_allocator);
+        ex.set_workspace_allocator(&workspace_pool_allocator);
         ex.input(net.input_names[0].c_str(), in);
 
+        // every layer takes the fp32 input, so the error is its own
         for (size_t j = 0; j < net.conv_names.size(); j++)
         {
-            std::string layer_name = net.conv_names[j];
-            std::string blob_name = net.conv_bottom_blob_names[layer_name];
+            const std::string& layer_name = net.conv_names[j];
+            const std::string& blob_name = net.conv_bottom_blob_names.find(layer_name)->second;
 
-            ncnn::Mat out;
-            ex.extract(blob_name.c_str(), out);
+            ncnn::Mat bottom_blob;
+            ex.extract(blob_name.c_str(), bottom_blob);
+
+            ncnn::Mat bottom_blob_fq = fake_quantize_blob(bottom_blob, (*ctx->bottom_blob_scales)[j]);
+
+            ncnn::Mat top_blob;
+            ncnn::Mat top_blob_fq;
+            (*ctx->reference_layers)[j]->forward(bottom_blob, top_blob, opt);
+            (*ctx->quantized_layers)[j]->forward(bottom_blob_fq, top_blob_fq, opt);
 
-            for (size_t k = 0; k < quantize_datas.size(); k++)
+            const int size = top_blob.w * top_blob.h;
+            for (int q = 0; q < top_blob.c; q++)
             {
-                if (quantize_datas[k].name == layer_name)
+                const float* ptr = top_blob.channel(q);
+                const float* ptr_fq = top_blob_fq.channel(q);
+                for (int k = 0; k < size; k++)
                 {
-                    quantize_datas[k].initial_blob_max(out);
-                    break;
+                    worker->error_sums[j] += (ptr_fq[k] - ptr[k]) * (ptr_fq[k] - ptr[k]);
+                    worker->energy_sums[j] += ptr[k] * ptr[k];
                 }
             }
         }
     }
 
-    // step 2 histogram_interval
-    printf("    ====> step 2 : generate the histogram_interval.\n");
-    for (size_t i = 0; i < net.conv_names.size(); i++)
+    return 0;
+}
+
+// run func on workers_count threads, the calling thread being the first
+static void run_calibration_workers(void* (*func)(void*), std::vector<CalibrationWorker>& workers, int workers_count)
+{
+    std::vector<ncnn::Thread*> threads(workers_count - 1);
+    for (int i = 1; i < workers_count; i++)
+    {
+        threads[i - 1] = new ncnn::Thread(func, &workers[i]);
+    }
+
+    func(&workers[0]);
+
+    for (int i = 1; i < workers_count; i++)
+    {
+        threads[i - 1]->join();
+        delete threads[i - 1];
+    }
+}
+
+static const char* calibration_method_name(int method)
+{
+    if (method == CALIBRATION_ACIQ)
+        return "aciq";
+    if (method == CALIBRATION_PERCENTILE)
+        return "percentile";
+    if (method == CALIBRATION_MSE)
+        return "mse";
+    return "kld";
+}
+
+static int post_training_quantize(const std::vector<std::string>& image_list, const std::string& param_path, const std::string& bin_path, const std::string& table_path, struct PreParam& per_param, const struct CalibrationParam& calibration_param)
+{
+    size_t size = image_list.size();
+
+    QuantNet net;
+    net.opt = g_default_option;
+
+    net.load_param(param_path.c_str());
+    net.load_model(bin_path.c_str());
+
+    net.get_input_names();
+    net.get_conv_names();
+    net.get_conv_bottom_blob_names();
+    net.get_conv_weight_blob_scales();
+    net.get_conv_channel_counts();
+
+    if (net.input_names.empty())
+    {
+        fprintf(stderr, "not found [Input] Layer, Check your ncnn.param \n");
+        return -1;
+    }
+
+    const size_t layer_count = net.conv_names.size();
+
+    // initial quantization data
+    std::vector<QuantizeData> quantize_datas;
+    std::vector<std::vector<QuantizeData> > channel_quantize_datas(layer_count);
+
+    for (size_t i = 0; i < layer_count; i++)
     {
         std::string layer_name = net.conv_names[i];
 
-        for (size_t k = 0; k < quantize_datas.size(); k++)
+        // twice the 2048 bins over [0, max value], as the range may reach twice the max value
+        QuantizeData quantize_data(layer_name, 4096);
+        quantize_datas.push_back(quantize_data);
+
+        // fewer bins per channel, there are far fewer values to count
+        if (calibration_param.per_channel && net.conv_channel_counts.find(layer_name) != net.conv_channel_counts.end())
         {
-            if (quantize_datas[k].name == layer_name)
-            {
-                quantize_datas[k].initial_histogram_interval();
+            channel_quantize_datas[i].resize(net.conv_channel_counts[layer_name], QuantizeData(layer_name, 512));
+        }
+    }
+
+    const int workers_count = std::max(1, std::min(calibration_param.num_workers, static_cast<int>(size)));
+
+    CalibrationContext ctx;
+    ctx.net = &net;
+    ctx.image_list = &image_list;
+    ctx.pre_param = &per_param;
+    ctx.num_threads = g_default_option.num_threads;
+    ctx.threshold_tasks = 0;
+    ctx.method = calibration_param.method;
+    ctx.percentile = calibration_param.percentile;
+    ctx.reference_layers = 0;
+    ctx.quantized_layers = 0;
+    ctx.bottom_blob_scales = 0;
+    ctx.sensitivity_image_count = 0;
+    ctx.next = 0;
+    ctx.ret = 0;
+
+    std::vector<CalibrationWorker> workers(workers_count);
+    for (int i = 0; i < workers_count; i++)
+    {
+        workers[i].ctx = &ctx;
+        workers[i].quantize_datas = quantize_datas;
+        workers[i].channel_quantize_datas = channel_quantize_datas;
+    }
+
+    // step 1 histogram, every image is decoded and run once
+    printf("====> Quantize the activation.\n");
+    printf("    ====> step 1 : generate the histogram with %d workers.\n", workers_count);
 
-                fprintf(stderr, "%-20s : max = %-15f interval = %-10f\n", quantize_datas[k].name.c_str(), quantize_datas[k].max_value, quantize_datas[k].histogram_interval);
-                break;
+    run_calibration_workers(calibration_worker_func, workers, workers_count);
+
+    if (ctx.ret != 0)
+    {
+        return ctx.ret;
+    }
+
+    // step 2 merge
+    printf("    ====> step 2 : merge the histogram of workers.\n");
+    for (int i = 1; i < workers_count; i++)
+    {
+        for (size_t k = 0; k < layer_count; k++)
+        {
+            workers[0].quantize_datas[k].merge_histogram(workers[i].quantize_datas[k]);
+
+            for (size_t q = 0; q < channel_quantize_datas[k].size(); q++)
+            {
+                workers[0].channel_quantize_datas[k][q].merge_histogram(workers[i].channel_quantize_datas[k][q]);
             }
         }
+
+        workers[i].quantize_datas.clear();
+        workers[i].channel_quantize_datas.clear();
     }
 
-    // step 3 histogram
-    printf("    ====> step 3 : generate the histogram.\n");
-    for (size_t i = 0; i < image_list.size(); i++)
+    for (size_t k = 0; k < layer_count; k++)
     {
-        std::string img_name = image_list[i];
+        const QuantizeData& quantize_data = workers[0].quantize_datas[k];
+        fprintf(stderr, "%-20s : max = %-15f range = %-15f\n", quantize_data.name.c_str(), quantize_data.max_value, ldexp(1.f, quantize_data.range_exponent));
+    }
 
-        if ((i + 1) % 100 == 0)
-            fprintf(stderr, "          %d/%d\n", (int)(i + 1), (int)size);
-#if OpenCV_VERSION_MAJOR > 2
-        cv::Mat bgr = cv::imread(img_name, cv::IMREAD_COLOR);
-#else
-        cv::Mat bgr = cv::imread(img_name, CV_LOAD_IMAGE_COLOR);
-#endif
-        if (bgr.empty())
+    // step 3 threshold, one histogram per worker at a time
+    printf("    ====> step 3 : using %s to find the best threshold value.\n", calibration_method_name(calibration_param.method));
+    std::vector<QuantizeData*> threshold_tasks;
+    for (size_t k = 0; k < layer_count; k++)
+    {
+        threshold_tasks.push_back(&workers[0].quantize_datas[k]);
+
+        for (size_t q = 0; q < channel_quantize_datas[k].size(); q++)
         {
-            fprintf(stderr, "cv::imread %s failed\n", img_name.c_str());
-            return -1;
+            threshold_tasks.push_back(&workers[0].channel_quantize_datas[k][q]);
         }
+    }
 
-        ncnn::Mat in = ncnn::Mat::from_pixels_resize(bgr.data, swapRB ? ncnn::Mat::PIXEL_BGR2RGB : ncnn::Mat::PIXEL_BGR, bgr.cols, bgr.rows, width, height);
-        in.substract_mean_normalize(mean_vals, norm_vals);
+    ctx.threshold_tasks = &threshold_tasks;
+    ctx.next = 0;
 
-        ncnn::Extractor ex = net.create_extractor();
-        ex.input(net.input_names[0].c_str(), in);
+    run_calibration_workers(threshold_worker_func, workers, workers_count);
 
-        for (size_t j = 0; j < net.conv_names.size(); j++)
+    std::vector<std::vector<float> > bottom_blob_scales(layer_count);
+    for (size_t k = 0; k < layer_count; k++)
+    {
+        const QuantizeData& quantize_data = workers[0].quantize_datas[k];
+
+        fprintf(stderr, "%-20s bin : %-8d threshold : %-15f interval : %-10f scale : %-10f\n",
+                quantize_data.name.c_str(),
+                quantize_data.threshold_bin,
+                quantize_data.threshold,
+                quantize_data.histogram_interval,
+                quantize_data.scale);
+
+        if (channel_quantize_datas[k].empty())
         {
-            std::string layer_name = net.conv_names[j];
-            std::string blob_name = net.conv_bottom_blob_names[layer_name];
+            bottom_blob_scales[k].push_back(quantize_data.scale);
+            continue;
+        }
 
-            ncnn::Mat out;
-            ex.extract(blob_name.c_str(), out);
+        // channels that stayed zero over all images take the layer scale
+        for (size_t q = 0; q < channel_quantize_datas[k].size(); q++)
+        {
+            const QuantizeData& channel_quantize_data = workers[0].channel_quantize_datas[k][q];
+            bottom_blob_scales[k].push_back(channel_quantize_data.range_valid ? channel_quantize_data.scale : quantize_data.scale);
+        }
+    }
+
+    // step 4 sensitivity, the layers with the largest int8 error stay fp32
+    std::vector<bool> keep_fp32(layer_count, false);
+    if (calibration_param.mixed_error > 0.f)
+    {
+        std::vector<ncnn::Layer*> reference_layers(layer_count);
+        std::vector<ncnn::Layer*> quantized_layers(layer_count);
+        for (size_t k = 0; k < layer_count; k++)
+        {
+            reference_layers[k] = create_reference_layer(net.conv_layers[k], 0);
+            quantized_layers[k] = create_reference_layer(net.conv_layers[k], &net.weight_scales[net.conv_names[k]]);
+        }
+
+        ctx.reference_layers = &reference_layers;
+        ctx.quantized_layers = &quantized_layers;
+        ctx.bottom_blob_scales = &bottom_blob_scales;
+        ctx.sensitivity_image_count = std::min(size, (size_t)16);
+        ctx.next = 0;
 
-            for (size_t k = 0; k < quantize_datas.size(); k++)
+        const int sensitivity_workers_count = std::min(workers_count, static_cast<int>(ctx.sensitivity_image_count));
+        for (int i = 0; i < sensitivity_workers_count; i++)
+        {
+            workers[i].error_sums.resize(layer_count, 0.0);
+            workers[i].energy_sums.resize(layer_count, 0.0);
+        }
+
+        printf("    ====> step 4 : measure the int8 error of every layer on %d images.\n", static_cast<int>(ctx.sensitivity_image_count));
+
+        run_calibration_workers(sensitivity_worker_func, workers, sensitivity_workers_count);
+
+        for (size_t k = 0; k < layer_count; k++)
+        {
+            delete reference_layers[k];
+            delete quantized_layers[k];
+        }
+
+        if (ctx.ret != 0)
+        {
+            return ctx.ret;
+        }
+
+        for (size_t k = 0; k < layer_count; k++)
+        {
+            double error_sum = 0.0;
+            double energy_sum = 0.0;
+            for (int i = 0; i < sensitivity_workers_count; i++)
             {
-                if (quantize_datas[k].name == layer_name)
-                {
-                    quantize_datas[k].update_histogram(out);
-                    break;
-                }
+                error_sum += workers[i].error_sums[k];
+                energy_sum += workers[i].energy_sums[k];
             }
+
+            const float error = energy_sum > 0.0 ? static_cast<float>(error_sum / energy_sum) : 0.f;
+            keep_fp32[k] = error > calibration_param.mixed_error;
+
+            fprintf(stderr, "%-20s relative error : %-15f %s\n", net.conv_names[k].c_str(), error, keep_fp32[k] ? "fp32" : "int8");
         }
     }
 
-    // step4 kld
-    printf("    ====> step 4 : using kld to find the best threshold value.\n");
-    for (size_t i = 0; i < net.conv_names.size(); i++)
+    FILE* fp = fopen(table_path.c_str(), "w");
+    if (!fp)
+    {
+        fprintf(stderr, "fopen %s failed\n", table_path.c_str());
+        return -1;
+    }
+
+    // save quantization scale of weight, layers left out of the table stay fp32 in ncnn2int8
+    printf("====> Quantize the parameters.\n");
+    for (size_t i = 0; i < layer_count; i++)
     {
+        if (keep_fp32[i])
+            continue;
+
         std::string layer_name = net.conv_names[i];
-        std::string blob_name = net.conv_bottom_blob_names[layer_name];
-        fprintf(stderr, "%-20s ", layer_name.c_str());
+        std::vector<float> weight_scale_n = net.weight_scales[layer_name];
 
-        for (size_t k = 0; k < quantize_datas.size(); k++)
+        fprintf(fp, "%s_param_0 ", layer_name.c_str());
+        for (size_t j = 0; j < weight_scale_n.size(); j++)
         {
-            if (quantize_datas[k].name == layer_name)
-            {
-                quantize_datas[k].get_data_blob_scale();
-                fprintf(stderr, "bin : %-8d threshold : %-15f interval : %-10f scale : %-10f\n",
-                        quantize_datas[k].threshold_bin,
-                        quantize_datas[k].threshold,
-                        quantize_datas[k].histogram_interval,
-                        quantize_datas[k].scale);
+            fprintf(fp, "%f ", weight_scale_n[j]);
+        }
+        fprintf(fp, "\n");
+    }
 
-                fprintf(fp, "%s %f\n", layer_name.c_str(), quantize_datas[k].scale);
+    for (size_t i = 0; i < layer_count; i++)
+    {
+        if (keep_fp32[i])
+            continue;
 
-                break;
-            }
+        fprintf(fp, "%s", net.conv_names[i].c_str());
+        for (size_t j = 0; j < bottom_blob_scales[i].size(); j++)
+        {
+            fprintf(fp, " %f", bottom_blob_scales[i][j]);
         }
+        fprintf(fp, "\n");
     }
 
     fclose(fp);
@@ -732,7 +1303,7 @@ static int post_training_quantize(const std::vector<std::string>& image_list, co
 // usage
 void showUsage()
 {
-    std::cout << "example: ./ncnn2table --param=squeezenet-fp32.param --bin=squeezenet-fp32.bin --images=images/ --output=squeezenet.table --mean=104.0,117.0,123.0 --norm=1.0,1.0,1.0 --size=224,224 --swapRB --thread=2" << std::endl;
+    std::cout << "example: ./ncnn2table --param=squeezenet-fp32.param --bin=squeezenet-fp32.bin --images=images/ --output=squeezenet.table --mean=104.0,117.0,123.0 --norm=1.0,1.0,1.0 --size=224,224 --swapRB --thread=2 --workers=4 --method=kl" << std::endl;
 }
 
 static int find_all_value_in_string(const std::string& values_string, std::vector<float>& value)
@@ -808,7 +1379,12 @@ int main(int argc, char** argv)
                           "{norm n         |   | value of normalize (scale value, default is 1.0,1.0,1.0) }"
                           "{size s         |   | the size of input image(using the resize the original image,default is w=224,h=224) }"
                           "{swapRB c       |   | flag which indicates that swap first and last channels in 3-channel image is necessary }"
-                          "{thread t       | 4 | count of processing threads }";
+                          "{thread t       | 4 | count of processing threads }"
+                          "{workers w      | 1 | count of images calibrated at once, each with --thread threads }"
+                          "{method         | kl | threshold search method, kl aciq percentile or mse }"
+                          "{percentile     | 99.99 | percent of activation values below the threshold with --method=percentile }"
+                          "{perchannel     |   | flag which indicates one activation scale per channel for depthwise convolution }"
+                          "{mixed          | 0 | layers whose simulated int8 relative error is above this value stay fp32, 0 quantizes all }";
 
     cv::CommandLineParser parser(argc, argv, key_map);
 
@@ -841,6 +1417,36 @@ int main(int argc, char** argv)
 
     const int num_threads = parser.get<int>("thread");
 
+    struct CalibrationParam calibration_param;
+    calibration_param.num_workers = parser.get<int>("workers");
+    calibration_param.percentile = parser.get<float>("percentile");
+    calibration_param.per_channel = parser.has("perchannel");
+    calibration_param.mixed_error = parser.get<float>("mixed");
+
+    const std::string method_str = parser.get<std::string>("method");
+    if (method_str == "kl")
+    {
+        calibration_param.method = CALIBRATION_KL;
+    }
+    else if (method_str == "aciq")
+    {
+        calibration_param.method = CALIBRATION_ACIQ;
+    }
+    else if (method_str == "percentile")
+    {
+        calibration_param.method = CALIBRATION_PERCENTILE;
+    }
+    else if (method_str == "mse")
+    {
+        calibration_param.method = CALIBRATION_MSE;
+    }
+    else
+    {
+        fprintf(stderr, "ERROR: Unknown calibration method %s, please check --method param.\n", method_str.c_str());
+
+        return -1;
+    }
+
     struct PreParam pre_param;
     pre_param.mean[0] = 104.f;
     pre_param.mean[1] = 117.f;
@@ -946,7 +1552,7 @@ int main(int argc, char** argv)
     parse_images_dir(image_folder_path, image_file_path_list);
 
     // get the calibration table file, and save it.
-    const int ret = post_training_quantize(image_file_path_list, ncnn_param_file_path, ncnn_bin_file_path, saved_table_file_path, pre_param);
+    const int ret = post_training_quantize(image_file_path_list, ncnn_param_file_path, ncnn_bin_file_path, saved_table_file_path, pre_param, calibration_param);
     if (!ret)
     {
         fprintf(stderr, "\nNCNN Int8 Calibration table create success, best wish for your INT8 inference has a low accuracy loss...\\(^0^)/...233...\n");